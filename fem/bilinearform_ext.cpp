@@ -36,20 +36,205 @@ const Operator *BilinearFormExtension::GetRestriction() const
 }
 
 
+ElementMatrixGroup::ElementMatrixGroup(
+   const FiniteElementSpace &fes, const Array<int> &elements,
+   const Array<BilinearFormIntegrator*> &integrators)
+   : elem_restrict(fes, ElementDofOrdering::NATIVE, elements)
+{
+   const int ne = elements.Size();
+   const int nd = ne > 0 ? fes.GetFE(elements[0])->GetDof()*fes.GetVDim() : 0;
+   elem_mats.SetSize(nd, nd, ne);
+   elem_mats = 0.0;
+   DenseMatrix elmat;
+   for (int i = 0; i < ne; ++i)
+   {
+      const FiniteElement &fe = *fes.GetFE(elements[i]);
+      for (int k = 0; k < integrators.Size(); ++k)
+      {
+         ElementTransformation &T = *fes.GetElementTransformation(elements[i]);
+         integrators[k]->AssembleElementMatrix(fe, T, elmat);
+         MFEM_VERIFY(elmat.Height() == nd, "invalid element matrix size");
+         elem_mats(i) += elmat;
+      }
+   }
+   localX.SetSize(elem_restrict.Height(), Device::GetMemoryType());
+   localY.SetSize(elem_restrict.Height(), Device::GetMemoryType());
+}
+
+// Batched element matrix-vector product kernel
+static void ElementMatrixMult(const int NE, const int ND, const bool transpose,
+                              const DenseTensor &mats, const Vector &x_,
+                              Vector &y_)
+{
+   auto M = Reshape(mats.Read(), ND, ND, NE);
+   auto X = Reshape(x_.Read(), ND, NE);
+   auto Y = Reshape(y_.Write(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < ND; ++i)
+      {
+         double d = 0.0;
+         for (int j = 0; j < ND; ++j)
+         {
+            d += (transpose ? M(j,i,e) : M(i,j,e)) * X(j,e);
+         }
+         Y(i,e) = d;
+      }
+   });
+}
+
+void ElementMatrixGroup::AddMult(const Vector &x, Vector &y,
+                                 const bool transpose) const
+{
+   const int ne = elem_mats.SizeK();
+   if (ne == 0) { return; }
+   elem_restrict.Mult(x, localX);
+   ElementMatrixMult(ne, elem_mats.SizeI(), transpose, elem_mats, localX,
+                     localY);
+   elem_restrict.AddMultTranspose(localY, y);
+}
+
+void ElementMatrixGroup::AddDiagonal(Vector &diag) const
+{
+   const int NE = elem_mats.SizeK();
+   if (NE == 0) { return; }
+   const int ND = elem_mats.SizeI();
+   auto M = Reshape(elem_mats.Read(), ND, ND, NE);
+   auto Y = Reshape(localY.Write(), ND, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int i = 0; i < ND; ++i) { Y(i,e) = M(i,i,e); }
+   });
+   elem_restrict.AddMultTranspose(localY, diag);
+}
+
+
 // Data and methods for partially-assembled bilinear forms
 PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form)
    : BilinearFormExtension(form),
      trialFes(a->FESpace()),
-     testFes(a->FESpace())
+     testFes(a->FESpace()),
+     elem_restrict_lex(NULL),
+     bdr_elem_restrict_lex(NULL),
+     mixed(false),
+     tensor_restrict(NULL),
+     num_interior(-1),
+     int_restrict(NULL),
+     shr_restrict(NULL)
+{
+   SetupRestriction();
+}
+
+PABilinearFormExtension::~PABilinearFormExtension()
+{
+   delete shr_restrict;
+   delete int_restrict;
+   delete tensor_restrict;
+   for (int g = 0; g < elem_groups.Size(); ++g) { delete elem_groups[g]; }
+}
+
+void PABilinearFormExtension::SetupRestriction()
 {
-   elem_restrict_lex = trialFes->GetElementRestriction(
-                          ElementDofOrdering::LEXICOGRAPHIC);
+   delete shr_restrict;
+   delete int_restrict;
+   delete tensor_restrict;
+   shr_restrict = int_restrict = tensor_restrict = NULL;
+   for (int g = 0; g < elem_groups.Size(); ++g) { delete elem_groups[g]; }
+   elem_groups.SetSize(0);
+
+   const Mesh *mesh = trialFes->GetMesh();
+   mixed = mesh->GetNumGeometries(mesh->Dimension()) > 1;
+   if (!mixed && !Partitioned())
+   {
+      elem_restrict_lex = trialFes->GetElementRestriction(
+                             ElementDofOrdering::LEXICOGRAPHIC);
+   }
+   else
+   {
+      if (mixed)
+      {
+         tensor_elements.SetSize(0);
+         for (int e = 0; e < trialFes->GetNE(); ++e)
+         {
+            if (dynamic_cast<const TensorBasisElement*>(trialFes->GetFE(e)))
+            {
+               tensor_elements.Append(e);
+            }
+         }
+      }
+      // With a partition, tensor_elements holds the interior elements
+      // followed by the shared ones
+      tensor_restrict = new SubsetElementRestriction(
+         *trialFes, ElementDofOrdering::LEXICOGRAPHIC, tensor_elements);
+      elem_restrict_lex = tensor_restrict;
+   }
    if (elem_restrict_lex)
    {
       localX.SetSize(elem_restrict_lex->Height(), Device::GetMemoryType());
       localY.SetSize(elem_restrict_lex->Height(), Device::GetMemoryType());
       localY.UseDevice(true); // ensure 'localY = 0.0' is done on device
    }
+
+   if (Partitioned())
+   {
+      const int ne = tensor_elements.Size();
+      Array<int> interior(tensor_elements.GetData(), num_interior);
+      Array<int> shared(tensor_elements.GetData() + num_interior,
+                        ne - num_interior);
+      int_restrict = new SubsetElementRestriction(
+         *trialFes, ElementDofOrdering::LEXICOGRAPHIC, interior);
+      shr_restrict = new SubsetElementRestriction(
+         *trialFes, ElementDofOrdering::LEXICOGRAPHIC, shared);
+      // The E-vectors of the interior and shared elements are contiguous parts
+      // of the E-vectors of all elements
+      const int int_size = int_restrict->Height();
+      const int shr_size = shr_restrict->Height();
+      int_localX.MakeRef(localX, 0, int_size);
+      int_localY.MakeRef(localY, 0, int_size);
+      shr_localX.MakeRef(localX, int_size, shr_size);
+      shr_localY.MakeRef(localY, int_size, shr_size);
+      int_localY.UseDevice(true);
+      shr_localY.UseDevice(true);
+   }
+}
+
+void PABilinearFormExtension::SetupElementGroups()
+{
+   for (int g = 0; g < elem_groups.Size(); ++g) { delete elem_groups[g]; }
+   elem_groups.SetSize(0);
+   if (!mixed) { return; }
+
+   const Mesh *mesh = trialFes->GetMesh();
+   Array<Geometry::Type> geoms;
+   mesh->GetGeometries(mesh->Dimension(), geoms);
+   Array<int> elements;
+   for (int g = 0; g < geoms.Size(); ++g)
+   {
+      elements.SetSize(0);
+      for (int e = 0; e < trialFes->GetNE(); ++e)
+      {
+         const FiniteElement *fe = trialFes->GetFE(e);
+         if (fe->GetGeomType() == geoms[g] &&
+             !dynamic_cast<const TensorBasisElement*>(fe))
+         {
+            elements.Append(e);
+         }
+      }
+      if (elements.Size() == 0) { continue; }
+      elem_groups.Append(
+         new ElementMatrixGroup(*trialFes, elements, *a->GetDBFI()));
+   }
+}
+
+void PABilinearFormExtension::SetupBdrRestriction()
+{
+   bdr_elem_restrict_lex = NULL;
+   if (a->GetBBFI()->Size() == 0) { return; }
+   bdr_elem_restrict_lex = trialFes->GetBdrElementRestriction(
+                              ElementDofOrdering::LEXICOGRAPHIC);
+   bdr_localX.SetSize(bdr_elem_restrict_lex->Height(), Device::GetMemoryType());
+   bdr_localY.SetSize(bdr_elem_restrict_lex->Height(), Device::GetMemoryType());
+   bdr_localY.UseDevice(true); // ensure 'bdr_localY = 0.0' is done on device
 }
 
 void PABilinearFormExtension::Assemble()
@@ -58,15 +243,59 @@ void PABilinearFormExtension::Assemble()
    const int integratorCount = integrators.Size();
    for (int i = 0; i < integratorCount; ++i)
    {
-      integrators[i]->AssemblePA(*a->FESpace());
+      if (!mixed && !Partitioned())
+      {
+         integrators[i]->AssemblePA(*a->FESpace());
+      }
+      else if (UsePAKernels())
+      {
+         // The quadrature data is set up on the device in the order of
+         // tensor_elements, so that the interior and the shared elements of a
+         // partition are contiguous ranges
+         integrators[i]->AssemblePAElements(*a->FESpace(), tensor_elements);
+      }
    }
+   SetupElementGroups();
+
+   SetupBdrRestriction();
+   Array<BilinearFormIntegrator*> &bdr_integrators = *a->GetBBFI();
+   Array<Array<int>*> &bdr_markers = *a->GetBBFI_Marker();
+   for (int i = 0; i < bdr_integrators.Size(); ++i)
+   {
+      bdr_integrators[i]->AssemblePABoundary(*a->FESpace(), bdr_markers[i]);
+   }
+}
+
+void PABilinearFormExtension::AddMultBdr(const Vector &x, Vector &y,
+                                         const bool transpose) const
+{
+   if (!bdr_elem_restrict_lex || bdr_elem_restrict_lex->Height() == 0)
+   {
+      return;
+   }
+   Array<BilinearFormIntegrator*> &bdr_integrators = *a->GetBBFI();
+   const int bSz = bdr_integrators.Size();
+   bdr_elem_restrict_lex->Mult(x, bdr_localX);
+   bdr_localY = 0.0;
+   for (int i = 0; i < bSz; ++i)
+   {
+      if (transpose)
+      {
+         bdr_integrators[i]->AddMultTransposePA(bdr_localX, bdr_localY);
+      }
+      else
+      {
+         bdr_integrators[i]->AddMultPA(bdr_localX, bdr_localY);
+      }
+   }
+   bdr_elem_restrict_lex->AddMultTranspose(bdr_localY, y);
 }
 
 void PABilinearFormExtension::AssembleDiagonal(Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
 
-   const int iSz = integrators.Size();
+   const int iSz = UsePAKernels() ? integrators.Size() : 0;
    if (elem_restrict_lex)
    {
       localY = 0.0;
@@ -85,6 +314,22 @@ void PABilinearFormExtension::AssembleDiagonal(Vector &y) const
          integrators[i]->AssembleDiagonalPA(y);
       }
    }
+
+   for (int g = 0; g < elem_groups.Size(); ++g)
+   {
+      elem_groups[g]->AddDiagonal(y);
+   }
+
+   Array<BilinearFormIntegrator*> &bdr_integrators = *a->GetBBFI();
+   if (bdr_elem_restrict_lex && bdr_elem_restrict_lex->Height() > 0)
+   {
+      bdr_localY = 0.0;
+      for (int i = 0; i < bdr_integrators.Size(); ++i)
+      {
+         bdr_integrators[i]->AssembleDiagonalPA(bdr_localY);
+      }
+      bdr_elem_restrict_lex->AddMultTranspose(bdr_localY, y);
+   }
 }
 
 void PABilinearFormExtension::Update()
@@ -93,13 +338,9 @@ void PABilinearFormExtension::Update()
    height = width = fes->GetVSize();
    trialFes = fes;
    testFes = fes;
-   elem_restrict_lex = trialFes->GetElementRestriction(
-                          ElementDofOrdering::LEXICOGRAPHIC);
-   if (elem_restrict_lex)
-   {
-      localX.SetSize(elem_restrict_lex->Height());
-      localY.SetSize(elem_restrict_lex->Height());
-   }
+   num_interior = -1;
+   SetupRestriction();
+   SetupBdrRestriction();
 }
 
 void PABilinearFormExtension::FormSystemMatrix(const Array<int> &ess_tdof_list,
@@ -125,8 +366,8 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
 
-   const int iSz = integrators.Size();
-   if (DeviceCanUseCeed() || !elem_restrict_lex)
+   const int iSz = UsePAKernels() ? integrators.Size() : 0;
+   if ((DeviceCanUseCeed() && !mixed && !Partitioned()) || !elem_restrict_lex)
    {
       y.UseDevice(true); // typically this is a large vector, so store on device
       y = 0.0;
@@ -145,12 +386,17 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
       }
       elem_restrict_lex->MultTranspose(localY, y);
    }
+   for (int g = 0; g < elem_groups.Size(); ++g)
+   {
+      elem_groups[g]->AddMult(x, y);
+   }
+   AddMultBdr(x, y, false);
 }
 
 void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
-   const int iSz = integrators.Size();
+   const int iSz = UsePAKernels() ? integrators.Size() : 0;
    if (elem_restrict_lex)
    {
       elem_restrict_lex->Mult(x, localX);
@@ -170,6 +416,62 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
          integrators[i]->AddMultTransposePA(x, y);
       }
    }
+   for (int g = 0; g < elem_groups.Size(); ++g)
+   {
+      elem_groups[g]->AddMult(x, y, true);
+   }
+   AddMultBdr(x, y, true);
+}
+
+void PABilinearFormExtension::SetElementPartition(const Array<int> &interior,
+                                                  const Array<int> &shared)
+{
+   MFEM_VERIFY(!mixed, "meshes with mixed element geometries are not "
+               "supported");
+   MFEM_VERIFY(interior.Size() + shared.Size() == trialFes->GetNE(),
+               "invalid element partition");
+   tensor_elements = interior;
+   tensor_elements.Append(shared);
+   num_interior = interior.Size();
+   SetupRestriction();
+}
+
+void PABilinearFormExtension::MultInterior(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(Partitioned(), "the elements are not partitioned");
+   if (num_interior == 0)
+   {
+      y.UseDevice(true);
+      y = 0.0;
+      return;
+   }
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   int_restrict->Mult(x, int_localX);
+   int_localY = 0.0;
+   for (int i = 0; i < integrators.Size(); ++i)
+   {
+      integrators[i]->AddMultPARange(int_localX, int_localY, 0, num_interior);
+   }
+   int_restrict->MultTranspose(int_localY, y);
+}
+
+void PABilinearFormExtension::AddMultShared(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(Partitioned(), "the elements are not partitioned");
+   const int ne = tensor_elements.Size();
+   if (ne > num_interior)
+   {
+      Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+      shr_restrict->Mult(x, shr_localX);
+      shr_localY = 0.0;
+      for (int i = 0; i < integrators.Size(); ++i)
+      {
+         integrators[i]->AddMultPARange(shr_localX, shr_localY, num_interior,
+                                        ne);
+      }
+      shr_restrict->AddMultTranspose(shr_localY, y);
+   }
+   AddMultBdr(x, y, false);
 }
 
 
@@ -21,6 +21,7 @@ namespace mfem
 
 class BilinearForm;
 class MixedBilinearForm;
+class BilinearFormIntegrator;
 
 
 /** @brief Class extending the BilinearForm class to support the different
@@ -96,17 +97,82 @@ public:
    ~EABilinearFormExtension() {}
 };
 
+/** @brief Element matrices of a group of elements with the same geometry,
+    applied with a batched dense kernel. */
+/** The element matrices of all given integrators are assembled on the host,
+    using BilinearFormIntegrator::AssembleElementMatrix(), and stored in a
+    single DenseTensor. This is used by PABilinearFormExtension for the elements
+    without a tensor-product structure on meshes with mixed element geometries.
+    The input and output vectors of the methods are L-vectors. */
+class ElementMatrixGroup
+{
+protected:
+   SubsetElementRestriction elem_restrict;
+   DenseTensor elem_mats;
+   mutable Vector localX, localY;
+
+public:
+   ElementMatrixGroup(const FiniteElementSpace &fes, const Array<int> &elements,
+                      const Array<BilinearFormIntegrator*> &integrators);
+
+   /// Add the action (or its transpose) of the element matrices to @a y.
+   void AddMult(const Vector &x, Vector &y, const bool transpose = false) const;
+
+   /// Add the diagonal of the element matrices to @a diag.
+   void AddDiagonal(Vector &diag) const;
+};
+
 /// Data and methods for partially-assembled bilinear forms
+/** On meshes with mixed element geometries, the elements are partitioned by
+    geometry: the tensor-product elements use the partial assembly kernels of
+    the integrators, see BilinearFormIntegrator::AssemblePAElements(), while
+    each of the other geometries uses an ElementMatrixGroup. */
 class PABilinearFormExtension : public BilinearFormExtension
 {
 protected:
    const FiniteElementSpace *trialFes, *testFes; // Not owned
    mutable Vector localX, localY;
    const Operator *elem_restrict_lex; // Not owned
+   /// Boundary element restriction, used by the boundary integrators.
+   const ElementRestriction *bdr_elem_restrict_lex; // Not owned
+   mutable Vector bdr_localX, bdr_localY;
+
+   /// True if the mesh has elements of several geometries.
+   bool mixed;
+   /// Tensor-product elements of a mixed mesh and their restriction.
+   Array<int> tensor_elements;
+   SubsetElementRestriction *tensor_restrict; // Owned
+   /// Element matrices of the other geometries of a mixed mesh.
+   Array<ElementMatrixGroup*> elem_groups; // Owned
+
+   /** @brief Number of interior elements, at the start of #tensor_elements,
+       or -1 if the elements are not partitioned, see SetElementPartition(). */
+   int num_interior;
+   /// Restrictions of the interior and of the shared elements.
+   SubsetElementRestriction *int_restrict, *shr_restrict; // Owned
+   /// Interior and shared parts of #localX and #localY.
+   mutable Vector int_localX, int_localY, shr_localX, shr_localY;
+
+   /// Setup the element restriction, partitioning the elements if mixed.
+   void SetupRestriction();
+
+   /// Setup the element matrices of the non-tensor elements of a mixed mesh.
+   void SetupElementGroups();
+
+   /// Return true if the integrators' partial assembly kernels are used.
+   bool UsePAKernels() const { return !mixed || tensor_elements.Size() > 0; }
+
+   /// Setup the boundary element restriction, if there are boundary integrators.
+   void SetupBdrRestriction();
+
+   /// Add the action (or its transpose) of the boundary integrators to @a y.
+   void AddMultBdr(const Vector &x, Vector &y, const bool transpose) const;
 
 public:
    PABilinearFormExtension(BilinearForm*);
 
+   virtual ~PABilinearFormExtension();
+
    void Assemble();
    void AssembleDiagonal(Vector &diag) const;
    void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A);
@@ -118,6 +184,30 @@ public:
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
    void Update();
+
+   /** @brief Partition the elements into the @a interior ones and the
+       @a shared ones, whose actions are computed separately by MultInterior()
+       and AddMultShared(). */
+   /** In parallel, the interior elements are the ones with no DOFs shared with
+       other processors, see ParFiniteElementSpace::GetInteriorElements(), and
+       their action can overlap the exchange of the shared DOFs. The partition
+       must be set before Assemble() and is reset by Update(). It requires a
+       mesh with a single element geometry and integrators which support
+       BilinearFormIntegrator::AddMultPARange(). */
+   void SetElementPartition(const Array<int> &interior,
+                            const Array<int> &shared);
+
+   /// Return true if the elements are partitioned, see SetElementPartition().
+   bool Partitioned() const { return num_interior >= 0; }
+
+   /** @brief Set @a y to the action of the interior elements on @a x, see
+       SetElementPartition(). */
+   /** Only the values of @a x at the DOFs of the interior elements are used. */
+   void MultInterior(const Vector &x, Vector &y) const;
+
+   /** @brief Add to @a y the action of the shared elements and of the boundary
+       integrators on @a x, see SetElementPartition(). */
+   void AddMultShared(const Vector &x, Vector &y) const;
 };
 
 
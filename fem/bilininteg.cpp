@@ -33,6 +33,20 @@ void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace&,
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AssemblePABoundary(const FiniteElementSpace&,
+                                                const Array<int>*)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePABoundary(...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssemblePAElements(const FiniteElementSpace&,
+                                                const Array<int>&)
+{
+   mfem_error ("BilinearFormIntegrator::AssemblePAElements(...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AssembleDiagonalPA(Vector &)
 {
    MFEM_ABORT("BilinearFormIntegrator::AssembleDiagonalPA (...)\n"
@@ -45,6 +59,13 @@ void BilinearFormIntegrator::AddMultPA(const Vector &, Vector &) const
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AddMultPARange(const Vector &, Vector &,
+                                            const int, const int) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultPARange (...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AddMultTransposePA(const Vector &, Vector &) const
 {
    mfem_error ("BilinearFormIntegrator::MultAssembledTranspose (...)\n"
@@ -916,6 +937,7 @@ void ConvectionIntegrator::AssembleElementMatrix(
 {
    int nd = el.GetDof();
    int dim = el.GetDim();
+   int sdim = Trans.GetSpaceDim();
 
 #ifdef MFEM_THREAD_SAFE
    DenseMatrix dshape, adjJ, Q_ir;
@@ -923,7 +945,7 @@ void ConvectionIntegrator::AssembleElementMatrix(
 #endif
    elmat.SetSize(nd);
    dshape.SetSize(nd,dim);
-   adjJ.SetSize(dim);
+   adjJ.SetSize(dim,sdim);
    shape.SetSize(nd);
    vec2.SetSize(dim);
    BdFidxT.SetSize(nd);
@@ -949,7 +971,9 @@ void ConvectionIntegrator::AssembleElementMatrix(
       Trans.SetIntPoint(&ip);
       CalcAdjugate(Trans.Jacobian(), adjJ);
       Q_ir.GetColumnReference(i, vec1);
-      vec1 *= alpha * ip.weight;
+      // On elements of lower dimension than the space, e.g. boundary
+      // elements, adjJ is |J|^2 times the pseudo-inverse of J
+      vec1 *= alpha * ip.weight / ((dim == sdim) ? 1.0 : Trans.Weight());
 
       adjJ.Mult(vec1, vec2);
       dshape.Mult(vec2, BdFidxT);
@@ -50,6 +50,26 @@ public:
    virtual void AssemblePA(const FiniteElementSpace &trial_fes,
                            const FiniteElementSpace &test_fes);
 
+   /// Method defining partial assembly on the boundary elements of the mesh.
+   /** The integrator is set up to act on boundary E-vectors, see
+       FiniteElementSpace::GetBdrElementRestriction(), through the methods
+       AddMultPA(), AddMultTransposePA() and AssembleDiagonalPA(). If
+       @a bdr_marker is not NULL, only the boundary elements with marked
+       attributes contribute to the action. */
+   virtual void AssemblePABoundary(const FiniteElementSpace &fes,
+                                   const Array<int> *bdr_marker = NULL);
+
+   /// Method defining partial assembly on a subset of the mesh elements.
+   /** The given @a elements must all have the same geometry. The integrator is
+       set up to act on the E-vectors of these elements, see
+       SubsetElementRestriction, through the methods AddMultPA(),
+       AddMultTransposePA() and AssembleDiagonalPA(). The quadrature data is
+       computed on the device, as in AssemblePA(). This is used on meshes with
+       mixed element geometries and to partition the elements, see
+       PABilinearFormExtension::SetElementPartition(). */
+   virtual void AssemblePAElements(const FiniteElementSpace &fes,
+                                   const Array<int> &elements);
+
    /// Assemble diagonal and add it to Vector @a diag.
    virtual void AssembleDiagonalPA(Vector &diag);
 
@@ -62,6 +82,16 @@ public:
        called. */
    virtual void AddMultPA(const Vector &x, Vector &y) const;
 
+   /// Method for partially assembled action on a range of elements.
+   /** Same as AddMultPA(), restricted to the elements @a e_begin <= e <
+       @a e_end in the order used by AssemblePA(), resp. by the list given to
+       AssemblePAElements(). Both @a x and @a y are the E-vectors of these
+       elements only. This is used to overlap the exchange of shared DOFs with
+       computation in parallel, see
+       PABilinearFormExtension::SetElementPartition(). */
+   virtual void AddMultPARange(const Vector &x, Vector &y, const int e_begin,
+                               const int e_end) const;
+
    /// Method for partially assembled transposed action.
    /** Perform the transpose action of integrator on the input @a x and add the
        result to the output @a y. Both @a x and @a y are E-vectors, i.e. they
@@ -1817,14 +1847,27 @@ public:
 
    virtual void AssemblePA(const FiniteElementSpace &fes);
 
+   virtual void AssemblePABoundary(const FiniteElementSpace &fes,
+                                   const Array<int> *bdr_marker = NULL);
+
+   virtual void AssemblePAElements(const FiniteElementSpace &fes,
+                                   const Array<int> &elements);
+
    virtual void AssembleDiagonalPA(Vector &diag);
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultPARange(const Vector&, Vector&, const int e_begin,
+                               const int e_end) const;
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe);
 
-   void SetupPA(const FiniteElementSpace &fes, const bool force = false);
+   /** @brief Compute the partial assembly data for all mesh elements or, if
+       @a elements is not NULL, for the given elements of the same geometry,
+       see AssemblePAElements(). */
+   void SetupPA(const FiniteElementSpace &fes, const bool force = false,
+                const Array<int> *elements = NULL);
 };
 
 /** Class for local mass matrix assembling a(u,v) := (Q u, v) */
@@ -1890,15 +1933,28 @@ public:
 
    virtual void AssemblePA(const FiniteElementSpace &fes);
 
+   virtual void AssemblePABoundary(const FiniteElementSpace &fes,
+                                   const Array<int> *bdr_marker = NULL);
+
+   virtual void AssemblePAElements(const FiniteElementSpace &fes,
+                                   const Array<int> &elements);
+
    virtual void AssembleDiagonalPA(Vector &diag);
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultPARange(const Vector&, Vector&, const int e_begin,
+                               const int e_end) const;
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe,
                                          ElementTransformation &Trans);
 
-   void SetupPA(const FiniteElementSpace &fes, const bool force = false);
+   /** @brief Compute the partial assembly data for all mesh elements or, if
+       @a elements is not NULL, for the given elements of the same geometry,
+       see AssemblePAElements(). */
+   void SetupPA(const FiniteElementSpace &fes, const bool force = false,
+                const Array<int> *elements = NULL);
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -1945,11 +2001,25 @@ public:
 
    virtual void AssemblePA(const FiniteElementSpace&);
 
+   virtual void AssemblePABoundary(const FiniteElementSpace &fes,
+                                   const Array<int> *bdr_marker = NULL);
+
+   virtual void AssemblePAElements(const FiniteElementSpace &fes,
+                                   const Array<int> &elements);
+
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultPARange(const Vector&, Vector&, const int e_begin,
+                               const int e_end) const;
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe,
                                          ElementTransformation &Trans);
+
+   /** @brief Compute the partial assembly data for all mesh elements or, if
+       @a elements is not NULL, for the given elements of the same geometry,
+       see AssemblePAElements(). */
+   void SetupPA(const FiniteElementSpace &fes, const Array<int> *elements);
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
@@ -22,18 +22,45 @@ namespace mfem
 
 // PA Convection Assemble kernel
 void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   SetupPA(fes, NULL);
+}
+
+void ConvectionIntegrator::AssemblePAElements(const FiniteElementSpace &fes,
+                                              const Array<int> &elements)
+{
+   SetupPA(fes, &elements);
+}
+
+void ConvectionIntegrator::SetupPA(const FiniteElementSpace &fes,
+                                   const Array<int> *elements)
 {
    // Assuming the same element type
    Mesh *mesh = fes.GetMesh();
-   if (mesh->GetNE() == 0) { return; }
-   const FiniteElement &el = *fes.GetFE(0);
-   ElementTransformation *T = mesh->GetElementTransformation(0);
+   ne = elements ? elements->Size() : mesh->GetNE();
+   if (ne == 0) { return; }
+   const int e0 = elements ? (*elements)[0] : 0;
+   const FiniteElement &el = *fes.GetFE(e0);
+   ElementTransformation *T = mesh->GetElementTransformation(e0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
    dim = mesh->Dimension();
-   ne = fes.GetMesh()->GetNE();
    nq = ir->GetNPoints();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
-                                    GeometricFactors::JACOBIANS);
+   // The geometric factors of a subset of the elements are not cached by the
+   // mesh, they are only used in the setup kernels below
+   GeometricFactors *subset_geom = NULL;
+   if (elements)
+   {
+      mesh->EnsureNodes();
+      subset_geom = new GeometricFactors(mesh, *ir,
+                                         GeometricFactors::JACOBIANS,
+                                         *elements);
+      geom = subset_geom;
+   }
+   else
+   {
+      geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
+                                       GeometricFactors::JACOBIANS);
+   }
    maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
@@ -62,7 +89,8 @@ void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    {
       for (int e=0; e<NE; ++e)
       {
-         ElementTransformation& Te = *fes.GetElementTransformation(e);
+         ElementTransformation& Te =
+            *fes.GetElementTransformation(elements ? (*elements)[e] : e);
          for (int q=0; q<nq; ++q)
          {
             for (int idim=0; idim < dim; ++idim)
@@ -148,6 +176,116 @@ void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
 
       });
    }//dim = 3
+   if (subset_geom)
+   {
+      delete subset_geom;
+      geom = NULL;
+   }
+}
+
+void ConvectionIntegrator::AssemblePABoundary(const FiniteElementSpace &fes,
+                                              const Array<int> *bdr_marker)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNBE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetBE(0);
+   ElementTransformation *T = mesh->GetBdrElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
+   const int sdim = mesh->SpaceDimension();
+   dim = el.GetDim();
+   nq = ir->GetNPoints();
+   geom = NULL;
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   // The velocity is mapped to the reference element, w |J| (J^t J)^{-1} J^t q,
+   // using the pseudo-inverse of the Jacobian; for boundary elements, this is
+   // the projection on the tangent space.
+   pa_data.SetSize(dim*ne*nq, Device::GetMemoryType());
+   auto v = Reshape(pa_data.HostWrite(), dim, nq, ne);
+   Vector e_coeff(sdim);
+   DenseMatrix Jinv(dim, sdim);
+   for (int e = 0; e < ne; ++e)
+   {
+      const int attr = mesh->GetBdrAttribute(e);
+      const bool active = !bdr_marker || (*bdr_marker)[attr-1];
+      ElementTransformation &Tr = *fes.GetBdrElementTransformation(e);
+      for (int q = 0; q < nq; ++q)
+      {
+         if (!active)
+         {
+            for (int idim = 0; idim < dim; ++idim) { v(idim,q,e) = 0.0; }
+            continue;
+         }
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         Tr.SetIntPoint(&ip);
+         CalcInverse(Tr.Jacobian(), Jinv);
+         if (Q == nullptr) { e_coeff = 1.0; }
+         else { Q->Eval(e_coeff, Tr, ip); }
+         const double w_coeff = alpha * ip.weight * Tr.Weight();
+         for (int idim = 0; idim < dim; ++idim)
+         {
+            double d = 0.0;
+            for (int k = 0; k < sdim; ++k) { d += Jinv(idim,k) * e_coeff(k); }
+            v(idim,q,e) = w_coeff * d;
+         }
+      }
+   }
+}
+
+// PA Convection Apply 1D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PAConvectionApply1D(const int NE,
+                         const Array<double> &b,
+                         const Array<double> &g,
+                         const Array<double> &bt,
+                         const Vector &_op,
+                         const Vector &_x,
+                         Vector &_y,
+                         const int d1d = 0,
+                         const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto D = Reshape(_op.Read(), Q1D, NE);
+   auto xloc = Reshape(_x.Read(), D1D, NE);
+   auto yloc = Reshape(_y.ReadWrite(), D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+
+      // the following variables are evaluated at compile time
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      double Z[max_Q1D];
+      for (int j1=0; j1<Q1D; ++j1)
+      {
+         double dot = 0.0;
+         for (int i1=0; i1<D1D; ++i1)
+         {
+            dot += G(j1,i1)*xloc(i1, e);
+         }
+         Z[j1] = D(j1, e) * dot;
+      }
+
+      for (int j1=0; j1<D1D; ++j1)
+      {
+         double dot = 0.0;
+         for (int i1=0; i1<Q1D; ++i1)
+         {
+            dot += Bt(j1, i1)*Z[i1];
+         }
+         yloc(j1, e) += dot;
+      }
+   });
 }
 
 // PA Convection Apply 2D kernel
@@ -462,7 +600,11 @@ static void PAConvectionApply(const int dim,
                               const Vector &x,
                               Vector &y)
 {
-
+   if (dim==1)
+   {
+      PAConvectionApply1D(NE, B, G, Bt, op, x, y, D1D, Q1D);
+      return;
+   }
    if (dim==2)
    {
       switch ((D1D << 4 ) | Q1D)
@@ -497,4 +639,18 @@ void ConvectionIntegrator::AddMultPA(const Vector &x, Vector &y) const
                      pa_data, x, y);
 }
 
+void ConvectionIntegrator::AddMultPARange(const Vector &x, Vector &y,
+                                          const int e_begin,
+                                          const int e_end) const
+{
+   const int nr = e_end - e_begin;
+   if (nr == 0) { return; }
+   // The partial assembly data is ordered by element
+   const int stride = pa_data.Size()/ne;
+   Vector range_data;
+   range_data.MakeRef(const_cast<Vector&>(pa_data), e_begin*stride, nr*stride);
+   PAConvectionApply(dim, dofs1D, quad1D, nr, maps->B, maps->G, maps->Bt,
+                     maps->Gt, range_data, x, y);
+}
+
 } // namespace mfem
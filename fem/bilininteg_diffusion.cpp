@@ -200,13 +200,22 @@ static void PADiffusionSetup(const int dim,
 }
 
 void DiffusionIntegrator::SetupPA(const FiniteElementSpace &fes,
-                                  const bool force)
+                                  const bool force,
+                                  const Array<int> *elements)
 {
    // Assuming the same element type
    fespace = &fes;
    Mesh *mesh = fes.GetMesh();
-   if (mesh->GetNE() == 0) { return; }
-   const FiniteElement &el = *fes.GetFE(0);
+#ifdef MFEM_USE_CEED
+   if (elements)
+   {
+      delete ceedDataPtr;
+      ceedDataPtr = NULL;
+   }
+#endif
+   ne = elements ? elements->Size() : fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(elements ? (*elements)[0] : 0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
 #ifdef MFEM_USE_CEED
    if (DeviceCanUseCeed() && !force)
@@ -222,8 +231,21 @@ void DiffusionIntegrator::SetupPA(const FiniteElementSpace &fes,
    const int symmDims = (dims * (dims + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
    const int nq = ir->GetNPoints();
    dim = mesh->Dimension();
-   ne = fes.GetNE();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   // The geometric factors of a subset of the elements are not cached by the
+   // mesh, they are only used in the setup kernels below
+   GeometricFactors *subset_geom = NULL;
+   if (elements)
+   {
+      mesh->EnsureNodes();
+      subset_geom = new GeometricFactors(mesh, *ir,
+                                         GeometricFactors::JACOBIANS,
+                                         *elements);
+      geom = subset_geom;
+   }
+   else
+   {
+      geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   }
    maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
@@ -245,7 +267,8 @@ void DiffusionIntegrator::SetupPA(const FiniteElementSpace &fes,
       auto C = Reshape(coeff.HostWrite(), nq, ne);
       for (int e = 0; e < ne; ++e)
       {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
+         ElementTransformation& T =
+            *fes.GetElementTransformation(elements ? (*elements)[e] : e);
          for (int q = 0; q < nq; ++q)
          {
             C(q,e) = Q->Eval(T, ir->IntPoint(q));
@@ -254,6 +277,11 @@ void DiffusionIntegrator::SetupPA(const FiniteElementSpace &fes,
    }
    PADiffusionSetup(dim, dofs1D, quad1D, ne, ir->GetWeights(), geom->J, coeff,
                     pa_data);
+   if (subset_geom)
+   {
+      delete subset_geom;
+      geom = NULL;
+   }
 }
 
 void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
@@ -261,6 +289,72 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    SetupPA(fes);
 }
 
+void DiffusionIntegrator::AssemblePAElements(const FiniteElementSpace &fes,
+                                             const Array<int> &elements)
+{
+   SetupPA(fes, true, &elements);
+}
+
+void DiffusionIntegrator::AssemblePABoundary(const FiniteElementSpace &fes,
+                                             const Array<int> *bdr_marker)
+{
+   MFEM_VERIFY(MQ == NULL, "matrix coefficients are not supported");
+   // Assuming the same element type
+   fespace = &fes;
+   Mesh *mesh = fes.GetMesh();
+#ifdef MFEM_USE_CEED
+   delete ceedDataPtr;
+   ceedDataPtr = NULL;
+#endif
+   ne = fes.GetNBE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetBE(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el);
+   const int sdim = mesh->SpaceDimension();
+   dim = el.GetDim();
+   MFEM_VERIFY(1 <= dim && dim <= 3, "unsupported element dimension");
+   const int symmDims = (dim * (dim + 1)) / 2; // 1x1: 1, 2x2: 3, 3x3: 6
+   const int nq = ir->GetNPoints();
+   geom = NULL;
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   // The metric term w |J| (J^t J)^{-1} is computed on the host, using the
+   // pseudo-inverse of the Jacobian which, for boundary elements, is not
+   // square, and stored in the same layout as the one used in dimension dim.
+   pa_data.SetSize(symmDims * nq * ne, Device::GetMemoryType());
+   auto D = Reshape(pa_data.HostWrite(), nq, symmDims, ne);
+   DenseMatrix Jinv(dim, sdim);
+   for (int e = 0; e < ne; ++e)
+   {
+      const int attr = mesh->GetBdrAttribute(e);
+      const bool active = !bdr_marker || (*bdr_marker)[attr-1];
+      ElementTransformation &Tr = *fes.GetBdrElementTransformation(e);
+      for (int q = 0; q < nq; ++q)
+      {
+         if (!active)
+         {
+            for (int s = 0; s < symmDims; ++s) { D(q,s,e) = 0.0; }
+            continue;
+         }
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         Tr.SetIntPoint(&ip);
+         CalcInverse(Tr.Jacobian(), Jinv);
+         const double coeff = Q ? Q->Eval(Tr, ip) : 1.0;
+         const double c_w = ip.weight * coeff * Tr.Weight();
+         for (int i = 0, s = 0; i < dim; ++i)
+         {
+            for (int j = i; j < dim; ++j, ++s)
+            {
+               double g = 0.0;
+               for (int k = 0; k < sdim; ++k) { g += Jinv(i,k) * Jinv(j,k); }
+               D(q,s,e) = c_w * g;
+            }
+         }
+      }
+   }
+}
+
 
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PADiffusionDiagonal2D(const int NE,
@@ -635,6 +729,37 @@ static void SmemPADiffusionDiagonal3D(const int NE,
    });
 }
 
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PADiffusionDiagonal1D(const int NE,
+                                  const Array<double> &g,
+                                  const Vector &d,
+                                  Vector &y,
+                                  const int d1d = 0,
+                                  const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto D = Reshape(d.Read(), Q1D, NE);
+   auto Y = Reshape(y.ReadWrite(), D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         double t = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            t += G(qx, dx) * G(qx, dx) * D(qx, e);
+         }
+         Y(dx, e) += t;
+      }
+   });
+}
+
 static void PADiffusionAssembleDiagonal(const int dim,
                                         const int D1D,
                                         const int Q1D,
@@ -644,7 +769,11 @@ static void PADiffusionAssembleDiagonal(const int dim,
                                         const Vector &D,
                                         Vector &Y)
 {
-   if (dim == 2)
+   if (dim == 1)
+   {
+      return PADiffusionDiagonal1D(NE,G,D,Y,D1D,Q1D);
+   }
+   else if (dim == 2)
    {
       switch ((D1D << 4 ) | Q1D)
       {
@@ -785,6 +914,61 @@ static void OccaPADiffusionApply3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
+// PA Diffusion Apply 1D kernel
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PADiffusionApply1D(const int NE,
+                               const Array<double> &g_,
+                               const Array<double> &gt_,
+                               const Vector &d_,
+                               const Vector &x_,
+                               Vector &y_,
+                               const int d1d = 0,
+                               const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto G = Reshape(g_.Read(), Q1D, D1D);
+   auto Gt = Reshape(gt_.Read(), D1D, Q1D);
+   auto D = Reshape(d_.Read(), Q1D, NE);
+   auto X = Reshape(x_.Read(), D1D, NE);
+   auto Y = Reshape(y_.ReadWrite(), D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double grad[max_Q1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         grad[qx] = 0.0;
+      }
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         const double s = X(dx,e);
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qx] += s * G(qx,dx);
+         }
+      }
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         grad[qx] *= D(qx,e);
+      }
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         double u = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            u += Gt(dx,qx) * grad[qx];
+         }
+         Y(dx,e) += u;
+      }
+   });
+}
+
 // PA Diffusion Apply 2D kernel
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PADiffusionApply2D(const int NE,
@@ -1506,7 +1690,7 @@ static void PADiffusionApply(const int dim,
                              Vector &Y)
 {
 #ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   if (DeviceCanUseOcca() && dim > 1)
    {
       if (dim == 2)
       {
@@ -1521,7 +1705,11 @@ static void PADiffusionApply(const int dim,
       MFEM_ABORT("OCCA PADiffusionApply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-   if (dim == 2)
+   if (dim == 1)
+   {
+      return PADiffusionApply1D(NE,G,Gt,D,X,Y,D1D,Q1D);
+   }
+   else if (dim == 2)
    {
       switch ((D1D << 4 ) | Q1D)
       {
@@ -1559,7 +1747,7 @@ static void PADiffusionApply(const int dim,
 void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
 #ifdef MFEM_USE_CEED
-   if (DeviceCanUseCeed())
+   if (DeviceCanUseCeed() && ceedDataPtr)
    {
       const CeedScalar *x_ptr;
       CeedScalar *y_ptr;
@@ -1594,4 +1782,23 @@ void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
    }
 }
 
+void DiffusionIntegrator::AddMultPARange(const Vector &x, Vector &y,
+                                         const int e_begin,
+                                         const int e_end) const
+{
+#ifdef MFEM_USE_CEED
+   MFEM_VERIFY(!(DeviceCanUseCeed() && ceedDataPtr),
+               "element ranges are not supported with libCEED");
+#endif
+   const int nr = e_end - e_begin;
+   if (nr == 0) { return; }
+   // The partial assembly data is ordered by element
+   const int stride = pa_data.Size()/ne;
+   Vector range_data;
+   range_data.MakeRef(const_cast<Vector&>(pa_data), e_begin*stride, nr*stride);
+   PADiffusionApply(dim, dofs1D, quad1D, nr,
+                    maps->B, maps->G, maps->Bt, maps->Gt,
+                    range_data, x, y);
+}
+
 } // namespace mfem
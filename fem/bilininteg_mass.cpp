@@ -23,14 +23,24 @@ namespace mfem
 
 // PA Mass Assemble kernel
 
-void MassIntegrator::SetupPA(const FiniteElementSpace &fes, const bool force)
+void MassIntegrator::SetupPA(const FiniteElementSpace &fes, const bool force,
+                             const Array<int> *elements)
 {
    // Assuming the same element type
    fespace = &fes;
    Mesh *mesh = fes.GetMesh();
-   if (mesh->GetNE() == 0) { return; }
-   const FiniteElement &el = *fes.GetFE(0);
-   ElementTransformation *T = mesh->GetElementTransformation(0);
+#ifdef MFEM_USE_CEED
+   if (elements)
+   {
+      delete ceedDataPtr;
+      ceedDataPtr = NULL;
+   }
+#endif
+   ne = elements ? elements->Size() : mesh->GetNE();
+   if (ne == 0) { return; }
+   const int e0 = elements ? (*elements)[0] : 0;
+   const FiniteElement &el = *fes.GetFE(e0);
+   ElementTransformation *T = mesh->GetElementTransformation(e0);
    const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
 #ifdef MFEM_USE_CEED
    if (DeviceCanUseCeed() && !force)
@@ -43,10 +53,23 @@ void MassIntegrator::SetupPA(const FiniteElementSpace &fes, const bool force)
    }
 #endif
    dim = mesh->Dimension();
-   ne = fes.GetMesh()->GetNE();
    nq = ir->GetNPoints();
-   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
-                                    GeometricFactors::JACOBIANS);
+   // The geometric factors of a subset of the elements are not cached by the
+   // mesh, they are only used in the setup kernels below
+   GeometricFactors *subset_geom = NULL;
+   if (elements)
+   {
+      mesh->EnsureNodes();
+      subset_geom = new GeometricFactors(mesh, *ir,
+                                         GeometricFactors::JACOBIANS,
+                                         *elements);
+      geom = subset_geom;
+   }
+   else
+   {
+      geom = mesh->GetGeometricFactors(*ir, GeometricFactors::COORDINATES |
+                                       GeometricFactors::JACOBIANS);
+   }
    maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
    dofs1D = maps->ndof;
    quad1D = maps->nqpt;
@@ -68,7 +91,8 @@ void MassIntegrator::SetupPA(const FiniteElementSpace &fes, const bool force)
       auto C = Reshape(coeff.HostWrite(), nq, ne);
       for (int e = 0; e < ne; ++e)
       {
-         ElementTransformation& T = *fes.GetElementTransformation(e);
+         ElementTransformation& T =
+            *fes.GetElementTransformation(elements ? (*elements)[e] : e);
          for (int q = 0; q < nq; ++q)
          {
             C(q,e) = Q->Eval(T, ir->IntPoint(q));
@@ -125,6 +149,11 @@ void MassIntegrator::SetupPA(const FiniteElementSpace &fes, const bool force)
          }
       });
    }
+   if (subset_geom)
+   {
+      delete subset_geom;
+      geom = NULL;
+   }
 }
 
 void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
@@ -132,6 +161,86 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
    SetupPA(fes);
 }
 
+void MassIntegrator::AssemblePAElements(const FiniteElementSpace &fes,
+                                        const Array<int> &elements)
+{
+   SetupPA(fes, true, &elements);
+}
+
+void MassIntegrator::AssemblePABoundary(const FiniteElementSpace &fes,
+                                        const Array<int> *bdr_marker)
+{
+   // Assuming the same element type
+   fespace = &fes;
+   Mesh *mesh = fes.GetMesh();
+#ifdef MFEM_USE_CEED
+   delete ceedDataPtr;
+   ceedDataPtr = NULL;
+#endif
+   ne = fes.GetNBE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetBE(0);
+   ElementTransformation *T = mesh->GetBdrElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule : &GetRule(el, el, *T);
+   dim = el.GetDim();
+   nq = ir->GetNPoints();
+   geom = NULL;
+   maps = &el.GetDofToQuad(*ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   // The boundary elements are, in general, embedded in a higher dimensional
+   // space and the geometric factors are computed for all mesh elements, so
+   // the quadrature data is computed on the host using the measure given by
+   // the ElementTransformation.
+   pa_data.SetSize(ne*nq, Device::GetMemoryType());
+   auto v = Reshape(pa_data.HostWrite(), nq, ne);
+   for (int i = 0; i < ne; ++i)
+   {
+      const int attr = mesh->GetBdrAttribute(i);
+      const bool active = !bdr_marker || (*bdr_marker)[attr-1];
+      ElementTransformation &Tr = *fes.GetBdrElementTransformation(i);
+      for (int q = 0; q < nq; ++q)
+      {
+         if (!active) { v(q,i) = 0.0; continue; }
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         Tr.SetIntPoint(&ip);
+         const double coeff = Q ? Q->Eval(Tr, ip) : 1.0;
+         v(q,i) = ip.weight * coeff * Tr.Weight();
+      }
+   }
+}
+
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAMassAssembleDiagonal1D(const int NE,
+                                     const Array<double> &b,
+                                     const Vector &d,
+                                     Vector &y,
+                                     const int d1d = 0,
+                                     const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto D = Reshape(d.Read(), Q1D, NE);
+   auto Y = Reshape(y.ReadWrite(), D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         double t = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            t += B(qx, dx) * B(qx, dx) * D(qx, e);
+         }
+         Y(dx, e) += t;
+      }
+   });
+}
+
 
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PAMassAssembleDiagonal2D(const int NE,
@@ -406,7 +515,11 @@ static void PAMassAssembleDiagonal(const int dim, const int D1D,
                                    const Vector &D,
                                    Vector &Y)
 {
-   if (dim == 2)
+   if (dim == 1)
+   {
+      return PAMassAssembleDiagonal1D(NE,B,D,Y,D1D,Q1D);
+   }
+   else if (dim == 2)
    {
       switch ((D1D << 4 ) | Q1D)
       {
@@ -537,6 +650,60 @@ static void OccaPAMassApply3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
+template<int T_D1D = 0, int T_Q1D = 0>
+static void PAMassApply1D(const int NE,
+                          const Array<double> &b_,
+                          const Array<double> &bt_,
+                          const Vector &d_,
+                          const Vector &x_,
+                          Vector &y_,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b_.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt_.Read(), D1D, Q1D);
+   auto D = Reshape(d_.Read(), Q1D, NE);
+   auto X = Reshape(x_.Read(), D1D, NE);
+   auto Y = Reshape(y_.ReadWrite(), D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double sol_x[max_Q1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         sol_x[qx] = 0.0;
+      }
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         const double s = X(dx,e);
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_x[qx] += B(qx,dx) * s;
+         }
+      }
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         sol_x[qx] *= D(qx,e);
+      }
+      for (int dx = 0; dx < D1D; ++dx)
+      {
+         double u = 0.0;
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            u += Bt(dx,qx) * sol_x[qx];
+         }
+         Y(dx,e) += u;
+      }
+   });
+}
+
 template<int T_D1D = 0, int T_Q1D = 0>
 static void PAMassApply2D(const int NE,
                           const Array<double> &b_,
@@ -1072,7 +1239,7 @@ static void PAMassApply(const int dim,
                         Vector &Y)
 {
 #ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   if (DeviceCanUseOcca() && dim > 1)
    {
       if (dim == 2)
       {
@@ -1085,7 +1252,11 @@ static void PAMassApply(const int dim,
       MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-   if (dim == 2)
+   if (dim == 1)
+   {
+      return PAMassApply1D(NE,B,Bt,D,X,Y,D1D,Q1D);
+   }
+   else if (dim == 2)
    {
       switch ((D1D << 4) | Q1D)
       {
@@ -1120,7 +1291,7 @@ static void PAMassApply(const int dim,
 void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
 #ifdef MFEM_USE_CEED
-   if (DeviceCanUseCeed())
+   if (DeviceCanUseCeed() && ceedDataPtr)
    {
       const CeedScalar *x_ptr;
       CeedScalar *y_ptr;
@@ -1153,4 +1324,20 @@ void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
    }
 }
 
+void MassIntegrator::AddMultPARange(const Vector &x, Vector &y,
+                                    const int e_begin, const int e_end) const
+{
+#ifdef MFEM_USE_CEED
+   MFEM_VERIFY(!(DeviceCanUseCeed() && ceedDataPtr),
+               "element ranges are not supported with libCEED");
+#endif
+   const int nr = e_end - e_begin;
+   if (nr == 0) { return; }
+   // The partial assembly data is ordered by element
+   const int stride = pa_data.Size()/ne;
+   Vector range_data;
+   range_data.MakeRef(const_cast<Vector&>(pa_data), e_begin*stride, nr*stride);
+   PAMassApply(dim, dofs1D, quad1D, nr, maps->B, maps->Bt, range_data, x, y);
+}
+
 } // namespace mfem
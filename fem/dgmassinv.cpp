@@ -0,0 +1,448 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "dgmassinv.hpp"
+#include "bilininteg.hpp"
+
+namespace mfem
+{
+
+DGMassInverse::DGMassInverse(const FiniteElementSpace &fes_, Coefficient *Q,
+                             Mode mode_)
+   : Operator(fes_.GetVSize()),
+     fes(fes_),
+     mode(mode_),
+     dim(fes.GetMesh()->Dimension()),
+     ne(fes.GetNE()),
+     vdim(fes.GetVDim()),
+     nd(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
+     d1d(0),
+     elem_restrict(NULL)
+{
+   MFEM_VERIFY(dynamic_cast<const L2_FECollection*>(fes.FEColl()),
+               "DGMassInverse requires a discontinuous (L2) space");
+   for (int e = 0; e < ne; ++e)
+   {
+      MFEM_VERIFY(fes.GetFE(e)->GetDof() == nd,
+                  "all elements must have the same number of DOFs");
+   }
+   // The L-vector is the E-vector of a scalar space, unless its DOFs were
+   // reordered
+   if (vdim > 1 || fes.DofsReordered())
+   {
+      elem_restrict = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+      localX.SetSize(elem_restrict->Height(), Device::GetMemoryType());
+      localY.SetSize(elem_restrict->Height(), Device::GetMemoryType());
+   }
+   if (ne == 0) { return; }
+   if (mode == DENSE) { SetupDense(Q); }
+   else { SetupTensor(Q); }
+}
+
+void DGMassInverse::SetupDense(Coefficient *Q)
+{
+   MassIntegrator *integ = Q ? new MassIntegrator(*Q) : new MassIntegrator;
+   Minv.SetSize(nd, nd, ne);
+   DenseMatrix elmat;
+   for (int e = 0; e < ne; ++e)
+   {
+      integ->AssembleElementMatrix(*fes.GetFE(e),
+                                   *fes.GetElementTransformation(e), elmat);
+      Minv(e) = elmat;
+   }
+   delete integ;
+   BatchInverse(Minv, Minv);
+}
+
+void DGMassInverse::SetupTensor(Coefficient *Q)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   const TensorBasisElement *tel = dynamic_cast<const TensorBasisElement*>(&el);
+   MFEM_VERIFY(tel, "the TENSOR mode requires tensor-product elements");
+   MFEM_VERIFY(tel->GetDofMap().Size() == 0,
+               "the TENSOR mode requires lexicographically ordered DOFs");
+   for (int e = 0; e < ne; ++e)
+   {
+      MFEM_VERIFY(fes.GetFE(e)->GetGeomType() == el.GetGeomType(),
+                  "all elements must be of the same type");
+   }
+
+   // Gauss-Legendre rule with as many points as DOFs in each direction
+   const int order = el.GetOrder();
+   const IntegrationRule &ir = IntRules.Get(el.GetGeomType(), 2*order + 1);
+   const DofToQuad &maps = el.GetDofToQuad(ir, DofToQuad::TENSOR);
+   d1d = maps.ndof;
+   MFEM_VERIFY(maps.nqpt == d1d, "invalid quadrature rule");
+   MFEM_VERIFY(d1d <= MAX_D1D, "the order is too high");
+
+   // Invert the 1D basis-to-quadrature matrix on the host
+   DenseMatrix B1(d1d), B1inv(d1d);
+   for (int i = 0; i < d1d*d1d; ++i) { B1.Data()[i] = maps.B[i]; }
+   DenseMatrixInverse inv(B1);
+   inv.GetInverseMatrix(B1inv);
+   Binv.SetSize(d1d*d1d);
+   for (int i = 0; i < d1d*d1d; ++i) { Binv[i] = B1inv.Data()[i]; }
+
+   const int nq = ir.GetNPoints();
+   Vector coeff;
+   if (Q == NULL)
+   {
+      coeff.SetSize(1);
+      coeff(0) = 1.0;
+   }
+   else if (ConstantCoefficient *cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+   }
+   else
+   {
+      coeff.SetSize(nq * ne);
+      auto C = Reshape(coeff.HostWrite(), nq, ne);
+      for (int e = 0; e < ne; ++e)
+      {
+         ElementTransformation &T = *fes.GetElementTransformation(e);
+         for (int q = 0; q < nq; ++q)
+         {
+            C(q,e) = Q->Eval(T, ir.IntPoint(q));
+         }
+      }
+   }
+
+   Vector h_detJ;
+   if (dim == 1)
+   {
+      // The geometric factors are not available in 1D
+      h_detJ.SetSize(nq * ne);
+      auto dJ = Reshape(h_detJ.HostWrite(), nq, ne);
+      for (int e = 0; e < ne; ++e)
+      {
+         ElementTransformation &T = *fes.GetElementTransformation(e);
+         for (int q = 0; q < nq; ++q)
+         {
+            T.SetIntPoint(&ir.IntPoint(q));
+            dJ(q,e) = T.Weight();
+         }
+      }
+   }
+   const Vector &d_detJ = (dim == 1) ? h_detJ :
+                          fes.GetMesh()->GetGeometricFactors(
+                             ir, GeometricFactors::DETERMINANTS)->detJ;
+   const int NE = ne;
+   const int NQ = nq;
+   const bool const_c = coeff.Size() == 1;
+   auto W = ir.GetWeights().Read();
+   auto detJ = Reshape(d_detJ.Read(), NQ, NE);
+   auto C =
+      const_c ? Reshape(coeff.Read(), 1, 1) : Reshape(coeff.Read(), NQ, NE);
+   Dinv.SetSize(nq*ne, Device::GetMemoryType());
+   auto D = Reshape(Dinv.Write(), NQ, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double c = const_c ? C(0,0) : C(q,e);
+         D(q,e) = 1.0 / (W[q] * c * detJ(q,e));
+      }
+   });
+}
+
+// Tensor inverse 1D kernel
+static void DGMassInverseTensor1D(const int NE,
+                                  const int VD,
+                                  const int D1D,
+                                  const Array<double> &binv,
+                                  const Vector &dinv,
+                                  const Vector &x_,
+                                  Vector &y_)
+{
+   auto Bi = Reshape(binv.Read(), D1D, D1D);
+   auto D = Reshape(dinv.Read(), D1D, NE);
+   auto X = Reshape(x_.Read(), D1D, VD, NE);
+   auto Y = Reshape(y_.Write(), D1D, VD, NE);
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MD1 = MAX_D1D;
+      for (int c = 0; c < VD; ++c)
+      {
+         double U[MD1];
+         for (int qx = 0; qx < D1D; ++qx)
+         {
+            double u = 0.0;
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               u += Bi(dx,qx) * X(dx,c,e);
+            }
+            U[qx] = D(qx,e) * u;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double u = 0.0;
+            for (int qx = 0; qx < D1D; ++qx)
+            {
+               u += Bi(dx,qx) * U[qx];
+            }
+            Y(dx,c,e) = u;
+         }
+      }
+   });
+}
+
+// Tensor inverse 2D kernel
+template<int T_D1D = 0>
+static void DGMassInverseTensor2D(const int NE,
+                                  const int VD,
+                                  const Array<double> &binv,
+                                  const Vector &dinv,
+                                  const Vector &x_,
+                                  Vector &y_,
+                                  const int d1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   auto Bi = Reshape(binv.Read(), D1D, D1D);
+   auto D = Reshape(dinv.Read(), D1D, D1D, NE);
+   auto X = Reshape(x_.Read(), D1D, D1D, VD, NE);
+   auto Y = Reshape(y_.Write(), D1D, D1D, VD, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      constexpr int MD1 = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < VD; ++c)
+      {
+         double T[MD1][MD1];
+         double U[MD1][MD1];
+         // U = D^{-1} B^{-T} X
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int qx = 0; qx < D1D; ++qx)
+            {
+               double u = 0.0;
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  u += Bi(dx,qx) * X(dx,dy,c,e);
+               }
+               T[dy][qx] = u;
+            }
+         }
+         for (int qy = 0; qy < D1D; ++qy)
+         {
+            for (int qx = 0; qx < D1D; ++qx)
+            {
+               double u = 0.0;
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  u += Bi(dy,qy) * T[dy][qx];
+               }
+               U[qy][qx] = D(qx,qy,e) * u;
+            }
+         }
+         // Y = B^{-1} U
+         for (int qy = 0; qy < D1D; ++qy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double u = 0.0;
+               for (int qx = 0; qx < D1D; ++qx)
+               {
+                  u += Bi(dx,qx) * U[qy][qx];
+               }
+               T[qy][dx] = u;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double u = 0.0;
+               for (int qy = 0; qy < D1D; ++qy)
+               {
+                  u += Bi(dy,qy) * T[qy][dx];
+               }
+               Y(dx,dy,c,e) = u;
+            }
+         }
+      }
+   });
+}
+
+// Tensor inverse 3D kernel
+template<int T_D1D = 0>
+static void DGMassInverseTensor3D(const int NE,
+                                  const int VD,
+                                  const Array<double> &binv,
+                                  const Vector &dinv,
+                                  const Vector &x_,
+                                  Vector &y_,
+                                  const int d1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   auto Bi = Reshape(binv.Read(), D1D, D1D);
+   auto D = Reshape(dinv.Read(), D1D, D1D, D1D, NE);
+   auto X = Reshape(x_.Read(), D1D, D1D, D1D, VD, NE);
+   auto Y = Reshape(y_.Write(), D1D, D1D, D1D, VD, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      constexpr int MD1 = T_D1D ? T_D1D : MAX_D1D;
+      for (int c = 0; c < VD; ++c)
+      {
+         double A[MD1][MD1][MD1];
+         double B[MD1][MD1][MD1];
+         // B = D^{-1} B^{-T} X, contracting one direction at a time
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int qx = 0; qx < D1D; ++qx)
+               {
+                  double u = 0.0;
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     u += Bi(dx,qx) * X(dx,dy,dz,c,e);
+                  }
+                  A[dz][dy][qx] = u;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int qy = 0; qy < D1D; ++qy)
+            {
+               for (int qx = 0; qx < D1D; ++qx)
+               {
+                  double u = 0.0;
+                  for (int dy = 0; dy < D1D; ++dy)
+                  {
+                     u += Bi(dy,qy) * A[dz][dy][qx];
+                  }
+                  B[dz][qy][qx] = u;
+               }
+            }
+         }
+         for (int qz = 0; qz < D1D; ++qz)
+         {
+            for (int qy = 0; qy < D1D; ++qy)
+            {
+               for (int qx = 0; qx < D1D; ++qx)
+               {
+                  double u = 0.0;
+                  for (int dz = 0; dz < D1D; ++dz)
+                  {
+                     u += Bi(dz,qz) * B[dz][qy][qx];
+                  }
+                  A[qz][qy][qx] = D(qx,qy,qz,e) * u;
+               }
+            }
+         }
+         // Y = B^{-1} A
+         for (int qz = 0; qz < D1D; ++qz)
+         {
+            for (int qy = 0; qy < D1D; ++qy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double u = 0.0;
+                  for (int qx = 0; qx < D1D; ++qx)
+                  {
+                     u += Bi(dx,qx) * A[qz][qy][qx];
+                  }
+                  B[qz][qy][dx] = u;
+               }
+            }
+         }
+         for (int qz = 0; qz < D1D; ++qz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double u = 0.0;
+                  for (int qy = 0; qy < D1D; ++qy)
+                  {
+                     u += Bi(dy,qy) * B[qz][qy][dx];
+                  }
+                  A[qz][dy][dx] = u;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  double u = 0.0;
+                  for (int qz = 0; qz < D1D; ++qz)
+                  {
+                     u += Bi(dz,qz) * A[qz][dy][dx];
+                  }
+                  Y(dx,dy,dz,c,e) = u;
+               }
+            }
+         }
+      }
+   });
+}
+
+void DGMassInverse::MultElements(const Vector &x, Vector &y) const
+{
+   if (mode == DENSE)
+   {
+      return BatchMult(Minv, x, y);
+   }
+   if (dim == 1)
+   {
+      return DGMassInverseTensor1D(ne, vdim, d1d, Binv, Dinv, x, y);
+   }
+   if (dim == 2)
+   {
+      switch (d1d)
+      {
+         case 2: return DGMassInverseTensor2D<2>(ne, vdim, Binv, Dinv, x, y);
+         case 3: return DGMassInverseTensor2D<3>(ne, vdim, Binv, Dinv, x, y);
+         case 4: return DGMassInverseTensor2D<4>(ne, vdim, Binv, Dinv, x, y);
+         case 5: return DGMassInverseTensor2D<5>(ne, vdim, Binv, Dinv, x, y);
+         default:
+            return DGMassInverseTensor2D(ne, vdim, Binv, Dinv, x, y, d1d);
+      }
+   }
+   if (dim == 3)
+   {
+      switch (d1d)
+      {
+         case 2: return DGMassInverseTensor3D<2>(ne, vdim, Binv, Dinv, x, y);
+         case 3: return DGMassInverseTensor3D<3>(ne, vdim, Binv, Dinv, x, y);
+         case 4: return DGMassInverseTensor3D<4>(ne, vdim, Binv, Dinv, x, y);
+         case 5: return DGMassInverseTensor3D<5>(ne, vdim, Binv, Dinv, x, y);
+         default:
+            return DGMassInverseTensor3D(ne, vdim, Binv, Dinv, x, y, d1d);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void DGMassInverse::Mult(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   if (elem_restrict)
+   {
+      elem_restrict->Mult(x, localX);
+      MultElements(localX, localY);
+      elem_restrict->MultTranspose(localY, y);
+   }
+   else
+   {
+      MultElements(x, y);
+   }
+}
+
+}
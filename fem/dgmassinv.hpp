@@ -0,0 +1,102 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_DGMASSINV
+#define MFEM_DGMASSINV
+
+#include "../config/config.hpp"
+#include "../linalg/densemat.hpp"
+#include "fespace.hpp"
+#include "coefficient.hpp"
+
+namespace mfem
+{
+
+/** @brief Operator applying the inverse of the (block-diagonal) mass matrix of
+    a discontinuous (L2) finite element space. */
+/** The inverse is applied element-by-element on the device using one of the
+    following methods, see DGMassInverse::Mode:
+
+    - DENSE: the element mass matrices are assembled and inverted during setup
+      and stored in a single DenseTensor. The application is a batched dense
+      matrix-vector product. This mode supports all element types and computes
+      the exact inverse of the mass matrix assembled with MassIntegrator.
+
+    - TENSOR: for tensor-product elements (segments, quadrilaterals and
+      hexahedra), the mass matrix is integrated with the Gauss-Legendre rule
+      with as many points per direction as the number of DOFs per direction.
+      In this case, the 1D basis-to-quadrature matrix B is square and the mass
+      matrix is M = B^T D B, where D is diagonal, so that its inverse, B^{-1}
+      D^{-1} B^{-T}, can be applied by sum factorization. Only the 1D matrix
+      B^{-1} and the diagonal D^{-1} are stored. On affine elements this is the
+      exact inverse of the mass matrix; for Gauss-Legendre nodal bases, it
+      corresponds to the collocated (diagonal) mass matrix.
+
+    The input and output vectors are L-vectors, i.e. their size is the size of
+    the finite element space. */
+class DGMassInverse : public Operator
+{
+public:
+   /// Method used to apply the inverse of the element mass matrices.
+   enum Mode
+   {
+      DENSE,  ///< Batched dense inverses of the element mass matrices
+      TENSOR  ///< Tensor-product inverse based on Gauss point collocation
+   };
+
+protected:
+   const FiniteElementSpace &fes;
+   Mode mode;
+   int dim, ne, vdim, nd, d1d;
+
+   /** Element restriction, used only when vdim > 1 or when the DOFs of the
+       space were reordered. */
+   const Operator *elem_restrict; // Not owned
+   mutable Vector localX, localY;
+
+   /// Inverses of the element mass matrices (DENSE mode), size nd x nd x ne.
+   DenseTensor Minv;
+
+   /// Inverse of the 1D basis-to-quadrature matrix (TENSOR mode).
+   Array<double> Binv;
+   /// Inverse of the quadrature weights times Q |J| (TENSOR mode).
+   Vector Dinv;
+
+   void SetupDense(Coefficient *Q);
+   void SetupTensor(Coefficient *Q);
+
+   /// Apply the inverse to E-vectors.
+   void MultElements(const Vector &x, Vector &y) const;
+
+public:
+   /** @brief Construct the inverse of the mass matrix of @a fes with an
+       optional coefficient @a Q, using the given @a mode. */
+   /** The space @a fes must be discontinuous and all its elements must have the
+       same number of DOFs. The TENSOR mode requires tensor-product elements. */
+   DGMassInverse(const FiniteElementSpace &fes, Coefficient *Q = NULL,
+                 Mode mode = DENSE);
+
+   /// Return the method used to apply the inverse.
+   Mode GetMode() const { return mode; }
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   /// Compute y = M^{-1} x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The mass matrix is symmetric, so this is the same as Mult().
+   virtual void MultTranspose(const Vector &x, Vector &y) const { Mult(x, y); }
+};
+
+}
+
+#endif
@@ -27,6 +27,7 @@
 #include "linearform.hpp"
 #include "nonlinearform.hpp"
 #include "bilinearform.hpp"
+#include "dgmassinv.hpp"
 #include "hybridization.hpp"
 #include "datacollection.hpp"
 #include "estimators.hpp"
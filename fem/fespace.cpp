@@ -260,6 +260,51 @@ void FiniteElementSpace::ReorderElementToDofTable()
    }
 }
 
+void FiniteElementSpace::RenumberDofs(Array<int> &dofs) const
+{
+   if (dof_perm.Size() == 0) { return; }
+   for (int i = 0; i < dofs.Size(); i++)
+   {
+      const int sdof = dofs[i]; // signed dof
+      const int new_dof = dof_perm[(sdof < 0) ? -1-sdof : sdof];
+      dofs[i] = (sdof < 0) ? -1-new_dof : new_dof; // preserve the sign of sdof
+   }
+}
+
+void FiniteElementSpace::ReorderDofs(const Array<int> &p)
+{
+   MFEM_VERIFY(!NURBSext, "NURBS spaces are not supported");
+   MFEM_VERIFY(Conforming(), "non-conforming spaces are not supported");
+#ifdef MFEM_USE_MPI
+   MFEM_VERIFY(dynamic_cast<const ParFiniteElementSpace*>(this) == NULL,
+               "This method should not be used with a ParFiniteElementSpace!");
+#endif
+   MFEM_VERIFY(p.Size() == ndofs, "invalid permutation size: " << p.Size());
+
+   // Compose the permutation with the current numbering
+   Array<int> p_inv;
+   InvertPermutation(p, p_inv);
+   if (dof_perm.Size() == 0)
+   {
+      Swap(dof_perm, p_inv);
+   }
+   else
+   {
+      for (int k = 0; k < ndofs; k++) { dof_perm[k] = p_inv[dof_perm[k]]; }
+   }
+
+   // The DOF tables are rebuilt from the mesh with the new numbering
+   RebuildElementToDofTable();
+   delete bdrElem_dof;
+   bdrElem_dof = NULL;
+
+   dof_elem_array.DeleteAll();
+   dof_ldof_array.DeleteAll();
+   L2E_nat.Clear();
+   L2E_lex.Clear();
+   L2BE_lex.Clear();
+}
+
 void FiniteElementSpace::BuildDofToArrays()
 {
    if (dof_elem_array.Size()) { return; }
@@ -817,6 +862,20 @@ const SparseMatrix* FiniteElementSpace::GetConformingProlongation() const
    return cP;
 }
 
+const Operator *FiniteElementSpace::GetProlongationMatrix() const
+{
+   const SparseMatrix *P = GetConformingProlongation();
+   if (P == NULL || !Device::Allows(Backend::DEVICE_MASK)) { return P; }
+   if (dcP.Ptr() == NULL)
+   {
+      // The true DOFs are the columns of the conforming restriction
+      const SparseMatrix *R = GetConformingRestriction();
+      const Array<int> tdof_ldof(const_cast<int*>(R->GetJ()), R->Height());
+      dcP.Reset(new DeviceNCProlongationOperator(*P, tdof_ldof));
+   }
+   return dcP.Ptr();
+}
+
 const SparseMatrix* FiniteElementSpace::GetConformingRestriction() const
 {
    if (Conforming()) { return NULL; }
@@ -839,7 +898,18 @@ const Operator *FiniteElementSpace::GetElementRestriction(
    {
       if (L2E_nat.Ptr() == NULL)
       {
-         L2E_nat.Reset(new L2ElementRestriction(*this));
+         // After ReorderDofs() the DOFs of an element are not contiguous in
+         // the L-vector, so use the element DOFs. The native ordering of L2
+         // elements is lexicographic.
+         if (DofsReordered())
+         {
+            L2E_nat.Reset(new ElementRestriction(*this,
+                                                 ElementDofOrdering::NATIVE));
+         }
+         else
+         {
+            L2E_nat.Reset(new L2ElementRestriction(*this));
+         }
       }
       return L2E_nat.Ptr();
    }
@@ -859,6 +929,18 @@ const Operator *FiniteElementSpace::GetElementRestriction(
    return L2E_nat.Ptr();
 }
 
+const ElementRestriction *FiniteElementSpace::GetBdrElementRestriction(
+   ElementDofOrdering e_ordering) const
+{
+   MFEM_VERIFY(e_ordering == ElementDofOrdering::LEXICOGRAPHIC,
+               "only lexicographic ordering is supported");
+   if (L2BE_lex.Ptr() == NULL)
+   {
+      L2BE_lex.Reset(new BdrElementRestriction(*this, e_ordering));
+   }
+   return L2BE_lex.As<ElementRestriction>();
+}
+
 const QuadratureInterpolator *FiniteElementSpace::GetQuadratureInterpolator(
    const IntegrationRule &ir) const
 {
@@ -1576,6 +1658,7 @@ void FiniteElementSpace::GetElementDofs(int i, Array<int> &dofs) const
             dofs[ne+j] = k + j;
          }
       }
+      RenumberDofs(dofs);
    }
 }
 
@@ -1676,6 +1759,7 @@ void FiniteElementSpace::GetBdrElementDofs(int i, Array<int> &dofs) const
             }
          }
       }
+      RenumberDofs(dofs);
    }
 }
 
@@ -1736,6 +1820,7 @@ void FiniteElementSpace::GetFaceDofs(int i, Array<int> &dofs) const
          dofs[ne+k] = j;
       }
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
@@ -1765,6 +1850,7 @@ void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
    {
       dofs[nv+j] = k;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
@@ -1777,6 +1863,7 @@ void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
    {
       dofs[j] = i*nv+j;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
@@ -1790,6 +1877,7 @@ void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k + j;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
@@ -1802,6 +1890,7 @@ void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k;
    }
+   RenumberDofs(dofs);
 }
 
 void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
@@ -1817,6 +1906,7 @@ void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
          dofs[j] = k;
       }
    }
+   RenumberDofs(dofs);
 }
 
 const FiniteElement *FiniteElementSpace::GetBE (int i) const
@@ -1888,9 +1978,11 @@ void FiniteElementSpace::Destroy()
 {
    delete cR;
    delete cP;
+   dcP.Clear();
    Th.Clear();
    L2E_nat.Clear();
    L2E_lex.Clear();
+   L2BE_lex.Clear();
    for (int i = 0; i < E2Q_array.Size(); i++)
    {
       delete E2Q_array[i];
@@ -1899,6 +1991,7 @@ void FiniteElementSpace::Destroy()
 
    dof_elem_array.DeleteAll();
    dof_ldof_array.DeleteAll();
+   dof_perm.DeleteAll();
 
    if (NURBSext)
    {
@@ -2756,19 +2849,10 @@ void L2ElementRestriction::MultTranspose(const Vector &x, Vector &y) const
 
 ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
                                        ElementDofOrdering e_ordering)
-   : fes(f),
-     ne(fes.GetNE()),
-     vdim(fes.GetVDim()),
-     byvdim(fes.GetOrdering() == Ordering::byVDIM),
-     ndofs(fes.GetNDofs()),
-     dof(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
-     nedofs(ne*dof),
-     offsets(ndofs+1),
-     indices(ne*dof)
+   : ElementRestriction(f, f.GetNE(),
+                        f.GetNE() > 0 ? f.GetFE(0)->GetDof() : 0)
 {
    // Assuming all finite elements are the same.
-   height = vdim*ne*dof;
-   width = fes.GetVSize();
    const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
    const int *dof_map = NULL;
    if (dof_reorder && ne > 0)
@@ -2789,7 +2873,29 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
       dof_map = fe_dof_map.GetData();
    }
    const Table& e2dTable = fes.GetElementToDofTable();
-   const int* elementMap = e2dTable.GetJ();
+   SetupIndices(e2dTable.GetJ(), dof_map);
+}
+
+ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
+                                       const int _ne, const int _dof)
+   : fes(f),
+     ne(_ne),
+     vdim(fes.GetVDim()),
+     byvdim(fes.GetOrdering() == Ordering::byVDIM),
+     ndofs(fes.GetNDofs()),
+     dof(_dof),
+     nedofs(_ne*_dof),
+     offsets(ndofs+1),
+     indices(_ne*_dof)
+{
+   height = vdim*ne*dof;
+   width = fes.GetVSize();
+}
+
+void ElementRestriction::SetupIndices(const int *elementMap,
+                                      const int *dof_map)
+{
+   const bool dof_reorder = (dof_map != NULL);
    // We will be keeping a count of how many local nodes point to its global dof
    for (int i = 0; i <= ndofs; ++i)
    {
@@ -2881,6 +2987,247 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
    });
 }
 
+void ElementRestriction::AddMultTranspose(const Vector& x, Vector& y) const
+{
+   // Assumes all elements have the same number of dofs
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_y = Reshape(y.ReadWrite(), t?vd:ndofs, t?ndofs:vd);
+   MFEM_FORALL(i, ndofs,
+   {
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i + 1];
+      for (int c = 0; c < vd; ++c)
+      {
+         double dofValue = 0;
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const int idx_j = d_indices[j];
+            dofValue +=  d_x(idx_j % nd, c, idx_j / nd);
+         }
+         d_y(t?c:i,t?i:c) += dofValue;
+      }
+   });
+}
+
+BdrElementRestriction::BdrElementRestriction(const FiniteElementSpace &f,
+                                             ElementDofOrdering e_ordering)
+   : ElementRestriction(f, f.GetNBE(),
+                        f.GetNBE() > 0 ? f.GetBE(0)->GetDof() : 0)
+{
+   const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
+   const int *dof_map = NULL;
+   if (ne == 0) { return; }
+   MFEM_VERIFY(dof > 0, "the FE space has no boundary element DOFs");
+   for (int be = 0; be < ne; ++be)
+   {
+      MFEM_VERIFY(fes.GetBE(be)->GetGeomType() == fes.GetBE(0)->GetGeomType(),
+                  "all boundary elements must be of the same type");
+   }
+   if (dof_reorder)
+   {
+      const TensorBasisElement* el =
+         dynamic_cast<const TensorBasisElement*>(fes.GetBE(0));
+      MFEM_VERIFY(el, "Finite element not suitable for lexicographic ordering");
+      const Array<int> &fe_dof_map = el->GetDofMap();
+      MFEM_VERIFY(fe_dof_map.Size() > 0, "invalid dof map");
+      dof_map = fe_dof_map.GetData();
+   }
+   Array<int> elementMap(ne*dof), dofs;
+   for (int be = 0; be < ne; ++be)
+   {
+      fes.GetBdrElementDofs(be, dofs);
+      MFEM_ASSERT(dofs.Size() == dof, "invalid number of boundary dofs");
+      for (int d = 0; d < dof; ++d)
+      {
+         elementMap[dof*be + d] = dofs[d];
+      }
+   }
+   SetupIndices(elementMap.GetData(), dof_map);
+}
+
+SubsetElementRestriction::SubsetElementRestriction(
+   const FiniteElementSpace &f, ElementDofOrdering e_ordering,
+   const Array<int> &elements)
+   : ElementRestriction(f, elements.Size(), elements.Size() > 0 ?
+                        f.GetFE(elements[0])->GetDof() : 0)
+{
+   const bool dof_reorder = (e_ordering == ElementDofOrdering::LEXICOGRAPHIC);
+   const int *dof_map = NULL;
+   if (ne == 0) { return; }
+   const FiniteElement *fe = fes.GetFE(elements[0]);
+   for (int i = 0; i < ne; ++i)
+   {
+      MFEM_VERIFY(fes.GetFE(elements[i])->GetGeomType() == fe->GetGeomType(),
+                  "all elements must be of the same type");
+   }
+   if (dof_reorder)
+   {
+      const TensorBasisElement* el =
+         dynamic_cast<const TensorBasisElement*>(fe);
+      MFEM_VERIFY(el, "Finite element not suitable for lexicographic ordering");
+      const Array<int> &fe_dof_map = el->GetDofMap();
+      MFEM_VERIFY(fe_dof_map.Size() > 0, "invalid dof map");
+      dof_map = fe_dof_map.GetData();
+   }
+   Array<int> elementMap(ne*dof), dofs;
+   for (int i = 0; i < ne; ++i)
+   {
+      fes.GetElementDofs(elements[i], dofs);
+      MFEM_ASSERT(dofs.Size() == dof, "invalid number of element dofs");
+      for (int d = 0; d < dof; ++d)
+      {
+         elementMap[dof*i + d] = dofs[d];
+      }
+   }
+   SetupIndices(elementMap.GetData(), dof_map);
+}
+
+
+DeviceNCProlongationOperator::DeviceNCProlongationOperator(
+   const SparseMatrix &P, const Array<int> &tdof_ldof_, int n_loc_)
+   : Operator(P.Height(), n_loc_ < 0 ? P.Width() : n_loc_),
+     n_loc(width)
+{
+   MFEM_VERIFY(P.Finalized(), "the prolongation matrix must be finalized");
+   MFEM_VERIFY(tdof_ldof_.Size() <= n_loc, "invalid number of true DOFs");
+   const int ncols = P.Width();
+   const int *I = P.GetI(), *J = P.GetJ();
+   const double *A = P.GetData();
+
+   tdof_ldof.SetSize(n_loc);
+   tdof_ldof = -1;
+   Array<bool> is_tdof(height);
+   is_tdof = false;
+   for (int i = 0; i < tdof_ldof_.Size(); i++)
+   {
+      tdof_ldof[i] = tdof_ldof_[i];
+      is_tdof[tdof_ldof_[i]] = true;
+   }
+
+   // Collect the slave rows and count the slave entries in each column
+   int num_slaves = 0, nnz = 0;
+   for (int i = 0; i < height; i++)
+   {
+      if (is_tdof[i]) { continue; }
+      num_slaves++;
+      nnz += I[i+1] - I[i];
+   }
+   slave_ldof.SetSize(num_slaves);
+   slave_I.SetSize(num_slaves+1);
+   slave_J.SetSize(nnz);
+   slave_A.SetSize(nnz);
+   master_I.SetSize(ncols+1);
+   master_I = 0;
+   slave_I[0] = 0;
+   for (int i = 0, s = 0, k = 0; i < height; i++)
+   {
+      if (is_tdof[i]) { continue; }
+      slave_ldof[s] = i;
+      for (int j = I[i]; j < I[i+1]; j++, k++)
+      {
+         slave_J[k] = J[j];
+         slave_A(k) = A[j];
+         master_I[J[j]+1]++;
+      }
+      slave_I[++s] = k;
+   }
+
+   // Transpose of the slave constraints
+   for (int c = 0; c < ncols; c++) { master_I[c+1] += master_I[c]; }
+   master_J.SetSize(nnz);
+   master_A.SetSize(nnz);
+   for (int s = 0; s < num_slaves; s++)
+   {
+      for (int k = slave_I[s]; k < slave_I[s+1]; k++)
+      {
+         const int pos = master_I[slave_J[k]]++;
+         master_J[pos] = s;
+         master_A(pos) = slave_A(k);
+      }
+   }
+   for (int c = ncols; c > 0; c--) { master_I[c] = master_I[c-1]; }
+   master_I[0] = 0;
+}
+
+void DeviceNCProlongationOperator::MultExternal(const Vector &x,
+                                                const Vector &x_ext,
+                                                Vector &y) const
+{
+   const int NL = n_loc;
+   const int NS = slave_ldof.Size();
+   auto d_tdof_ldof = tdof_ldof.Read();
+   auto d_slave_ldof = slave_ldof.Read();
+   auto d_I = slave_I.Read();
+   auto d_J = slave_J.Read();
+   auto d_A = slave_A.Read();
+   auto d_x = x.Read();
+   auto d_x_ext = (NS > 0 && x_ext.Size() > 0) ? x_ext.Read() : d_x;
+   auto d_y = y.Write();
+   // Copy the true DOFs
+   MFEM_FORALL(i, NL,
+   {
+      const int ldof = d_tdof_ldof[i];
+      if (ldof >= 0) { d_y[ldof] = d_x[i]; }
+   });
+   // Interpolate the slave DOFs from their masters
+   MFEM_FORALL(s, NS,
+   {
+      double d = 0.0;
+      const int end = d_I[s+1];
+      for (int k = d_I[s]; k < end; k++)
+      {
+         const int j = d_J[k];
+         d += d_A[k] * ((j < NL) ? d_x[j] : d_x_ext[j-NL]);
+      }
+      d_y[d_slave_ldof[s]] = d;
+   });
+}
+
+void DeviceNCProlongationOperator::MultTransposeExternal(const Vector &x,
+                                                         Vector &y,
+                                                         Vector &y_ext) const
+{
+   const int NL = n_loc;
+   const int NE = master_I.Size() - 1 - n_loc;
+   auto d_tdof_ldof = tdof_ldof.Read();
+   auto d_slave_ldof = slave_ldof.Read();
+   auto d_I = master_I.Read();
+   auto d_J = master_J.Read();
+   auto d_A = master_A.Read();
+   auto d_x = x.Read();
+   auto d_y = y.Write();
+   // Each column receives its own local DOF and the contributions of its
+   // slaves
+   MFEM_FORALL(i, NL,
+   {
+      const int ldof = d_tdof_ldof[i];
+      double d = (ldof >= 0) ? d_x[ldof] : 0.0;
+      const int end = d_I[i+1];
+      for (int k = d_I[i]; k < end; k++)
+      {
+         d += d_A[k] * d_x[d_slave_ldof[d_J[k]]];
+      }
+      d_y[i] = d;
+   });
+   if (NE == 0) { return; }
+   MFEM_VERIFY(y_ext.Size() == NE, "invalid size of the external vector");
+   auto d_y_ext = y_ext.Write();
+   MFEM_FORALL(i, NE,
+   {
+      double d = 0.0;
+      const int end = d_I[NL+i+1];
+      for (int k = d_I[NL+i]; k < end; k++)
+      {
+         d += d_A[k] * d_x[d_slave_ldof[d_J[k]]];
+      }
+      d_y_ext[i] = d;
+   });
+}
 
 QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
                                                const IntegrationRule &ir)
@@ -3095,13 +3442,28 @@ void QuadratureInterpolator::Mult(
    const Vector &e_vec, unsigned eval_flags,
    Vector &q_val, Vector &q_der, Vector &q_det) const
 {
-   const int ne = fespace->GetNE();
+   Eval(fespace->GetNE(), 0, e_vec, eval_flags, q_val, q_der, q_det);
+}
+
+void QuadratureInterpolator::Mult(
+   const Vector &e_vec, const Array<int> &elements, unsigned eval_flags,
+   Vector &q_val, Vector &q_der, Vector &q_det) const
+{
+   const int ne = elements.Size();
+   if (ne == 0) { return; }
+   Eval(ne, elements[0], e_vec, eval_flags, q_val, q_der, q_det);
+}
+
+void QuadratureInterpolator::Eval(
+   const int ne, const int e0, const Vector &e_vec, unsigned eval_flags,
+   Vector &q_val, Vector &q_der, Vector &q_det) const
+{
    if (ne == 0) { return; }
    const int vdim = fespace->GetVDim();
    const int dim = fespace->GetMesh()->Dimension();
-   const FiniteElement *fe = fespace->GetFE(0);
+   const FiniteElement *fe = fespace->GetFE(e0);
    const IntegrationRule *ir =
-      IntRule ? IntRule : &qspace->GetElementIntRule(0);
+      IntRule ? IntRule : &qspace->GetElementIntRule(e0);
    const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::FULL);
    const int nd = maps.ndof;
    const int nq = maps.nqpt;
@@ -76,6 +76,7 @@ enum class ElementDofOrdering
 // Forward declarations
 class NURBSExtension;
 class BilinearFormIntegrator;
+class ElementRestriction;
 class QuadratureSpace;
 class QuadratureInterpolator;
 
@@ -108,10 +109,14 @@ protected:
    int *fdofs, *bdofs;
 
    mutable Table *elem_dof; // if NURBS FE space, not owned; otherwise, owned.
-   Table *bdrElem_dof; // used only with NURBS FE spaces; not owned.
+   // used with NURBS FE spaces (not owned) and after ReorderDofs() (owned)
+   Table *bdrElem_dof;
 
    Array<int> dof_elem_array, dof_ldof_array;
 
+   /// New number of each DOF after ReorderDofs(); empty if not reordered.
+   Array<int> dof_perm;
+
    NURBSExtension *NURBSext;
    int own_ext;
 
@@ -122,12 +127,16 @@ protected:
    /// Conforming restriction matrix such that cR.cP=I.
    mutable SparseMatrix *cR; // owned
    mutable bool cP_is_set;
+   /// Device version of cP, see GetProlongationMatrix().
+   mutable OperatorHandle dcP;
 
    /// Transformation to apply to GridFunctions after space Update().
    OperatorHandle Th;
 
    /// The element restriction operators, see GetElementRestriction().
    mutable OperatorHandle L2E_nat, L2E_lex;
+   /// The boundary element restriction operator, see GetBdrElementRestriction().
+   mutable OperatorHandle L2BE_lex;
 
    mutable Array<QuadratureInterpolator*> E2Q_array;
 
@@ -140,6 +149,9 @@ protected:
 
    void BuildElementToDofTable() const;
 
+   /// Renumber the DOFs computed from the mesh entities, see ReorderDofs().
+   void RenumberDofs(Array<int> &dofs) const;
+
    /// Helper to remove encoded sign from a DOF
    static inline int DecodeDof(int dof, double& sign)
    { return (dof >= 0) ? (sign = 1, dof) : (sign = -1, (-1 - dof)); }
@@ -290,8 +302,10 @@ public:
    const SparseMatrix *GetConformingRestriction() const;
 
    /// The returned Operator is owned by the FiniteElementSpace.
-   virtual const Operator *GetProlongationMatrix() const
-   { return GetConformingProlongation(); }
+   /** On non-conforming meshes, when a device backend is enabled, this is a
+       DeviceNCProlongationOperator, otherwise it is the SparseMatrix returned
+       by GetConformingProlongation(). */
+   virtual const Operator *GetProlongationMatrix() const;
 
    /// The returned SparseMatrix is owned by the FiniteElementSpace.
    virtual const SparseMatrix *GetRestrictionMatrix() const
@@ -316,6 +330,21 @@ public:
        The returned Operator is owned by the FiniteElementSpace. */
    const Operator *GetElementRestriction(ElementDofOrdering e_ordering) const;
 
+   /// Return an Operator that converts L-vectors to boundary E-vectors.
+   /** The boundary E-vector represents the element-wise discontinuous version
+       of the FE space restricted to the boundary elements of the mesh. Its
+       layout is: ND x VDIM x NBE, where ND is the number of degrees of freedom
+       of a boundary element and NBE is the number of boundary elements.
+
+       This restriction is used, e.g., by the partial assembly of boundary
+       integrators. Only spaces with DOFs associated with the boundary elements
+       (e.g. H1 spaces) are supported and all boundary elements are assumed to
+       be of the same type.
+
+       The returned Operator is owned by the FiniteElementSpace. */
+   const ElementRestriction *GetBdrElementRestriction(
+      ElementDofOrdering e_ordering) const;
+
    /** @brief Return a QuadratureInterpolator that interpolates E-vectors to
        quadrature point values and/or derivatives (Q-vectors). */
    /** An E-vector represents the element-wise discontinuous version of the FE
@@ -482,6 +511,23 @@ public:
        is preserved. */
    void ReorderElementToDofTable();
 
+   /** @brief Reorder the scalar DOFs with the permutation @a p: the new DOF i
+       is the old DOF p[i].
+
+       The permutation can be computed with one of the orderings in
+       linalg/reordering.hpp, e.g. from the matrix of a BilinearForm on the
+       scalar space. All DOFs returned by the space are renumbered, including
+       the element, vertex, edge and face DOFs, also after
+       RebuildElementToDofTable(); if there are any signed DOFs their sign is
+       preserved. The DOFs of a space rebuilt by Update() are not renumbered.
+       Only serial, conforming, non-NURBS spaces are supported. In L2 spaces,
+       the element restriction follows the element DOFs after the reordering,
+       so that the DOFs of an element need not be contiguous. */
+   void ReorderDofs(const Array<int> &p);
+
+   /// Return true if the DOFs were renumbered by ReorderDofs().
+   bool DofsReordered() const { return dof_perm.Size() > 0; }
+
    void BuildDofToArrays();
 
    const Table &GetElementToDofTable() const { return *elem_dof; }
@@ -896,10 +942,41 @@ protected:
    Array<int> offsets;
    Array<int> indices;
 
+   /// Constructor used by derived classes, see SetupIndices().
+   ElementRestriction(const FiniteElementSpace&, const int _ne, const int _dof);
+
+   /** @brief Fill the #offsets and #indices arrays given the (scalar) DOFs of
+       all elements, @a elementMap, of size #ne x #dof, and an optional local
+       reordering @a dof_map. */
+   void SetupIndices(const int *elementMap, const int *dof_map);
+
 public:
    ElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
+   /// Add the transpose action to @a y, i.e. y += R^T x.
+   void AddMultTranspose(const Vector &x, Vector &y) const;
+};
+
+/// Operator that converts FiniteElementSpace L-vectors to boundary E-vectors.
+/** Objects of this type are typically created and owned by FiniteElementSpace
+    objects, see FiniteElementSpace::GetBdrElementRestriction(). */
+class BdrElementRestriction : public ElementRestriction
+{
+public:
+   BdrElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
+};
+
+/** @brief Operator that converts FiniteElementSpace L-vectors to the E-vectors
+    of a subset of the mesh elements. */
+/** All elements in the subset must have the same geometry and number of DOFs.
+    This is used for partial assembly on meshes with mixed element geometries,
+    where the elements are partitioned by geometry. */
+class SubsetElementRestriction : public ElementRestriction
+{
+public:
+   SubsetElementRestriction(const FiniteElementSpace&, ElementDofOrdering,
+                            const Array<int> &elements);
 };
 
 /// Operator that converts L2 FiniteElementSpace L-vectors to E-vectors.
@@ -919,6 +996,61 @@ public:
    void MultTranspose(const Vector &x, Vector &y) const;
 };
 
+/** @brief Device version of the conforming prolongation matrix of a
+    FiniteElementSpace on a non-conforming mesh. */
+/** The prolongation P, mapping true DOFs to (partially conforming) local DOFs,
+    is stored in a compact form: each true DOF is copied to its local DOF and
+    each slave (constrained) local DOF is a weighted combination of true DOFs,
+    given by a list of master indices and weights. Both Mult() and
+    MultTranspose() are computed on the device without atomic operations; for
+    the latter, the transpose of the slave constraints is stored as well.
+
+    The columns of P with index >= @a n_loc are treated as "external" and are
+    read from, resp. written to, a separate vector in MultExternal() and
+    MultTransposeExternal(). This is used by the parallel version,
+    ParDeviceNCProlongationOperator. Objects of this type are typically created
+    and owned by FiniteElementSpace objects, see GetProlongationMatrix(). */
+class DeviceNCProlongationOperator : public Operator
+{
+protected:
+   int n_loc; ///< Number of local (non-external) columns
+   Array<int> tdof_ldof; ///< Local DOF of each true DOF, or -1
+   Array<int> slave_ldof; ///< Local DOF of each slave row
+   /// Master DOFs and weights of the slave rows, in CSR format.
+   Array<int> slave_I, slave_J;
+   Vector slave_A;
+   /// Slave rows and weights for each column, in CSR format.
+   Array<int> master_I, master_J;
+   Vector master_A;
+
+public:
+   /** @brief Construct the operator from the prolongation matrix @a P and the
+       local DOF of each true DOF, @a tdof_ldof. */
+   /** The size of @a tdof_ldof can be smaller than the width of @a P; all rows
+       not listed in @a tdof_ldof are treated as slave rows. The first @a n_loc
+       columns of @a P are local; if @a n_loc < 0, all columns are local. */
+   DeviceNCProlongationOperator(const SparseMatrix &P,
+                                const Array<int> &tdof_ldof,
+                                int n_loc = -1);
+
+   /** @brief Compute y = P [x; x_ext], where @a x has size n_loc and @a x_ext
+       contains the values of the external columns. */
+   void MultExternal(const Vector &x, const Vector &x_ext, Vector &y) const;
+
+   /** @brief Compute [y; y_ext] = P^T x, where @a y has size n_loc and @a y_ext
+       receives the values of the external columns. */
+   void MultTransposeExternal(const Vector &x, Vector &y, Vector &y_ext) const;
+
+   /// Return the number of local (non-external) columns.
+   int NumLocalCols() const { return n_loc; }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   { MultExternal(x, x, y); }
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { MultTransposeExternal(x, y, y); }
+};
+
 /** @brief A class that performs interpolation from an E-vector to quadrature
     point values and/or derivatives (Q-vectors). */
 /** An E-vector represents the element-wise discontinuous version of the FE
@@ -947,6 +1079,11 @@ protected:
    static const int MAX_ND3D = 1000;
    static const int MAX_VDIM3D = 3;
 
+   /// Interpolate the E-vector of @a ne elements of the same type as @a e0.
+   void Eval(const int ne, const int e0, const Vector &e_vec,
+             unsigned eval_flags,
+             Vector &q_val, Vector &q_der, Vector &q_det) const;
+
 public:
    enum EvalFlags
    {
@@ -983,6 +1120,13 @@ public:
    void Mult(const Vector &e_vec, unsigned eval_flags,
              Vector &q_val, Vector &q_der, Vector &q_det) const;
 
+   /// Interpolate the E-vector @a e_vec of a subset of the mesh elements.
+   /** Same as Mult(), where @a e_vec is the E-vector of the given @a elements,
+       which must all be of the same type, see SubsetElementRestriction. */
+   void Mult(const Vector &e_vec, const Array<int> &elements,
+             unsigned eval_flags,
+             Vector &q_val, Vector &q_der, Vector &q_det) const;
+
    /// Perform the transpose operation of Mult(). (TODO)
    void MultTranspose(unsigned eval_flags, const Vector &q_val,
                       const Vector &q_der, Vector &e_vec) const;
@@ -19,6 +19,36 @@
 namespace mfem
 {
 
+ParPAOverlapOperator::ParPAOverlapOperator(
+   const ConformingProlongationOperator &P_,
+   const PABilinearFormExtension &ext_)
+   : Operator(P_.Width()), P(P_), ext(ext_)
+{
+   MFEM_VERIFY(ext.Partitioned(), "the elements of the extension must be "
+               "partitioned");
+   Px.SetSize(P.Height(), Device::GetMemoryType());
+   APx.SetSize(P.Height(), Device::GetMemoryType());
+   Px.UseDevice(true);
+   APx.UseDevice(true);
+}
+
+void ParPAOverlapOperator::Mult(const Vector &x, Vector &y) const
+{
+   P.BcastBegin(x, Px);
+   // The interior elements only use the local DOFs which are not shared
+   ext.MultInterior(Px, APx);
+   P.BcastEnd(Px);
+   ext.AddMultShared(Px, APx);
+   P.MultTranspose(APx, y);
+}
+
+void ParPAOverlapOperator::MultTranspose(const Vector &x, Vector &y) const
+{
+   P.Mult(x, Px);
+   ext.MultTranspose(Px, APx);
+   P.MultTranspose(APx, y);
+}
+
 void ParBilinearForm::pAllocMat()
 {
    int nbr_size = pfes->GetFaceNbrVSize();
@@ -123,11 +153,28 @@ void ParBilinearForm::pAllocMat()
 
 void ParBilinearForm::ParallelAssemble(OperatorHandle &A, SparseMatrix *A_local)
 {
-   A.Clear();
-
-   if (A_local == NULL) { return; }
+   if (A_local == NULL) { A.Clear(); return; }
    MFEM_VERIFY(A_local->Finalized(), "the local matrix must be finalized");
 
+   if (keep_rap_plan && A_local == mat && fbfi.Size() == 0 &&
+       A.Type() == Operator::Hypre_ParCSR)
+   {
+      if (rap_plan == NULL)
+      {
+         rap_plan = new HypreRAPPlan(*A_local, *pfes->Dof_TrueDof_Matrix());
+      }
+      // Overwrite the values of the previous product, if A still owns it
+      if (A.Ptr() == NULL || A.Ptr() != rap_mat || !A.OwnsOperator())
+      {
+         A.Reset(rap_plan->CreateMatrix());
+         rap_mat = A.As<HypreParMatrix>();
+      }
+      rap_plan->Mult(*A_local, *A.As<HypreParMatrix>());
+      return;
+   }
+
+   A.Clear();
+
    OperatorHandle dA(A.Type()), Ph(A.Type()), hdA;
 
    if (fbfi.Size() == 0)
@@ -230,8 +277,29 @@ void ParBilinearForm::AssembleSharedFaces(int skip_zeros)
    }
 }
 
+PABilinearFormExtension *ParBilinearForm::OverlapExtension() const
+{
+   // There is nothing to overlap on a single processor
+   if (!overlap_comm || pfes->GetNRanks() == 1) { return NULL; }
+   PABilinearFormExtension *pa_ext =
+      dynamic_cast<PABilinearFormExtension*>(ext);
+   if (!pa_ext) { return NULL; }
+   // The overlap uses the split action of the conforming prolongation
+   if (!dynamic_cast<const ConformingProlongationOperator*>(
+          pfes->GetProlongationMatrix())) { return NULL; }
+   return pa_ext;
+}
+
 void ParBilinearForm::Assemble(int skip_zeros)
 {
+   PABilinearFormExtension *pa_ext = OverlapExtension();
+   if (pa_ext && !pa_ext->Partitioned())
+   {
+      Array<int> interior, shared;
+      pfes->GetInteriorElements(interior, shared);
+      pa_ext->SetElementPartition(interior, shared);
+   }
+
    if (mat == NULL && fbfi.Size() > 0)
    {
       pfes->ExchangeFaceNbrData();
@@ -293,6 +361,14 @@ void ParBilinearForm::FormLinearSystem(
 {
    if (ext)
    {
+      if (OverlapExtension())
+      {
+         FormSystemMatrix(ess_tdof_list, A);
+         InitTVectors(GetProlongation(), GetRestriction(), x, b, X, B);
+         if (!copy_interior) { X.SetSubVectorComplement(ess_tdof_list, 0.0); }
+         A.As<ConstrainedOperator>()->EliminateRHS(X, B);
+         return;
+      }
       ext->FormLinearSystem(ess_tdof_list, x, b, A, X, B, copy_interior);
       return;
    }
@@ -342,6 +418,15 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
 {
    if (ext)
    {
+      if (PABilinearFormExtension *pa_ext = OverlapExtension())
+      {
+         const ConformingProlongationOperator *P =
+            static_cast<const ConformingProlongationOperator*>(
+               pfes->GetProlongationMatrix());
+         Operator *PtAP = new ParPAOverlapOperator(*P, *pa_ext);
+         A.Reset(new ConstrainedOperator(PtAP, ess_tdof_list, true));
+         return;
+      }
       ext->FormSystemMatrix(ess_tdof_list, A);
       return;
    }
@@ -364,7 +449,8 @@ void ParBilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
       {
          const int remove_zeros = 0;
          Finalize(remove_zeros);
-         MFEM_VERIFY(p_mat.Ptr() == NULL && p_mat_e.Ptr() == NULL,
+         MFEM_VERIFY((p_mat.Ptr() == NULL && p_mat_e.Ptr() == NULL) ||
+                     (rap_mat != NULL && p_mat.Ptr() == rap_mat),
                      "The ParBilinearForm must be updated with Update() before "
                      "re-assembling the ParBilinearForm.");
          ParallelAssemble(p_mat, mat);
@@ -432,6 +518,10 @@ void ParBilinearForm::Update(FiniteElementSpace *nfes)
 
    p_mat.Clear();
    p_mat_e.Clear();
+
+   delete rap_plan;
+   rap_plan = NULL;
+   rap_mat = NULL;
 }
 
 
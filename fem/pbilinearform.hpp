@@ -24,6 +24,32 @@
 namespace mfem
 {
 
+/** @brief The true DOF operator P^t A P of a partially assembled
+    ParBilinearForm, which overlaps the exchange of shared DOFs with
+    computation. */
+/** In Mult(), the exchange of the shared DOFs in the prolongation P is started,
+    the action of A on the interior elements is computed while the messages are
+    in flight, and the action on the remaining elements is added once they have
+    arrived, see ParBilinearForm::OverlapCommunication(). */
+class ParPAOverlapOperator : public Operator
+{
+protected:
+   const ConformingProlongationOperator &P;
+   const PABilinearFormExtension &ext;
+   mutable Vector Px, APx;
+
+public:
+   /** @brief Construct the operator from the prolongation @a P_ and the
+       extension @a ext_ whose elements have been partitioned, see
+       PABilinearFormExtension::SetElementPartition(). */
+   ParPAOverlapOperator(const ConformingProlongationOperator &P_,
+                        const PABilinearFormExtension &ext_);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+};
+
 /// Class for parallel bilinear form
 class ParBilinearForm : public BilinearForm
 {
@@ -37,6 +63,19 @@ protected:
 
    bool keep_nbr_block;
 
+   /// Structure of the product P^t A P, see KeepRAPPlan().
+   HypreRAPPlan *rap_plan;
+   /// The last product computed with #rap_plan, not owned.
+   HypreParMatrix *rap_mat;
+   bool keep_rap_plan;
+
+   /// See OverlapCommunication().
+   bool overlap_comm;
+
+   /** @brief Return the partial assembly extension if the overlapped action
+       is used, see OverlapCommunication(), and NULL otherwise. */
+   PABilinearFormExtension *OverlapExtension() const;
+
    // Allocate mat - called when (mat == NULL && fbfi.Size() > 0)
    void pAllocMat();
 
@@ -54,7 +93,8 @@ public:
    /** The pointer @a pf is not owned by the newly constructed object. */
    ParBilinearForm(ParFiniteElementSpace *pf)
       : BilinearForm(pf), pfes(pf),
-        p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
+        p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR),
+        rap_plan(NULL), rap_mat(NULL), keep_rap_plan(false), overlap_comm(false)
    { keep_nbr_block = false; }
 
    /** @brief Create a ParBilinearForm on the ParFiniteElementSpace @a *pf,
@@ -66,7 +106,8 @@ public:
        the newly constructed ParBilinearForm. */
    ParBilinearForm(ParFiniteElementSpace *pf, ParBilinearForm *bf)
       : BilinearForm(pf, bf), pfes(pf),
-        p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR)
+        p_mat(Operator::Hypre_ParCSR), p_mat_e(Operator::Hypre_ParCSR),
+        rap_plan(NULL), rap_mat(NULL), keep_rap_plan(false), overlap_comm(false)
    { keep_nbr_block = false; }
 
    /** When set to true and the ParBilinearForm has interior face integrators,
@@ -75,6 +116,30 @@ public:
        those rows. Must be called before the first Assemble call. */
    void KeepNbrBlock(bool knb = true) { keep_nbr_block = knb; }
 
+   /** When set to true, the assembly of the local matrix into a HypreParMatrix
+       with ParallelAssemble() computes the structure of the product P^t A P,
+       including its communication pattern, in the first call and reuses it in
+       the following calls, which only compute the values. The matrix of the
+       previous call is reused, i.e. its values are overwritten, when it is
+       still owned by the OperatorHandle passed to ParallelAssemble(), e.g. the
+       matrix of FormSystemMatrix(), which can then be called again after
+       Assemble() without Update(). This is beneficial when the form is
+       reassembled with the same sparsity many times, e.g. in time stepping or
+       Newton loops. It is not used with interior face integrators. */
+   void KeepRAPPlan(bool keep = true) { keep_rap_plan = keep; }
+
+   /** When set to true and the form uses partial assembly, the action of the
+       operator returned by FormSystemMatrix() and FormLinearSystem() overlaps
+       the exchange of the shared DOFs with computation, see
+       ParPAOverlapOperator. The elements are split with
+       ParFiniteElementSpace::GetInteriorElements(); the requirements on the
+       mesh and the integrators are listed in
+       PABilinearFormExtension::SetElementPartition(). This is beneficial when
+       the number of elements per processor is small, e.g. in strong scaling.
+       It has no effect on a single processor and on non-conforming meshes.
+       Must be called before the first Assemble call. */
+   void OverlapCommunication(bool overlap = true) { overlap_comm = overlap; }
+
    /** @brief Set the operator type id for the parallel matrix/operator when
        using AssemblyLevel::FULL. */
    /** If using static condensation or hybridization, call this method *after*
@@ -181,7 +246,7 @@ public:
 
    virtual void Update(FiniteElementSpace *nfes = NULL);
 
-   virtual ~ParBilinearForm() { }
+   virtual ~ParBilinearForm() { delete rap_plan; }
 };
 
 /// Class for parallel bilinear form using different test and trial FE spaces.
@@ -766,6 +766,27 @@ void ParFiniteElementSpace::GetEssentialTrueDofs(const Array<int>
    MarkerToList(true_ess_dofs, ess_tdof_list);
 }
 
+void ParFiniteElementSpace::GetInteriorElements(Array<int> &interior,
+                                                Array<int> &shared) const
+{
+   MFEM_VERIFY(Conforming(), "non-conforming meshes are not supported");
+   interior.SetSize(0);
+   shared.SetSize(0);
+   Array<int> vdofs;
+   for (int i = 0; i < GetNE(); i++)
+   {
+      GetElementVDofs(i, vdofs);
+      bool is_shared = false;
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         const int ldof = (vdofs[j] >= 0) ? vdofs[j] : -1 - vdofs[j];
+         if (ldof_group[ldof] != 0) { is_shared = true; break; }
+      }
+      if (is_shared) { shared.Append(i); }
+      else { interior.Append(i); }
+   }
+}
+
 int ParFiniteElementSpace::GetLocalTDofNumber(int ldof) const
 {
    if (Nonconforming())
@@ -882,7 +903,12 @@ const Operator *ParFiniteElementSpace::GetProlongationMatrix() const
    }
    else
    {
-      return Dof_TrueDof_Matrix();
+      if (!Device::Allows(Backend::DEVICE_MASK))
+      {
+         return Dof_TrueDof_Matrix();
+      }
+      if (!Pconf) { Pconf = new ParDeviceNCProlongationOperator(*this); }
+      return Pconf;
    }
 }
 
@@ -2941,6 +2967,45 @@ ConformingProlongationOperator::ConformingProlongationOperator(
    }
    external_ldofs.Sort();
    MFEM_ASSERT(external_ldofs.Size() == Height()-Width(), "");
+
+   // Index data of BcastBegin() and BcastEnd(), which exchange the shared
+   // ldofs in a buffer ordered like group_ldof, see GroupCommunicator layout 1
+   Array<int> ldof_ltdof(Height());
+   ltdof_to_ldof.SetSize(Width());
+   for (int i = 0, j = 0, e = 0; j < Height(); j++)
+   {
+      if (e < external_ldofs.Size() && external_ldofs[e] == j)
+      {
+         ldof_ltdof[j] = -1;
+         e++;
+      }
+      else
+      {
+         ldof_ltdof[j] = i;
+         ltdof_to_ldof[i++] = j;
+      }
+   }
+   MFEM_ASSERT(group_ldof.RowSize(0) == 0, "");
+   const int *I = group_ldof.GetI(), *J = group_ldof.GetJ();
+   for (int gr = 1; gr < group_ldof.Size(); gr++)
+   {
+      const bool master = gc.GetGroupTopology().IAmMaster(gr);
+      for (int k = I[gr]; k < I[gr+1]; k++)
+      {
+         if (master)
+         {
+            send_pos.Append(k);
+            send_ltdof.Append(ldof_ltdof[J[k]]);
+         }
+         else
+         {
+            recv_pos.Append(k);
+            recv_ldof.Append(J[k]);
+         }
+      }
+   }
+   bcast_buf.SetSize(group_ldof.Size_of_connections());
+   bcast_buf.UseDevice(true);
 #ifdef MFEM_DEBUG
    for (int j = 1; j < external_ldofs.Size(); j++)
    {
@@ -2991,6 +3056,43 @@ void ConformingProlongationOperator::Mult(const Vector &x, Vector &y) const
    gc.BcastEnd(ydata, out_layout);
 }
 
+void ConformingProlongationOperator::BcastBegin(const Vector &x,
+                                                Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == Width(), "");
+   MFEM_ASSERT(y.Size() == Height(), "");
+
+   // Gather the shared true dofs into the exchange buffer and copy the local
+   // true dofs to y, where x and y are, e.g. on the device
+   const int ns = send_pos.Size(), n = Width();
+   auto d_x = x.Read();
+   auto d_send_pos = send_pos.Read();
+   auto d_send_ltdof = send_ltdof.Read();
+   auto d_buf = bcast_buf.Write();
+   MFEM_FORALL(i, ns, d_buf[d_send_pos[i]] = d_x[d_send_ltdof[i]];);
+   auto d_ltdof_ldof = ltdof_to_ldof.Read();
+   auto d_y = y.Write();
+   MFEM_FORALL(i, n, d_y[d_ltdof_ldof[i]] = d_x[i];);
+
+   // Only the exchange buffer is moved to the host
+   const int layout = 1; // 1 - the buffer is an array on the shared ldofs
+   gc.BcastBegin(bcast_buf.HostReadWrite(), layout);
+}
+
+void ConformingProlongationOperator::BcastEnd(Vector &y) const
+{
+   const int layout = 1; // 1 - the buffer is an array on the shared ldofs
+   gc.BcastEnd(bcast_buf.HostReadWrite(), layout);
+
+   // Copy the received external dofs to y, without moving y to the host
+   const int nr = recv_pos.Size();
+   auto d_buf = bcast_buf.Read();
+   auto d_recv_pos = recv_pos.Read();
+   auto d_recv_ldof = recv_ldof.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(i, nr, d_y[d_recv_ldof[i]] = d_buf[d_recv_pos[i]];);
+}
+
 void ConformingProlongationOperator::MultTranspose(
    const Vector &x, Vector &y) const
 {
@@ -3019,7 +3121,8 @@ void ConformingProlongationOperator::MultTranspose(
 DeviceConformingProlongationOperator::DeviceConformingProlongationOperator(
    const ParFiniteElementSpace &pfes) :
    ConformingProlongationOperator(pfes),
-   mpi_gpu_aware(Device::GetGPUAwareMPI())
+   mpi_gpu_aware(Device::GetGPUAwareMPI()),
+   num_requests(0)
 {
    MFEM_ASSERT(pfes.Conforming(), "internal error");
    const SparseMatrix *R = pfes.GetRestrictionMatrix();
@@ -3134,6 +3237,13 @@ void DeviceConformingProlongationOperator::BcastEndCopy(
 
 void DeviceConformingProlongationOperator::Mult(const Vector &x,
                                                 Vector &y) const
+{
+   BcastBegin(x, y);
+   BcastEnd(y);
+}
+
+void DeviceConformingProlongationOperator::BcastBegin(const Vector &x,
+                                                      Vector &y) const
 {
    const GroupTopology &gtopo = gc.GetGroupTopology();
    BcastBeginCopy(x); // copy to 'shr_buf'
@@ -3160,7 +3270,13 @@ void DeviceConformingProlongationOperator::Mult(const Vector &x,
       }
    }
    BcastLocalCopy(x, y);
-   MPI_Waitall(req_counter, requests, MPI_STATUSES_IGNORE);
+   num_requests = req_counter;
+}
+
+void DeviceConformingProlongationOperator::BcastEnd(Vector &y) const
+{
+   MPI_Waitall(num_requests, requests, MPI_STATUSES_IGNORE);
+   num_requests = 0;
    BcastEndCopy(y); // copy from 'ext_buf'
 }
 
@@ -3252,6 +3368,187 @@ void DeviceConformingProlongationOperator::MultTranspose(const Vector &x,
    ReduceEndAssemble(y); // assemble from 'shr_buf'
 }
 
+// MPI tags of the exchanges of ParDeviceNCProlongationOperator: the true DOFs
+// sent to the neighbors in Mult() and the contributions sent back to their
+// owners in MultTranspose()
+static const int NC_PROLONGATION_MULT_TAG = 41824;
+static const int NC_PROLONGATION_MULT_TRANSPOSE_TAG = 41825;
+
+ParDeviceNCProlongationOperator::ParDeviceNCProlongationOperator(
+   const ParFiniteElementSpace &pfes)
+   : Operator(pfes.GetVSize(), pfes.GetTrueVSize()),
+     comm(pfes.GetComm()),
+     mpi_gpu_aware(Device::GetGPUAwareMPI())
+{
+   MFEM_VERIFY(pfes.Nonconforming(), "internal error");
+   HypreParMatrix *P = pfes.Dof_TrueDof_Matrix();
+   const SparseMatrix *R = pfes.GetRestrictionMatrix();
+   MFEM_ASSERT(R->Finalized(), "");
+
+   // Merge the diagonal and off-diagonal blocks of P, numbering the
+   // off-diagonal columns after the local true DOFs
+   SparseMatrix diag, offd;
+   HYPRE_Int *cmap;
+   P->GetDiag(diag);
+   P->GetOffd(offd, cmap);
+   const int n_loc = diag.Width(), n_ext = offd.Width();
+   MFEM_ASSERT(n_loc == Width(), "");
+   SparseMatrix P_loc(Height(), n_loc + n_ext);
+   Array<int> cols;
+   Vector srow;
+   for (int i = 0; i < Height(); i++)
+   {
+      diag.GetRow(i, cols, srow);
+      P_loc.SetRow(i, cols, srow);
+      if (n_ext == 0) { continue; }
+      offd.GetRow(i, cols, srow);
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         P_loc.Add(i, cols[j] + n_loc, srow(j));
+      }
+   }
+   P_loc.Finalize();
+   const Array<int> tdof_ldof(const_cast<int*>(R->GetJ()), R->Height());
+   local = new DeviceNCProlongationOperator(P_loc, tdof_ldof, n_loc);
+
+   // Copy the communication pattern of P
+   hypre_ParCSRMatrix *hP = *P;
+   if (!hypre_ParCSRMatrixCommPkg(hP)) { hypre_MatvecCommPkgCreate(hP); }
+   hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hP);
+   const int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+   const int num_recvs = hypre_ParCSRCommPkgNumRecvs(comm_pkg);
+   send_procs.SetSize(num_sends);
+   send_offsets.SetSize(num_sends+1);
+   for (int i = 0; i < num_sends; i++)
+   {
+      send_procs[i] = hypre_ParCSRCommPkgSendProc(comm_pkg, i);
+      send_offsets[i] = hypre_ParCSRCommPkgSendMapStart(comm_pkg, i);
+   }
+   send_offsets[num_sends] =
+      hypre_ParCSRCommPkgSendMapStart(comm_pkg, num_sends);
+   recv_procs.SetSize(num_recvs);
+   recv_offsets.SetSize(num_recvs+1);
+   for (int i = 0; i < num_recvs; i++)
+   {
+      recv_procs[i] = hypre_ParCSRCommPkgRecvProc(comm_pkg, i);
+      recv_offsets[i] = hypre_ParCSRCommPkgRecvVecStart(comm_pkg, i);
+   }
+   recv_offsets[num_recvs] =
+      hypre_ParCSRCommPkgRecvVecStart(comm_pkg, num_recvs);
+   MFEM_ASSERT(recv_offsets[num_recvs] == n_ext, "");
+
+   const int num_send_dofs = send_offsets[num_sends];
+   send_ltdof.SetSize(num_send_dofs);
+   for (int i = 0; i < num_send_dofs; i++)
+   {
+      send_ltdof[i] = hypre_ParCSRCommPkgSendMapElmt(comm_pkg, i);
+   }
+   send_buf.SetSize(num_send_dofs);
+   send_buf.UseDevice(true);
+   ext_buf.SetSize(n_ext);
+   ext_buf.UseDevice(true);
+
+   // A true DOF can be sent to several neighbors; in MultTranspose(), its
+   // contributions are summed using the transpose of the send map
+   {
+      Array<int> unique_ltdof(send_ltdof);
+      unique_ltdof.Sort();
+      unique_ltdof.Unique();
+      Array<int> send_unq(num_send_dofs);
+      for (int i = 0; i < num_send_dofs; i++)
+      {
+         send_unq[i] = unique_ltdof.FindSorted(send_ltdof[i]);
+         MFEM_ASSERT(send_unq[i] != -1, "internal error");
+      }
+      Table unique_send;
+      Transpose(send_unq, unique_send, unique_ltdof.Size());
+      unq_ltdof = unique_ltdof;
+      unq_send_i = Array<int>(unique_send.GetI(), unique_send.Size()+1);
+      unq_send_j = Array<int>(unique_send.GetJ(),
+                              unique_send.Size_of_connections());
+   }
+   requests = new MPI_Request[num_sends + num_recvs];
+}
+
+ParDeviceNCProlongationOperator::~ParDeviceNCProlongationOperator()
+{
+   delete [] requests;
+   delete local;
+}
+
+int ParDeviceNCProlongationOperator::StartExchange(
+   const Vector &send, const Array<int> &sprocs, const Array<int> &soffsets,
+   Vector &recv, const Array<int> &rprocs, const Array<int> &roffsets,
+   int tag) const
+{
+   int req_counter = 0;
+   if (rprocs.Size() > 0)
+   {
+      double *recv_data = mpi_gpu_aware ? recv.Write() : recv.HostWrite();
+      for (int i = 0; i < rprocs.Size(); i++)
+      {
+         const int size = roffsets[i+1] - roffsets[i];
+         if (size == 0) { continue; }
+         MPI_Irecv(recv_data + roffsets[i], size, MPI_DOUBLE, rprocs[i], tag,
+                   comm, &requests[req_counter++]);
+      }
+   }
+   if (sprocs.Size() > 0)
+   {
+      const double *send_data = mpi_gpu_aware ? send.Read() : send.HostRead();
+      for (int i = 0; i < sprocs.Size(); i++)
+      {
+         const int size = soffsets[i+1] - soffsets[i];
+         if (size == 0) { continue; }
+         MPI_Isend(const_cast<double*>(send_data) + soffsets[i], size,
+                   MPI_DOUBLE, sprocs[i], tag, comm, &requests[req_counter++]);
+      }
+   }
+   return req_counter;
+}
+
+void ParDeviceNCProlongationOperator::Mult(const Vector &x, Vector &y) const
+{
+   // send_buf[i] = x[send_ltdof[i]]
+   if (send_ltdof.Size() > 0)
+   {
+      ExtractSubVector(send_ltdof.Size(), send_ltdof, x, send_buf);
+      if (mpi_gpu_aware) { Device::Synchronize(); }
+   }
+   const int num_requests = StartExchange(send_buf, send_procs, send_offsets,
+                                          ext_buf, recv_procs, recv_offsets,
+                                          NC_PROLONGATION_MULT_TAG);
+   MPI_Waitall(num_requests, requests, MPI_STATUSES_IGNORE);
+   local->MultExternal(x, ext_buf, y);
+}
+
+void ParDeviceNCProlongationOperator::MultTranspose(const Vector &x,
+                                                    Vector &y) const
+{
+   local->MultTransposeExternal(x, y, ext_buf);
+   if (mpi_gpu_aware && ext_buf.Size() > 0) { Device::Synchronize(); }
+   // The external contributions are sent back to the owners of the true DOFs
+   const int num_requests = StartExchange(ext_buf, recv_procs, recv_offsets,
+                                          send_buf, send_procs, send_offsets,
+                                          NC_PROLONGATION_MULT_TRANSPOSE_TAG);
+   MPI_Waitall(num_requests, requests, MPI_STATUSES_IGNORE);
+   // y[send_ltdof[i]] += send_buf[i]
+   const int num_unique = unq_ltdof.Size();
+   if (num_unique == 0) { return; }
+   auto d_y = y.ReadWrite();
+   const auto d_buf = send_buf.Read();
+   const auto d_ltdof = unq_ltdof.Read();
+   const auto d_I = unq_send_i.Read();
+   const auto d_J = unq_send_j.Read();
+   MFEM_FORALL(i, num_unique,
+   {
+      double sum = 0.0;
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++) { sum += d_buf[d_J[j]]; }
+      d_y[d_ltdof[i]] += sum;
+   });
+}
+
 } // namespace mfem
 
 #endif
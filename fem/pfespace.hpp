@@ -312,6 +312,14 @@ public:
                                      Array<int> &ess_tdof_list,
                                      int component = -1);
 
+   /** @brief Split the local elements into the @a interior ones, none of whose
+       DOFs are shared with other processors, and the @a shared ones. */
+   /** The action of an operator assembled element by element on the interior
+       elements does not need the values of the shared DOFs, which allows it
+       to overlap their exchange, see ConformingProlongationOperator::
+       BcastBegin(). This method is not supported on non-conforming meshes. */
+   void GetInteriorElements(Array<int> &interior, Array<int> &shared) const;
+
    /** If the given ldof is owned by the current processor, return its local
        tdof number, otherwise return -1 */
    int GetLocalTDofNumber(int ldof) const;
@@ -379,12 +387,32 @@ protected:
    Array<int> external_ldofs;
    const GroupCommunicator &gc;
 
+   // Data of BcastBegin() and BcastEnd(): the shared ldofs are exchanged in
+   // bcast_buf, ordered like the group ldof table, where the entries send_pos
+   // are the true dofs send_ltdof, and the entries recv_pos are received into
+   // the ldofs recv_ldof.
+   Array<int> ltdof_to_ldof, send_pos, send_ltdof, recv_pos, recv_ldof;
+   mutable Vector bcast_buf;
+
 public:
    ConformingProlongationOperator(const ParFiniteElementSpace &pfes);
 
    virtual void Mult(const Vector &x, Vector &y) const;
 
    virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /** @brief Begin the action of the operator: copy the local true DOFs of
+       @a x to @a y and start the exchange of the shared DOFs. */
+   /** On return, the entries of @a y which are not shared with other
+       processors have their final values. The action is completed by
+       BcastEnd(); Mult() is the same as BcastBegin() followed by BcastEnd().
+       In between, @a x must not be modified. Unlike Mult(), which works on
+       the host, only the shared DOFs are moved to the host for the exchange,
+       so @a x and @a y can stay on the device. */
+   virtual void BcastBegin(const Vector &x, Vector &y) const;
+
+   /// Finish the action started with BcastBegin().
+   virtual void BcastEnd(Vector &y) const;
 };
 
 /// Auxiliary device class used by ParFiniteElementSpace.
@@ -399,6 +427,7 @@ protected:
    Array<int> ltdof_ldof, unq_ltdof;
    Array<int> unq_shr_i, unq_shr_j;
    MPI_Request *requests;
+   mutable int num_requests; // number of requests posted by BcastBegin()
    // Kernel: copy ltdofs from 'src' to 'shr_buf' - prepare for send.
    //         shr_buf[i] = src[shr_ltdof[i]]
    void BcastBeginCopy(const Vector &src) const;
@@ -431,6 +460,46 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 
    virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   virtual void BcastBegin(const Vector &x, Vector &y) const;
+
+   virtual void BcastEnd(Vector &y) const;
+};
+
+/** @brief Auxiliary device class used by ParFiniteElementSpace on
+    non-conforming meshes. */
+/** The local rows of the prolongation matrix, Dof_TrueDof_Matrix(), are stored
+    in a DeviceNCProlongationOperator whose external columns are the
+    off-diagonal true DOFs. Their values are exchanged with the communication
+    pattern of the HypreParMatrix, using device buffers for packing and
+    unpacking. */
+class ParDeviceNCProlongationOperator : public Operator
+{
+protected:
+   MPI_Comm comm;
+   bool mpi_gpu_aware;
+   DeviceNCProlongationOperator *local; // owned
+   Array<int> send_procs, send_offsets, recv_procs, recv_offsets;
+   Array<int> send_ltdof; ///< Local true DOFs sent to the neighbors
+   /// Unique entries of send_ltdof and their positions in the send buffer.
+   Array<int> unq_ltdof, unq_send_i, unq_send_j;
+   mutable Vector send_buf, ext_buf;
+   MPI_Request *requests;
+
+   /// Post the non-blocking sends and receives, return the number of requests.
+   int StartExchange(const Vector &send, const Array<int> &sprocs,
+                     const Array<int> &soffsets, Vector &recv,
+                     const Array<int> &rprocs, const Array<int> &roffsets,
+                     int tag) const;
+
+public:
+   ParDeviceNCProlongationOperator(const ParFiniteElementSpace &pfes);
+
+   virtual ~ParDeviceNCProlongationOperator();
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
 };
 
 }
@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <map>
+#include <algorithm>
 
 using namespace std;
 
@@ -348,6 +349,12 @@ GroupCommunicator::GroupCommunicator(GroupTopology &gt, Mode m)
    num_requests = 0;
    request_marker = NULL;
    buf_offsets = NULL;
+   nbr_send_total = 0;
+   nbr_comm = MPI_COMM_NULL;
+#if MPI_VERSION < 3
+   MFEM_VERIFY(mode != byNeighborCollective,
+               "byNeighborCollective requires MPI-3");
+#endif
 }
 
 void GroupCommunicator::Create(const Array<int> &ldof_group)
@@ -402,7 +409,8 @@ void GroupCommunicator::Finalize()
       }
    }
 
-   requests = new MPI_Request[request_counter];
+   // at least one request is used by the neighborhood collective
+   requests = new MPI_Request[max(request_counter, 1)];
    // statuses = new MPI_Status[request_counter];
    request_marker = new int[request_counter];
 
@@ -483,6 +491,116 @@ void GroupCommunicator::Finalize()
          }
       }
    }
+
+   SetupNeighborData();
+}
+
+void GroupCommunicator::SetMode(Mode m)
+{
+   MFEM_VERIFY(comm_lock == 0, "object is in use");
+#if MPI_VERSION < 3
+   MFEM_VERIFY(m != byNeighborCollective,
+               "byNeighborCollective requires MPI-3");
+#endif
+   if (m == mode) { return; }
+   FreeNeighborData();
+   mode = m;
+   // SetupNeighborData() requires the tables built in Finalize()
+   if (buf_offsets) { SetupNeighborData(); }
+}
+
+void GroupCommunicator::SetupNeighborData()
+{
+   if (mode != byNeighborPersistent && mode != byNeighborCollective)
+   {
+      return;
+   }
+
+   nbr_list.SetSize(0);
+   nbr_send_size.SetSize(0);
+   nbr_recv_size.SetSize(0);
+   for (int nbr = 1; nbr < nbr_send_groups.Size(); nbr++)
+   {
+      int send_size = 0, recv_size = 0;
+      const int num_send_groups = nbr_send_groups.RowSize(nbr);
+      const int *send_grp_list = nbr_send_groups.GetRow(nbr);
+      for (int i = 0; i < num_send_groups; i++)
+      {
+         send_size += group_ldof.RowSize(send_grp_list[i]);
+      }
+      const int num_recv_groups = nbr_recv_groups.RowSize(nbr);
+      const int *recv_grp_list = nbr_recv_groups.GetRow(nbr);
+      for (int i = 0; i < num_recv_groups; i++)
+      {
+         recv_size += group_ldof.RowSize(recv_grp_list[i]);
+      }
+      // The active neighbor relation is symmetric: our sends to 'nbr' are
+      // the receives of 'nbr' from us.
+      if (send_size > 0 || recv_size > 0)
+      {
+         nbr_list.Append(nbr);
+         nbr_send_size.Append(send_size);
+         nbr_recv_size.Append(recv_size);
+      }
+   }
+
+   const int num_nbrs = nbr_list.Size();
+   nbr_send_displ.SetSize(num_nbrs);
+   nbr_recv_displ.SetSize(num_nbrs);
+   nbr_send_total = 0;
+   int nbr_recv_total = 0;
+   for (int i = 0; i < num_nbrs; i++)
+   {
+      nbr_send_displ[i] = nbr_send_total;
+      nbr_recv_displ[i] = nbr_recv_total;
+      nbr_send_total += nbr_send_size[i];
+      nbr_recv_total += nbr_recv_size[i];
+   }
+   MFEM_VERIFY(nbr_send_total + nbr_recv_total == group_buf_size,
+               "inconsistent buffer size");
+
+   if (mode == byNeighborPersistent)
+   {
+      // The persistent requests are bound to the buffer address, so allocate
+      // it once for the largest supported type.
+      group_buf.SetSize(group_buf_size*sizeof(double));
+   }
+   else
+   {
+#if MPI_VERSION >= 3
+      Array<int> nbr_ranks(num_nbrs);
+      for (int i = 0; i < num_nbrs; i++)
+      {
+         nbr_ranks[i] = gtopo.GetNeighborRank(nbr_list[i]);
+      }
+      MPI_Dist_graph_create_adjacent(gtopo.GetComm(),
+                                     num_nbrs, nbr_ranks, MPI_UNWEIGHTED,
+                                     num_nbrs, nbr_ranks, MPI_UNWEIGHTED,
+                                     MPI_INFO_NULL, 0, &nbr_comm);
+#endif
+   }
+}
+
+void GroupCommunicator::FreeNeighborData()
+{
+   int mpi_finalized;
+   MPI_Finalized(&mpi_finalized);
+   for (int i = 0; i < 4; i++)
+   {
+      if (!mpi_finalized)
+      {
+         for (int j = 0; j < persistent_requests[i].Size(); j++)
+         {
+            MPI_Request_free(&persistent_requests[i][j]);
+         }
+      }
+      persistent_requests[i].DeleteAll();
+   }
+   if (nbr_comm != MPI_COMM_NULL)
+   {
+      if (!mpi_finalized) { MPI_Comm_free(&nbr_comm); }
+      nbr_comm = MPI_COMM_NULL;
+   }
 }
 
 void GroupCommunicator::SetLTDofTable(const Array<int> &ldof_ltdof)
@@ -693,12 +811,77 @@ const T *GroupCommunicator::ReduceGroupFromBuffer(const T *buf, T *ldata,
    return buf + opd.nldofs;
 }
 
+template <class T>
+int GroupCommunicator::StartNeighborExchange(int op) const
+{
+   const MPI_Datatype type = MPITypeMap<T>::mpi_type;
+   T *buf = (T *)group_buf.GetData();
+   T *send_buf = buf, *recv_buf = buf + nbr_send_total;
+   const int *send_size = nbr_send_size, *send_displ = nbr_send_displ;
+   const int *recv_size = nbr_recv_size, *recv_displ = nbr_recv_displ;
+   if (op == 1) // in Reduce: send <--> recv
+   {
+      std::swap(send_buf, recv_buf);
+      std::swap(send_size, recv_size);
+      std::swap(send_displ, recv_displ);
+   }
+
+#if MPI_VERSION >= 3
+   if (mode == byNeighborCollective)
+   {
+      MPI_Ineighbor_alltoallv(send_buf, send_size, send_displ, type,
+                              recv_buf, recv_size, recv_displ, type,
+                              nbr_comm, &requests[0]);
+      return 1;
+   }
+#endif
+
+   Array<MPI_Request> &preqs =
+      persistent_requests[2*op + (type == MPI_INT ? 0 : 1)];
+   if (preqs.Size() == 0)
+   {
+      const int tag = (op == 0) ? 40822 : 43822;
+      for (int i = 0; i < nbr_list.Size(); i++)
+      {
+         if (recv_size[i] == 0) { continue; }
+         preqs.Append(MPI_REQUEST_NULL);
+         MPI_Recv_init(recv_buf + recv_displ[i], recv_size[i], type,
+                       gtopo.GetNeighborRank(nbr_list[i]), tag,
+                       gtopo.GetComm(), &preqs.Last());
+      }
+      for (int i = 0; i < nbr_list.Size(); i++)
+      {
+         if (send_size[i] == 0) { continue; }
+         preqs.Append(MPI_REQUEST_NULL);
+         MPI_Send_init(send_buf + send_displ[i], send_size[i], type,
+                       gtopo.GetNeighborRank(nbr_list[i]), tag,
+                       gtopo.GetComm(), &preqs.Last());
+      }
+   }
+   MPI_Startall(preqs.Size(), preqs.GetData());
+   return preqs.Size();
+}
+
+template <class T>
+void GroupCommunicator::WaitNeighborExchange(int op) const
+{
+   if (mode == byNeighborCollective)
+   {
+      MPI_Wait(&requests[0], MPI_STATUS_IGNORE);
+      return;
+   }
+   const int type = (MPITypeMap<T>::mpi_type == MPI_INT) ? 0 : 1;
+   Array<MPI_Request> &preqs = persistent_requests[2*op + type];
+   MPI_Waitall(preqs.Size(), preqs.GetData(), MPI_STATUSES_IGNORE);
+}
+
 template <class T>
 void GroupCommunicator::BcastBegin(T *ldata, int layout) const
 {
    MFEM_VERIFY(comm_lock == 0, "object is already in use");
 
-   if (group_buf_size == 0) { return; }
+   // The neighborhood collective requires the participation of all ranks
+   if (group_buf_size == 0 && mode != byNeighborCollective) { return; }
 
    int request_counter = 0;
    switch (mode)
@@ -824,6 +1007,26 @@ void GroupCommunicator::BcastBegin(T *ldata, int layout) const
          MFEM_ASSERT(buf - (T*)group_buf.GetData() == group_buf_size, "");
          break;
       }
+
+      case byNeighborPersistent:
+      case byNeighborCollective:
+      {
+         group_buf.SetSize(group_buf_size*sizeof(T));
+         T *buf = (T *)group_buf.GetData();
+         for (int i = 0; i < nbr_list.Size(); i++)
+         {
+            const int nbr = nbr_list[i];
+            const int num_send_groups = nbr_send_groups.RowSize(nbr);
+            const int *grp_list = nbr_send_groups.GetRow(nbr);
+            T *nbr_buf = buf + nbr_send_displ[i];
+            for (int j = 0; j < num_send_groups; j++)
+            {
+               nbr_buf = CopyGroupToBuffer(ldata, nbr_buf, grp_list[j], layout);
+            }
+         }
+         request_counter = StartNeighborExchange<T>(0);
+         break;
+      }
    }
 
    comm_lock = 1; // 1 - locked fot Bcast
@@ -886,6 +1089,26 @@ void GroupCommunicator::BcastEnd(T *ldata, int layout) const
          }
          break;
       }
+
+      case byNeighborPersistent:
+      case byNeighborCollective:
+      {
+         WaitNeighborExchange<T>(0);
+         const T *buf = (T *)group_buf.GetData() + nbr_send_total;
+         for (int i = 0; i < nbr_list.Size(); i++)
+         {
+            const int nbr = nbr_list[i];
+            const int num_recv_groups = nbr_recv_groups.RowSize(nbr);
+            const int *grp_list = nbr_recv_groups.GetRow(nbr);
+            const T *nbr_buf = buf + nbr_recv_displ[i];
+            for (int j = 0; j < num_recv_groups; j++)
+            {
+               nbr_buf = CopyGroupFromBuffer(nbr_buf, ldata, grp_list[j],
+                                             layout);
+            }
+         }
+         break;
+      }
    }
 
    comm_lock = 0; // 0 - no lock
@@ -897,7 +1120,8 @@ void GroupCommunicator::ReduceBegin(const T *ldata) const
 {
    MFEM_VERIFY(comm_lock == 0, "object is already in use");
 
-   if (group_buf_size == 0) { return; }
+   // The neighborhood collective requires the participation of all ranks
+   if (group_buf_size == 0 && mode != byNeighborCollective) { return; }
 
    int request_counter = 0;
    group_buf.SetSize(group_buf_size*sizeof(T));
@@ -1005,6 +1229,27 @@ void GroupCommunicator::ReduceBegin(const T *ldata) const
          MFEM_ASSERT(buf - (T*)group_buf.GetData() == group_buf_size, "");
          break;
       }
+
+      case byNeighborPersistent:
+      case byNeighborCollective:
+      {
+         // In Reduce operation: send_groups <--> recv_groups
+         buf += nbr_send_total;
+         for (int i = 0; i < nbr_list.Size(); i++)
+         {
+            const int nbr = nbr_list[i];
+            const int num_send_groups = nbr_recv_groups.RowSize(nbr);
+            const int *grp_list = nbr_recv_groups.GetRow(nbr);
+            T *nbr_buf = buf + nbr_recv_displ[i];
+            for (int j = 0; j < num_send_groups; j++)
+            {
+               const int layout = 0; // ldata is an array on all ldofs
+               nbr_buf = CopyGroupToBuffer(ldata, nbr_buf, grp_list[j], layout);
+            }
+         }
+         request_counter = StartNeighborExchange<T>(1);
+         break;
+      }
    }
 
    comm_lock = 2;
@@ -1075,6 +1320,27 @@ void GroupCommunicator::ReduceEnd(T *ldata, int layout,
          }
          break;
       }
+
+      case byNeighborPersistent:
+      case byNeighborCollective:
+      {
+         WaitNeighborExchange<T>(1);
+         // In Reduce operation: send_groups <--> recv_groups
+         const T *buf = (T *)group_buf.GetData();
+         for (int i = 0; i < nbr_list.Size(); i++)
+         {
+            const int nbr = nbr_list[i];
+            const int num_recv_groups = nbr_send_groups.RowSize(nbr);
+            const int *grp_list = nbr_send_groups.GetRow(nbr);
+            const T *nbr_buf = buf + nbr_send_displ[i];
+            for (int j = 0; j < num_recv_groups; j++)
+            {
+               nbr_buf = ReduceGroupFromBuffer(nbr_buf, ldata, grp_list[j],
+                                               layout, Op);
+            }
+         }
+         break;
+      }
    }
 
    comm_lock = 0; // 0 - no lock
@@ -1160,6 +1426,8 @@ void GroupCommunicator::PrintInfo(std::ostream &out) const
    char c = '\0';
    const int tag = 46800;
    const int myid = gtopo.MyRank();
+   const char *mode_names[] =
+   { "byGroup", "byNeighbor", "byNeighborPersistent", "byNeighborCollective" };
 
    int num_sends = 0, num_recvs = 0;
    size_t mem_sends = 0, mem_recvs = 0;
@@ -1191,6 +1459,8 @@ void GroupCommunicator::PrintInfo(std::ostream &out) const
          break;
 
       case byNeighbor:
+      case byNeighborPersistent:
+      case byNeighborCollective:
          for (int gr = 1; gr < group_ldof.Size(); gr++)
          {
             const int nldofs = group_ldof.RowSize(gr);
@@ -1244,8 +1514,7 @@ void GroupCommunicator::PrintInfo(std::ostream &out) const
       out << "\nGroupCommunicator:\n";
    }
    out << "Rank " << myid << ":\n"
-       "   mode             = " <<
-       (mode == byGroup ? "byGroup" : "byNeighbor") << "\n"
+       "   mode             = " << mode_names[mode] << "\n"
        "   number of sends  = " << num_sends <<
        " (" << mem_sends << " bytes)\n"
        "   number of recvs  = " << num_recvs <<
@@ -1255,7 +1524,7 @@ void GroupCommunicator::PrintInfo(std::ostream &out) const
        num_master_groups << " + " <<
        group_ldof.Size()-num_master_groups-num_empty_groups << " + " <<
        num_empty_groups << " (master + slave + empty)\n";
-   if (mode == byNeighbor)
+   if (mode != byGroup)
    {
       out <<
           "   num neighbors    = " << nbr_send_groups.Size() << " = " <<
@@ -1277,6 +1546,7 @@ void GroupCommunicator::PrintInfo(std::ostream &out) const
 
 GroupCommunicator::~GroupCommunicator()
 {
+   FreeNeighborData();
    delete [] buf_offsets;
    delete [] request_marker;
    // delete [] statuses;
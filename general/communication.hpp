@@ -124,8 +124,16 @@ public:
    enum Mode
    {
       byGroup,    ///< Communications are performed one group at a time.
-      byNeighbor  /**< Communications are performed one neighbor at a time,
+      byNeighbor, /**< Communications are performed one neighbor at a time,
                        aggregating over groups. */
+      byNeighborPersistent, /**< Same as byNeighbor, using persistent requests
+                                 that are created once and restarted in every
+                                 operation. */
+      byNeighborCollective  /**< Same as byNeighbor, using MPI-3 neighborhood
+                                 collectives on a distributed graph
+                                 communicator. All ranks must take part in
+                                 Finalize(), SetMode() and every operation.
+                                 Requires MPI_VERSION >= 3. */
    };
 
 protected:
@@ -144,6 +152,32 @@ protected:
    int *buf_offsets; // size = max(number of groups, number of neighbors)
    Table nbr_send_groups, nbr_recv_groups; // nbr 0 = me
 
+   // Data for the modes byNeighborPersistent and byNeighborCollective. The
+   // sizes and displacements are in the Bcast direction; in Reduce the send
+   // and receive roles are swapped. The buffer holds all outgoing data in the
+   // first nbr_send_total entries, followed by all incoming data.
+   Array<int> nbr_list; // active neighbors (excluding me)
+   Array<int> nbr_send_size, nbr_send_displ;
+   Array<int> nbr_recv_size, nbr_recv_displ;
+   int nbr_send_total;
+   // Persistent requests, index = 2*op + type, op: 0 - Bcast, 1 - Reduce,
+   // type: 0 - int, 1 - double; created on first use.
+   mutable Array<MPI_Request> persistent_requests[4];
+   MPI_Comm nbr_comm; // distributed graph communicator
+
+   /// Set up the data for the modes byNeighborPersistent and
+   /// byNeighborCollective after Finalize().
+   void SetupNeighborData();
+   /// Free the data created by SetupNeighborData() and the persistent requests.
+   void FreeNeighborData();
+
+   /// Start the exchange of the packed buffer in the modes
+   /// byNeighborPersistent and byNeighborCollective; @a op is 0 for Bcast and
+   /// 1 for Reduce. Returns the number of started requests.
+   template <class T> int StartNeighborExchange(int op) const;
+   /// Wait for the exchange started with StartNeighborExchange().
+   template <class T> void WaitNeighborExchange(int op) const;
+
 public:
    /// Construct a GroupCommunicator object.
    /** The object must be initialized before it can be used to perform any
@@ -168,6 +202,13 @@ public:
    /// Allocate internal buffers after the GroupLDofTable is defined
    void Finalize();
 
+   /// Get the communication mode.
+   Mode GetMode() const { return mode; }
+
+   /** @brief Change the communication mode. If the object is finalized, this
+       call is collective when switching to or from byNeighborCollective. */
+   void SetMode(Mode m);
+
    /// Initialize the internal group_ltdof Table.
    /** This method must be called before performing operations that use local
        data layout 2, see CopyGroupToBuffer() for layout descriptions. */
@@ -0,0 +1,318 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the smoothed aggregation algebraic multigrid
+
+#include "amg.hpp"
+#include "sparsesmoothers.hpp"
+
+#include <cmath>
+
+namespace mfem
+{
+
+// Above this size, the coarsest level is solved with its smoother instead of a
+// dense LU factorization.
+static const int AMG_MAX_DENSE_SIZE = 2000;
+
+// Number of smoother sweeps used to solve the coarsest level when it is too
+// large for a dense factorization.
+static const int AMG_COARSE_SWEEPS = 10;
+
+SmoothedAggregationAMG::SmoothedAggregationAMG()
+   : theta(0.08), max_levels(10), max_coarse_size(100),
+     smoother_type(JACOBI), smoother_param(1), cycle_type(V_CYCLE),
+     print_level(0), coarse_solver(NULL)
+{ }
+
+SmoothedAggregationAMG::SmoothedAggregationAMG(const SparseMatrix &A_)
+   : theta(0.08), max_levels(10), max_coarse_size(100),
+     smoother_type(JACOBI), smoother_param(1), cycle_type(V_CYCLE),
+     print_level(0), coarse_solver(NULL)
+{
+   SetOperator(A_);
+}
+
+void SmoothedAggregationAMG::Clear()
+{
+   for (int l = 1; l < A.Size(); l++) { delete A[l]; }
+   for (int l = 0; l < P.Size(); l++) { delete P[l]; }
+   for (int l = 0; l < S.Size(); l++) { delete S[l]; }
+   for (int l = 0; l < r.Size(); l++)
+   {
+      delete r[l];
+      delete bc[l];
+      delete xc[l];
+   }
+   A.SetSize(0);
+   P.SetSize(0);
+   S.SetSize(0);
+   r.SetSize(0);
+   bc.SetSize(0);
+   xc.SetSize(0);
+   delete coarse_solver;
+   coarse_solver = NULL;
+}
+
+int SmoothedAggregationAMG::Aggregate(const SparseMatrix &Af,
+                                      Array<int> &aggregate) const
+{
+   const int n = Af.Height();
+   const int *I = Af.HostReadI(), *J = Af.HostReadJ();
+   const double *a = Af.HostReadData();
+   Vector diag;
+   Af.GetDiag(diag);
+   const double *d = diag.HostRead();
+
+   // Strength graph, with the magnitude of each strong connection
+   Array<int> SI(n+1), SJ;
+   Array<double> SV;
+   for (int i = 0; i < n; i++)
+   {
+      SI[i] = SJ.Size();
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if (j != i && a[k]*a[k] > theta*theta*fabs(d[i]*d[j]))
+         {
+            SJ.Append(j);
+            SV.Append(fabs(a[k]));
+         }
+      }
+   }
+   SI[n] = SJ.Size();
+
+   // Phase 1: aggregates of nodes whose strong neighbors are all free
+   aggregate.SetSize(n);
+   aggregate = -1;
+   int num_aggregates = 0;
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregate[i] >= 0 || SI[i] == SI[i+1]) { continue; }
+      bool free = true;
+      for (int k = SI[i]; k < SI[i+1] && free; k++)
+      {
+         free = (aggregate[SJ[k]] < 0);
+      }
+      if (!free) { continue; }
+      aggregate[i] = num_aggregates;
+      for (int k = SI[i]; k < SI[i+1]; k++)
+      {
+         aggregate[SJ[k]] = num_aggregates;
+      }
+      num_aggregates++;
+   }
+
+   // Phase 2: join the strongest connected aggregate from phase 1
+   Array<int> aggregate1(aggregate);
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregate[i] >= 0) { continue; }
+      double max_strength = 0.0;
+      for (int k = SI[i]; k < SI[i+1]; k++)
+      {
+         const int agg = aggregate1[SJ[k]];
+         if (agg >= 0 && SV[k] > max_strength)
+         {
+            max_strength = SV[k];
+            aggregate[i] = agg;
+         }
+      }
+   }
+
+   // Phase 3: aggregates of the remaining nodes and their free neighbors.
+   // Nodes without strong connections are not aggregated.
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregate[i] >= 0 || SI[i] == SI[i+1]) { continue; }
+      aggregate[i] = num_aggregates;
+      for (int k = SI[i]; k < SI[i+1]; k++)
+      {
+         if (aggregate[SJ[k]] < 0) { aggregate[SJ[k]] = num_aggregates; }
+      }
+      num_aggregates++;
+   }
+
+   return num_aggregates;
+}
+
+SparseMatrix *SmoothedAggregationAMG::Prolongator(const SparseMatrix &Af,
+                                                  const Array<int> &aggregate,
+                                                  int num_aggregates) const
+{
+   const int n = Af.Height();
+
+   // Tentative prolongator: the normalized constant vector on each aggregate
+   Array<int> agg_size(num_aggregates);
+   agg_size = 0;
+   int nnz = 0;
+   for (int i = 0; i < n; i++)
+   {
+      if (aggregate[i] >= 0)
+      {
+         agg_size[aggregate[i]]++;
+         nnz++;
+      }
+   }
+   int *T_i = new int[n+1];
+   int *T_j = new int[nnz];
+   double *T_data = new double[nnz];
+   T_i[0] = 0;
+   for (int i = 0, k = 0; i < n; i++)
+   {
+      if (aggregate[i] >= 0)
+      {
+         T_j[k] = aggregate[i];
+         T_data[k] = 1.0/sqrt(double(agg_size[aggregate[i]]));
+         k++;
+      }
+      T_i[i+1] = k;
+   }
+   SparseMatrix T(T_i, T_j, T_data, n, num_aggregates);
+
+   // Smoothed prolongator: P = T - omega D^{-1} A T
+   const double omega = 4.0/(3.0*MaxEigenvalueDinvA(Af));
+   SparseMatrix *AT = mfem::Mult(Af, T);
+   Vector s;
+   Af.GetDiag(s);
+   double *h_s = s.HostReadWrite();
+   for (int i = 0; i < n; i++) { h_s[i] = -omega/h_s[i]; }
+   AT->ScaleRows(s);
+   SparseMatrix *Pf = Add(T, *AT);
+   delete AT;
+   return Pf;
+}
+
+void SmoothedAggregationAMG::SetOperator(const Operator &op)
+{
+   const SparseMatrix *Af = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(Af != NULL && Af->Finalized(),
+               "the operator must be a finalized SparseMatrix");
+   MFEM_VERIFY(Af->Height() == Af->Width(), "the matrix must be square");
+   MFEM_VERIFY(smoother_param > 0, "invalid smoother parameter: "
+               << smoother_param);
+
+   Clear();
+   height = width = Af->Height();
+
+   // Coarsening
+   A.Append(Af);
+   while (A.Size() < max_levels && A.Last()->Height() > max_coarse_size)
+   {
+      const SparseMatrix &Al = *A.Last();
+      Array<int> aggregate;
+      const int num_aggregates = Aggregate(Al, aggregate);
+      if (num_aggregates == 0 || num_aggregates >= Al.Height()) { break; }
+
+      SparseMatrix *Pl = Prolongator(Al, aggregate, num_aggregates);
+      P.Append(Pl);
+      A.Append(RAP(*Pl, Al, *Pl));
+   }
+
+   // Smoothers and coarsest solver
+   const int num_levels = A.Size();
+   const bool dense_coarse = A.Last()->Height() <= AMG_MAX_DENSE_SIZE;
+   const int num_smoothers = dense_coarse ? num_levels - 1 : num_levels;
+   for (int l = 0; l < num_smoothers; l++)
+   {
+      Solver *smoother;
+      if (smoother_type == JACOBI)
+      {
+         smoother = new DSmoother(*A[l], 1, 1.0, smoother_param);
+      }
+      else
+      {
+         smoother = new ChebyshevSmoother(*A[l], smoother_param);
+      }
+      smoother->iterative_mode = true;
+      S.Append(smoother);
+   }
+   if (dense_coarse)
+   {
+      DenseMatrix *Ac = A.Last()->ToDenseMatrix();
+      coarse_solver = new DenseMatrixInverse(*Ac);
+      delete Ac;
+   }
+
+   for (int l = 0; l < num_levels - 1; l++)
+   {
+      r.Append(new Vector(A[l]->Height()));
+      bc.Append(new Vector(A[l+1]->Height()));
+      xc.Append(new Vector(A[l+1]->Height()));
+   }
+
+   if (print_level > 0)
+   {
+      mfem::out << "SmoothedAggregationAMG: " << num_levels << " levels\n";
+      for (int l = 0; l < num_levels; l++)
+      {
+         mfem::out << "   level " << l << ": rows = " << A[l]->Height()
+                   << ", nonzeros = " << A[l]->NumNonZeroElems() << '\n';
+      }
+      mfem::out << "   operator complexity = " << GetOperatorComplexity()
+                << '\n';
+   }
+}
+
+void SmoothedAggregationAMG::Cycle(int l, const Vector &b, Vector &x) const
+{
+   const int coarsest = A.Size() - 1;
+   if (l == coarsest)
+   {
+      if (coarse_solver)
+      {
+         coarse_solver->Mult(b, x);
+      }
+      else
+      {
+         for (int i = 0; i < AMG_COARSE_SWEEPS; i++) { S[l]->Mult(b, x); }
+      }
+      return;
+   }
+
+   // Pre-smoothing
+   S[l]->Mult(b, x);
+
+   // Coarse grid correction, applied twice in the W-cycle
+   A[l]->Mult(x, *r[l]);
+   subtract(b, *r[l], *r[l]);
+   P[l]->MultTranspose(*r[l], *bc[l]);
+   *xc[l] = 0.0;
+   const int gamma = (l + 1 == coarsest) ? 1 : int(cycle_type);
+   for (int g = 0; g < gamma; g++)
+   {
+      Cycle(l + 1, *bc[l], *xc[l]);
+   }
+   P[l]->AddMult(*xc[l], x);
+
+   // Post-smoothing
+   S[l]->Mult(b, x);
+}
+
+void SmoothedAggregationAMG::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "SetOperator() must be called first");
+   if (!iterative_mode)
+   {
+      x = 0.0;
+   }
+   Cycle(0, b, x);
+}
+
+double SmoothedAggregationAMG::GetOperatorComplexity() const
+{
+   if (A.Size() == 0) { return 0.0; }
+   double nnz = 0.0;
+   for (int l = 0; l < A.Size(); l++) { nnz += A[l]->NumNonZeroElems(); }
+   return nnz/A[0]->NumNonZeroElems();
+}
+
+}
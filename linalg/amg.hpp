@@ -0,0 +1,138 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+/// Smoothed aggregation algebraic multigrid for a serial SparseMatrix
+/** The multigrid hierarchy is constructed in SetOperator(). On each level:
+    - the strength graph keeps the connections with
+      |a_ij| > theta sqrt(|a_ii a_jj|), see SetStrengthThreshold();
+    - the nodes are grouped in aggregates of strongly connected nodes with the
+      three-phase algorithm of Vanek, Mandel and Brezina; nodes without strong
+      connections, e.g. eliminated essential dofs, are not aggregated;
+    - the tentative prolongator, which interpolates the constant vector on each
+      aggregate, is smoothed with a damped Jacobi step,
+      P = (I - 4/(3 lmax) D^{-1} A) T, with lmax from MaxEigenvalueDinvA();
+    - the coarse matrix is the Galerkin product P^t A P, computed with RAP().
+
+    The coarsening stops when the coarse matrix has at most max_coarse_size
+    rows, after max_levels levels, or when the number of rows does not
+    decrease. The levels are smoothed with l1-Jacobi (DSmoother) or with
+    ChebyshevSmoother, and the coarsest level is solved with a dense LU
+    factorization, or with its smoother if it is too large for that.
+
+    Mult() applies one V- or W-cycle, so the solver is meant to be used as a
+    preconditioner, e.g. of CGSolver for symmetric positive definite matrices,
+    for which the cycle is symmetric. The constant vector is the near null
+    space of the construction, which suits scalar diffusion-type problems. */
+class SmoothedAggregationAMG : public Solver
+{
+public:
+   /// Smoothers on the levels, see SetSmoother().
+   enum SmootherType { JACOBI, CHEBYSHEV };
+
+   /// Multigrid cycles, see SetCycleType().
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   double theta;
+   int max_levels, max_coarse_size;
+   SmootherType smoother_type;
+   int smoother_param;
+   CycleType cycle_type;
+   int print_level;
+
+   /// The matrices of the levels; A[0] is the (not owned) fine matrix.
+   Array<const SparseMatrix*> A;
+   /// Prolongation from level l+1 to level l.
+   Array<SparseMatrix*> P;
+   /// Smoothers of the levels; the coarsest one only without coarse_solver.
+   Array<Solver*> S;
+   DenseMatrixInverse *coarse_solver;
+
+   /// Residual, coarse right-hand side and coarse correction of each level.
+   mutable Array<Vector*> r, bc, xc;
+
+   void Clear();
+
+   /** @brief Group the nodes of @a Af in aggregates, returning their number
+       and, in @a aggregate, the aggregate of each node (-1: not aggregated). */
+   int Aggregate(const SparseMatrix &Af, Array<int> &aggregate) const;
+
+   /// Return the smoothed prolongator for the given aggregates.
+   SparseMatrix *Prolongator(const SparseMatrix &Af,
+                             const Array<int> &aggregate,
+                             int num_aggregates) const;
+
+   /// Apply the cycle on level @a l, with @a x as initial guess.
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   SmoothedAggregationAMG();
+
+   /// Construct the multigrid hierarchy of @a A with the default parameters.
+   SmoothedAggregationAMG(const SparseMatrix &A);
+
+   /// Set the strength threshold, default is 0.08.
+   void SetStrengthThreshold(double th) { theta = th; }
+
+   /// Set the maximum number of levels, default is 10.
+   void SetMaxLevels(int levels) { max_levels = levels; }
+
+   /// Set the maximum size of the coarsest matrix, default is 100.
+   void SetMaxCoarseSize(int size) { max_coarse_size = size; }
+
+   /** @brief Set the smoother of the levels, with the number of sweeps of
+       JACOBI or the polynomial degree of CHEBYSHEV, default is one sweep of
+       JACOBI. */
+   void SetSmoother(SmootherType type, int param = 1)
+   { smoother_type = type; smoother_param = param; }
+
+   /// Set the multigrid cycle, default is V_CYCLE.
+   void SetCycleType(CycleType type) { cycle_type = type; }
+
+   /// Print the levels of the hierarchy when @a print_lvl > 0.
+   void SetPrintLevel(int print_lvl) { print_level = print_lvl; }
+
+   /** @brief Construct the multigrid hierarchy of @a op, which must be a
+       finalized SparseMatrix. The parameters must be set before. */
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one multigrid cycle to the system A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the number of levels, including the fine and coarsest levels.
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Return the matrix of level @a l, where level 0 is the fine level.
+   const SparseMatrix &GetLevelMatrix(int l) const { return *A[l]; }
+
+   /// Return the prolongation from level @a l+1 to level @a l.
+   const SparseMatrix &GetProlongation(int l) const { return *P[l]; }
+
+   /** @brief Return the operator complexity, the sum of the numbers of nonzeros
+       of all levels divided by the number of nonzeros of the fine matrix. */
+   double GetOperatorComplexity() const;
+
+   virtual ~SmoothedAggregationAMG() { Clear(); }
+};
+
+}
+
+#endif
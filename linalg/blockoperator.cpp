@@ -11,13 +11,40 @@
 
 
 #include "../general/array.hpp"
+#include "../general/device.hpp"
 #include "operator.hpp"
+#include "matrix.hpp"
 #include "blockvector.hpp"
 #include "blockoperator.hpp"
 
 namespace mfem
 {
 
+// Returns true if the blocks should be applied concurrently by OpenMP threads.
+// Device kernels are launched from the host thread only.
+static inline bool UseConcurrentBlocks(bool concurrent)
+{
+   return concurrent && !Device::IsEnabled();
+}
+
+// Compute y += c A x, or y += c A^t x, with the temporary vector t of the size
+// of y. Sparse matrices accumulate directly into y.
+static void AddBlockMult(const Operator &A, const Vector &x, Vector &y,
+                         double c, Vector &t, bool transpose)
+{
+   const AbstractSparseMatrix *S =
+      dynamic_cast<const AbstractSparseMatrix*>(&A);
+   if (S)
+   {
+      if (transpose) { S->AddMultTranspose(x, y, c); }
+      else { S->AddMult(x, y, c); }
+      return;
+   }
+   if (transpose) { A.MultTranspose(x, t); }
+   else { A.Mult(x, t); }
+   y.Add(c, t);
+}
+
 BlockOperator::BlockOperator(const Array<int> & offsets)
    : Operator(offsets.Last()),
      owns_blocks(0),
@@ -26,7 +53,8 @@ BlockOperator::BlockOperator(const Array<int> & offsets)
      row_offsets(0),
      col_offsets(0),
      op(nRowBlocks, nRowBlocks),
-     coef(nRowBlocks, nColBlocks)
+     coef(nRowBlocks, nColBlocks),
+     concurrent_blocks(false)
 {
    op = static_cast<Operator *>(NULL);
    row_offsets.MakeRef(offsets);
@@ -42,7 +70,8 @@ BlockOperator::BlockOperator(const Array<int> & row_offsets_,
      row_offsets(0),
      col_offsets(0),
      op(nRowBlocks, nColBlocks),
-     coef(nRowBlocks, nColBlocks)
+     coef(nRowBlocks, nColBlocks),
+     concurrent_blocks(false)
 {
    op = static_cast<Operator *>(NULL);
    row_offsets.MakeRef(row_offsets_);
@@ -70,22 +99,40 @@ void BlockOperator::Mult (const Vector & x, Vector & y) const
    MFEM_ASSERT(x.Size() == width, "incorrect input Vector size");
    MFEM_ASSERT(y.Size() == height, "incorrect output Vector size");
 
-   yblock.Update(y.GetData(),row_offsets);
-   xblock.Update(x.GetData(),col_offsets);
+   x.Read();
+   y.Write();
+   xblock.Update(const_cast<Vector&>(x), col_offsets);
+   yblock.Update(y, row_offsets);
+   if (tmp_rows.Size() != height) { tmp_rows.Update(row_offsets); }
 
-   y = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for schedule(dynamic) \
+   if (nRowBlocks > 1 && UseConcurrentBlocks(concurrent_blocks))
+#endif
    for (int iRow=0; iRow < nRowBlocks; ++iRow)
    {
-      tmp.SetSize(row_offsets[iRow+1] - row_offsets[iRow]);
+      Vector &y_i = yblock.GetBlock(iRow);
+      bool first = true;
       for (int jCol=0; jCol < nColBlocks; ++jCol)
       {
-         if (op(iRow,jCol))
+         if (!op(iRow,jCol)) { continue; }
+         if (first)
          {
-            op(iRow,jCol)->Mult(xblock.GetBlock(jCol), tmp);
-            yblock.GetBlock(iRow).Add(coef(iRow,jCol), tmp);
+            op(iRow,jCol)->Mult(xblock.GetBlock(jCol), y_i);
+            if (coef(iRow,jCol) != 1.0) { y_i *= coef(iRow,jCol); }
+            first = false;
+         }
+         else
+         {
+            AddBlockMult(*op(iRow,jCol), xblock.GetBlock(jCol), y_i,
+                         coef(iRow,jCol), tmp_rows.GetBlock(iRow), false);
          }
       }
+      if (first) { y_i = 0.0; }
    }
+
+   xblock.SyncFromBlocks();
+   yblock.SyncFromBlocks();
 }
 
 // Action of the transpose operator
@@ -94,24 +141,40 @@ void BlockOperator::MultTranspose (const Vector & x, Vector & y) const
    MFEM_ASSERT(x.Size() == height, "incorrect input Vector size");
    MFEM_ASSERT(y.Size() == width, "incorrect output Vector size");
 
-   y = 0.0;
-
-   xblock.Update(x.GetData(),row_offsets);
-   yblock.Update(y.GetData(),col_offsets);
-
-   for (int iRow=0; iRow < nColBlocks; ++iRow)
+   x.Read();
+   y.Write();
+   xblock.Update(const_cast<Vector&>(x), row_offsets);
+   yblock.Update(y, col_offsets);
+   if (tmp_cols.Size() != width) { tmp_cols.Update(col_offsets); }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for schedule(dynamic) \
+   if (nColBlocks > 1 && UseConcurrentBlocks(concurrent_blocks))
+#endif
+   for (int iCol=0; iCol < nColBlocks; ++iCol)
    {
-      tmp.SetSize(col_offsets[iRow+1] - col_offsets[iRow]);
-      for (int jCol=0; jCol < nRowBlocks; ++jCol)
+      Vector &y_i = yblock.GetBlock(iCol);
+      bool first = true;
+      for (int jRow=0; jRow < nRowBlocks; ++jRow)
       {
-         if (op(jCol,iRow))
+         if (!op(jRow,iCol)) { continue; }
+         if (first)
+         {
+            op(jRow,iCol)->MultTranspose(xblock.GetBlock(jRow), y_i);
+            if (coef(jRow,iCol) != 1.0) { y_i *= coef(jRow,iCol); }
+            first = false;
+         }
+         else
          {
-            op(jCol,iRow)->MultTranspose(xblock.GetBlock(jCol), tmp);
-            yblock.GetBlock(iRow).Add(coef(jCol,iRow), tmp);
+            AddBlockMult(*op(jRow,iCol), xblock.GetBlock(jRow), y_i,
+                         coef(jRow,iCol), tmp_cols.GetBlock(iCol), true);
          }
       }
+      if (first) { y_i = 0.0; }
    }
 
+   xblock.SyncFromBlocks();
+   yblock.SyncFromBlocks();
 }
 
 BlockOperator::~BlockOperator()
@@ -135,8 +198,8 @@ BlockDiagonalPreconditioner::BlockDiagonalPreconditioner(
    owns_blocks(0),
    nBlocks(offsets_.Size() - 1),
    offsets(0),
-   op(nBlocks)
-
+   op(nBlocks),
+   concurrent_blocks(false)
 {
    op = static_cast<Operator *>(NULL);
    offsets.MakeRef(offsets_);
@@ -157,9 +220,15 @@ void BlockDiagonalPreconditioner::Mult (const Vector & x, Vector & y) const
    MFEM_ASSERT(x.Size() == width, "incorrect input Vector size");
    MFEM_ASSERT(y.Size() == height, "incorrect output Vector size");
 
-   yblock.Update(y.GetData(), offsets);
-   xblock.Update(x.GetData(), offsets);
+   x.Read();
+   y.Write();
+   xblock.Update(const_cast<Vector&>(x), offsets);
+   yblock.Update(y, offsets);
 
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for schedule(dynamic) \
+   if (nBlocks > 1 && UseConcurrentBlocks(concurrent_blocks))
+#endif
    for (int i=0; i<nBlocks; ++i)
    {
       if (op[i])
@@ -171,6 +240,9 @@ void BlockDiagonalPreconditioner::Mult (const Vector & x, Vector & y) const
          yblock.GetBlock(i) = xblock.GetBlock(i);
       }
    }
+
+   xblock.SyncFromBlocks();
+   yblock.SyncFromBlocks();
 }
 
 // Action of the transpose operator
@@ -180,9 +252,15 @@ void BlockDiagonalPreconditioner::MultTranspose (const Vector & x,
    MFEM_ASSERT(x.Size() == height, "incorrect input Vector size");
    MFEM_ASSERT(y.Size() == width, "incorrect output Vector size");
 
-   yblock.Update(y.GetData(), offsets);
-   xblock.Update(x.GetData(), offsets);
+   x.Read();
+   y.Write();
+   xblock.Update(const_cast<Vector&>(x), offsets);
+   yblock.Update(y, offsets);
 
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for schedule(dynamic) \
+   if (nBlocks > 1 && UseConcurrentBlocks(concurrent_blocks))
+#endif
    for (int i=0; i<nBlocks; ++i)
    {
       if (op[i])
@@ -194,6 +272,9 @@ void BlockDiagonalPreconditioner::MultTranspose (const Vector & x,
          yblock.GetBlock(i) = xblock.GetBlock(i);
       }
    }
+
+   xblock.SyncFromBlocks();
+   yblock.SyncFromBlocks();
 }
 
 BlockDiagonalPreconditioner::~BlockDiagonalPreconditioner()
@@ -213,7 +294,8 @@ BlockLowerTriangularPreconditioner::BlockLowerTriangularPreconditioner(
      owns_blocks(0),
      nBlocks(offsets_.Size() - 1),
      offsets(0),
-     op(nBlocks, nBlocks)
+     op(nBlocks, nBlocks),
+     concurrent_blocks(false)
 {
    op = static_cast<Operator *>(NULL);
    offsets.MakeRef(offsets_);
@@ -240,76 +322,107 @@ void BlockLowerTriangularPreconditioner::SetBlock(int iRow, int iCol,
    op(iRow, iCol) = opt;
 }
 
-// Operator application
-void BlockLowerTriangularPreconditioner::Mult (const Vector & x,
-                                               Vector & y) const
+void BlockLowerTriangularPreconditioner::ComputeLevels(
+   bool transpose, Array<int> &level) const
 {
-   MFEM_ASSERT(x.Size() == width, "incorrect input Vector size");
-   MFEM_ASSERT(y.Size() == height, "incorrect output Vector size");
-
-   yblock.Update(y.GetData(),offsets);
-   xblock.Update(x.GetData(),offsets);
-
-   y = 0.0;
-   for (int iRow=0; iRow < nBlocks; ++iRow)
+   // The level of a block row is one more than the maximum level of the block
+   // rows it depends on; the block rows of a level are independent.
+   level.SetSize(nBlocks);
+   int num_levels = 0;
+   for (int k = 0; k < nBlocks; ++k)
    {
-      tmp.SetSize(offsets[iRow+1] - offsets[iRow]);
-      tmp2.SetSize(offsets[iRow+1] - offsets[iRow]);
-      tmp2 = 0.0;
-      tmp2 += xblock.GetBlock(iRow);
-      for (int jCol=0; jCol < iRow; ++jCol)
+      const int i = transpose ? nBlocks-1-k : k;
+      level[i] = 0;
+      for (int l = 0; l < k; ++l)
       {
-         if (op(iRow,jCol))
+         const int j = transpose ? nBlocks-1-l : l;
+         if ((transpose ? op(j,i) : op(i,j)) && level[j] >= level[i])
          {
-            op(iRow,jCol)->Mult(yblock.GetBlock(jCol), tmp);
-            tmp2 -= tmp;
+            level[i] = level[j] + 1;
          }
       }
-      if (op(iRow,iRow))
-      {
-         op(iRow,iRow)->Mult(tmp2, yblock.GetBlock(iRow));
-      }
-      else
-      {
-         yblock.GetBlock(iRow) = tmp2;
-      }
+      if (level[i] >= num_levels) { num_levels = level[i] + 1; }
    }
+   level.Append(num_levels);
 }
 
-// Action of the transpose operator
-void BlockLowerTriangularPreconditioner::MultTranspose (const Vector & x,
-                                                        Vector & y) const
+void BlockLowerTriangularPreconditioner::SolveLevels(bool transpose,
+                                                     const Vector &x,
+                                                     Vector &y) const
 {
-   MFEM_ASSERT(x.Size() == height, "incorrect input Vector size");
-   MFEM_ASSERT(y.Size() == width, "incorrect output Vector size");
+   x.Read();
+   y.Write();
+   xblock.Update(const_cast<Vector&>(x), offsets);
+   yblock.Update(y, offsets);
+   if (tmp.Size() != height)
+   {
+      tmp.Update(offsets);
+      tmp2.Update(offsets);
+   }
 
-   yblock.Update(y.GetData(),offsets);
-   xblock.Update(x.GetData(),offsets);
+   // Without concurrency, the block rows are processed in order as one level
+   const bool concurrent = UseConcurrentBlocks(concurrent_blocks);
+   Array<int> level;
+   if (concurrent) { ComputeLevels(transpose, level); }
+   const int num_levels = concurrent ? level.Last() : 1;
 
-   y = 0.0;
-   for (int iRow=nBlocks-1; iRow >=0; --iRow)
+   for (int l = 0; l < num_levels; ++l)
    {
-      tmp.SetSize(offsets[iRow+1] - offsets[iRow]);
-      tmp2.SetSize(offsets[iRow+1] - offsets[iRow]);
-      tmp2 = 0.0;
-      tmp2 += xblock.GetBlock(iRow);
-      for (int jCol=iRow+1; jCol < nBlocks; ++jCol)
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for schedule(dynamic) \
+      if (concurrent && num_levels < nBlocks)
+#endif
+      for (int k = 0; k < nBlocks; ++k)
       {
-         if (op(jCol,iRow))
+         const int i = transpose ? nBlocks-1-k : k;
+         if (concurrent && level[i] != l) { continue; }
+
+         // Compute r_i = x_i - sum_j L_ij y_j, in y_i if the diagonal block is
+         // the identity
+         Operator *diag = op(i,i);
+         Vector &r_i = diag ? tmp2.GetBlock(i) : yblock.GetBlock(i);
+         r_i = xblock.GetBlock(i);
+         const int j_begin = transpose ? i+1 : 0;
+         const int j_end = transpose ? nBlocks : i;
+         for (int j = j_begin; j < j_end; ++j)
          {
-            op(jCol,iRow)->MultTranspose(yblock.GetBlock(jCol), tmp);
-            tmp2 -= tmp;
+            Operator *L_ij = transpose ? op(j,i) : op(i,j);
+            if (L_ij)
+            {
+               AddBlockMult(*L_ij, yblock.GetBlock(j), r_i, -1.0,
+                            tmp.GetBlock(i), transpose);
+            }
+         }
+         if (diag)
+         {
+            if (transpose) { diag->MultTranspose(r_i, yblock.GetBlock(i)); }
+            else { diag->Mult(r_i, yblock.GetBlock(i)); }
          }
-      }
-      if (op(iRow,iRow))
-      {
-         op(iRow,iRow)->MultTranspose(tmp2, yblock.GetBlock(iRow));
-      }
-      else
-      {
-         yblock.GetBlock(iRow) = tmp2;
       }
    }
+
+   xblock.SyncFromBlocks();
+   yblock.SyncFromBlocks();
+}
+
+// Operator application
+void BlockLowerTriangularPreconditioner::Mult (const Vector & x,
+                                               Vector & y) const
+{
+   MFEM_ASSERT(x.Size() == width, "incorrect input Vector size");
+   MFEM_ASSERT(y.Size() == height, "incorrect output Vector size");
+
+   SolveLevels(false, x, y);
+}
+
+// Action of the transpose operator
+void BlockLowerTriangularPreconditioner::MultTranspose (const Vector & x,
+                                                        Vector & y) const
+{
+   MFEM_ASSERT(x.Size() == height, "incorrect input Vector size");
+   MFEM_ASSERT(y.Size() == width, "incorrect output Vector size");
+
+   SolveLevels(true, x, y);
 }
 
 BlockLowerTriangularPreconditioner::~BlockLowerTriangularPreconditioner()
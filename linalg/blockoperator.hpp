@@ -30,6 +30,11 @@ namespace mfem
  * - Use the method Mult and MultTranspose to apply the operator to a vector.
  *
  * If a block is not set, it is assumed to be a zero block.
+ *
+ * The blocks are applied to views of the blocks of the input and output
+ * vectors, without copying them. Sparse matrix blocks accumulate directly into
+ * the output; other off-diagonal contributions use a temporary vector. With
+ * SetConcurrentBlocks(), the block rows are applied concurrently.
  */
 class BlockOperator : public Operator
 {
@@ -88,6 +93,15 @@ public:
    //! Return the columns offsets for block starts
    Array<int> & ColOffsets() { return col_offsets; }
 
+   /** @brief Apply the block rows (block columns in MultTranspose())
+       concurrently using OpenMP threads; the default is false.
+
+       The blocks of different rows must be safe to apply at the same time,
+       e.g. they should not share temporary vectors. The option has no effect
+       without MFEM_USE_OPENMP or when the Device is enabled. */
+   void SetConcurrentBlocks(bool concurrent = true)
+   { concurrent_blocks = concurrent; }
+
    /// Operator application
    virtual void Mult (const Vector & x, Vector & y) const;
 
@@ -113,11 +127,16 @@ private:
    Array2D<Operator *> op;
    //! 2D array that stores a coefficient for each block of the operator.
    Array2D<double> coef;
+   //! Apply the blocks concurrently, see SetConcurrentBlocks().
+   bool concurrent_blocks;
 
-   //! Temporary Vectors used to efficiently apply the Mult and MultTranspose methods.
+   //! Views of the input and output Vectors of Mult and MultTranspose.
    mutable BlockVector xblock;
    mutable BlockVector yblock;
-   mutable Vector tmp;
+   //! Temporary Vectors, one block per block row (tmp_rows) or block column
+   //! (tmp_cols), used by the Mult and MultTranspose methods.
+   mutable BlockVector tmp_rows;
+   mutable BlockVector tmp_cols;
 };
 
 //! @class BlockDiagonalPreconditioner
@@ -156,6 +175,14 @@ public:
    //! Return the offsets for block starts
    Array<int> & Offsets() { return offsets; }
 
+   /** @brief Apply the diagonal blocks concurrently using OpenMP threads; the
+       default is false.
+
+       The blocks must be safe to apply at the same time. The option has no
+       effect without MFEM_USE_OPENMP or when the Device is enabled. */
+   void SetConcurrentBlocks(bool concurrent = true)
+   { concurrent_blocks = concurrent; }
+
    /// Operator application
    virtual void Mult (const Vector & x, Vector & y) const;
 
@@ -176,8 +203,9 @@ private:
    Array<int> offsets;
    //! 1D array that stores each block of the operator.
    Array<Operator *> op;
-   //! Temporary Vectors used to efficiently apply the Mult and MultTranspose
-   //! methods.
+   //! Apply the blocks concurrently, see SetConcurrentBlocks().
+   bool concurrent_blocks;
+   //! Views of the input and output Vectors of Mult and MultTranspose.
    mutable BlockVector xblock;
    mutable BlockVector yblock;
 };
@@ -239,6 +267,19 @@ public:
    //! Return the offsets for block starts
    Array<int> & Offsets() { return offsets; }
 
+   /** @brief Apply the independent block rows concurrently using OpenMP
+       threads; the default is false.
+
+       The block rows are grouped in levels: a block row depends on the
+       previous block rows with nonzero off-diagonal blocks in it (in its
+       block column for MultTranspose()), and its level is one more than the
+       maximum level of these. The block rows of one level are processed
+       concurrently, so their blocks must be safe to apply at the same time.
+       The option has no effect without MFEM_USE_OPENMP or when the Device is
+       enabled. */
+   void SetConcurrentBlocks(bool concurrent = true)
+   { concurrent_blocks = concurrent; }
+
    /// Operator application
    virtual void Mult (const Vector & x, Vector & y) const;
 
@@ -259,13 +300,23 @@ private:
    Array<int> offsets;
    //! 2D array that stores each block of the operator.
    Array2D<Operator *> op;
+   //! Apply the independent block rows concurrently, see
+   //! SetConcurrentBlocks().
+   bool concurrent_blocks;
 
-   //! Temporary Vectors used to efficiently apply the Mult and MultTranspose
-   //! methods.
+   //! Views of the input and output Vectors of Mult and MultTranspose.
    mutable BlockVector xblock;
    mutable BlockVector yblock;
-   mutable Vector tmp;
-   mutable Vector tmp2;
+   //! Temporary Vectors, one block per block row, used by the Mult and
+   //! MultTranspose methods.
+   mutable BlockVector tmp;
+   mutable BlockVector tmp2;
+
+   /** Compute the level of each block row of L (of L^t if @a transpose is
+       true), followed by the number of levels, see SetConcurrentBlocks(). */
+   void ComputeLevels(bool transpose, Array<int> &level) const;
+   /// Forward (backward if @a transpose is true) block substitution.
+   void SolveLevels(bool transpose, const Vector &x, Vector &y) const;
 };
 
 }
@@ -74,6 +74,17 @@ BlockVector::BlockVector(double *data, const Array<int> & bOffsets):
    SetBlocks();
 }
 
+//! View constructor
+BlockVector::BlockVector(Vector & v, const Array<int> & bOffsets):
+   Vector(),
+   numBlocks(bOffsets.Size()-1),
+   blockOffsets(bOffsets.GetData())
+{
+   MakeRef(v, 0, bOffsets.Last());
+   blocks = new Vector[numBlocks];
+   SetBlocks();
+}
+
 void BlockVector::Update(double *data, const Array<int> & bOffsets)
 {
    NewDataAndSize(data, bOffsets.Last());
@@ -87,6 +98,27 @@ void BlockVector::Update(double *data, const Array<int> & bOffsets)
    SetBlocks();
 }
 
+void BlockVector::Update(Vector & data, const Array<int> & bOffsets)
+{
+   MakeRef(data, 0, bOffsets.Last());
+   blockOffsets = bOffsets.GetData();
+   if (numBlocks != bOffsets.Size()-1)
+   {
+      delete [] blocks;
+      numBlocks = bOffsets.Size()-1;
+      blocks = new Vector[numBlocks];
+   }
+   SetBlocks();
+}
+
+void BlockVector::SyncFromBlocks() const
+{
+   for (int i = 0; i < numBlocks; ++i)
+   {
+      blocks[i].SyncAliasMemory(*this);
+   }
+}
+
 void BlockVector::Update(const Array<int> &bOffsets)
 {
    Update(bOffsets, data.GetMemoryType());
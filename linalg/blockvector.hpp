@@ -72,6 +72,15 @@ public:
     */
    BlockVector(double *data, const Array<int> & bOffsets);
 
+   //! View constructor
+   /**
+    * The BlockVector and its blocks are aliases of the memory of @a v, i.e.
+    * of its host and device data, and no data is copied. bOffsets is an array
+    * of integers (length nBlocks+1) that tells the offsets of each block
+    * start.
+    */
+   BlockVector(Vector & v, const Array<int> & bOffsets);
+
    //! Assignment operator. this and original must have the same block structure.
    BlockVector & operator=(const BlockVector & original);
    //! Set each entry of this equal to val
@@ -99,6 +108,14 @@ public:
     */
    void Update(double *data, const Array<int> & bOffsets);
 
+   //! Update method
+   /**
+    * View the memory of the Vector @a data, see BlockVector(Vector &, const
+    * Array<int> &). Unlike Update(double *, const Array<int> &), this keeps
+    * the device data of @a data valid, without copying it to the host.
+    */
+   void Update(Vector & data, const Array<int> & bOffsets);
+
    /// Update a BlockVector with new @a bOffsets and make sure it owns its data.
    /** The block-vector will be re-allocated if either:
        - the offsets @a bOffsets are different from the current offsets, or
@@ -112,6 +129,15 @@ public:
        - currently, the block-vector does not own its data, or
        - currently, the block-vector does not use MemoryType @a mt. */
    void Update(const Array<int> &bOffsets, MemoryType mt);
+
+   /** @brief Synchronize the memory location flags (i.e. the memory validity
+       flags) of the big/monolithic block-vector with its sub-vector blocks. */
+   /** The blocks are aliases of the big block-vector and writing to them, e.g.
+       on the device, does not update the flags of the block-vector, see
+       Memory::SyncAlias(). This method should be called after writing to the
+       blocks and before accessing the big block-vector, or the Vector viewed
+       by it, see Update(Vector &, const Array<int> &). */
+   void SyncFromBlocks() const;
 };
 
 }
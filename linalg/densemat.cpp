@@ -18,6 +18,7 @@
 #include "densemat.hpp"
 #include "../general/table.hpp"
 #include "../general/globals.hpp"
+#include "../general/forall.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -4677,4 +4678,391 @@ DenseTensor &DenseTensor::operator=(double c)
    return *this;
 }
 
+// Batched dense linear algebra. The kernels are templated on the matrix size
+// T_M, with T_M = 0 for the generic, run-time sized, version.
+
+template<int T_M = 0> MFEM_HOST_DEVICE inline
+bool BatchLUFactorKernel(const int m_, double *A, int *ipiv, const double tol)
+{
+   const int m = T_M ? T_M : m_;
+   bool ok = true;
+   for (int i = 0; i < m; i++)
+   {
+      int piv = i;
+      double a = fabs(A[i+i*m]);
+      for (int j = i+1; j < m; j++)
+      {
+         const double b = fabs(A[j+i*m]);
+         if (b > a)
+         {
+            a = b;
+            piv = j;
+         }
+      }
+      ipiv[i] = piv;
+      if (piv != i)
+      {
+         for (int j = 0; j < m; j++)
+         {
+            const double t = A[i+j*m];
+            A[i+j*m] = A[piv+j*m];
+            A[piv+j*m] = t;
+         }
+      }
+      if (a <= tol)
+      {
+         ok = false;
+         break;
+      }
+      const double a_ii_inv = 1.0/A[i+i*m];
+      for (int j = i+1; j < m; j++)
+      {
+         A[j+i*m] *= a_ii_inv;
+      }
+      for (int k = i+1; k < m; k++)
+      {
+         const double a_ik = A[i+k*m];
+         for (int j = i+1; j < m; j++)
+         {
+            A[j+k*m] -= a_ik * A[j+i*m];
+         }
+      }
+   }
+   return ok;
+}
+
+template<int T_M = 0> MFEM_HOST_DEVICE inline
+void BatchLUSolveKernel(const int m_, const double *LU, const int *ipiv,
+                        double *x)
+{
+   const int m = T_M ? T_M : m_;
+   // x <- L^{-1} P x
+   for (int i = 0; i < m; i++)
+   {
+      const double t = x[i];
+      x[i] = x[ipiv[i]];
+      x[ipiv[i]] = t;
+   }
+   for (int j = 0; j < m; j++)
+   {
+      const double x_j = x[j];
+      for (int i = j+1; i < m; i++)
+      {
+         x[i] -= LU[i+j*m] * x_j;
+      }
+   }
+   // x <- U^{-1} x
+   for (int j = m-1; j >= 0; j--)
+   {
+      const double x_j = (x[j] /= LU[j+j*m]);
+      for (int i = 0; i < j; i++)
+      {
+         x[i] -= LU[i+j*m] * x_j;
+      }
+   }
+}
+
+template<int T_M = 0>
+static void BatchLUFactor(const int m_, const int nk, double tol,
+                          DenseTensor &A, Array<int> &P, Array<int> &status)
+{
+   const int m = T_M ? T_M : m_;
+   auto d_A = A.ReadWrite();
+   auto d_P = P.Write();
+   auto d_status = status.Write();
+   MFEM_FORALL(k, nk,
+   {
+      d_status[k] = BatchLUFactorKernel<T_M>(m, d_A + k*m*m, d_P + k*m, tol);
+   });
+}
+
+bool BatchLUFactor(DenseTensor &A, Array<int> &P, double TOL)
+{
+   const int m = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices must be square");
+   P.SetSize(m*nk);
+   Array<int> status(nk);
+   switch (m)
+   {
+      case 2: BatchLUFactor<2>(m, nk, TOL, A, P, status); break;
+      case 3: BatchLUFactor<3>(m, nk, TOL, A, P, status); break;
+      default: BatchLUFactor(m, nk, TOL, A, P, status); break;
+   }
+   const int *h_status = status.HostRead();
+   for (int k = 0; k < nk; k++)
+   {
+      if (!h_status[k]) { return false; }
+   }
+   return true;
+}
+
+template<int T_M = 0>
+static void BatchLUSolve(const int m_, const int nk, const int n,
+                         const DenseTensor &LU, const Array<int> &P,
+                         Vector &X)
+{
+   const int m = T_M ? T_M : m_;
+   auto d_LU = LU.Read();
+   auto d_P = P.Read();
+   auto d_X = X.ReadWrite();
+   MFEM_FORALL(k, nk,
+   {
+      for (int c = 0; c < n; c++)
+      {
+         BatchLUSolveKernel<T_M>(m, d_LU + k*m*m, d_P + k*m,
+                                 d_X + (c + k*n)*m);
+      }
+   });
+}
+
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X)
+{
+   const int m = LU.SizeI(), nk = LU.SizeK();
+   MFEM_VERIFY(P.Size() == m*nk, "invalid pivots");
+   if (nk == 0) { return; }
+   const int n = X.Size()/(m*nk);
+   MFEM_VERIFY(X.Size() == m*n*nk, "invalid size of X: " << X.Size());
+   switch (m)
+   {
+      case 2: return BatchLUSolve<2>(m, nk, n, LU, P, X);
+      case 3: return BatchLUSolve<3>(m, nk, n, LU, P, X);
+      default: return BatchLUSolve(m, nk, n, LU, P, X);
+   }
+}
+
+void BatchInverse(const DenseTensor &A, DenseTensor &Ainv)
+{
+   const int m = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices must be square");
+   if (Ainv.SizeI() != m || Ainv.SizeJ() != m || Ainv.SizeK() != nk)
+   {
+      Ainv.SetSize(m, m, nk);
+   }
+
+   if (m == 2 || m == 3)
+   {
+      // Adjugate divided by the determinant
+      Array<int> status(nk);
+      auto d_status = status.Write();
+      auto d_A = A.Read();
+      auto d_Ainv = (&Ainv == &A) ? Ainv.ReadWrite() : Ainv.Write();
+      MFEM_FORALL(k, nk,
+      {
+         const double *a = d_A + k*m*m;
+         double *b = d_Ainv + k*m*m;
+         if (m == 2)
+         {
+            const double a11 = a[0], a21 = a[1], a12 = a[2], a22 = a[3];
+            const double det = a11*a22 - a12*a21;
+            d_status[k] = (det != 0.0);
+            const double d = 1.0/det;
+            b[0] = d*a22;
+            b[1] = -d*a21;
+            b[2] = -d*a12;
+            b[3] = d*a11;
+         }
+         else
+         {
+            const double a11 = a[0], a21 = a[1], a31 = a[2];
+            const double a12 = a[3], a22 = a[4], a32 = a[5];
+            const double a13 = a[6], a23 = a[7], a33 = a[8];
+            const double c11 = a22*a33 - a23*a32;
+            const double c12 = a23*a31 - a21*a33;
+            const double c13 = a21*a32 - a22*a31;
+            const double det = a11*c11 + a12*c12 + a13*c13;
+            d_status[k] = (det != 0.0);
+            const double d = 1.0/det;
+            b[0] = d*c11;
+            b[1] = d*c12;
+            b[2] = d*c13;
+            b[3] = d*(a13*a32 - a12*a33);
+            b[4] = d*(a11*a33 - a13*a31);
+            b[5] = d*(a12*a31 - a11*a32);
+            b[6] = d*(a12*a23 - a13*a22);
+            b[7] = d*(a13*a21 - a11*a23);
+            b[8] = d*(a11*a22 - a12*a21);
+         }
+      });
+      const int *h_status = status.HostRead();
+      for (int k = 0; k < nk; k++)
+      {
+         MFEM_VERIFY(h_status[k], "singular matrix in the batch");
+      }
+      return;
+   }
+
+   // Solve for the columns of the identity with the LU factors of a copy
+   DenseTensor LU(A);
+   Array<int> P;
+   MFEM_VERIFY(BatchLUFactor(LU, P), "singular matrix in the batch");
+   auto d_LU = LU.Read();
+   auto d_P = P.Read();
+   auto d_Ainv = Ainv.Write();
+   MFEM_FORALL(k, nk,
+   {
+      double *b = d_Ainv + k*m*m;
+      for (int j = 0; j < m; j++)
+      {
+         for (int i = 0; i < m; i++) { b[i+j*m] = (i == j) ? 1.0 : 0.0; }
+         BatchLUSolveKernel(m, d_LU + k*m*m, d_P + k*m, b + j*m);
+      }
+   });
+}
+
+void BatchDet(const DenseTensor &A, Vector &det)
+{
+   const int m = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices must be square");
+   det.SetSize(nk);
+
+   if (m <= 3)
+   {
+      auto d_A = A.Read();
+      auto d_det = det.Write();
+      MFEM_FORALL(k, nk,
+      {
+         const double *a = d_A + k*m*m;
+         switch (m)
+         {
+            case 0: d_det[k] = 1.0; break;
+            case 1: d_det[k] = a[0]; break;
+            case 2: d_det[k] = a[0]*a[3] - a[1]*a[2]; break;
+            default:
+               d_det[k] = a[0]*(a[4]*a[8] - a[5]*a[7]) +
+                          a[3]*(a[7]*a[2] - a[1]*a[8]) +
+                          a[6]*(a[1]*a[5] - a[2]*a[4]);
+         }
+      });
+      return;
+   }
+
+   // Product of the pivots of the LU factors of a copy
+   DenseTensor LU(A);
+   Array<int> P;
+   BatchLUFactor(LU, P);
+   auto d_LU = LU.Read();
+   auto d_P = P.Read();
+   auto d_det = det.Write();
+   MFEM_FORALL(k, nk,
+   {
+      const double *lu = d_LU + k*m*m;
+      const int *p = d_P + k*m;
+      double d = 1.0;
+      for (int i = 0; i < m; i++)
+      {
+         d *= (p[i] != i) ? -lu[i+i*m] : lu[i+i*m];
+      }
+      d_det[k] = d;
+   });
+}
+
+template<int T_M = 0, int T_L = 0, int T_N = 0>
+static void BatchMult(const int m_, const int l_, const int n_, const int nk,
+                      const double a, const double beta, const DenseTensor &A,
+                      const DenseTensor &B, DenseTensor &C)
+{
+   const int m = T_M ? T_M : m_;
+   const int l = T_L ? T_L : l_;
+   const int n = T_N ? T_N : n_;
+   auto d_A = A.Read();
+   auto d_B = B.Read();
+   auto d_C = (beta == 0.0) ? C.Write() : C.ReadWrite();
+   MFEM_FORALL(k, nk,
+   {
+      const double *Ak = d_A + k*m*l;
+      const double *Bk = d_B + k*l*n;
+      double *Ck = d_C + k*m*n;
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < m; i++)
+         {
+            double s = 0.0;
+            for (int p = 0; p < l; p++)
+            {
+               s += Ak[i+p*m] * Bk[p+j*l];
+            }
+            Ck[i+j*m] = (beta == 0.0) ? a*s : Ck[i+j*m] + a*s;
+         }
+      }
+   });
+}
+
+static void BatchMult(const double a, const double beta, const DenseTensor &A,
+                      const DenseTensor &B, DenseTensor &C)
+{
+   const int m = A.SizeI(), l = A.SizeJ(), n = B.SizeJ(), nk = A.SizeK();
+   MFEM_VERIFY(B.SizeI() == l && B.SizeK() == nk,
+               "incompatible sizes of A and B");
+   MFEM_VERIFY(&C != &A && &C != &B, "C must be different from A and B");
+   if (C.SizeI() != m || C.SizeJ() != n || C.SizeK() != nk)
+   {
+      MFEM_VERIFY(beta == 0.0, "incompatible size of C");
+      C.SetSize(m, n, nk);
+   }
+   const int id = (m == l && l == n) ? m : 0;
+   switch (id)
+   {
+      case 2: return BatchMult<2,2,2>(m, l, n, nk, a, beta, A, B, C);
+      case 3: return BatchMult<3,3,3>(m, l, n, nk, a, beta, A, B, C);
+      default: return BatchMult(m, l, n, nk, a, beta, A, B, C);
+   }
+}
+
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C)
+{
+   BatchMult(1.0, 0.0, A, B, C);
+}
+
+void BatchAddMult_a(double a, const DenseTensor &A, const DenseTensor &B,
+                    DenseTensor &C)
+{
+   BatchMult(a, 1.0, A, B, C);
+}
+
+template<int T_M = 0, int T_L = 0>
+static void BatchMult(const int m_, const int l_, const int n, const int nk,
+                      const DenseTensor &A, const Vector &x, Vector &y)
+{
+   const int m = T_M ? T_M : m_;
+   const int l = T_L ? T_L : l_;
+   auto d_A = A.Read();
+   auto d_x = x.Read();
+   auto d_y = y.Write();
+   MFEM_FORALL(k, nk,
+   {
+      const double *Ak = d_A + k*m*l;
+      for (int c = 0; c < n; c++)
+      {
+         const double *xc = d_x + (c + k*n)*l;
+         double *yc = d_y + (c + k*n)*m;
+         for (int i = 0; i < m; i++)
+         {
+            double s = 0.0;
+            for (int p = 0; p < l; p++)
+            {
+               s += Ak[i+p*m] * xc[p];
+            }
+            yc[i] = s;
+         }
+      }
+   });
+}
+
+void BatchMult(const DenseTensor &A, const Vector &x, Vector &y)
+{
+   const int m = A.SizeI(), l = A.SizeJ(), nk = A.SizeK();
+   if (nk == 0 || l == 0) { y.SetSize(0); return; }
+   const int n = x.Size()/(l*nk);
+   MFEM_VERIFY(x.Size() == l*n*nk, "invalid size of x: " << x.Size());
+   MFEM_VERIFY(x.GetData() != y.GetData(), "x and y must be different");
+   y.SetSize(m*n*nk);
+   const int id = (m == l) ? m : 0;
+   switch (id)
+   {
+      case 2: return BatchMult<2,2>(m, l, n, nk, A, x, y);
+      case 3: return BatchMult<3,3>(m, l, n, nk, A, x, y);
+      default: return BatchMult(m, l, n, nk, A, x, y);
+   }
+}
+
 }
@@ -827,6 +827,53 @@ public:
    ~DenseTensor() { tdata.Delete(); }
 };
 
+/** @name Batched dense linear algebra
+
+    Operations on all matrices A(k) = A(:,:,k), k = 0,...,SizeK()-1, of a
+    DenseTensor, e.g. the element matrices of a mesh. The matrices are
+    processed in parallel with MFEM_FORALL, on the host or on the device, and
+    the 2x2 and 3x3 cases use kernels with compile-time sizes. The vectors
+    associated with the batch store n columns per matrix, contiguously for each
+    k, i.e. x has size SizeJ()*n*SizeK() and x(:,c,k) is its column c for A(k).
+
+    The kernels work on the native DenseTensor layout, where the entries of
+    each matrix are contiguous and the batch index k is outermost, with one
+    matrix per thread. They do not use an interleaved layout with k innermost,
+    which would coalesce the accesses of consecutive GPU threads, since that
+    would differ from the layout of every other user of DenseTensor.
+*/
+///@{
+
+/** @brief Compute the LU factorizations with partial pivoting of all matrices
+    of @a A, overwriting them with their factors. The pivots are stored in @a P,
+    with SizeI() pivots per matrix.
+
+    @return false if a pivot of magnitude less than or equal to @a TOL was
+    found, in which case the factorization of that matrix is incomplete. */
+bool BatchLUFactor(DenseTensor &A, Array<int> &P, double TOL = 0.0);
+
+/** @brief Solve the systems A(k) X(:,:,k) = X(:,:,k), in place, given the LU
+    factors and pivots computed by BatchLUFactor(). */
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X);
+
+/// Compute the inverses of all matrices of @a A. @a Ainv may be @a A.
+void BatchInverse(const DenseTensor &A, DenseTensor &Ainv);
+
+/// Compute the determinants of all matrices of @a A.
+void BatchDet(const DenseTensor &A, Vector &det);
+
+/// Compute C(k) = A(k) B(k) for all k.
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C);
+
+/// Compute C(k) += a A(k) B(k) for all k.
+void BatchAddMult_a(double a, const DenseTensor &A, const DenseTensor &B,
+                    DenseTensor &C);
+
+/// Compute y(:,:,k) = A(k) x(:,:,k) for all k.
+void BatchMult(const DenseTensor &A, const Vector &x, Vector &y);
+
+///@}
+
 
 // Inline methods
 
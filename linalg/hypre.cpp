@@ -20,6 +20,7 @@
 #include <iomanip>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
 
 // Define macro wrappers for hypre_TAlloc, hypre_CTAlloc and hypre_TFree:
 // mfem_hypre_TAlloc, mfem_hypre_CTAlloc, and mfem_hypre_TFree, respectively.
@@ -1087,6 +1088,60 @@ void HypreParMatrix::MultTranspose(double a, const Vector &x,
    hypre_ParCSRMatrixMatvecT(a, A, *Y, b, *X);
 }
 
+// Create a hypre multi-vector with k column-major local vectors stored in the
+// given data array, which is not owned by the multi-vector.
+static hypre_ParVector *CreateParMultiVector(MPI_Comm comm, HYPRE_Int glob_size,
+                                             HYPRE_Int *col, int k,
+                                             double *data)
+{
+   hypre_ParVector *x = hypre_ParMultiVectorCreate(comm, glob_size, col, k);
+   hypre_ParVectorSetDataOwner(x,1); // owns the seq vector
+   hypre_SeqVectorSetDataOwner(hypre_ParVectorLocalVector(x),0);
+   hypre_ParVectorSetPartitioningOwner(x,0);
+   double tmp = 0.0;
+   hypre_VectorData(hypre_ParVectorLocalVector(x)) = &tmp;
+   // Initialize the vector strides without allocating memory
+   hypre_ParVectorInitialize(x);
+   hypre_VectorData(hypre_ParVectorLocalVector(x)) = data;
+   return x;
+}
+
+void HypreParMatrix::Mult(double a, const DenseMatrix &X,
+                          double b, DenseMatrix &Y) const
+{
+   MFEM_ASSERT(X.Height() == Width(), "invalid X.Height() = " << X.Height()
+               << ", expected = " << Width());
+   MFEM_ASSERT(Y.Height() == Height() && Y.Width() == X.Width(),
+               "invalid Y size = " << Y.Height() << " x " << Y.Width());
+
+   const int k = X.Width();
+   hypre_ParVector *x = CreateParMultiVector(A->comm, GetGlobalNumCols(),
+                                             GetColStarts(), k, X.Data());
+   hypre_ParVector *y = CreateParMultiVector(A->comm, GetGlobalNumRows(),
+                                             GetRowStarts(), k, Y.Data());
+   hypre_ParCSRMatrixMatvec(a, A, x, b, y);
+   hypre_ParVectorDestroy(x);
+   hypre_ParVectorDestroy(y);
+}
+
+void HypreParMatrix::MultTranspose(double a, const DenseMatrix &X,
+                                   double b, DenseMatrix &Y) const
+{
+   MFEM_ASSERT(X.Height() == Height(), "invalid X.Height() = " << X.Height()
+               << ", expected = " << Height());
+   MFEM_ASSERT(Y.Height() == Width() && Y.Width() == X.Width(),
+               "invalid Y size = " << Y.Height() << " x " << Y.Width());
+
+   const int k = X.Width();
+   hypre_ParVector *x = CreateParMultiVector(A->comm, GetGlobalNumRows(),
+                                             GetRowStarts(), k, X.Data());
+   hypre_ParVector *y = CreateParMultiVector(A->comm, GetGlobalNumCols(),
+                                             GetColStarts(), k, Y.Data());
+   hypre_ParCSRMatrixMatvecT(a, A, x, b, y);
+   hypre_ParVectorDestroy(x);
+   hypre_ParVectorDestroy(y);
+}
+
 HYPRE_Int HypreParMatrix::Mult(HYPRE_ParVector x, HYPRE_ParVector y,
                                double a, double b)
 {
@@ -1651,6 +1706,335 @@ HypreParMatrix * RAP(const HypreParMatrix * Rt, const HypreParMatrix *A,
    return new HypreParMatrix(rap);
 }
 
+// MPI tags of the messages of HypreRAPPlan: the sparsity of the rows sent to
+// their owners in the constructor and their values in Mult()
+static const int RAP_PLAN_STRUCTURE_TAG = 46802;
+static const int RAP_PLAN_VALUES_TAG = 46803;
+
+HypreRAPPlan::HypreRAPPlan(const SparseMatrix &A_local,
+                           const HypreParMatrix &P_)
+   : P(P_)
+{
+   hypre_ParCSRMatrix *hP = P;
+   MPI_Comm comm = P.GetComm();
+   const int tag = RAP_PLAN_STRUCTURE_TAG;
+
+   // The local rows of P, with the off-diagonal columns after the diagonal ones
+   SparseMatrix P_diag, P_offd;
+   HYPRE_Int *P_cmap;
+   P.GetDiag(P_diag);
+   P.GetOffd(P_offd, P_cmap);
+   const int nd = P_diag.Width(), no = P_offd.Width(), nl = P_diag.Height();
+   MFEM_VERIFY(A_local.Height() == nl && A_local.Width() == nl,
+               "the local matrix does not match the rows of P");
+   num_diag_cols = nd;
+   {
+      const int *di = P_diag.GetI(), *dj = P_diag.GetJ();
+      const int *oi = P_offd.GetI(), *oj = P_offd.GetJ();
+      const double *dd = P_diag.GetData(), *od = P_offd.GetData();
+      int *I = new int[nl+1];
+      int *J = new int[di[nl] + oi[nl]];
+      double *data = new double[di[nl] + oi[nl]];
+      I[0] = 0;
+      for (int i = 0, k = 0; i < nl; i++)
+      {
+         for (int l = di[i]; l < di[i+1]; l++, k++)
+         {
+            J[k] = dj[l];
+            data[k] = dd[l];
+         }
+         for (int l = oi[i]; l < oi[i+1]; l++, k++)
+         {
+            J[k] = nd + oj[l];
+            data[k] = od[l];
+         }
+         I[i+1] = k;
+      }
+      P_loc = new SparseMatrix(I, J, data, nl, nd + no);
+   }
+
+   // The local contribution: rows < nd are owned, the other rows belong to
+   // the owners of the off-diagonal columns of P
+   loc_plan = new SparseRAPPlan(*P_loc, A_local, *P_loc);
+   C_loc = loc_plan->CreateMatrix();
+   const int *Ci = C_loc->GetI(), *Cj = C_loc->GetJ();
+
+   if (!hypre_ParCSRMatrixCommPkg(hP)) { hypre_MatvecCommPkgCreate(hP); }
+   hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hP);
+   const int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+   const HYPRE_Int *send_procs = hypre_ParCSRCommPkgSendProcs(comm_pkg);
+   const HYPRE_Int *send_starts = hypre_ParCSRCommPkgSendMapStarts(comm_pkg);
+   const HYPRE_Int *send_elmts = hypre_ParCSRCommPkgSendMapElmts(comm_pkg);
+   const int num_recvs = hypre_ParCSRCommPkgNumRecvs(comm_pkg);
+   const HYPRE_Int *recv_procs = hypre_ParCSRCommPkgRecvProcs(comm_pkg);
+   const HYPRE_Int *recv_starts = hypre_ParCSRCommPkgRecvVecStarts(comm_pkg);
+
+   // We receive rows from the processors that P sends to, and send rows to
+   // the processors that P receives from. The rows received from
+   // send_procs[i] correspond to the local rows send_elmts[send_starts[i]...].
+   requests.SetSize(num_sends + num_recvs);
+   MPI_Request *recv_req = requests.GetData();
+   MPI_Request *send_req = requests.GetData() + num_sends;
+
+   // Exchange the lengths of the rows
+   const int num_recv_rows = send_starts[num_sends];
+   Array<int> send_len(no), recv_len(num_recv_rows);
+   for (int r = 0; r < no; r++) { send_len[r] = Ci[nd+r+1] - Ci[nd+r]; }
+   for (int i = 0; i < num_sends; i++)
+   {
+      MPI_Irecv(recv_len.GetData() + send_starts[i],
+                send_starts[i+1] - send_starts[i], MPI_INT, send_procs[i],
+                tag, comm, &recv_req[i]);
+   }
+   for (int i = 0; i < num_recvs; i++)
+   {
+      MPI_Isend(send_len.GetData() + recv_starts[i],
+                recv_starts[i+1] - recv_starts[i], MPI_INT, recv_procs[i],
+                tag, comm, &send_req[i]);
+   }
+   MPI_Waitall(requests.Size(), requests.GetData(), MPI_STATUSES_IGNORE);
+
+   Array<int> recv_row_offset(num_recv_rows + 1);
+   recv_row_offset[0] = 0;
+   for (int q = 0; q < num_recv_rows; q++)
+   {
+      recv_row_offset[q+1] = recv_row_offset[q] + recv_len[q];
+   }
+   recv_offsets.SetSize(num_sends + 1);
+   for (int i = 0; i <= num_sends; i++)
+   {
+      recv_offsets[i] = recv_row_offset[send_starts[i]];
+   }
+
+   // Exchange the global column indices of the rows
+   const HYPRE_Int first_col = hypre_ParCSRMatrixFirstColDiag(hP);
+   Array<HYPRE_Int> send_cols(Ci[nd+no] - Ci[nd]);
+   Array<HYPRE_Int> recv_cols(recv_offsets[num_sends]);
+   for (int k = Ci[nd]; k < Ci[nd+no]; k++)
+   {
+      const int c = Cj[k];
+      send_cols[k - Ci[nd]] = (c < nd) ? first_col + c : P_cmap[c - nd];
+   }
+   for (int i = 0; i < num_sends; i++)
+   {
+      MPI_Irecv(recv_cols.GetData() + recv_offsets[i],
+                recv_offsets[i+1] - recv_offsets[i], HYPRE_MPI_INT,
+                send_procs[i], tag, comm, &recv_req[i]);
+   }
+   for (int i = 0; i < num_recvs; i++)
+   {
+      const int begin = Ci[nd + recv_starts[i]];
+      const int end = Ci[nd + recv_starts[i+1]];
+      MPI_Isend(send_cols.GetData() + begin - Ci[nd], end - begin,
+                HYPRE_MPI_INT, recv_procs[i], tag, comm, &send_req[i]);
+   }
+   MPI_Waitall(requests.Size(), requests.GetData(), MPI_STATUSES_IGNORE);
+
+   // Off-diagonal columns of the product
+   for (int k = 0; k < Ci[nd]; k++)
+   {
+      if (Cj[k] >= nd) { col_map_offd.Append(P_cmap[Cj[k] - nd]); }
+   }
+   for (int k = 0; k < recv_cols.Size(); k++)
+   {
+      const HYPRE_Int g = recv_cols[k];
+      if (g < first_col || g >= first_col + nd) { col_map_offd.Append(g); }
+   }
+   col_map_offd.Sort();
+   col_map_offd.Unique();
+
+   // Received rows of each local row
+   Array<int> rows_I(nd+1), rows_J(num_recv_rows);
+   rows_I = 0;
+   for (int q = 0; q < num_recv_rows; q++) { rows_I[send_elmts[q]+1]++; }
+   for (int r = 0; r < nd; r++) { rows_I[r+1] += rows_I[r]; }
+   for (int q = 0; q < num_recv_rows; q++)
+   {
+      rows_J[rows_I[send_elmts[q]]++] = q;
+   }
+   for (int r = nd; r > 0; r--) { rows_I[r] = rows_I[r-1]; }
+   rows_I[0] = 0;
+
+   // Structure of the product and position of each contribution, with the
+   // diagonal entry first in each row of the diagonal block, as expected by
+   // hypre for square matrices
+   Array<int> diag_marker(nd), offd_marker(col_map_offd.Size());
+   diag_marker = -1;
+   offd_marker = -1;
+   diag_I.SetSize(nd+1);
+   offd_I.SetSize(nd+1);
+   diag_J.SetSize(0);
+   offd_J.SetSize(0);
+   loc_pos.SetSize(Ci[nd]);
+   recv_pos.SetSize(recv_cols.Size());
+   for (int r = 0; r < nd; r++)
+   {
+      diag_I[r] = diag_J.Size();
+      offd_I[r] = offd_J.Size();
+      diag_marker[r] = diag_J.Append(r) - 1;
+      for (int s = -1; s < rows_I[r+1] - rows_I[r]; s++)
+      {
+         // s = -1: own row, s >= 0: the received rows
+         const int q = (s < 0) ? -1 : rows_J[rows_I[r] + s];
+         const int begin = (s < 0) ? Ci[r] : recv_row_offset[q];
+         const int end = (s < 0) ? Ci[r+1] : recv_row_offset[q+1];
+         for (int k = begin; k < end; k++)
+         {
+            HYPRE_Int g;
+            if (s < 0)
+            {
+               const int c = Cj[k];
+               g = (c < nd) ? first_col + c : P_cmap[c - nd];
+            }
+            else
+            {
+               g = recv_cols[k];
+            }
+            int pos;
+            if (g >= first_col && g < first_col + nd)
+            {
+               const int c = g - first_col;
+               if (diag_marker[c] < diag_I[r])
+               {
+                  diag_marker[c] = diag_J.Append(c) - 1;
+               }
+               pos = diag_marker[c];
+            }
+            else
+            {
+               const int c = std::lower_bound(col_map_offd.begin(),
+                                              col_map_offd.end(), g) -
+                             col_map_offd.begin();
+               if (offd_marker[c] < offd_I[r])
+               {
+                  offd_marker[c] = offd_J.Append(c) - 1;
+               }
+               pos = -1 - offd_marker[c];
+            }
+            if (s < 0) { loc_pos[k] = pos; }
+            else { recv_pos[k] = pos; }
+         }
+      }
+   }
+   diag_I[nd] = diag_J.Size();
+   offd_I[nd] = offd_J.Size();
+}
+
+HypreParMatrix *HypreRAPPlan::CreateMatrix() const
+{
+   const int nd = num_diag_cols;
+   HYPRE_Int *d_i = new HYPRE_Int[nd+1], *o_i = new HYPRE_Int[nd+1];
+   HYPRE_Int *d_j = new HYPRE_Int[diag_J.Size()];
+   HYPRE_Int *o_j = new HYPRE_Int[offd_J.Size()];
+   double *d_data = new double[diag_J.Size()];
+   double *o_data = new double[offd_J.Size()];
+   HYPRE_Int *cmap = new HYPRE_Int[col_map_offd.Size()];
+   for (int r = 0; r <= nd; r++)
+   {
+      d_i[r] = diag_I[r];
+      o_i[r] = offd_I[r];
+   }
+   for (int k = 0; k < diag_J.Size(); k++)
+   {
+      d_j[k] = diag_J[k];
+      d_data[k] = 0.0;
+   }
+   for (int k = 0; k < offd_J.Size(); k++)
+   {
+      o_j[k] = offd_J[k];
+      o_data[k] = 0.0;
+   }
+   for (int k = 0; k < col_map_offd.Size(); k++)
+   {
+      cmap[k] = col_map_offd[k];
+   }
+
+   // The product uses the column partitioning of P for its rows and columns
+   HYPRE_Int *col_starts = const_cast<HYPRE_Int*>(P.ColPart());
+   return new HypreParMatrix(P.GetComm(), P.GetGlobalNumCols(),
+                             P.GetGlobalNumCols(), col_starts, col_starts,
+                             d_i, d_j, d_data, o_i, o_j, o_data,
+                             col_map_offd.Size(), cmap);
+}
+
+void HypreRAPPlan::Mult(const SparseMatrix &A_local, HypreParMatrix &C) const
+{
+   hypre_ParCSRMatrix *hP = P, *hC = C;
+   hypre_CSRMatrix *C_diag = hypre_ParCSRMatrixDiag(hC);
+   hypre_CSRMatrix *C_offd = hypre_ParCSRMatrixOffd(hC);
+   MFEM_VERIFY(hypre_CSRMatrixNumRows(C_diag) == num_diag_cols &&
+               hypre_CSRMatrixNumNonzeros(C_diag) == diag_J.Size() &&
+               hypre_CSRMatrixNumNonzeros(C_offd) == offd_J.Size(),
+               "the output matrix does not match the structure of the product");
+
+   MPI_Comm comm = P.GetComm();
+   const int tag = RAP_PLAN_VALUES_TAG;
+   hypre_ParCSRCommPkg *comm_pkg = hypre_ParCSRMatrixCommPkg(hP);
+   const int num_sends = hypre_ParCSRCommPkgNumSends(comm_pkg);
+   const HYPRE_Int *send_procs = hypre_ParCSRCommPkgSendProcs(comm_pkg);
+   const int num_recvs = hypre_ParCSRCommPkgNumRecvs(comm_pkg);
+   const HYPRE_Int *recv_procs = hypre_ParCSRCommPkgRecvProcs(comm_pkg);
+   const HYPRE_Int *recv_starts = hypre_ParCSRCommPkgRecvVecStarts(comm_pkg);
+   const int nd = num_diag_cols;
+
+   // Compute the local contribution and send the rows owned by other
+   // processors, while the owned rows are added to the product
+   loc_plan->Mult(*P_loc, A_local, *P_loc, *C_loc);
+   const int *Ci = C_loc->HostReadI();
+   double *Cd = C_loc->HostReadWriteData();
+
+   MPI_Request *recv_req = requests.GetData();
+   MPI_Request *send_req = requests.GetData() + num_sends;
+   recv_buf.SetSize(recv_pos.Size());
+   for (int i = 0; i < num_sends; i++)
+   {
+      MPI_Irecv(recv_buf.GetData() + recv_offsets[i],
+                recv_offsets[i+1] - recv_offsets[i], MPI_DOUBLE,
+                send_procs[i], tag, comm, &recv_req[i]);
+   }
+   for (int i = 0; i < num_recvs; i++)
+   {
+      const int begin = Ci[nd + recv_starts[i]];
+      const int end = Ci[nd + recv_starts[i+1]];
+      MPI_Isend(Cd + begin, end - begin, MPI_DOUBLE, recv_procs[i], tag, comm,
+                &send_req[i]);
+   }
+
+   double *diag_data = hypre_CSRMatrixData(C_diag);
+   double *offd_data = hypre_CSRMatrixData(C_offd);
+   for (int k = 0; k < diag_J.Size(); k++) { diag_data[k] = 0.0; }
+   for (int k = 0; k < offd_J.Size(); k++) { offd_data[k] = 0.0; }
+   for (int k = 0; k < loc_pos.Size(); k++)
+   {
+      const int p = loc_pos[k];
+      if (p >= 0) { diag_data[p] += Cd[k]; }
+      else { offd_data[-1-p] += Cd[k]; }
+   }
+
+   MPI_Waitall(num_sends, recv_req, MPI_STATUSES_IGNORE);
+   for (int k = 0; k < recv_pos.Size(); k++)
+   {
+      const int p = recv_pos[k];
+      if (p >= 0) { diag_data[p] += recv_buf(k); }
+      else { offd_data[-1-p] += recv_buf(k); }
+   }
+   MPI_Waitall(num_recvs, send_req, MPI_STATUSES_IGNORE);
+}
+
+HypreParMatrix *HypreRAPPlan::Mult(const SparseMatrix &A_local) const
+{
+   HypreParMatrix *C = CreateMatrix();
+   Mult(A_local, *C);
+   return C;
+}
+
+HypreRAPPlan::~HypreRAPPlan()
+{
+   delete C_loc;
+   delete loc_plan;
+   delete P_loc;
+}
+
 void EliminateBC(HypreParMatrix &A, HypreParMatrix &Ae,
                  const Array<int> &ess_dof_list,
                  const Vector &X, Vector &B)
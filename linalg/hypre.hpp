@@ -453,6 +453,22 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { MultTranspose(1.0, x, 0.0, y); }
 
+   /** @brief Computes Y = a * A * X + b * Y for the multi-vectors @a X and @a Y,
+       whose k columns are local vectors. */
+   /** The k vectors are multiplied together, with a single exchange of the
+       off-processor entries of @a X. @a Y must be of size Height() x k. */
+   void Mult(double a, const DenseMatrix &X, double b, DenseMatrix &Y) const;
+   /// Computes Y = a * A^t * X + b * Y for the multi-vectors @a X and @a Y.
+   void MultTranspose(double a, const DenseMatrix &X,
+                      double b, DenseMatrix &Y) const;
+
+   /// Computes Y = A * X for the multi-vectors @a X and @a Y.
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const
+   { Y.SetSize(Height(), X.Width()); Mult(1.0, X, 0.0, Y); }
+   /// Computes Y = A^t * X for the multi-vectors @a X and @a Y.
+   void MultTranspose(const DenseMatrix &X, DenseMatrix &Y) const
+   { Y.SetSize(Width(), X.Width()); MultTranspose(1.0, X, 0.0, Y); }
+
    /** The "Boolean" analog of y = alpha * A * x + beta * y, where elements in
        the sparsity pattern of the matrix are treated as "true". */
    void BooleanMult(int alpha, const int *x, int beta, int *y)
@@ -568,6 +584,57 @@ HypreParMatrix * RAP(const HypreParMatrix *A, const HypreParMatrix *P);
 HypreParMatrix * RAP(const HypreParMatrix * Rt, const HypreParMatrix *A,
                      const HypreParMatrix *P);
 
+/** @brief Sparsity structure and communication pattern of the triple product
+    P^t A P, where A is the block-diagonal parallel matrix with the local
+    SparseMatrix @a A_local on each processor, for repeated products with the
+    same P and a fixed sparsity of @a A_local. */
+/** This is the product formed by ParBilinearForm::ParallelAssemble(). The
+    local contribution P_loc^t A_local P_loc, where P_loc contains the local
+    rows of P, is computed with a SparseRAPPlan. Its rows that belong to other
+    processors are sent to their owners, in the reverse direction of the
+    communication pattern of P, and are added to the owned rows. The
+    construction exchanges the sparsity of these rows once and computes the
+    structure of the product and the position of each contribution in it, so
+    that Mult() only computes and exchanges the values. P must remain
+    unchanged during the lifetime of the plan. */
+class HypreRAPPlan
+{
+protected:
+   const HypreParMatrix &P;
+   int num_diag_cols;      ///< Number of local columns of P.
+   SparseMatrix *P_loc;    ///< The local rows of P, [P_diag P_offd].
+   SparseRAPPlan *loc_plan;
+   SparseMatrix *C_loc;    ///< The local contribution P_loc^t A_local P_loc.
+
+   /// Structure of the diagonal and off-diagonal blocks of the product.
+   Array<int> diag_I, diag_J, offd_I, offd_J;
+   Array<HYPRE_Int> col_map_offd;
+
+   /** Position of each owned (resp. received) entry of the contribution in the
+       product: p >= 0 for diag entry p, p < 0 for offd entry -1-p. */
+   Array<int> loc_pos, recv_pos;
+   /// Offsets of the entries received from each neighbor.
+   Array<int> recv_offsets;
+
+   mutable Vector recv_buf;
+   mutable Array<MPI_Request> requests;
+
+public:
+   HypreRAPPlan(const SparseMatrix &A_local, const HypreParMatrix &P);
+
+   /// Return a new matrix with the sparsity of the product and zero values.
+   HypreParMatrix *CreateMatrix() const;
+
+   /** @brief Compute C = P^t A P, where C has the structure of the product,
+       i.e. C is returned by CreateMatrix(). */
+   void Mult(const SparseMatrix &A_local, HypreParMatrix &C) const;
+
+   /// Return a new matrix P^t A P.
+   HypreParMatrix *Mult(const SparseMatrix &A_local) const;
+
+   ~HypreRAPPlan();
+};
+
 /** Eliminate essential BC specified by 'ess_dof_list' from the solution X to
     the r.h.s. B. Here A is a matrix with eliminated BC, while Ae is such that
     (A+Ae) is the original (Neumann) matrix before elimination. */
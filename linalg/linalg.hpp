@@ -18,14 +18,18 @@
 #include "operator.hpp"
 #include "matrix.hpp"
 #include "sparsemat.hpp"
+#include "sellmat.hpp"
 #include "complex_operator.hpp"
 #include "blockvector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
 #include "sparsesmoothers.hpp"
+#include "reordering.hpp"
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "amg.hpp"
+#include "mixedprec.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
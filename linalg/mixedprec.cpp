@@ -0,0 +1,328 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the mixed precision matrices and solvers
+
+#include "mixedprec.hpp"
+#include "../general/forall.hpp"
+
+#include <iomanip>
+
+namespace mfem
+{
+
+using namespace std;
+
+FloatSparseMatrix::FloatSparseMatrix(const SparseMatrix &A)
+   : Operator(A.Height(), A.Width())
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   const int nnz = A.NumNonZeroElems();
+   I.SetSize(height + 1);
+   J.SetSize(nnz);
+   data.SetSize(nnz);
+   const int *A_i = A.HostReadI();
+   const int *A_j = A.HostReadJ();
+   const double *A_data = A.HostReadData();
+   for (int i = 0; i <= height; i++) { I[i] = A_i[i]; }
+   for (int k = 0; k < nnz; k++)
+   {
+      J[k] = A_j[k];
+      data[k] = float(A_data[k]);
+   }
+}
+
+// y = a A x, or y += a A x if add is true, for the CSR matrix (I, J, A) with
+// single precision values
+static void FloatCSRMult(const int height, const Array<int> &I,
+                         const Array<int> &J, const Array<float> &A,
+                         const Vector &x, Vector &y, const double a,
+                         const bool add)
+{
+   auto d_I = I.Read();
+   auto d_J = J.Read();
+   auto d_A = A.Read();
+   auto d_x = x.Read();
+   auto d_y = add ? y.ReadWrite() : y.Write();
+   MFEM_FORALL(i, height,
+   {
+      double d = 0.0;
+      const int end = d_I[i+1];
+      for (int k = d_I[i]; k < end; k++)
+      {
+         d += double(d_A[k]) * d_x[d_J[k]];
+      }
+      d_y[i] = add ? d_y[i] + a * d : a * d;
+   });
+}
+
+void FloatSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix height (" << height << ")");
+
+   FloatCSRMult(height, I, J, data, x, y, 1.0, false);
+}
+
+void FloatSparseMatrix::AddMult(const Vector &x, Vector &y,
+                                const double a) const
+{
+   MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix height (" << height << ")");
+
+   FloatCSRMult(height, I, J, data, x, y, a, true);
+}
+
+void FloatSparseMatrix::BuildTranspose() const
+{
+   const int nnz = J.Size();
+   It.SetSize(width + 1);
+   Jt.SetSize(nnz);
+   data_t.SetSize(nnz);
+   const int *h_I = I.HostRead();
+   const int *h_J = J.HostRead();
+   const float *h_A = data.HostRead();
+   int *h_It = It.HostWrite();
+   int *h_Jt = Jt.HostWrite();
+   float *h_At = data_t.HostWrite();
+   for (int j = 0; j <= width; j++) { h_It[j] = 0; }
+   for (int k = 0; k < nnz; k++) { h_It[h_J[k]+1]++; }
+   for (int j = 0; j < width; j++) { h_It[j+1] += h_It[j]; }
+   // The rows of the transpose are filled in increasing order of i
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = h_I[i]; k < h_I[i+1]; k++)
+      {
+         const int pos = h_It[h_J[k]]++;
+         h_Jt[pos] = i;
+         h_At[pos] = h_A[k];
+      }
+   }
+   for (int j = width; j > 0; j--) { h_It[j] = h_It[j-1]; }
+   h_It[0] = 0;
+}
+
+void FloatSparseMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(height == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix height (" << height << ")");
+   MFEM_ASSERT(width == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix width (" << width << ")");
+
+   if (It.Size() == 0) { BuildTranspose(); }
+   FloatCSRMult(width, It, Jt, data_t, x, y, 1.0, false);
+}
+
+void FloatSparseMatrix::GetDiag(Vector &d) const
+{
+   MFEM_VERIFY(height == width, "Matrix must be square, not height = "
+               << height << ", width = " << width);
+
+   d.SetSize(height);
+   auto d_I = I.Read();
+   auto d_J = J.Read();
+   auto d_A = data.Read();
+   auto d_d = d.Write();
+   MFEM_FORALL(i, height,
+   {
+      double di = 0.0;
+      for (int k = d_I[i]; k < d_I[i+1]; k++)
+      {
+         if (d_J[k] == i) { di += double(d_A[k]); }
+      }
+      d_d[i] = di;
+   });
+}
+
+FloatDSmoother::FloatDSmoother(const Operator &A, double damping_)
+   : damping(damping_)
+{
+   SetOperator(A);
+}
+
+void FloatDSmoother::SetOperator(const Operator &op)
+{
+   Vector diag;
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(&op);
+   const FloatSparseMatrix *Af = dynamic_cast<const FloatSparseMatrix*>(&op);
+   if (A)
+   {
+      A->GetDiag(diag);
+   }
+   else if (Af)
+   {
+      Af->GetDiag(diag);
+   }
+   else
+   {
+      MFEM_ABORT("FloatDSmoother requires a SparseMatrix or FloatSparseMatrix");
+   }
+   height = width = op.Height();
+
+   const double *h_diag = diag.HostRead();
+   dinv.SetSize(height);
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(h_diag[i] != 0.0, "zero diagonal entry in row " << i);
+      dinv[i] = float(damping/h_diag[i]);
+   }
+}
+
+void FloatDSmoother::Mult(const Vector &x, Vector &y) const
+{
+   auto d_dinv = dinv.Read();
+   auto d_x = x.Read();
+   auto d_y = y.Write();
+   MFEM_FORALL(i, height, d_y[i] = double(d_dinv[i]) * d_x[i];);
+}
+
+MixedPrecisionRefinementSolver::MixedPrecisionRefinementSolver()
+   : inner_type(GMRES), inner_rel_tol(1e-3), inner_max_iter(200),
+     inner(NULL), own_inner(false), Af(NULL), Mf(NULL)
+{ }
+
+#ifdef MFEM_USE_MPI
+MixedPrecisionRefinementSolver::MixedPrecisionRefinementSolver(MPI_Comm _comm)
+   : IterativeSolver(_comm),
+     inner_type(GMRES), inner_rel_tol(1e-3), inner_max_iter(200),
+     inner(NULL), own_inner(false), Af(NULL), Mf(NULL)
+{ }
+#endif
+
+void MixedPrecisionRefinementSolver::DeleteInnerSolver()
+{
+   if (own_inner) { delete inner; }
+   delete Mf;
+   delete Af;
+   inner = NULL;
+   own_inner = false;
+   Mf = NULL;
+   Af = NULL;
+}
+
+void MixedPrecisionRefinementSolver::SetInnerSolver(Solver &s)
+{
+   DeleteInnerSolver();
+   inner = &s;
+}
+
+void MixedPrecisionRefinementSolver::SetOperator(const Operator &op)
+{
+   IterativeSolver::SetOperator(op);
+   r.SetSize(height);
+   d.SetSize(height);
+   r.UseDevice(true);
+   d.UseDevice(true);
+
+   if (inner && !own_inner) { return; }
+
+   DeleteInnerSolver();
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix*>(&op);
+   if (!A) { return; }
+
+   Af = new FloatSparseMatrix(*A);
+   Mf = new FloatDSmoother(*Af);
+   IterativeSolver *krylov;
+   if (inner_type == CG)
+   {
+      krylov = new CGSolver;
+   }
+   else
+   {
+      krylov = new GMRESSolver;
+   }
+   krylov->SetOperator(*Af);
+   krylov->SetPreconditioner(*Mf);
+   krylov->SetRelTol(inner_rel_tol);
+   krylov->SetAbsTol(0.0);
+   krylov->SetMaxIter(inner_max_iter);
+   krylov->SetPrintLevel(-1);
+   krylov->iterative_mode = false;
+   inner = krylov;
+   own_inner = true;
+}
+
+void MixedPrecisionRefinementSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(oper != NULL, "the operator is not set");
+   MFEM_VERIFY(inner != NULL, "the inner solver is not set, see "
+               "SetInnerSolver()");
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   double nom = Norm(r);
+   MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  ||r|| = "
+                << nom << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   const double r0 = std::max(nom*rel_tol, abs_tol);
+   converged = 0;
+   final_iter = max_iter;
+   if (nom <= r0)
+   {
+      converged = 1;
+      final_iter = 0;
+   }
+   for (int i = 1; !converged && i <= max_iter; i++)
+   {
+      d = 0.0;
+      inner->Mult(r, d);   // d ~ A^{-1} r, in the precision of the inner solver
+      x += d;              // x = x + d
+      oper->Mult(x, r);
+      subtract(b, r, r);   // r = b - A x
+      nom = Norm(r);
+      MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  ||r|| = "
+                   << nom << '\n';
+      }
+      if (nom <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+      }
+   }
+   final_norm = nom;
+
+   if (print_level == 2)
+   {
+      mfem::out << "Number of refinement iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << final_iter << "  ||r|| = "
+                << final_norm << '\n';
+   }
+   if (!converged && print_level >= 0)
+   {
+      mfem::out << "MixedPrecisionRefinementSolver: No convergence!\n";
+   }
+}
+
+}
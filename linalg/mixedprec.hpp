@@ -0,0 +1,158 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MIXEDPREC
+#define MFEM_MIXEDPREC
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+
+namespace mfem
+{
+
+/// Single precision copy of a finalized SparseMatrix
+/** The values of the matrix are stored in single precision, while the products
+    use double precision vectors and accumulate in double precision. Compared
+    to SparseMatrix, the products move 8 instead of 12 bytes per nonzero, which
+    makes this class suitable as the operator of the inner solver of
+    MixedPrecisionRefinementSolver. All products run on the device; the
+    transpose is stored in the first call to MultTranspose(). */
+class FloatSparseMatrix : public Operator
+{
+protected:
+   Array<int> I, J;
+   Array<float> data;
+
+   /// The transpose, in the same format, see BuildTranspose().
+   mutable Array<int> It, Jt;
+   mutable Array<float> data_t;
+
+   /// Build the transpose, used in MultTranspose().
+   void BuildTranspose() const;
+
+public:
+   /// Create a single precision copy of the finalized matrix @a A.
+   FloatSparseMatrix(const SparseMatrix &A);
+
+   /// Matrix vector multiplication, y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Multiply by the transpose, y = A^t x.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// Return the diagonal of the matrix in @a d.
+   void GetDiag(Vector &d) const;
+
+   /// Return the number of stored entries.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /// Return the single precision values of the matrix.
+   const Array<float> &GetData() const { return data; }
+};
+
+/// Jacobi preconditioner with the inverse diagonal in single precision
+class FloatDSmoother : public Solver
+{
+protected:
+   Array<float> dinv;
+   double damping;
+
+public:
+   /** Create the preconditioner y = damping D^{-1} x from the diagonal of
+       @a A, which must be a SparseMatrix or a FloatSparseMatrix. */
+   FloatDSmoother(const Operator &A, double damping_ = 1.0);
+
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/// Mixed precision iterative refinement
+/** The residual r = b - A x and the updates x = x + d are computed in double
+    precision with the operator given to SetOperator(), while the corrections
+    d ~ A^{-1} r are computed by an inner solver to a loose relative tolerance.
+
+    When the operator is a SparseMatrix, the default inner solver is a CG or
+    GMRES solver (see SetInnerSolverType()) with a FloatSparseMatrix copy of
+    the matrix and a FloatDSmoother preconditioner. Any other inner solver,
+    e.g. with a single precision partial assembly operator, can be given with
+    SetInnerSolver(). The iteration converges to double precision accuracy as
+    long as the inner solver reduces the residual.
+
+    The tolerances of the outer iteration are set with the usual
+    IterativeSolver methods and apply to the norm of the double precision
+    residual. Alternatively, the inner solver can be used as a (variable)
+    preconditioner of FGMRESSolver.
+
+    @note Only the matrix and the preconditioner of the default inner solver
+    are stored in single precision: the Krylov vectors and their dot products
+    are in double precision, since the Krylov solvers operate on Vector. The
+    savings come from the memory traffic of the matrix, which dominates the
+    cost of an iteration for sparse matrices. */
+class MixedPrecisionRefinementSolver : public IterativeSolver
+{
+public:
+   /// Krylov method of the default inner solver.
+   enum InnerSolverType { CG, GMRES };
+
+protected:
+   InnerSolverType inner_type;
+   double inner_rel_tol;
+   int inner_max_iter;
+
+   /// The inner solver, owned if built in SetOperator().
+   Solver *inner;
+   bool own_inner;
+   FloatSparseMatrix *Af;
+   FloatDSmoother *Mf;
+
+   mutable Vector r, d;
+
+   void DeleteInnerSolver();
+
+public:
+   MixedPrecisionRefinementSolver();
+
+#ifdef MFEM_USE_MPI
+   MixedPrecisionRefinementSolver(MPI_Comm _comm);
+#endif
+
+   /// Set the Krylov method of the default inner solver, default is GMRES.
+   void SetInnerSolverType(InnerSolverType type) { inner_type = type; }
+
+   /// Set the relative tolerance of the default inner solver, default is 1e-3.
+   void SetInnerRelTol(double rtol) { inner_rel_tol = rtol; }
+
+   /** @brief Set the maximum number of iterations of the default inner
+       solver, default is 200. */
+   void SetInnerMaxIter(int max_it) { inner_max_iter = max_it; }
+
+   /** @brief Use @a s as the inner solver, with its own operator. It is
+       applied with zero initial guess. */
+   void SetInnerSolver(Solver &s);
+
+   /** @brief Set the double precision operator. If it is a SparseMatrix and no
+       inner solver was given with SetInnerSolver(), the default inner solver
+       is built. The parameters must be set before. */
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~MixedPrecisionRefinementSolver() { DeleteInnerSolver(); }
+};
+
+}
+
+#endif
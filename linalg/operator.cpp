@@ -391,16 +391,32 @@ ConstrainedOperator::ConstrainedOperator(Operator *A, const Array<int> &list,
    // 'mem_class' should work with A->Mult() and MFEM_FORALL():
    mem_class = A->GetMemoryClass()*Device::GetMemoryClass();
    MemoryType mem_type = GetMemoryType(mem_class);
-   list.Read(); // TODO: just ensure 'list' is registered, no need to copy it
-   constraint_list.MakeRef(list);
    // typically z and w are large vectors, so store them on the device
    z.SetSize(height, mem_type); z.UseDevice(true);
    w.SetSize(height, mem_type); w.UseDevice(true);
+   w = 0.0; // only the constrained entries of w are modified
+   SetConstraints(list);
+}
+
+void ConstrainedOperator::SetConstraints(const Array<int> &list)
+{
+   list.Read(); // TODO: just ensure 'list' is registered, no need to copy it
+   constraint_list.MakeRef(list);
+   xc.SetSize(constraint_list.Size(), GetMemoryType(mem_class));
+   xc.UseDevice(true);
+   // constraint_marker[i] is the position of i in the list, or -1
+   constraint_marker.SetSize(height);
+   int *marker = constraint_marker.HostWrite();
+   for (int i = 0; i < height; i++) { marker[i] = -1; }
+   const int *h_list = constraint_list.HostRead();
+   for (int i = 0; i < constraint_list.Size(); i++)
+   {
+      marker[h_list[i]] = i;
+   }
 }
 
 void ConstrainedOperator::EliminateRHS(const Vector &x, Vector &b) const
 {
-   w = 0.0;
    const int csz = constraint_list.Size();
    auto idx = constraint_list.Read();
    auto d_x = x.Read();
@@ -416,12 +432,14 @@ void ConstrainedOperator::EliminateRHS(const Vector &x, Vector &b) const
    A->Mult(w, z);
    b -= z;
 
-   // Use read+write access - we are modifying sub-vector of b
+   // Use read+write access - we are modifying sub-vectors of b and w
    auto d_b = b.ReadWrite();
+   d_w = w.ReadWrite();
    MFEM_FORALL(i, csz,
    {
       const int id = idx[i];
       d_b[id] = d_x[id];
+      d_w[id] = 0.0;
    });
 }
 
@@ -434,22 +452,28 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
       return;
    }
 
-   z = x;
-
-   auto idx = constraint_list.Read();
-   // Use read+write access - we are modifying sub-vector of z
-   auto d_z = z.ReadWrite();
-   MFEM_FORALL(i, csz, d_z[idx[i]] = 0.0;);
+   // Copy x to z with the constrained entries set to zero, saving them in xc
+   auto marker = constraint_marker.Read();
+   auto d_x = x.Read();
+   auto d_z = z.Write();
+   auto d_xc = xc.Write();
+   MFEM_FORALL(i, height,
+   {
+      const int k = marker[i];
+      const double xi = d_x[i];
+      if (k >= 0) { d_xc[k] = xi; }
+      d_z[i] = (k >= 0) ? 0.0 : xi;
+   });
 
    A->Mult(z, y);
 
-   auto d_x = x.Read();
    // Use read+write access - we are modifying sub-vector of y
+   auto idx = constraint_list.Read();
    auto d_y = y.ReadWrite();
    MFEM_FORALL(i, csz,
    {
       const int id = idx[i];
-      d_y[id] = d_x[id];
+      d_y[id] = d_xc[marker[id]];
    });
 }
 
@@ -612,10 +612,12 @@ public:
 class ConstrainedOperator : public Operator
 {
 protected:
-   Array<int> constraint_list;  ///< List of constrained indices/dofs.
-   Operator *A;                 ///< The unconstrained Operator.
-   bool own_A;                  ///< Ownership flag for A.
-   mutable Vector z, w;         ///< Auxiliary vectors.
+   Array<int> constraint_list;   ///< List of constrained indices/dofs.
+   Operator *A;                  ///< The unconstrained Operator.
+   bool own_A;                   ///< Ownership flag for A.
+   mutable Vector z, w;          ///< Auxiliary vectors.
+   mutable Vector xc;            ///< Constrained entries of the input.
+   Array<int> constraint_marker; ///< Position in constraint_list, or -1.
    MemoryClass mem_class;
 
 public:
@@ -625,9 +627,17 @@ public:
        Specify the unconstrained operator @a *A and a @a list of indices to
        constrain, i.e. each entry @a list[i] represents an essential-dof. If the
        ownership flag @a own_A is true, the operator @a *A will be destroyed
-       when this object is destroyed. */
+       when this object is destroyed.
+
+       The @a list is referenced, not copied, and must not be changed while it
+       is used by this object, since the marker of the constrained entries is
+       built from it here; use SetConstraints() to change the list. */
    ConstrainedOperator(Operator *A, const Array<int> &list, bool own_A = false);
 
+   /** @brief Set a new @a list of constrained indices/dofs, referenced like
+       in the constructor, and rebuild the marker of the constrained entries. */
+   void SetConstraints(const Array<int> &list);
+
    /// Returns the type of memory in which the solution and temporaries are stored.
    virtual MemoryClass GetMemoryClass() const { return mem_class; }
 
@@ -639,7 +649,9 @@ public:
            z = A((0,x_b));  b_i -= z_i;  b_b = x_b;
 
        where the "_b" subscripts denote the essential (boundary) indices/dofs of
-       the vectors, and "_i" -- the rest of the entries. */
+       the vectors, and "_i" -- the rest of the entries. The auxiliary vector
+       (0,x_b) is kept zero between calls, so only the constrained entries are
+       accessed before and after the action of A. */
    void EliminateRHS(const Vector &x, Vector &b) const;
 
    /** @brief Constrained operator action.
@@ -649,7 +661,11 @@ public:
            z = A((x_i,0));  y_i = z_i;  y_b = x_b;
 
        where the "_b" subscripts denote the essential (boundary) indices/dofs of
-       the vectors, and "_i" -- the rest of the entries. */
+       the vectors, and "_i" -- the rest of the entries.
+
+       The vector (x_i,0) is formed in an auxiliary vector, which also saves
+       x_b, in a single device kernel, so @a x is not modified and @a x and
+       @a y may alias. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
    /// Destructor: destroys the unconstrained Operator, if owned.
@@ -0,0 +1,655 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the sparse matrix reorderings
+
+#include "reordering.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace mfem
+{
+
+typedef std::vector<std::vector<int>> AdjacencyLists;
+
+// Adjacency of the symmetrized graph of A, without the diagonal, with sorted
+// and unique neighbor lists
+static void SymmetricAdjacency(const SparseMatrix &A, AdjacencyLists &adj)
+{
+   MFEM_VERIFY(A.Height() == A.Width(), "the matrix must be square");
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   const int n = A.Height();
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+
+   adj.assign(n, std::vector<int>());
+   for (int i=0; i<n; ++i)
+   {
+      for (int k=I[i]; k<I[i+1]; ++k)
+      {
+         int j = J[k];
+         if (j == i) { continue; }
+         adj[i].push_back(j);
+         adj[j].push_back(i);
+      }
+   }
+   for (int i=0; i<n; ++i)
+   {
+      std::sort(adj[i].begin(), adj[i].end());
+      adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+   }
+}
+
+void ReverseCuthillMcKeeOrdering(const SparseMatrix &A, Array<int> &p)
+{
+   const int n = A.Height();
+   AdjacencyLists adj;
+   SymmetricAdjacency(A, adj);
+
+   std::vector<int> degree(n), by_degree(n);
+   for (int i=0; i<n; ++i)
+   {
+      degree[i] = adj[i].size();
+      by_degree[i] = i;
+   }
+   auto lower_degree = [&degree](int i, int j)
+   {
+      return degree[i] < degree[j] || (degree[i] == degree[j] && i < j);
+   };
+   std::sort(by_degree.begin(), by_degree.end(), lower_degree);
+
+   // Breadth-first search from root, returning the depth of the level
+   // structure. The visited nodes are queue[0], ..., queue[num-1] and the last
+   // level starts at queue[last].
+   std::vector<int> mark(n, -1), queue(n);
+   int stamp = 0;
+   auto bfs = [&](int root, int &num, int &last)
+   {
+      ++stamp;
+      queue[0] = root;
+      mark[root] = stamp;
+      num = 1;
+      last = 0;
+      int depth = 0;
+      for (int begin = 0; begin < num; ++depth)
+      {
+         int end = num;
+         last = begin;
+         for (int q=begin; q<end; ++q)
+         {
+            for (int j : adj[queue[q]])
+            {
+               if (mark[j] != stamp)
+               {
+                  mark[j] = stamp;
+                  queue[num++] = j;
+               }
+            }
+         }
+         begin = end;
+      }
+      return depth;
+   };
+
+   std::vector<int> order;
+   order.reserve(n);
+   std::vector<bool> placed(n, false);
+   std::vector<int> neighbors;
+   for (int r : by_degree)
+   {
+      if (placed[r]) { continue; }
+
+      // Find a pseudo-peripheral root in the connected component of r, starting
+      // from its node of minimum degree
+      int root = r, num, last;
+      int depth = bfs(root, num, last);
+      while (true)
+      {
+         int candidate = queue[last];
+         for (int q=last+1; q<num; ++q)
+         {
+            if (lower_degree(queue[q], candidate)) { candidate = queue[q]; }
+         }
+         int candidate_depth = bfs(candidate, num, last);
+         if (candidate_depth <= depth) { break; }
+         root = candidate;
+         depth = candidate_depth;
+      }
+
+      // Cuthill-McKee ordering of the component: visit the neighbors in order
+      // of increasing degree
+      size_t q = order.size();
+      order.push_back(root);
+      placed[root] = true;
+      for (; q<order.size(); ++q)
+      {
+         neighbors.clear();
+         for (int j : adj[order[q]])
+         {
+            if (!placed[j])
+            {
+               placed[j] = true;
+               neighbors.push_back(j);
+            }
+         }
+         std::sort(neighbors.begin(), neighbors.end(), lower_degree);
+         order.insert(order.end(), neighbors.begin(), neighbors.end());
+      }
+   }
+
+   // Reverse the ordering
+   p.SetSize(n);
+   for (int i=0; i<n; ++i)
+   {
+      p[i] = order[n-1-i];
+   }
+}
+
+// Approximate minimum degree ordering of the graph with adjacency lists adj,
+// appended to order
+static void AMDOrdering(const AdjacencyLists &adj, std::vector<int> &order)
+{
+   const int n = adj.size();
+
+   // Quotient graph: each variable i is adjacent to the variables A[i] and to
+   // the elements E[i]; element e, created by the elimination of node e, is
+   // the clique of the variables L[e]. The lists may contain absorbed elements
+   // and eliminated nodes, which are skipped and removed lazily.
+   enum { VARIABLE, ELEMENT, ABSORBED };
+   AdjacencyLists A(adj), E(n), L(n);
+   std::vector<int> status(n, VARIABLE), degree(n);
+   std::vector<int> mark(n, -1), w(n), w_step(n, -1);
+
+   // Doubly linked lists of the variables with the same approximate degree
+   std::vector<int> head(n, -1), next(n), prev(n);
+   int min_degree = n;
+   auto insert = [&](int i, int d)
+   {
+      degree[i] = d;
+      prev[i] = -1;
+      next[i] = head[d];
+      if (head[d] >= 0) { prev[head[d]] = i; }
+      head[d] = i;
+      min_degree = std::min(min_degree, d);
+   };
+   auto remove = [&](int i)
+   {
+      if (prev[i] >= 0) { next[prev[i]] = next[i]; }
+      else { head[degree[i]] = next[i]; }
+      if (next[i] >= 0) { prev[next[i]] = prev[i]; }
+   };
+   for (int i=0; i<n; ++i) { insert(i, adj[i].size()); }
+
+   std::vector<int> Lp, keep;
+   for (int k=0; k<n; ++k)
+   {
+      // Select the pivot of minimum approximate degree
+      while (head[min_degree] < 0) { ++min_degree; }
+      const int piv = head[min_degree];
+      remove(piv);
+      order.push_back(piv);
+      status[piv] = ELEMENT;
+
+      // The new element is the union of the adjacent variables and of the
+      // variables of the adjacent elements, which are absorbed
+      mark[piv] = k;
+      Lp.clear();
+      for (int j : A[piv])
+      {
+         if (status[j] == VARIABLE && mark[j] != k)
+         {
+            mark[j] = k;
+            Lp.push_back(j);
+         }
+      }
+      for (int e : E[piv])
+      {
+         if (status[e] != ELEMENT) { continue; }
+         for (int j : L[e])
+         {
+            if (status[j] == VARIABLE && mark[j] != k)
+            {
+               mark[j] = k;
+               Lp.push_back(j);
+            }
+         }
+         status[e] = ABSORBED;
+         std::vector<int>().swap(L[e]);
+      }
+      std::vector<int>().swap(A[piv]);
+      std::vector<int>().swap(E[piv]);
+      L[piv] = Lp;
+      const int Lp_size = Lp.size();
+
+      // w[e] = |L[e] \ Lp| for the elements adjacent to the variables of Lp
+      for (int i : Lp)
+      {
+         remove(i);
+         for (int e : E[i])
+         {
+            if (status[e] != ELEMENT) { continue; }
+            if (w_step[e] != k)
+            {
+               w_step[e] = k;
+               w[e] = L[e].size();
+            }
+            w[e]--;
+         }
+      }
+
+      // Update the lists and the approximate external degree of the variables
+      // in Lp
+      const int num_remaining = n-k-1;
+      for (int i : Lp)
+      {
+         // Elements adjacent to i, absorbing the ones covered by Lp
+         int d_elem = 0;
+         keep.clear();
+         for (int e : E[i])
+         {
+            if (status[e] != ELEMENT) { continue; }
+            if (w[e] == 0)
+            {
+               status[e] = ABSORBED;
+               std::vector<int>().swap(L[e]);
+               continue;
+            }
+            d_elem += w[e];
+            keep.push_back(e);
+         }
+         keep.push_back(piv);
+         E[i].swap(keep);
+
+         // Adjacent variables, without the ones connected through Lp
+         keep.clear();
+         for (int j : A[i])
+         {
+            if (status[j] == VARIABLE && mark[j] != k) { keep.push_back(j); }
+         }
+         A[i].swap(keep);
+
+         int d = A[i].size() + (Lp_size-1) + d_elem;
+         d = std::min(d, degree[i] + Lp_size-1);
+         d = std::min(d, num_remaining-1);
+         insert(i, std::max(d, 0));
+      }
+   }
+}
+
+void ApproximateMinimumDegreeOrdering(const SparseMatrix &A, Array<int> &p)
+{
+   AdjacencyLists adj;
+   SymmetricAdjacency(A, adj);
+   std::vector<int> order;
+   order.reserve(adj.size());
+   AMDOrdering(adj, order);
+   p.SetSize(order.size());
+   for (int i=0; i<p.Size(); ++i) { p[i] = order[i]; }
+}
+
+// Recursive nested dissection of the subgraphs of a graph
+class NestedDissection
+{
+private:
+   const AdjacencyLists &adj;
+   const int leaf_size;
+   // part[i]: the subgraph containing node i, local[i]: its index in a leaf
+   std::vector<int> part, local, level;
+   int num_parts;
+
+   // Breadth-first search from root within the subgraph sub, storing the level
+   // of each visited node and the visited nodes in queue. Returns the depth of
+   // the level structure.
+   int LevelStructure(int root, int sub, std::vector<int> &queue)
+   {
+      queue.clear();
+      queue.push_back(root);
+      level[root] = 0;
+      int depth = 0;
+      for (size_t q=0; q<queue.size(); ++q)
+      {
+         const int i = queue[q];
+         depth = level[i] + 1;
+         for (int j : adj[i])
+         {
+            if (part[j] == sub && level[j] < 0)
+            {
+               level[j] = level[i] + 1;
+               queue.push_back(j);
+            }
+         }
+      }
+      return depth;
+   }
+
+   void ResetLevels(const std::vector<int> &nodes)
+   {
+      for (int i : nodes) { level[i] = -1; }
+   }
+
+   void OrderLeaf(const std::vector<int> &nodes, std::vector<int> &order)
+   {
+      const int n = nodes.size();
+      const int sub = part[nodes[0]];
+      for (int i=0; i<n; ++i) { local[nodes[i]] = i; }
+      AdjacencyLists sub_adj(n);
+      for (int i=0; i<n; ++i)
+      {
+         for (int j : adj[nodes[i]])
+         {
+            if (part[j] == sub) { sub_adj[i].push_back(local[j]); }
+         }
+      }
+      std::vector<int> sub_order;
+      sub_order.reserve(n);
+      AMDOrdering(sub_adj, sub_order);
+      for (int i : sub_order) { order.push_back(nodes[i]); }
+   }
+
+   // Move the nodes to a new subgraph
+   int NewPart(const std::vector<int> &nodes)
+   {
+      const int sub = num_parts++;
+      for (int i : nodes) { part[i] = sub; }
+      return sub;
+   }
+
+public:
+   NestedDissection(const AdjacencyLists &adj_, int leaf_size_)
+      : adj(adj_), leaf_size(leaf_size_), part(adj_.size(), 0),
+        local(adj_.size()), level(adj_.size(), -1), num_parts(1) { }
+
+   // Append the ordering of the nodes, which form the subgraph part[nodes[i]],
+   // to order
+   void Order(const std::vector<int> &nodes, std::vector<int> &order)
+   {
+      const int n = nodes.size();
+      if (n == 0) { return; }
+      if (n <= leaf_size)
+      {
+         OrderLeaf(nodes, order);
+         return;
+      }
+      const int sub = part[nodes[0]];
+
+      // Label the connected components in one sweep. The small components are
+      // gathered into leaves of at most leaf_size nodes and the large ones are
+      // dissected separately.
+      std::vector<int> queue, leaf;
+      AdjacencyLists components;
+      for (int i : nodes)
+      {
+         if (level[i] >= 0) { continue; }
+         LevelStructure(i, sub, queue);
+         if ((int) queue.size() == n)
+         {
+            ResetLevels(queue);
+            Dissect(nodes, order);
+            return;
+         }
+         if ((int) queue.size() > leaf_size)
+         {
+            components.push_back(queue);
+            continue;
+         }
+         if (leaf.size() + queue.size() > (size_t) leaf_size)
+         {
+            NewPart(leaf);
+            OrderLeaf(leaf, order);
+            leaf.clear();
+         }
+         leaf.insert(leaf.end(), queue.begin(), queue.end());
+      }
+      ResetLevels(nodes);
+      if (leaf.size() > 0)
+      {
+         NewPart(leaf);
+         OrderLeaf(leaf, order);
+      }
+      for (const std::vector<int> &component : components)
+      {
+         NewPart(component);
+         Dissect(component, order);
+      }
+   }
+
+private:
+   // Append the ordering of the nodes, which form the connected subgraph
+   // part[nodes[i]], to order
+   void Dissect(const std::vector<int> &nodes, std::vector<int> &order)
+   {
+      const int n = nodes.size();
+      const int sub = part[nodes[0]];
+
+      // Pseudo-peripheral root: restart from a node of minimum degree in the
+      // last level while the depth increases
+      std::vector<int> queue;
+      int depth = LevelStructure(nodes[0], sub, queue);
+      while (true)
+      {
+         int candidate = queue.back();
+         for (int q=queue.size()-1; q>=0 && level[queue[q]]==depth-1; --q)
+         {
+            if (adj[queue[q]].size() < adj[candidate].size())
+            {
+               candidate = queue[q];
+            }
+         }
+         ResetLevels(queue);
+         const int candidate_depth = LevelStructure(candidate, sub, queue);
+         const bool deeper = (candidate_depth > depth);
+         depth = candidate_depth;
+         if (!deeper) { break; }
+      }
+      if (depth < 3)
+      {
+         // No level separates the graph
+         ResetLevels(queue);
+         OrderLeaf(nodes, order);
+         return;
+      }
+
+      // The level which best balances the nodes before and after it is the
+      // separator
+      std::vector<int> level_size(depth, 0);
+      for (int i : queue) { level_size[level[i]]++; }
+      int sep_level = 1, below = level_size[0], best = n;
+      for (int l=1; l<depth-1; ++l)
+      {
+         const int above = n - below - level_size[l];
+         if (std::abs(above - below) < best)
+         {
+            best = std::abs(above - below);
+            sep_level = l;
+         }
+         below += level_size[l];
+      }
+
+      // Assign the nodes to the parts, 0: before, 1: after, 2: separator
+      std::vector<int> side(n);
+      for (int i=0; i<n; ++i)
+      {
+         const int l = level[nodes[i]];
+         side[i] = (l < sep_level) ? 0 : (l > sep_level ? 1 : 2);
+         local[nodes[i]] = i;
+      }
+      ResetLevels(queue);
+
+      // Thin the separator: a separator node which is not adjacent to one of
+      // the parts can be moved to the other one
+      for (int s=0; s<2; ++s)
+      {
+         for (int i=0; i<n; ++i)
+         {
+            if (side[i] != 2) { continue; }
+            bool adjacent = false;
+            for (int j : adj[nodes[i]])
+            {
+               if (part[j] == sub && side[local[j]] == 1-s)
+               {
+                  adjacent = true;
+                  break;
+               }
+            }
+            if (!adjacent) { side[i] = s; }
+         }
+      }
+
+      std::vector<int> first, second, separator;
+      for (int i=0; i<n; ++i)
+      {
+         if (side[i] == 0) { first.push_back(nodes[i]); }
+         else if (side[i] == 1) { second.push_back(nodes[i]); }
+         else { separator.push_back(nodes[i]); }
+      }
+      NewPart(first);
+      NewPart(second);
+      NewPart(separator);
+      Order(first, order);
+      Order(second, order);
+      order.insert(order.end(), separator.begin(), separator.end());
+   }
+};
+
+void NestedDissectionOrdering(const SparseMatrix &A, Array<int> &p,
+                              int leaf_size)
+{
+   MFEM_VERIFY(leaf_size > 0, "invalid leaf size: " << leaf_size);
+   AdjacencyLists adj;
+   SymmetricAdjacency(A, adj);
+   const int n = adj.size();
+   std::vector<int> nodes(n), order;
+   for (int i=0; i<n; ++i) { nodes[i] = i; }
+   order.reserve(n);
+   NestedDissection nd(adj, leaf_size);
+   nd.Order(nodes, order);
+   MFEM_ASSERT((int) order.size() == n, "internal error");
+   p.SetSize(n);
+   for (int i=0; i<n; ++i) { p[i] = order[i]; }
+}
+
+void InvertPermutation(const Array<int> &p, Array<int> &p_inv)
+{
+   const int n = p.Size();
+   p_inv.SetSize(n);
+   p_inv = -1;
+   for (int i=0; i<n; ++i)
+   {
+      MFEM_ASSERT(p[i] >= 0 && p[i] < n && p_inv[p[i]] < 0,
+                  "invalid permutation");
+      p_inv[p[i]] = i;
+   }
+}
+
+SparseMatrix *PermuteSparseMatrix(const SparseMatrix &A,
+                                  const Array<int> &row_p,
+                                  const Array<int> &col_p)
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   const int height = A.Height(), width = A.Width();
+   MFEM_VERIFY(row_p.Size() == 0 || row_p.Size() == height,
+               "invalid row permutation");
+   MFEM_VERIFY(col_p.Size() == 0 || col_p.Size() == width,
+               "invalid column permutation");
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+   const double *V = A.HostReadData();
+
+   Array<int> col_p_inv;
+   if (col_p.Size() > 0) { InvertPermutation(col_p, col_p_inv); }
+
+   int *BI = new int[height+1];
+   int *BJ = new int[A.NumNonZeroElems()];
+   double *BV = new double[A.NumNonZeroElems()];
+   BI[0] = 0;
+   for (int i=0; i<height; ++i)
+   {
+      const int row = (row_p.Size() > 0) ? row_p[i] : i;
+      int nnz = BI[i];
+      for (int k=I[row]; k<I[row+1]; ++k, ++nnz)
+      {
+         BJ[nnz] = (col_p.Size() > 0) ? col_p_inv[J[k]] : J[k];
+         BV[nnz] = V[k];
+      }
+      BI[i+1] = nnz;
+   }
+   SparseMatrix *B = new SparseMatrix(BI, BJ, BV, height, width);
+   B->SortColumnIndices();
+   return B;
+}
+
+void PermuteVector(const Vector &x, const Array<int> &p, Vector &y,
+                   bool inverse)
+{
+   const int n = p.Size();
+   MFEM_VERIFY(x.Size() == n, "incompatible sizes");
+   MFEM_VERIFY(&x != &y, "the vectors must be different");
+   y.SetSize(n);
+   const double *xd = x.HostRead();
+   double *yd = y.HostWrite();
+   for (int i=0; i<n; ++i)
+   {
+      if (inverse) { yd[p[i]] = xd[i]; }
+      else { yd[i] = xd[p[i]]; }
+   }
+}
+
+int Bandwidth(const SparseMatrix &A)
+{
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+   int bw = 0;
+   for (int i=0; i<A.Height(); ++i)
+   {
+      for (int k=I[i]; k<I[i+1]; ++k)
+      {
+         bw = std::max(bw, std::abs(i - J[k]));
+      }
+   }
+   return bw;
+}
+
+long CholeskyFactorNonZeros(const SparseMatrix &A, const Array<int> &p)
+{
+   AdjacencyLists adj;
+   SymmetricAdjacency(A, adj);
+   const int n = adj.size();
+   MFEM_VERIFY(p.Size() == 0 || p.Size() == n, "invalid permutation");
+   Array<int> p_inv;
+   if (p.Size() > 0) { InvertPermutation(p, p_inv); }
+
+   // The nonzeros of row i of the factor are the nodes of the subtree of the
+   // elimination tree reached from the entries A(i,j), j < i, of the row
+   std::vector<int> parent(n, -1), mark(n, -1);
+   long nnz = 0;
+   for (int i=0; i<n; ++i)
+   {
+      mark[i] = i;
+      nnz++;
+      const int row = (p.Size() > 0) ? p[i] : i;
+      for (int c : adj[row])
+      {
+         const int k = (p.Size() > 0) ? p_inv[c] : c;
+         if (k > i) { continue; }
+         for (int j = k; mark[j] != i; j = parent[j])
+         {
+            if (parent[j] < 0) { parent[j] = i; }
+            mark[j] = i;
+            nnz++;
+         }
+      }
+   }
+   return nnz;
+}
+
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_REORDERING
+#define MFEM_REORDERING
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @name Symmetric reorderings of sparse matrices
+
+    The orderings below are computed from the graph of the symmetrized
+    sparsity pattern of a square SparseMatrix, i.e. the pattern of A + A^t
+    without the diagonal; the values of the matrix are not used. The returned
+    permutation @a p maps the new indices to the old ones: row/column i of the
+    reordered matrix is row/column p[i] of the original one, see
+    PermuteSparseMatrix(). */
+///@{
+
+/** @brief Reverse Cuthill-McKee ordering, which reduces the bandwidth and the
+    profile of the matrix.
+
+    Each connected component is ordered by a breadth-first search from a
+    pseudo-peripheral node, visiting the neighbors in order of increasing
+    degree, and the resulting ordering is reversed. Besides reducing the fill
+    of banded factorizations, the ordering improves the locality of the vector
+    accesses in the matrix-vector product. */
+void ReverseCuthillMcKeeOrdering(const SparseMatrix &A, Array<int> &p);
+
+/** @brief Approximate minimum degree ordering, which reduces the fill of the
+    Cholesky and LU factorizations.
+
+    The elimination is simulated on the quotient graph, where each eliminated
+    node is represented by an element, i.e. the clique of its uneliminated
+    neighbors, with absorption of the elements covered by the new one. At each
+    step the node of minimum approximate external degree is eliminated, using
+    the upper bound of Amestoy, Davis and Duff. Supervariables are not
+    detected. */
+void ApproximateMinimumDegreeOrdering(const SparseMatrix &A, Array<int> &p);
+
+/** @brief Nested dissection ordering, which reduces the fill of the Cholesky
+    and LU factorizations, especially for matrices from 3D discretizations.
+
+    The graph is recursively split into two parts by a vertex separator,
+    obtained from a level structure rooted at a pseudo-peripheral node, and the
+    separator is ordered after the two parts. Subgraphs with at most
+    @a leaf_size nodes are ordered with the approximate minimum degree
+    algorithm. This is a native implementation which does not need METIS. */
+void NestedDissectionOrdering(const SparseMatrix &A, Array<int> &p,
+                              int leaf_size = 64);
+
+///@}
+
+/// Compute the inverse @a p_inv of the permutation @a p, p_inv[p[i]] = i.
+void InvertPermutation(const Array<int> &p, Array<int> &p_inv);
+
+/** @brief Return the matrix B with B(i,j) = A(row_p[i], col_p[j]).
+
+    An empty permutation is the identity. The columns of each row of B are
+    sorted. The caller is responsible for deleting the returned matrix. */
+SparseMatrix *PermuteSparseMatrix(const SparseMatrix &A,
+                                  const Array<int> &row_p,
+                                  const Array<int> &col_p);
+
+/// Return the symmetrically permuted matrix, B(i,j) = A(p[i], p[j]).
+inline SparseMatrix *PermuteSparseMatrix(const SparseMatrix &A,
+                                         const Array<int> &p)
+{ return PermuteSparseMatrix(A, p, p); }
+
+/** @brief Permute the vector @a x: y[i] = x[p[i]], or the inverse permutation,
+    y[p[i]] = x[i], if @a inverse is true. */
+void PermuteVector(const Vector &x, const Array<int> &p, Vector &y,
+                   bool inverse = false);
+
+/// Return the bandwidth of the matrix, i.e. the maximum of |i - j| over A(i,j).
+int Bandwidth(const SparseMatrix &A);
+
+/** @brief Return the number of nonzeros, including the diagonal, of the
+    Cholesky factor of the symmetrized pattern of A reordered with @a p.
+
+    This is the fill of the symbolic factorization, computed from the
+    elimination tree without forming the factor. An empty @a p is the
+    identity. */
+long CholeskyFactorNonZeros(const SparseMatrix &A,
+                            const Array<int> &p = Array<int>());
+
+}
+
+#endif
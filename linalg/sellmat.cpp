@@ -0,0 +1,280 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the SELL-C-sigma sparse matrix
+
+#include "sellmat.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// Maximum chunk height supported by the generic (non-templated) kernel.
+static const int SELL_MAX_C = 32;
+
+SellMatrix::SellMatrix(const SparseMatrix &A, int C_, int sigma_)
+   : Operator(A.Height(), A.Width()), C(C_), At(NULL)
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(C > 0 && C <= SELL_MAX_C, "invalid chunk size: " << C
+               << ", the maximum is " << SELL_MAX_C);
+   sigma = std::max(sigma_, 1);
+   if (sigma > 1) { sigma = C*((sigma + C - 1)/C); }
+   Build(A);
+}
+
+void SellMatrix::Build(const SparseMatrix &A)
+{
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+   const double *V = A.HostReadData();
+
+   nnz = A.NumNonZeroElems();
+   num_chunks = (height + C - 1)/C;
+
+   // Sort the rows by decreasing length within each window of sigma rows
+   row_perm.SetSize(num_chunks*C);
+   row_perm = -1;
+   for (int i = 0; i < height; i++) { row_perm[i] = i; }
+   if (sigma > 1)
+   {
+      for (int begin = 0; begin < height; begin += sigma)
+      {
+         const int end = std::min(begin + sigma, height);
+         std::stable_sort(row_perm.GetData() + begin, row_perm.GetData() + end,
+                          [I](int r1, int r2)
+         { return I[r1+1] - I[r1] > I[r2+1] - I[r2]; });
+      }
+   }
+
+   // The width of each chunk is the length of its longest row
+   chunk_width.SetSize(num_chunks);
+   chunk_offset.SetSize(num_chunks + 1);
+   chunk_offset[0] = 0;
+   for (int c = 0; c < num_chunks; c++)
+   {
+      int w = 0;
+      for (int r = 0; r < C; r++)
+      {
+         const int i = row_perm[c*C + r];
+         if (i >= 0) { w = std::max(w, I[i+1] - I[i]); }
+      }
+      chunk_width[c] = w;
+      chunk_offset[c+1] = chunk_offset[c] + w*C;
+   }
+
+   // Fill the chunks column by column. The padding entries are zeros, with the
+   // column index of the last entry of the row to keep the accesses to x local.
+   const int size = chunk_offset[num_chunks];
+   col.SetSize(size);
+   val.SetSize(size);
+   int *h_col = col.HostWrite();
+   double *h_val = val.HostWrite();
+   for (int c = 0; c < num_chunks; c++)
+   {
+      const int off = chunk_offset[c];
+      const int w = chunk_width[c];
+      for (int r = 0; r < C; r++)
+      {
+         const int i = row_perm[c*C + r];
+         const int len = (i >= 0) ? I[i+1] - I[i] : 0;
+         const int pad_col = (len > 0) ? J[I[i+1]-1] : 0;
+         for (int j = 0; j < w; j++)
+         {
+            const int k = off + j*C + r;
+            h_col[k] = (j < len) ? J[I[i]+j] : pad_col;
+            h_val[k] = (j < len) ? V[I[i]+j] : 0.0;
+         }
+      }
+   }
+}
+
+template<int T_C = 0>
+static void SellAddMult(const int num_chunks, const int c,
+                        const Array<int> &row_perm,
+                        const Array<int> &chunk_width,
+                        const Array<int> &chunk_offset,
+                        const Array<int> &col, const Vector &val,
+                        const Vector &x, Vector &y, const double a)
+{
+   const int C = T_C ? T_C : c;
+   auto d_perm = row_perm.Read();
+   auto d_width = chunk_width.Read();
+   auto d_offset = chunk_offset.Read();
+   auto d_col = col.Read();
+   auto d_val = val.Read();
+   auto d_x = x.Read();
+   auto d_y = y.ReadWrite();
+   MFEM_FORALL(ch, num_chunks,
+   {
+      constexpr int max_C = T_C ? T_C : SELL_MAX_C;
+      double sum[max_C];
+      for (int r = 0; r < C; r++) { sum[r] = 0.0; }
+      const int w = d_width[ch];
+      const int off = d_offset[ch];
+      for (int j = 0; j < w; j++)
+      {
+         const int k = off + j*C;
+         for (int r = 0; r < C; r++)
+         {
+            sum[r] += d_val[k+r] * d_x[d_col[k+r]];
+         }
+      }
+      for (int r = 0; r < C; r++)
+      {
+         const int i = d_perm[ch*C + r];
+         if (i >= 0) { d_y[i] += a * sum[r]; }
+      }
+   });
+}
+
+void SellMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y.UseDevice(true);
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void SellMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   MFEM_ASSERT(width == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix height (" << height << ")");
+
+   switch (C)
+   {
+      case 4:
+         return SellAddMult<4>(num_chunks, C, row_perm, chunk_width,
+                               chunk_offset, col, val, x, y, a);
+      case 8:
+         return SellAddMult<8>(num_chunks, C, row_perm, chunk_width,
+                               chunk_offset, col, val, x, y, a);
+      case 16:
+         return SellAddMult<16>(num_chunks, C, row_perm, chunk_width,
+                                chunk_offset, col, val, x, y, a);
+      default:
+         return SellAddMult(num_chunks, C, row_perm, chunk_width,
+                            chunk_offset, col, val, x, y, a);
+   }
+}
+
+void SellMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y.UseDevice(true);
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void SellMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                  const double a) const
+{
+   MFEM_ASSERT(height == x.Size(), "Input vector size (" << x.Size()
+               << ") must match matrix height (" << height << ")");
+   MFEM_ASSERT(width == y.Size(), "Output vector size (" << y.Size()
+               << ") must match matrix width (" << width << ")");
+
+   if (At || Device::Allows(Backend::DEVICE_MASK))
+   {
+      if (!At) { BuildTranspose(); }
+      At->AddMult(x, y, a);
+      return;
+   }
+
+   // Scatter the contributions of the rows on the host
+   const int *h_col = col.HostRead();
+   const double *h_val = val.HostRead();
+   const double *h_x = x.HostRead();
+   double *h_y = y.HostReadWrite();
+   for (int c = 0; c < num_chunks; c++)
+   {
+      const int w = chunk_width[c];
+      const int off = chunk_offset[c];
+      for (int r = 0; r < C; r++)
+      {
+         const int i = row_perm[c*C + r];
+         if (i < 0) { continue; }
+         const double xi = a * h_x[i];
+         for (int j = 0; j < w; j++)
+         {
+            const int k = off + j*C + r;
+            h_y[h_col[k]] += h_val[k] * xi;
+         }
+      }
+   }
+}
+
+void SellMatrix::BuildTranspose() const
+{
+   if (At) { return; }
+
+   // Assemble the transpose row by row, skipping the zero (padding) entries
+   const int *h_col = col.HostRead();
+   const double *h_val = val.HostRead();
+   SparseMatrix T(width, height);
+   for (int c = 0; c < num_chunks; c++)
+   {
+      const int w = chunk_width[c];
+      const int off = chunk_offset[c];
+      for (int r = 0; r < C; r++)
+      {
+         const int i = row_perm[c*C + r];
+         if (i < 0) { continue; }
+         for (int j = 0; j < w; j++)
+         {
+            const int k = off + j*C + r;
+            if (h_val[k] != 0.0) { T.Add(h_col[k], i, h_val[k]); }
+         }
+      }
+   }
+   T.Finalize(0);
+   At = new SellMatrix(T, C, sigma);
+}
+
+void SellMatrix::GetDiag(Vector &d) const
+{
+   MFEM_VERIFY(height == width, "Matrix must be square, not height = "
+               << height << ", width = " << width);
+
+   const int C = this->C;
+   d.UseDevice(true);
+   d.SetSize(height);
+   d = 0.0;
+   auto d_perm = row_perm.Read();
+   auto d_width = chunk_width.Read();
+   auto d_offset = chunk_offset.Read();
+   auto d_col = col.Read();
+   auto d_val = val.Read();
+   auto d_d = d.ReadWrite();
+   // Each row is processed by one thread; the padding entries add zeros.
+   MFEM_FORALL(s, num_chunks*C,
+   {
+      const int i = d_perm[s];
+      if (i >= 0)
+      {
+         const int ch = s / C;
+         const int r = s % C;
+         const int w = d_width[ch];
+         const int off = d_offset[ch];
+         double di = 0.0;
+         for (int j = 0; j < w; j++)
+         {
+            const int k = off + j*C + r;
+            if (d_col[k] == i) { di += d_val[k]; }
+         }
+         d_d[i] = di;
+      }
+   });
+}
+
+}
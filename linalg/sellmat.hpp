@@ -0,0 +1,117 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "../general/device.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in the SELL-C-sigma (sorted, sliced ELLPACK) format,
+    built from a finalized SparseMatrix. */
+/** The rows of the matrix are sorted by decreasing length within windows of
+    @a sigma rows and grouped in chunks of @a C consecutive (sorted) rows. Each
+    chunk is stored in ELLPACK format, column by column, with a width equal to
+    its longest row; shorter rows are padded with zeros. With @a C equal to the
+    SIMD width, the matrix-vector product processes the rows of a chunk in the
+    SIMD lanes, while the sorting limits the padding.
+
+    The matrix can be used in place of the SparseMatrix as an Operator, e.g. in
+    the iterative solvers. Its entries are not modifiable; preconditioners such
+    as DSmoother are constructed from the original SparseMatrix. */
+class SellMatrix : public Operator
+{
+protected:
+   int C;          ///< Chunk height.
+   int sigma;      ///< Size of the sorting windows.
+   int num_chunks; ///< Number of chunks, ceil(height/C).
+   int nnz;        ///< Number of nonzero entries (without padding).
+
+   /// Original row index of each sorted row, size num_chunks*C (-1: padding).
+   Array<int> row_perm;
+   /// Width (number of columns) of each chunk.
+   Array<int> chunk_width;
+   /// Offset of each chunk in the #col and #val arrays, size num_chunks+1.
+   Array<int> chunk_offset;
+   /// Column indices and values, stored column-major within each chunk.
+   Array<int> col;
+   Vector val;
+
+   /// Transpose of the matrix, used for the transpose action on the device.
+   mutable SellMatrix *At;
+
+   void Build(const SparseMatrix &A);
+
+public:
+   /// Default chunk height, the number of doubles in a 512-bit SIMD register.
+   static const int DEFAULT_CHUNK_SIZE = 8;
+
+   /// Default size of the sorting windows.
+   static const int DEFAULT_SIGMA = 256;
+
+   /** @brief Construct the SELL-C-sigma representation of the finalized
+       SparseMatrix @a A. */
+   /** The sorting window @a sigma is rounded up to a multiple of @a C; a value
+       of 1 disables the sorting. */
+   SellMatrix(const SparseMatrix &A, int C = DEFAULT_CHUNK_SIZE,
+              int sigma = DEFAULT_SIGMA);
+
+   /// The matrix owns its cached transpose and cannot be copied.
+   SellMatrix(const SellMatrix &) = delete;
+   SellMatrix &operator=(const SellMatrix &) = delete;
+
+   /// Return the chunk height C.
+   int GetChunkSize() const { return C; }
+
+   /// Return the size of the sorting windows.
+   int GetSigma() const { return sigma; }
+
+   /// Return the number of nonzero entries of the original matrix.
+   int NumNonZeroElems() const { return nnz; }
+
+   /// Return the number of stored entries, including the padding.
+   int NumStoredElems() const { return val.Size(); }
+
+   /// Return the diagonal of the matrix.
+   void GetDiag(Vector &d) const;
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   /// Matrix vector multiplication: y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a * A x.
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Multiply a vector with the transposed matrix: y = A^t x.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a * A^t x.
+   /** On the host, the transpose action is computed directly from the SELL
+       storage. When the device is enabled, the transpose is built with
+       BuildTranspose() on the first call. */
+   void AddMultTranspose(const Vector &x, Vector &y,
+                         const double a = 1.0) const;
+
+   /// Build and store the transpose, used by the transpose action.
+   void BuildTranspose() const;
+
+   virtual ~SellMatrix() { delete At; }
+};
+
+}
+
+#endif
@@ -34,6 +34,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   sum_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -48,6 +49,7 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   sum_request = MPI_REQUEST_NULL;
 }
 #endif
 
@@ -67,6 +69,76 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                               DenseMatrix &XtY) const
+{
+   XtY.SetSize(X.Width(), Y.Width());
+   if (X.Height() > 0)
+   {
+      MultAtB(X, Y, XtY);
+   }
+   else
+   {
+      XtY = 0.0;
+   }
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, XtY.Data(), XtY.Height()*XtY.Width(),
+                    MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
+void IterativeSolver::ColumnDot(const DenseMatrix &X, const DenseMatrix &Y,
+                                Vector &xy) const
+{
+   const int n = X.Height();
+   xy.SetSize(X.Width());
+   for (int c = 0; c < X.Width(); c++)
+   {
+      const double *x = X.GetColumn(c), *y = Y.GetColumn(c);
+      double d = 0.0;
+      for (int l = 0; l < n; l++) { d += x[l]*y[l]; }
+      xy(c) = d;
+   }
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, xy.GetData(), xy.Size(), MPI_DOUBLE,
+                    MPI_SUM, comm);
+   }
+#endif
+}
+
+void IterativeSolver::GlobalSumStart(double *buf, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, buf, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &sum_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, buf, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#else
+   MFEM_CONTRACT_VAR(buf);
+   MFEM_CONTRACT_VAR(n);
+#endif
+}
+
+void IterativeSolver::GlobalSumWait() const
+{
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+   if (dot_prod_type != 0)
+   {
+      MPI_Wait(&sum_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -423,17 +495,17 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    for (i = 1; true; )
    {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
-
+      // The update x = x + alpha d is fused with the update of d below
       if (prec)
       {
+         r.Add(-alpha, z);      //  r = r - alpha A d
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         //  r = r - alpha A d,  fused with (r, r)
+         betanom = GlobalSum(AddAndNorm2(r, -alpha, z, r));
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -454,6 +526,7 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
             mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
                       << betanom << '\n';
          }
+         x.Add(alpha, d);
          converged = 1;
          final_iter = i;
          break;
@@ -461,18 +534,13 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
 
       if (++i > max_iter)
       {
+         x.Add(alpha, d);
          break;
       }
 
       beta = betanom/nom;
-      if (prec)
-      {
-         add(z, beta, d, d);   //  d = z + beta d
-      }
-      else
-      {
-         add(r, beta, d, d);
-      }
+      //  x = x + alpha d,  d = z + beta d  (or d = r + beta d)
+      AddAndXpay(alpha, prec ? z : r, beta, x, d);
       oper->Mult(d, z);       //  z = A d
       den = Dot(d, z);
       MFEM_ASSERT(IsFinite(den), "den = " << den);
@@ -541,6 +609,157 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   z.SetSize(width);
+   q.SetSize(width);
+   s.SetSize(width);
+   p.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Algorithm 4 in P. Ghysels, W. Vanroose, "Hiding global synchronization
+   // latency in the preconditioned Conjugate Gradient algorithm"
+   double alpha = 0.0, beta, gamma, gamma_old = 0.0, delta, den, r0 = 0.0;
+   double nom0 = 0.0;
+   double dots[2];
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   if (prec) { prec->Mult(r, u); } // u = B r
+   else { u = r; }
+   oper->Mult(u, w);               // w = A u
+
+   converged = 0;
+   final_iter = max_iter;
+   int i;
+   for (i = 0; true; i++)
+   {
+      // Start the reduction of gamma = (B r, r) and delta = (A u, u), and
+      // overlap it with m = B w, n = A m
+      dots[0] = r * u;
+      dots[1] = w * u;
+      GlobalSumStart(dots, 2);
+      if (prec) { prec->Mult(w, m); }
+      else { m = w; }
+      oper->Mult(m, n);
+      GlobalSumWait();
+      gamma = dots[0];
+      delta = dots[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+      MFEM_ASSERT(IsFinite(delta), "delta = " << delta);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of pipelined PCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3 && i > 0)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i >= max_iter) { break; }
+
+      if (i > 0)
+      {
+         beta = gamma/gamma_old;
+         den = delta - beta*gamma/alpha;
+      }
+      else
+      {
+         beta = 0.0;
+         den = delta;
+      }
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "Pipelined PCG: The operator is not positive "
+                      "definite. (Ap, p) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = gamma/den;
+      gamma_old = gamma;
+
+      if (i > 0)
+      {
+         add(n, beta, z, z);   // z = n + beta z
+         add(m, beta, q, q);   // q = m + beta q
+         add(w, beta, s, s);   // s = w + beta s
+         add(u, beta, p, p);   // p = u + beta p
+      }
+      else
+      {
+         z = n;
+         q = m;
+         s = w;
+         p = u;
+      }
+      add(x,  alpha, p, x);    // x = x + alpha p
+      add(r, -alpha, s, r);    // r = r - alpha s
+      add(u, -alpha, q, u);    // u = u - alpha q
+      add(w, -alpha, z, w);    // w = w - alpha z
+   }
+
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << gamma << '\n';
+      }
+      mfem::out << "Pipelined PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (gamma/nom0, 0.5/std::max(final_iter, 1)) << '\n';
+   }
+   final_norm = sqrt(gamma);
+}
+
+
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
 {
@@ -591,6 +810,28 @@ inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
    }
 }
 
+inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
+                   DenseMatrix &v)
+{
+   Vector y(s);
+
+   // Backsolve:
+   for (int i = k; i >= 0; i--)
+   {
+      y(i) /= h(i,i);
+      for (int j = i - 1; j >= 0; j--)
+      {
+         y(j) -= h(j,i) * y(i);
+      }
+   }
+
+   for (int j = 0; j <= k; j++)
+   {
+      Vector vj(v.GetColumn(j), v.Height());
+      x.Add(y(j), vj);
+   }
+}
+
 void GMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    // Generalized Minimum Residual method following the algorithm
@@ -678,13 +919,15 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
             oper->Mult(*v[i], w);
          }
 
-         for (k = 0; k <= i; k++)
+         // Modified Gram-Schmidt, each update of w fused with the next dot
+         H(0,i) = Dot(w, *v[0]);     // H(0,i) = w * v[0]
+         for (k = 0; k < i; k++)
          {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
+            // w -= H(k,i) * v[k] and H(k+1,i) = w * v[k+1]
+            H(k+1,i) = GlobalSum(AddAndDot(w, -H(k,i), *v[k], w, *v[k+1]));
          }
-
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
+         // w -= H(i,i) * v[i] and H(i+1,i) = ||w||
+         H(i+1,i) = sqrt(GlobalSum(AddAndNorm2(w, -H(i,i), *v[i], w)));
          MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
          v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
@@ -842,13 +1085,15 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
          }
          oper->Mult(*z[i], r);
 
-         for (k = 0; k <= i; k++)
+         // Modified Gram-Schmidt, each update of r fused with the next dot
+         H(0,i) = Dot(r, *v[0]);     // H(0,i) = r * v[0]
+         for (k = 0; k < i; k++)
          {
-            H(k,i) = Dot( r, *v[k]); // H(k,i) = r * v[k]
-            r.Add(-H(k,i), (*v[k])); // r -= H(k,i) * v[k]
+            // r -= H(k,i) * v[k] and H(k+1,i) = r * v[k+1]
+            H(k+1,i) = GlobalSum(AddAndDot(r, -H(k,i), *v[k], r, *v[k+1]));
          }
-
-         H(i+1,i)  = Norm(r);       // H(i+1,i) = ||r||
+         // r -= H(i,i) * v[i] and H(i+1,i) = ||r||
+         H(i+1,i) = sqrt(GlobalSum(AddAndNorm2(r, -H(i,i), *v[i], r)));
          if (v[i+1] == NULL) { v[i+1] = new Vector(b.Size()); }
          (*v[i+1]) = 0.0;
          v[i+1] -> Add (1.0/H(i+1,i), r); // v[i+1] = r / H(i+1,i)
@@ -939,401 +1184,2142 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
-int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
-          int &max_iter, int m, double &tol, double atol, int printit)
+int CAGMRESSolver::OrthogonalizeBlock(DenseMatrix &V, int k, int sb,
+                                      DenseMatrix &C, DenseMatrix &R) const
 {
-   GMRESSolver gmres;
-   gmres.SetPrintLevel(printit);
-   gmres.SetMaxIter(max_iter);
-   gmres.SetKDim(m);
-   gmres.SetRelTol(sqrt(tol));
-   gmres.SetAbsTol(sqrt(atol));
-   gmres.SetOperator(A);
-   gmres.SetPreconditioner(M);
-   gmres.Mult(b, x);
-   max_iter = gmres.GetNumIterations();
-   tol = gmres.GetFinalNorm()*gmres.GetFinalNorm();
-   return gmres.GetConverged();
+   const int n = V.Height();
+   DenseMatrix Z(V.Data(), n, k+sb), W(V.GetColumn(k), n, sb);
+   DenseMatrix G;
+   BlockDot(Z, W, G); // G = [Q W]^t W, the only global reduction
+
+   // C = Q^t W and S = W^t W - C^t C = (W - Q C)^t (W - Q C)
+   C.SetSize(k, sb);
+   DenseMatrix S(sb);
+   for (int j = 0; j < sb; j++)
+   {
+      for (int i = 0; i < k; i++) { C(i,j) = G(i,j); }
+      for (int i = 0; i < sb; i++)
+      {
+         double sij = G(k+i,j);
+         for (int l = 0; l < k; l++) { sij -= G(l,i)*G(l,j); }
+         S(i,j) = sij;
+      }
+   }
+
+   // Cholesky factorization S = R^t R, stopping at the first column of the
+   // block that is numerically in the span of the previous columns of V
+   R.SetSize(sb);
+   R = 0.0;
+   int t;
+   for (t = 0; t < sb; t++)
+   {
+      for (int i = 0; i < t; i++)
+      {
+         double rit = S(i,t);
+         for (int l = 0; l < i; l++) { rit -= R(l,i)*R(l,t); }
+         R(i,t) = rit/R(i,i);
+      }
+      double d = S(t,t);
+      for (int l = 0; l < t; l++) { d -= R(l,t)*R(l,t); }
+      if (!(d > 1e-12*G(k+t,t))) { break; }
+      R(t,t) = sqrt(d);
+   }
+
+   // W(:,0:t-1) = (W - Q C) R^{-1}
+   if (k > 0 && t > 0)
+   {
+      DenseMatrix Q(V.Data(), n, k), Wt(V.GetColumn(k), n, t);
+      DenseMatrix Ct(C.Data(), k, t);
+      AddMult_a(-1.0, Q, Ct, Wt);
+   }
+   for (int j = 0; j < t; j++)
+   {
+      double *wj = V.GetColumn(k+j);
+      for (int i = 0; i < j; i++)
+      {
+         const double *wi = V.GetColumn(k+i);
+         const double rij = R(i,j);
+         for (int l = 0; l < n; l++) { wj[l] -= rij*wi[l]; }
+      }
+      const double rjj = 1.0/R(j,j);
+      for (int l = 0; l < n; l++) { wj[l] *= rjj; }
+   }
+   return t;
 }
 
-void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
-           int print_iter, int max_num_iter, int m, double rtol, double atol)
+void CAGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
-   GMRES(A, x, b, B, max_num_iter, m, rtol, atol, print_iter);
-}
+   // s-step GMRES, see M. Hoemmen, "Communication-avoiding Krylov subspace
+   // methods", PhD thesis, UC Berkeley, 2010.
 
+   MFEM_VERIFY(s > 0, "invalid step size: " << s);
 
-void BiCGSTABSolver::UpdateVectors()
-{
-   p.SetSize(width);
-   phat.SetSize(width);
-   s.SetSize(width);
-   shat.SetSize(width);
-   t.SetSize(width);
-   v.SetSize(width);
-   r.SetSize(width);
-   rtilde.SetSize(width);
-}
+   const int n = width;
+   const int ms = s*((std::max(m, 1) + s - 1)/s);
 
-void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
-{
-   // BiConjugate Gradient Stabilized method following the algorithm
-   // on p. 27 of the SIAM Templates book.
+   // V is the basis of a restart cycle, H the Hessenberg matrix of the Arnoldi
+   // process and Hr its triangular factor, computed with plane rotations.
+   DenseMatrix V(n, ms+1), H(ms+1, ms), Hr(ms+1, ms);
+   DenseMatrix B, C, R, C2, R2, E, F;
+   Vector g(ms+1), cs(ms+1), sn(ms+1);
+   Vector r(n), w(n);
 
-   int i;
-   double resid, tol_goal;
-   double rho_1, rho_2=1.0, alpha=1.0, beta, omega=1.0;
+   double beta, resid;
+   double scale = 1.0; // scaling of the generated vectors
+   int i, j, k;
 
    if (iterative_mode)
    {
       oper->Mult(x, r);
-      subtract(b, r, r); // r = b - A x
    }
    else
    {
       x = 0.0;
-      r = b;
-   }
-   rtilde = r;
-
-   resid = Norm(r);
-   MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
-   if (print_level >= 0)
-      mfem::out << "   Iteration : " << setw(3) << 0
-                << "   ||r|| = " << resid << '\n';
-
-   tol_goal = std::max(resid*rel_tol, abs_tol);
-
-   if (resid <= tol_goal)
-   {
-      final_norm = resid;
-      final_iter = 0;
-      converged = 1;
-      return;
    }
 
-   for (i = 1; i <= max_iter; i++)
+   if (prec)
    {
-      rho_1 = Dot(rtilde, r);
-      if (rho_1 == 0)
-      {
-         if (print_level >= 0)
-            mfem::out << "   Iteration : " << setw(3) << i
-                      << "   ||r|| = " << resid << '\n';
-         final_norm = resid;
-         final_iter = i;
-         converged = 0;
-         return;
-      }
-      if (i == 1)
+      if (iterative_mode)
       {
-         p = r;
+         subtract(b, r, w);
+         prec->Mult(w, r);    // r = M (b - A x)
       }
       else
       {
-         beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         prec->Mult(b, r);
       }
-      if (prec)
+   }
+   else
+   {
+      if (iterative_mode)
       {
-         prec->Mult(p, phat);   //  phat = M^{-1} * p
+         subtract(b, r, r);
       }
       else
       {
-         phat = p;
+         r = b;
       }
-      oper->Mult(phat, v);     //  v = A * phat
-      alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
-      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
-      if (resid < tol_goal)
+   }
+   beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   final_norm = std::max(rel_tol*beta, abs_tol);
+
+   if (beta <= final_norm)
+   {
+      final_norm = beta;
+      final_iter = 0;
+      converged = 1;
+      goto finish;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   for (j = 1; j <= max_iter; )
+   {
       {
-         x.Add(alpha, phat);  //  x = x + alpha * phat
-         if (print_level >= 0)
-            mfem::out << "   Iteration : " << setw(3) << i
-                      << "   ||s|| = " << resid << '\n';
-         final_norm = resid;
-         final_iter = i;
+         const double *h_r = r.HostRead();
+         double *v0 = V.GetColumn(0);
+         for (int l = 0; l < n; l++) { v0[l] = h_r[l]/beta; }
+      }
+      g = 0.0; g(0) = beta;
+      H = 0.0;
+
+      bool restart = false;
+      for (k = 0; k < ms && j <= max_iter && !restart; )
+      {
+         const int sb = std::min(s, std::min(ms - k, max_iter - j + 1));
+
+         // Generate the block V(:,k+1:k+sb) from v_k with
+         // (M A - theta_i I) v_{k+i} = scale v_{k+i+1}, i.e. M A W = W B
+         B.SetSize(sb+1, sb);
+         B = 0.0;
+         for (i = 0; i < sb; i++)
+         {
+            Vector vi(V.GetColumn(k+i), n), vn(V.GetColumn(k+i+1), n);
+            if (prec)
+            {
+               oper->Mult(vi, w);
+               prec->Mult(w, vn);
+            }
+            else
+            {
+               oper->Mult(vi, vn);
+            }
+            const double theta =
+               (shifts.Size() > 0) ? shifts(i % shifts.Size()) : 0.0;
+            const double *h_vi = V.GetColumn(k+i);
+            double *h_vn = vn.HostReadWrite();
+            for (int l = 0; l < n; l++)
+            {
+               h_vn[l] = (h_vn[l] - theta*h_vi[l])/scale;
+            }
+            B(i,i) = theta;
+            B(i+1,i) = scale;
+         }
+
+         // Block CGS2: W = V_k C + Q R with two passes, each with a single
+         // global reduction. If t < sb, the columns of the block after the
+         // first t are (numerically) in the span of the previous ones.
+         int t = OrthogonalizeBlock(V, k+1, sb, C, R);
+         if (t > 0)
+         {
+            const int t2 = OrthogonalizeBlock(V, k+1, t, C2, R2);
+            // C += C2 R and R = R2 R
+            for (int c = 0; c < std::max(t2, 1); c++)
+            {
+               for (int q = 0; q <= c; q++)
+               {
+                  for (int l = 0; l <= k; l++) { C(l,c) += C2(l,q)*R(q,c); }
+               }
+            }
+            for (int c = 0; c < t2; c++)
+            {
+               for (int q = 0; q <= c; q++)
+               {
+                  double rqc = 0.0;
+                  for (int l = q; l <= c; l++) { rqc += R2(q,l)*R(l,c); }
+                  R(q,c) = rqc;
+               }
+            }
+            t = t2;
+         }
+
+         // Number of new columns of H. For t = 0 (breakdown), v_k spans an
+         // invariant subspace together with the previous vectors and the last
+         // column of H is computed with H(k+1,k) = 0.
+         const int nc = (t > 0) ? t : 1;
+
+         // E = [e_k, [C; R]] are the coefficients of [v_k, W] in the basis.
+         E.SetSize(k+1+nc, nc+1);
+         E = 0.0;
+         E(k,0) = 1.0;
+         for (int c = 1; c <= nc; c++)
+         {
+            for (int l = 0; l <= k; l++) { E(l,c) = C(l,c-1); }
+            for (int l = 0; l < std::min(c, t); l++) { E(k+1+l,c) = R(l,c-1); }
+         }
+
+         // With V_new = V(:,k:k+nc-1) = ([v_k W] - V_k E_top) E_bot^{-1}:
+         //    H(:,k:k+nc-1) = (E B - [H_k E_top; 0]) E_bot^{-1}
+         F.SetSize(k+1+nc, nc);
+         for (int c = 0; c < nc; c++)
+         {
+            for (int l = 0; l < k+1+nc; l++)
+            {
+               F(l,c) = E(l,c)*B(c,c) + E(l,c+1)*B(c+1,c);
+            }
+            for (int q = 0; q < k; q++)
+            {
+               if (E(q,c) == 0.0) { continue; }
+               for (int l = 0; l <= q+1; l++) { F(l,c) -= H(l,q)*E(q,c); }
+            }
+         }
+         for (int c = 0; c < nc; c++)
+         {
+            const int col = k + c;
+            for (int l = 0; l <= col+1; l++)
+            {
+               double hlc = F(l,c);
+               for (int q = 0; q < c; q++) { hlc -= H(l,k+q)*E(k+q,c); }
+               H(l,col) = hlc/E(k+c,c);
+            }
+         }
+
+         // Scale the next block with the norm of M A v_k
+         {
+            double h2 = 0.0;
+            for (int l = 0; l <= k+1; l++) { h2 += H(l,k)*H(l,k); }
+            if (h2 > 0.0) { scale = sqrt(h2); }
+         }
+
+         for (int c = 0; c < nc; c++, j++)
+         {
+            i = k + c;
+            for (int l = 0; l <= i+1; l++) { Hr(l,i) = H(l,i); }
+            for (int q = 0; q < i; q++)
+            {
+               ApplyPlaneRotation(Hr(q,i), Hr(q+1,i), cs(q), sn(q));
+            }
+
+            GeneratePlaneRotation(Hr(i,i), Hr(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(Hr(i,i), Hr(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(g(i), g(i+1), cs(i), sn(i));
+
+            resid = fabs(g(i+1));
+            MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+
+            if (resid <= final_norm)
+            {
+               Update(x, i, Hr, g, V);
+               final_norm = resid;
+               final_iter = j;
+               converged = 1;
+               goto finish;
+            }
+
+            if (print_level == 1)
+            {
+               mfem::out << "   Pass : " << setw(2) << (j-1)/ms+1
+                         << "   Iteration : " << setw(3) << j
+                         << "  ||B r|| = " << resid << '\n';
+            }
+         }
+
+         k += nc;
+         restart = (t < sb);
+      }
+
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      Update(x, k-1, Hr, g, V);
+
+      oper->Mult(x, r);
+      if (prec)
+      {
+         subtract(b, r, w);
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         subtract(b, r, r);
+      }
+      beta = Norm(r);         // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      if (beta <= final_norm)
+      {
+         final_norm = beta;
+         final_iter = j;
          converged = 1;
-         return;
+         goto finish;
       }
-      if (print_level >= 0)
-         mfem::out << "   Iteration : " << setw(3) << i
-                   << "   ||s|| = " << resid;
+   }
+
+   final_norm = beta;
+   final_iter = max_iter;
+   converged = 0;
+
+finish:
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/ms+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "CA-GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "CA-GMRES: No convergence!\n";
+   }
+}
+
+
+int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
+          int &max_iter, int m, double &tol, double atol, int printit)
+{
+   GMRESSolver gmres;
+   gmres.SetPrintLevel(printit);
+   gmres.SetMaxIter(max_iter);
+   gmres.SetKDim(m);
+   gmres.SetRelTol(sqrt(tol));
+   gmres.SetAbsTol(sqrt(atol));
+   gmres.SetOperator(A);
+   gmres.SetPreconditioner(M);
+   gmres.Mult(b, x);
+   max_iter = gmres.GetNumIterations();
+   tol = gmres.GetFinalNorm()*gmres.GetFinalNorm();
+   return gmres.GetConverged();
+}
+
+void GMRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
+           int print_iter, int max_num_iter, int m, double rtol, double atol)
+{
+   GMRES(A, x, b, B, max_num_iter, m, rtol, atol, print_iter);
+}
+
+
+// Eigenvalues, in increasing order, and orthonormal eigenvectors (the columns
+// of Q) of the small symmetric matrix A, computed with the cyclic Jacobi
+// method. A is overwritten.
+static void JacobiEigensystem(DenseMatrix &A, Vector &ev, DenseMatrix &Q)
+{
+   const int n = A.Height();
+   Q.Diag(1.0, n);
+   for (int sweep = 0; sweep < 50; sweep++)
+   {
+      double off = 0.0, diag = 0.0;
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < n; i++)
+         {
+            if (i == j) { diag += A(i,j)*A(i,j); }
+            else { off += A(i,j)*A(i,j); }
+         }
+      }
+      if (off <= 1e-30*diag) { break; }
+
+      for (int p = 0; p < n-1; p++)
+      {
+         for (int q = p+1; q < n; q++)
+         {
+            if (A(p,q) == 0.0) { continue; }
+            // Rotation in the (p,q) plane that annihilates A(p,q)
+            const double theta = (A(q,q) - A(p,p))/(2.0*A(p,q));
+            const double t = ((theta >= 0.0) ? 1.0 : -1.0) /
+                             (fabs(theta) + sqrt(theta*theta + 1.0));
+            const double c = 1.0/sqrt(t*t + 1.0), s = t*c;
+            for (int l = 0; l < n; l++)
+            {
+               const double a_lp = A(l,p), a_lq = A(l,q);
+               A(l,p) = c*a_lp - s*a_lq;
+               A(l,q) = s*a_lp + c*a_lq;
+            }
+            for (int l = 0; l < n; l++)
+            {
+               const double a_pl = A(p,l), a_ql = A(q,l);
+               A(p,l) = c*a_pl - s*a_ql;
+               A(q,l) = s*a_pl + c*a_ql;
+            }
+            for (int l = 0; l < n; l++)
+            {
+               const double q_lp = Q(l,p), q_lq = Q(l,q);
+               Q(l,p) = c*q_lp - s*q_lq;
+               Q(l,q) = s*q_lp + c*q_lq;
+            }
+         }
+      }
+   }
+
+   // Sort the eigenpairs in increasing order
+   ev.SetSize(n);
+   for (int i = 0; i < n; i++) { ev(i) = A(i,i); }
+   for (int i = 0; i < n; i++)
+   {
+      int i_min = i;
+      for (int j = i+1; j < n; j++)
+      {
+         if (ev(j) < ev(i_min)) { i_min = j; }
+      }
+      if (i_min == i) { continue; }
+      std::swap(ev(i), ev(i_min));
+      for (int l = 0; l < n; l++) { std::swap(Q(l,i), Q(l,i_min)); }
+   }
+}
+
+void GCRODRSolver::DeleteRecycleSpace() const
+{
+   for (int i = 0; i < U.Size(); i++)
+   {
+      delete U[i];
+      delete C[i];
+   }
+   U.SetSize(0);
+   C.SetSize(0);
+   update_C = false;
+}
+
+void GCRODRSolver::SetPreconditioner(Solver &pr)
+{
+   IterativeSolver::SetPreconditioner(pr);
+   update_C = true;
+}
+
+void GCRODRSolver::SetOperator(const Operator &op)
+{
+   IterativeSolver::SetOperator(op);
+   if (U.Size() > 0 && U[0]->Size() != width)
+   {
+      DeleteRecycleSpace();
+   }
+   update_C = true;
+}
+
+void GCRODRSolver::UpdateRecycleSpace() const
+{
+   update_C = false;
+   const int kc = U.Size();
+   if (kc == 0) { return; }
+
+   Vector w(width);
+   for (int i = 0; i < kc; i++)
+   {
       if (prec)
       {
-         prec->Mult(s, shat);  //  shat = M^{-1} * s
+         oper->Mult(*U[i], w);
+         prec->Mult(w, *C[i]);      // C[i] = M A U[i]
       }
       else
       {
-         shat = s;
+         oper->Mult(*U[i], *C[i]);
+      }
+   }
+
+   // C = Q R with modified Gram-Schmidt, then C = Q and U = U R^{-1}
+   DenseMatrix R(kc);
+   for (int i = 0; i < kc; i++)
+   {
+      const double norm_c = Norm(*C[i]);
+      for (int l = 0; l < i; l++)
+      {
+         R(l,i) = Dot(*C[l], *C[i]);
+         C[i]->Add(-R(l,i), *C[l]);
+      }
+      R(i,i) = Norm(*C[i]);
+      if (R(i,i) <= 1e-12*norm_c)
+      {
+         // The recycled subspace is (numerically) degenerate for the new
+         // operator, start again without it
+         DeleteRecycleSpace();
+         return;
+      }
+      *C[i] /= R(i,i);
+      for (int l = 0; l < i; l++)
+      {
+         U[i]->Add(-R(l,i), *U[l]);
+      }
+      *U[i] /= R(i,i);
+   }
+}
+
+void GCRODRSolver::SelectRecycleSpace(const Array<Vector*> &Vh,
+                                      const Array<Vector*> &Wh,
+                                      const DenseMatrix &G) const
+{
+   const int nc = Vh.Size(), kc = U.Size();
+   const int kk = std::min(k, nc);
+   if (kk == 0) { return; }
+
+   // Gram matrix of Vh = [U, V], where the columns of V are orthonormal
+   DenseMatrix M(nc);
+   M = 0.0;
+   for (int i = 0; i < nc; i++)
+   {
+      for (int l = 0; l <= std::min(i, kc - 1); l++)
+      {
+         M(l,i) = M(i,l) = Dot(*Vh[l], *Vh[i]);
+      }
+      if (i >= kc) { M(i,i) = 1.0; }
+   }
+
+   // Cholesky factorization M = L L^t
+   DenseMatrix L(nc);
+   L = 0.0;
+   for (int j = 0; j < nc; j++)
+   {
+      double d = M(j,j);
+      for (int l = 0; l < j; l++) { d -= L(j,l)*L(j,l); }
+      if (d <= 1e-14*M(j,j)) { return; } // keep the current subspace
+      L(j,j) = sqrt(d);
+      for (int i = j+1; i < nc; i++)
+      {
+         double a = M(i,j);
+         for (int l = 0; l < j; l++) { a -= L(i,l)*L(j,l); }
+         L(i,j) = a/L(j,j);
+      }
+   }
+
+   // Minimize |G y|/|Vh y|: eigenvectors of T = L^{-1} G^t G L^{-t} with the
+   // smallest eigenvalues, P = L^{-t} Z
+   const int nr = nc + 1;
+   DenseMatrix T(nc), X(nc);
+   for (int j = 0; j < nc; j++)
+   {
+      for (int i = 0; i < nc; i++)
+      {
+         double a = 0.0;
+         for (int l = 0; l < nr; l++) { a += G(l,i)*G(l,j); }
+         X(i,j) = a;
+      }
+   }
+   for (int pass = 0; pass < 2; pass++)
+   {
+      // T = L^{-1} X^t: first T = L^{-1} G^t G, then T = L^{-1} G^t G L^{-t}
+      for (int j = 0; j < nc; j++)
+      {
+         for (int i = 0; i < nc; i++)
+         {
+            double a = X(j,i);
+            for (int l = 0; l < i; l++) { a -= L(i,l)*T(l,j); }
+            T(i,j) = a/L(i,i);
+         }
+      }
+      X = T;
+   }
+   for (int j = 0; j < nc; j++)
+   {
+      for (int i = 0; i < j; i++)
+      {
+         T(i,j) = T(j,i) = 0.5*(T(i,j) + T(j,i));
+      }
+   }
+   Vector ev;
+   DenseMatrix Z;
+   JacobiEigensystem(T, ev, Z);
+   DenseMatrix P(nc, kk);
+   for (int j = 0; j < kk; j++)
+   {
+      for (int i = nc-1; i >= 0; i--)
+      {
+         double a = Z(i,j);
+         for (int l = i+1; l < nc; l++) { a -= L(l,i)*P(l,j); }
+         P(i,j) = a/L(i,i);
+      }
+   }
+
+   // G P = Q R with modified Gram-Schmidt
+   DenseMatrix Q(nr, kk), R(kk);
+   R = 0.0;
+   for (int j = 0; j < kk; j++)
+   {
+      for (int i = 0; i < nr; i++)
+      {
+         double a = 0.0;
+         for (int l = 0; l < nc; l++) { a += G(i,l)*P(l,j); }
+         Q(i,j) = a;
+      }
+   }
+   int kn = kk;
+   for (int j = 0; j < kk; j++)
+   {
+      double norm_q = 0.0;
+      for (int i = 0; i < nr; i++) { norm_q += Q(i,j)*Q(i,j); }
+      for (int l = 0; l < j; l++)
+      {
+         double a = 0.0;
+         for (int i = 0; i < nr; i++) { a += Q(i,l)*Q(i,j); }
+         R(l,j) = a;
+         for (int i = 0; i < nr; i++) { Q(i,j) -= a*Q(i,l); }
+      }
+      double a = 0.0;
+      for (int i = 0; i < nr; i++) { a += Q(i,j)*Q(i,j); }
+      if (a <= 1e-24*norm_q) { kn = j; break; }
+      R(j,j) = sqrt(a);
+      for (int i = 0; i < nr; i++) { Q(i,j) /= R(j,j); }
+   }
+   if (kn == 0) { return; }
+
+   // The new subspace: C = Wh Q and U = Vh P R^{-1}, so that M A U = C
+   Array<Vector*> U_new(kn), C_new(kn);
+   for (int j = 0; j < kn; j++)
+   {
+      C_new[j] = new Vector(width);
+      U_new[j] = new Vector(width);
+      *C_new[j] = 0.0;
+      *U_new[j] = 0.0;
+      for (int i = 0; i < nr; i++) { C_new[j]->Add(Q(i,j), *Wh[i]); }
+      for (int i = 0; i < nc; i++) { U_new[j]->Add(P(i,j), *Vh[i]); }
+      for (int l = 0; l < j; l++) { U_new[j]->Add(-R(l,j), *U_new[l]); }
+      *U_new[j] /= R(j,j);
+   }
+   DeleteRecycleSpace();
+   U_new.Copy(U);
+   C_new.Copy(C);
+}
+
+void GCRODRSolver::Mult(const Vector &b, Vector &x) const
+{
+   // GCRO-DR following Parks, de Sturler, Mackey, Johnson and Maiti, "Recycling
+   // Krylov subspaces for sequences of linear systems", SIAM J. Sci. Comput.,
+   // 28 (2006), with a different choice of the recycled vectors, see the
+   // documentation of the class.
+   MFEM_VERIFY(k >= 0 && k < m, "the recycle dimension " << k
+               << " must be smaller than the search space dimension " << m);
+
+   const int n = width;
+   Vector r(n), w(n);
+
+   if (update_C) { UpdateRecycleSpace(); }
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, w);
+   }
+   else
+   {
+      x = 0.0;
+      w = b;
+   }
+   if (prec)
+   {
+      prec->Mult(w, r);    // r = M (b - A x)
+   }
+   else
+   {
+      r = w;
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   final_norm = std::max(rel_tol*beta, abs_tol);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   DenseMatrix G(m+1, m), H(m+1, m);
+   Vector s(m+1), cs(m+1), sn(m+1);
+   Array<Vector*> v(m+1), Vh, Wh;
+   v = NULL;
+
+   int j = 0, pass = 1;
+   converged = 0;
+   while (true)
+   {
+      // Minimize the residual over span(U): x += U C^t r, r -= C C^t r
+      const int kc = U.Size();
+      for (int l = 0; l < kc; l++)
+      {
+         const double alpha = Dot(*C[l], r);
+         x.Add(alpha, *U[l]);
+         r.Add(-alpha, *C[l]);
+      }
+      if (kc > 0)
+      {
+         beta = Norm(r);
+         MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      }
+      if (beta <= final_norm) { converged = 1; break; }
+      if (j >= max_iter) { break; }
+
+      // Arnoldi process for (I - C C^t) M A, with M A [U, V] = [C, V] G, where
+      // G = [ I B; 0 H ] is upper Hessenberg
+      G = 0.0;
+      H = 0.0;
+      for (int l = 0; l < kc; l++) { G(l,l) = H(l,l) = 1.0; }
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      s = 0.0;
+      s(kc) = beta;
+
+      double resid = beta;
+      int i = 0;
+      while (i < m - kc && j < max_iter)
+      {
+         const int c = kc + i;
+         if (prec)
+         {
+            oper->Mult(*v[i], r);
+            prec->Mult(r, w);        // w = M A v[i]
+         }
+         else
+         {
+            oper->Mult(*v[i], w);
+         }
+         for (int l = 0; l < kc; l++)
+         {
+            G(l,c) = Dot(w, *C[l]);
+            w.Add(-G(l,c), *C[l]);
+         }
+         for (int l = 0; l <= i; l++)
+         {
+            G(kc+l,c) = Dot(w, *v[l]);
+            w.Add(-G(kc+l,c), *v[l]);
+         }
+         G(c+1,c) = Norm(w);
+         MFEM_ASSERT(IsFinite(G(c+1,c)), "Norm(w) = " << G(c+1,c));
+         if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+         v[i+1]->Set(1.0/G(c+1,c), w);
+
+         for (int l = 0; l <= c+1; l++) { H(l,c) = G(l,c); }
+         for (int l = kc; l < c; l++)
+         {
+            ApplyPlaneRotation(H(l,c), H(l+1,c), cs(l), sn(l));
+         }
+         GeneratePlaneRotation(H(c,c), H(c+1,c), cs(c), sn(c));
+         ApplyPlaneRotation(H(c,c), H(c+1,c), cs(c), sn(c));
+         ApplyPlaneRotation(s(c), s(c+1), cs(c), sn(c));
+         i++;
+         j++;
+
+         resid = fabs(s(c+1));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+         if (resid <= final_norm) { break; }
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << pass
+                      << "   Iteration : " << setw(3) << j
+                      << "  ||B r|| = " << resid << '\n';
+         }
+      }
+      if (i == 0) { break; }
+
+      // Update the solution and the recycled subspace from the search space
+      // Vh = [U, V] and its image Wh = [C, V, v]
+      Vh.SetSize(0);
+      Wh.SetSize(0);
+      for (int l = 0; l < kc; l++)
+      {
+         Vh.Append(U[l]);
+         Wh.Append(C[l]);
+      }
+      for (int l = 0; l < i; l++)
+      {
+         Vh.Append(v[l]);
+         Wh.Append(v[l]);
+      }
+      Wh.Append(v[i]);
+      Update(x, kc+i-1, H, s, Vh);
+      SelectRecycleSpace(Vh, Wh, G);
+
+      if (resid > final_norm && print_level == 1 && j < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+      pass++;
+
+      oper->Mult(x, r);
+      subtract(b, r, w);
+      if (prec)
+      {
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         r = w;
+      }
+      beta = Norm(r);         // beta = ||r||
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+   }
+   final_norm = beta;
+   final_iter = j;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << pass
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "GCRO-DR: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GCRO-DR: No convergence!\n";
+   }
+   for (int i = 0; i < v.Size(); i++)
+   {
+      delete v[i];
+   }
+}
+
+
+// Remove the oldest (first) column of dF = Q R and of dG. The remaining
+// columns of R are made upper triangular again with plane rotations, which are
+// also applied to the columns of Q, whose last column is then dropped.
+static void AndersonDeleteOldest(Array<Vector*> &Q, Array<Vector*> &dG,
+                                 DenseMatrix &R, Vector &tmp)
+{
+   const int mk = Q.Size();
+   delete dG[0];
+   for (int i = 0; i < mk-1; i++)
+   {
+      dG[i] = dG[i+1];
+      for (int j = 0; j < mk; j++) { R(j,i) = R(j,i+1); }
+   }
+   for (int i = 0; i < mk-1; i++)
+   {
+      double cs, sn;
+      GeneratePlaneRotation(R(i,i), R(i+1,i), cs, sn);
+      for (int j = i; j < mk-1; j++)
+      {
+         ApplyPlaneRotation(R(i,j), R(i+1,j), cs, sn);
+      }
+      add(cs, *Q[i], sn, *Q[i+1], tmp);
+      add(-sn, *Q[i], cs, *Q[i+1], *Q[i+1]);
+      *Q[i] = tmp;
+   }
+   delete Q[mk-1];
+   Q.SetSize(mk-1);
+   dG.SetSize(mk-1);
+}
+
+void AndersonSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(oper != NULL, "the Operator is not set (use SetOperator).");
+   MFEM_VERIFY(m >= 0, "invalid history depth: " << m);
+
+   const int n = width;
+   const bool have_b = (b.Size() == height);
+   // Drop the oldest column when the factorization becomes ill-conditioned
+   const double max_cond = 1e10;
+
+   // dF = Q R, with the columns of Q (and dG) from the oldest to the newest
+   Array<Vector*> Q, dG;
+   DenseMatrix R(m);
+   Vector g(n), f(n), g_prev(n), f_prev(n), h(m), gamma(m), tmp(n);
+   int mk = 0;
+
+   if (!iterative_mode)
+   {
+      x = 0.0;
+   }
+
+   oper->Mult(x, g);
+   if (have_b)
+   {
+      g += b;
+   }
+
+   int it;
+   double norm0 = 0.0, norm = 0.0, norm_goal = 0.0;
+   converged = 0;
+   for (it = 0; true; it++)
+   {
+      subtract(g, x, f);    // f = G(x) + b - x
+      norm = Norm(f);
+      MFEM_ASSERT(IsFinite(norm), "norm = " << norm);
+      if (it == 0)
+      {
+         norm0 = norm;
+         norm_goal = std::max(rel_tol*norm, abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && it == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << it << "  ||f|| = "
+                   << norm << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (norm <= norm_goal)
+      {
+         converged = 1;
+         break;
+      }
+      if (it >= max_iter)
+      {
+         break;
+      }
+
+      if (it > 0 && m > 0)
+      {
+         // Remove the oldest column if the history is full
+         if (mk == m)
+         {
+            AndersonDeleteOldest(Q, dG, R, tmp);
+            mk--;
+         }
+
+         // Add the newest column, df = f - f_prev, orthogonalized against Q
+         Vector *df = new Vector(n);
+         subtract(f, f_prev, *df);
+         const double df_norm = Norm(*df);
+         for (int i = 0; i < mk; i++)
+         {
+            R(i,mk) = Dot(*Q[i], *df);
+            df->Add(-R(i,mk), *Q[i]);
+         }
+         R(mk,mk) = Norm(*df);
+         if (R(mk,mk) > 1e-14*df_norm)
+         {
+            *df /= R(mk,mk);
+            Q.Append(df);
+            Vector *dg = new Vector(n);
+            subtract(g, g_prev, *dg);
+            dG.Append(dg);
+            mk++;
+         }
+         else
+         {
+            delete df; // f - f_prev is in the span of the history
+         }
+      }
+      f_prev = f;
+      g_prev = g;
+
+      // gamma = R^{-1} Q^t f, and f - dF gamma = f - Q Q^t f
+      for (int i = 0; i < mk; i++)
+      {
+         h(i) = Dot(*Q[i], f);
+      }
+      for (int i = mk-1; i >= 0; i--)
+      {
+         gamma(i) = h(i);
+         for (int j = i+1; j < mk; j++)
+         {
+            gamma(i) -= R(i,j)*gamma(j);
+         }
+         gamma(i) /= R(i,i);
+      }
+
+      // x = g - dG gamma - (1 - beta) (f - dF gamma)
+      x = g;
+      for (int i = 0; i < mk; i++)
+      {
+         x.Add(-gamma(i), *dG[i]);
+      }
+      if (beta != 1.0)
+      {
+         x.Add(beta - 1.0, f);
+         for (int i = 0; i < mk; i++)
+         {
+            x.Add((1.0 - beta)*h(i), *Q[i]);
+         }
+      }
+
+      // Drop the oldest columns while the factorization is ill-conditioned;
+      // this takes effect in the next iteration
+      while (mk > 1)
+      {
+         double d_min = fabs(R(0,0)), d_max = fabs(R(0,0));
+         for (int i = 1; i < mk; i++)
+         {
+            d_min = std::min(d_min, fabs(R(i,i)));
+            d_max = std::max(d_max, fabs(R(i,i)));
+         }
+         if (d_max <= max_cond*d_min) { break; }
+
+         AndersonDeleteOldest(Q, dG, R, tmp);
+         mk--;
+      }
+
+      oper->Mult(x, g);
+      if (have_b)
+      {
+         g += b;
+      }
+   }
+
+   final_iter = it;
+   final_norm = norm;
+
+   if (print_level == 2)
+   {
+      mfem::out << "Anderson: Number of iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << final_iter << "  ||f|| = "
+                << final_norm << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Anderson: No convergence!\n";
+   }
+   if (print_level == 3 && norm0 > 0.0)
+   {
+      mfem::out << "Average reduction factor = "
+                << pow(final_norm/norm0, 1.0/std::max(final_iter, 1)) << '\n';
+   }
+
+   for (int i = 0; i < mk; i++)
+   {
+      delete Q[i];
+      delete dG[i];
+   }
+}
+
+
+void BiCGSTABSolver::UpdateVectors()
+{
+   p.SetSize(width);
+   phat.SetSize(width);
+   s.SetSize(width);
+   shat.SetSize(width);
+   t.SetSize(width);
+   v.SetSize(width);
+   r.SetSize(width);
+   rtilde.SetSize(width);
+}
+
+void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
+{
+   // BiConjugate Gradient Stabilized method following the algorithm
+   // on p. 27 of the SIAM Templates book.
+
+   int i;
+   double resid, tol_goal;
+   double rho_1, rho_2=1.0, alpha=1.0, beta, omega=1.0;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      x = 0.0;
+      r = b;
+   }
+   rtilde = r;
+
+   resid = Norm(r);
+   MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+   if (print_level >= 0)
+      mfem::out << "   Iteration : " << setw(3) << 0
+                << "   ||r|| = " << resid << '\n';
+
+   tol_goal = std::max(resid*rel_tol, abs_tol);
+
+   if (resid <= tol_goal)
+   {
+      final_norm = resid;
+      final_iter = 0;
+      converged = 1;
+      return;
+   }
+
+   for (i = 1; i <= max_iter; i++)
+   {
+      rho_1 = Dot(rtilde, r);
+      if (rho_1 == 0)
+      {
+         if (print_level >= 0)
+            mfem::out << "   Iteration : " << setw(3) << i
+                      << "   ||r|| = " << resid << '\n';
+         final_norm = resid;
+         final_iter = i;
+         converged = 0;
+         return;
+      }
+      if (i == 1)
+      {
+         p = r;
+      }
+      else
+      {
+         beta = (rho_1/rho_2) * (alpha/omega);
+         add(p, -omega, v, p);  //  p = p - omega * v
+         add(r, beta, p, p);    //  p = r + beta * p
+      }
+      if (prec)
+      {
+         prec->Mult(p, phat);   //  phat = M^{-1} * p
+      }
+      else
+      {
+         phat = p;
+      }
+      oper->Mult(phat, v);     //  v = A * phat
+      alpha = rho_1 / Dot(rtilde, v);
+      //  s = r - alpha * v
+      resid = sqrt(GlobalSum(AddAndNorm2(r, -alpha, v, s)));
+      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+      if (resid < tol_goal)
+      {
+         x.Add(alpha, phat);  //  x = x + alpha * phat
+         if (print_level >= 0)
+            mfem::out << "   Iteration : " << setw(3) << i
+                      << "   ||s|| = " << resid << '\n';
+         final_norm = resid;
+         final_iter = i;
+         converged = 1;
+         return;
+      }
+      if (print_level >= 0)
+         mfem::out << "   Iteration : " << setw(3) << i
+                   << "   ||s|| = " << resid;
+      if (prec)
+      {
+         prec->Mult(s, shat);  //  shat = M^{-1} * s
+      }
+      else
+      {
+         shat = s;
+      }
+      oper->Mult(shat, t);     //  t = A * shat
+      double dots[2];
+      Dot2(t, s, t, dots[0], dots[1]);
+      GlobalSumStart(dots, 2);
+      GlobalSumWait();
+      omega = dots[0] / dots[1];
+      x.Add(alpha, phat);   //  x += alpha * phat
+      x.Add(omega, shat);   //  x += omega * shat
+      //  r = s - omega * t
+      resid = sqrt(GlobalSum(AddAndNorm2(s, -omega, t, r)));
+
+      rho_2 = rho_1;
+      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+      if (print_level >= 0)
+      {
+         mfem::out << "   ||r|| = " << resid << '\n';
+      }
+      if (resid < tol_goal)
+      {
+         final_norm = resid;
+         final_iter = i;
+         converged = 1;
+         return;
+      }
+      if (omega == 0)
+      {
+         final_norm = resid;
+         final_iter = i;
+         converged = 0;
+         return;
+      }
+   }
+
+   final_norm = resid;
+   final_iter = max_iter;
+   converged = 0;
+}
+
+int BiCGSTAB(const Operator &A, Vector &x, const Vector &b, Solver &M,
+             int &max_iter, double &tol, double atol, int printit)
+{
+   BiCGSTABSolver bicgstab;
+   bicgstab.SetPrintLevel(printit);
+   bicgstab.SetMaxIter(max_iter);
+   bicgstab.SetRelTol(sqrt(tol));
+   bicgstab.SetAbsTol(sqrt(atol));
+   bicgstab.SetOperator(A);
+   bicgstab.SetPreconditioner(M);
+   bicgstab.Mult(b, x);
+   max_iter = bicgstab.GetNumIterations();
+   tol = bicgstab.GetFinalNorm()*bicgstab.GetFinalNorm();
+   return bicgstab.GetConverged();
+}
+
+void BiCGSTAB(const Operator &A, Solver &B, const Vector &b, Vector &x,
+              int print_iter, int max_num_iter, double rtol, double atol)
+{
+   BiCGSTAB(A, x, b, B, max_num_iter, rtol, atol, print_iter);
+}
+
+
+void MINRESSolver::SetOperator(const Operator &op)
+{
+   IterativeSolver::SetOperator(op);
+   v0.SetSize(width);
+   v1.SetSize(width);
+   w0.SetSize(width);
+   w1.SetSize(width);
+   q.SetSize(width);
+   if (prec)
+   {
+      u1.SetSize(width);
+   }
+}
+
+void MINRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Based on the MINRES algorithm on p. 86, Fig. 6.9 in
+   // "Iterative Krylov Methods for Large Linear Systems",
+   // by Henk A. van der Vorst, 2003.
+   // Extended to support an SPD preconditioner.
+
+   int it;
+   double beta, eta, gamma0, gamma1, sigma0, sigma1;
+   double alpha, delta, rho1, rho2, rho3, norm_goal;
+   Vector *z = (prec) ? &u1 : &v1;
+
+   converged = 1;
+
+   if (!iterative_mode)
+   {
+      v1 = b;
+      x = 0.;
+   }
+   else
+   {
+      oper->Mult(x, v1);
+      subtract(b, v1, v1);
+   }
+
+   if (prec)
+   {
+      prec->Mult(v1, u1);
+   }
+   eta = beta = sqrt(Dot(*z, v1));
+   MFEM_ASSERT(IsFinite(eta), "eta = " << eta);
+   gamma0 = gamma1 = 1.;
+   sigma0 = sigma1 = 0.;
+
+   norm_goal = std::max(rel_tol*eta, abs_tol);
+
+   if (eta <= norm_goal)
+   {
+      it = 0;
+      goto loop_end;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "MINRES: iteration " << setw(3) << 0 << ": ||r||_B = "
+                << eta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   for (it = 1; it <= max_iter; it++)
+   {
+      v1 /= beta;
+      if (prec)
+      {
+         u1 /= beta;
+      }
+      oper->Mult(*z, q);
+      alpha = Dot(*z, q);
+      MFEM_ASSERT(IsFinite(alpha), "alpha = " << alpha);
+      if (it > 1) // (v0 == 0) for (it == 1)
+      {
+         q.Add(-beta, v0);
+      }
+      double v0_v0 = 0.0;
+      if (!prec)
+      {
+         v0_v0 = AddAndNorm2(q, -alpha, v1, v0);
+      }
+      else
+      {
+         add(q, -alpha, v1, v0);
+      }
+
+      delta = gamma1*alpha - gamma0*sigma1*beta;
+      rho3 = sigma0*beta;
+      rho2 = sigma1*alpha + gamma0*gamma1*beta;
+      if (!prec)
+      {
+         beta = sqrt(GlobalSum(v0_v0));
+      }
+      else
+      {
+         prec->Mult(v0, q);
+         beta = sqrt(Dot(v0, q));
+      }
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      rho1 = hypot(delta, beta);
+
+      if (it == 1)
+      {
+         w0.Set(1./rho1, *z);   // (w0 == 0) and (w1 == 0)
+      }
+      else if (it == 2)
+      {
+         add(1./rho1, *z, -rho2/rho1, w1, w0);   // (w0 == 0)
+      }
+      else
+      {
+         add(-rho3/rho1, w0, -rho2/rho1, w1, w0);
+         w0.Add(1./rho1, *z);
+      }
+
+      gamma0 = gamma1;
+      gamma1 = delta/rho1;
+
+      x.Add(gamma1*eta, w0);
+
+      sigma0 = sigma1;
+      sigma1 = beta/rho1;
+
+      eta = -sigma1*eta;
+      MFEM_ASSERT(IsFinite(eta), "eta = " << eta);
+
+      if (fabs(eta) <= norm_goal)
+      {
+         goto loop_end;
+      }
+
+      if (print_level == 1)
+      {
+         mfem::out << "MINRES: iteration " << setw(3) << it << ": ||r||_B = "
+                   << fabs(eta) << '\n';
+      }
+
+      if (prec)
+      {
+         Swap(u1, q);
+      }
+      Swap(v0, v1);
+      Swap(w0, w1);
+   }
+   converged = 0;
+   it--;
+
+loop_end:
+   final_iter = it;
+   final_norm = fabs(eta);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "MINRES: iteration " << setw(3) << final_iter << ": ||r||_B = "
+                << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "MINRES: number of iterations: " << final_iter << '\n';
+   }
+#if 0
+   if (print_level >= 1)
+   {
+      oper->Mult(x, v1);
+      subtract(b, v1, v1);
+      if (prec)
+      {
+         prec->Mult(v1, u1);
+      }
+      eta = sqrt(Dot(*z, v1));
+      mfem::out << "MINRES: iteration " << setw(3) << it << ": ||r||_B = "
+                << eta << " (re-computed)" << '\n';
+   }
+#endif
+   if (!converged && print_level >= 0)
+   {
+      mfem::out << "MINRES: No convergence!\n";
+   }
+}
+
+void MINRES(const Operator &A, const Vector &b, Vector &x, int print_it,
+            int max_it, double rtol, double atol)
+{
+   MINRESSolver minres;
+   minres.SetPrintLevel(print_it);
+   minres.SetMaxIter(max_it);
+   minres.SetRelTol(sqrt(rtol));
+   minres.SetAbsTol(sqrt(atol));
+   minres.SetOperator(A);
+   minres.Mult(b, x);
+}
+
+void MINRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
+            int print_it, int max_it, double rtol, double atol)
+{
+   MINRESSolver minres;
+   minres.SetPrintLevel(print_it);
+   minres.SetMaxIter(max_it);
+   minres.SetRelTol(sqrt(rtol));
+   minres.SetAbsTol(sqrt(atol));
+   minres.SetOperator(A);
+   minres.SetPreconditioner(B);
+   minres.Mult(b, x);
+}
+
+
+void BlockIterativeSolver::MultiMult(const Operator &op, const DenseMatrix &X,
+                                     DenseMatrix &Y) const
+{
+   Y.SetSize(op.Height(), X.Width());
+   const SparseMatrix *spmat = dynamic_cast<const SparseMatrix*>(&op);
+   if (spmat && spmat->Finalized())
+   {
+      spmat->Mult(X, Y);
+      return;
+   }
+#ifdef MFEM_USE_MPI
+   const HypreParMatrix *hypre_mat = dynamic_cast<const HypreParMatrix*>(&op);
+   if (hypre_mat)
+   {
+      hypre_mat->Mult(X, Y);
+      return;
+   }
+#endif
+   for (int c = 0; c < X.Width(); c++)
+   {
+      Vector x(const_cast<double*>(X.GetColumn(c)), X.Height());
+      Vector y(Y.GetColumn(c), Y.Height());
+      op.Mult(x, y);
+      y.HostRead();
+   }
+}
+
+void BlockIterativeSolver::Orthonormalize(DenseMatrix &W,
+                                          DenseMatrix &R) const
+{
+   DenseMatrix G;
+   BlockDot(W, W, G);
+   Orthonormalize(G, W, R, NULL, NULL);
+}
+
+// W(:,0:r-1) = W(:,piv(0:r-1)) L(0:r-1,0:r-1)^{-t}, keeping r columns
+static void SolveCholeskyColumns(DenseMatrix &W, const Array<int> &piv,
+                                 const DenseMatrix &L, int r)
+{
+   const int n = W.Height();
+   DenseMatrix V(n, r);
+   for (int j = 0; j < r; j++)
+   {
+      double *vj = V.GetColumn(j);
+      const double *wj = W.GetColumn(piv[j]);
+      for (int l = 0; l < n; l++) { vj[l] = wj[l]; }
+      for (int i = 0; i < j; i++)
+      {
+         const double *vi = V.GetColumn(i);
+         const double lji = L(j,i);
+         for (int l = 0; l < n; l++) { vj[l] -= lji*vi[l]; }
+      }
+      const double ljj = 1.0/L(j,j);
+      for (int l = 0; l < n; l++) { vj[l] *= ljj; }
+   }
+   W = V;
+}
+
+void BlockIterativeSolver::Orthonormalize(const DenseMatrix &G,
+                                          DenseMatrix &W, DenseMatrix &R,
+                                          DenseMatrix *MW,
+                                          DenseMatrix *C) const
+{
+   const int k = W.Width();
+
+   // Pivoted Cholesky factorization G(piv,piv) = L L^t, where L is k x r. The
+   // factorization stops when the remaining pivots are small compared to the
+   // largest diagonal entry of G.
+   Array<int> piv(k);
+   Vector d(k);
+   double dmax = 0.0;
+   for (int i = 0; i < k; i++)
+   {
+      piv[i] = i;
+      d(i) = G(i,i);
+      dmax = std::max(dmax, d(i));
+   }
+   const double tol = 1e-14 * dmax;
+   DenseMatrix L(k);
+   L = 0.0;
+   int r = 0;
+   for ( ; r < k; r++)
+   {
+      int jmax = r;
+      for (int j = r+1; j < k; j++)
+      {
+         if (d(piv[j]) > d(piv[jmax])) { jmax = j; }
+      }
+      if (!(d(piv[jmax]) > tol)) { break; }
+      if (jmax != r)
+      {
+         Swap(piv[r], piv[jmax]);
+         for (int i = 0; i < r; i++) { Swap(L(r,i), L(jmax,i)); }
       }
-      oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
-
-      rho_2 = rho_1;
-      resid = Norm(r);
-      MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
-      if (print_level >= 0)
+      const int p = piv[r];
+      L(r,r) = sqrt(d(p));
+      for (int j = r+1; j < k; j++)
       {
-         mfem::out << "   ||r|| = " << resid << '\n';
+         const int q = piv[j];
+         double s = G(q,p);
+         for (int i = 0; i < r; i++) { s -= L(j,i)*L(r,i); }
+         L(j,r) = s/L(r,r);
+         d(q) -= L(j,r)*L(j,r);
       }
-      if (resid < tol_goal)
+   }
+
+   // V = W(:,piv(0:r-1)) L(0:r-1,0:r-1)^{-t} and R(:,piv) = L^t
+   SolveCholeskyColumns(W, piv, L, r);
+   if (MW) { SolveCholeskyColumns(*MW, piv, L, r); }
+   if (C)
+   {
+      // C = L(0:r-1,0:r-1)^{-1} C(piv(0:r-1),:)
+      const int m = C->Width();
+      DenseMatrix LC(r, m);
+      for (int c = 0; c < m; c++)
       {
-         final_norm = resid;
-         final_iter = i;
-         converged = 1;
-         return;
+         for (int j = 0; j < r; j++)
+         {
+            double s = (*C)(piv[j],c);
+            for (int i = 0; i < j; i++) { s -= L(j,i)*LC(i,c); }
+            LC(j,c) = s/L(j,j);
+         }
       }
-      if (omega == 0)
+      *C = LC;
+   }
+   R.SetSize(r, k);
+   R = 0.0;
+   for (int j = 0; j < k; j++)
+   {
+      for (int i = 0; i < r && i <= j; i++)
       {
-         final_norm = resid;
-         final_iter = i;
-         converged = 0;
-         return;
+         R(i,piv[j]) = L(j,i);
       }
    }
-
-   final_norm = resid;
-   final_iter = max_iter;
-   converged = 0;
-}
-
-int BiCGSTAB(const Operator &A, Vector &x, const Vector &b, Solver &M,
-             int &max_iter, double &tol, double atol, int printit)
-{
-   BiCGSTABSolver bicgstab;
-   bicgstab.SetPrintLevel(printit);
-   bicgstab.SetMaxIter(max_iter);
-   bicgstab.SetRelTol(sqrt(tol));
-   bicgstab.SetAbsTol(sqrt(atol));
-   bicgstab.SetOperator(A);
-   bicgstab.SetPreconditioner(M);
-   bicgstab.Mult(b, x);
-   max_iter = bicgstab.GetNumIterations();
-   tol = bicgstab.GetFinalNorm()*bicgstab.GetFinalNorm();
-   return bicgstab.GetConverged();
 }
 
-void BiCGSTAB(const Operator &A, Solver &B, const Vector &b, Vector &x,
-              int print_iter, int max_num_iter, double rtol, double atol)
+void BlockIterativeSolver::Mult(const Vector &b, Vector &x) const
 {
-   BiCGSTAB(A, x, b, B, max_num_iter, rtol, atol, print_iter);
+   DenseMatrix B(const_cast<double*>(b.HostRead()), b.Size(), 1);
+   DenseMatrix X(x.HostReadWrite(), x.Size(), 1);
+   Mult(B, X);
 }
 
-
-void MINRESSolver::SetOperator(const Operator &op)
+// Remove the columns c of X for which keep[c] is false, preserving the order
+// of the remaining columns.
+static void KeepColumns(DenseMatrix &X, const Array<bool> &keep)
 {
-   IterativeSolver::SetOperator(op);
-   v0.SetSize(width);
-   v1.SetSize(width);
-   w0.SetSize(width);
-   w1.SetSize(width);
-   q.SetSize(width);
-   if (prec)
+   const int n = X.Height();
+   int kept = 0;
+   for (int c = 0; c < X.Width(); c++)
    {
-      u1.SetSize(width);
+      if (!keep[c]) { continue; }
+      if (kept != c)
+      {
+         const double *xc = X.GetColumn(c);
+         double *xk = X.GetColumn(kept);
+         for (int l = 0; l < n; l++) { xk[l] = xc[l]; }
+      }
+      kept++;
    }
+   X.SetSize(n, kept);
 }
 
-void MINRESSolver::Mult(const Vector &b, Vector &x) const
+// Copy the columns of X to the columns of Y starting at column c
+static void CopyColumns(const DenseMatrix &X, DenseMatrix &Y, int c)
 {
-   // Based on the MINRES algorithm on p. 86, Fig. 6.9 in
-   // "Iterative Krylov Methods for Large Linear Systems",
-   // by Henk A. van der Vorst, 2003.
-   // Extended to support an SPD preconditioner.
+   if (X.Width() == 0) { return; }
+   std::copy(X.Data(), X.Data() + X.Height()*X.Width(), Y.GetColumn(c));
+}
 
-   int it;
-   double beta, eta, gamma0, gamma1, sigma0, sigma1;
-   double alpha, delta, rho1, rho2, rho3, norm_goal;
-   Vector *z = (prec) ? &u1 : &v1;
+void BlockCGSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   MFEM_VERIFY(B.Height() == height, "invalid B.Height() = " << B.Height());
 
-   converged = 1;
+   const int n = width, k = B.Width();
+   DenseMatrix R, Z, AZ, P(n, 0), Q(n, 0), ZP, RAZ, G, C, H, E, F, EtE, PA;
+   DenseMatrix Rfac;
 
-   if (!iterative_mode)
+   if (iterative_mode)
    {
-      v1 = b;
-      x = 0.;
+      MFEM_VERIFY(X.Height() == n && X.Width() == k, "invalid X size");
+      MultiMult(*oper, X, R);
+      R *= -1.0;
+      R += B;   // R = B - A X
    }
    else
    {
-      oper->Mult(x, v1);
-      subtract(b, v1, v1);
+      X.SetSize(n, k);
+      X = 0.0;
+      R = B;
    }
 
-   if (prec)
+   // Active (not converged) columns, deflating the converged ones
+   Array<int> active(k), kept(k);
+   for (int c = 0; c < k; c++) { active[c] = c; }
+   Array<bool> keep(k);
+   Vector final_nom(k), r0(k);
+   double max_nom = 0.0;
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
    {
-      prec->Mult(v1, u1);
-   }
-   eta = beta = sqrt(Dot(*z, v1));
-   MFEM_ASSERT(IsFinite(eta), "eta = " << eta);
-   gamma0 = gamma1 = 1.;
-   sigma0 = sigma1 = 0.;
+      if (prec) { MultiMult(*prec, R, Z); } // Z = M R
+      else { Z = R; }
+      MultiMult(*oper, Z, AZ);             // AZ = A Z
+
+      // All the inner products of the iteration with one global reduction:
+      // G = [Z P]^t [R AZ]
+      const int m = Z.Width(), p = P.Width();
+      ZP.SetSize(n, m + p);
+      CopyColumns(Z, ZP, 0);
+      CopyColumns(P, ZP, m);
+      RAZ.SetSize(n, 2*m);
+      CopyColumns(R, RAZ, 0);
+      CopyColumns(AZ, RAZ, m);
+      BlockDot(ZP, RAZ, G);
+
+      max_nom = 0.0;
+      int num_active = 0;
+      keep.SetSize(m);
+      for (int c = 0; c < m; c++)
+      {
+         const double nom = G(c,c);   // (M r, r)
+         MFEM_ASSERT(IsFinite(nom), "nom(" << c << ") = " << nom);
+         if (i == 0)
+         {
+            r0(c) = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+         }
+         final_nom(active[c]) = nom;
+         max_nom = std::max(max_nom, nom);
+         keep[c] = (nom > r0(active[c]));
+         if (keep[c])
+         {
+            kept[num_active] = c;
+            active[num_active++] = active[c];
+         }
+      }
+      active.SetSize(num_active);
+      KeepColumns(R, keep);
+      KeepColumns(Z, keep);
+      KeepColumns(AZ, keep);
 
-   norm_goal = std::max(rel_tol*eta, abs_tol);
+      if (i == 0)
+      {
+         if (print_level == 1 || print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0
+                      << "  max (B r, r) = " << max_nom
+                      << (print_level == 3 ? " ...\n" : "\n");
+         }
+      }
+      else if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  max (B r, r) = "
+                   << max_nom << " (" << num_active << " active)\n";
+      }
+      if (num_active == 0)
+      {
+         if (i > 0 && print_level == 2)
+         {
+            mfem::out << "Number of Block PCG iterations: " << i << '\n';
+         }
+         else if (i > 0 && print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i
+                      << "  max (B r, r) = " << max_nom << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter) { break; }
+
+      // Blocks of G for the active columns: C = Z^t R, H = Z^t A Z,
+      // F = P^t R and E = P^t A Z
+      C.SetSize(num_active);
+      H.SetSize(num_active);
+      F.SetSize(p, num_active);
+      E.SetSize(p, num_active);
+      for (int b = 0; b < num_active; b++)
+      {
+         for (int a = 0; a < num_active; a++)
+         {
+            C(a,b) = G(kept[a],kept[b]);
+            H(a,b) = G(kept[a],m+kept[b]);
+         }
+         for (int a = 0; a < p; a++)
+         {
+            F(a,b) = G(m+a,kept[b]);
+            E(a,b) = G(m+a,m+kept[b]);
+         }
+      }
 
-   if (eta <= norm_goal)
+      // Z = Z + P beta with beta = -P^t A Z, i.e. A-orthogonal to P, since
+      // P^t A P = I. Then Z^t A Z = H - E^t E and Z^t R = C + beta^t F.
+      if (p > 0)
+      {
+         E *= -1.0;
+         AddMult(P, E, Z);
+         AddMult(Q, E, AZ);
+         EtE.SetSize(num_active);
+         MultAtB(E, E, EtE);
+         H -= EtE;
+         MultAtB(E, F, EtE);
+         C += EtE;
+      }
+
+      // P = Z V and Q = A P with P^t A P = I, alpha = P^t R
+      Orthonormalize(H, Z, Rfac, &AZ, &C);
+      if (Z.Width() == 0)
+      {
+         final_iter = i;   // the search space can not be extended
+         break;
+      }
+      P = Z;
+      Q = AZ;
+
+      PA.SetSize(n, num_active);
+      mfem::Mult(P, C, PA);
+      for (int c = 0; c < num_active; c++)
+      {
+         const double *pa = PA.GetColumn(c);
+         double *xc = X.GetColumn(active[c]);
+         for (int l = 0; l < n; l++) { xc[l] += pa[l]; }   // X = X + P alpha
+      }
+      AddMult_a(-1.0, Q, C, R);    // R = R - A P alpha
+   }
+   final_norm = sqrt((k > 0) ? final_nom.Max() : 0.0);
+
+   if (print_level >= 0 && !converged)
    {
-      it = 0;
-      goto loop_end;
+      mfem::out << "Block PCG: No convergence!" << '\n';
    }
+}
 
-   if (print_level == 1 || print_level == 3)
+void BlockGMRESSolver::Mult(const DenseMatrix &B, DenseMatrix &X) const
+{
+   MFEM_VERIFY(B.Height() == height, "invalid B.Height() = " << B.Height());
+
+   const int n = width, k = B.Width();
+   if (iterative_mode)
    {
-      mfem::out << "MINRES: iteration " << setw(3) << 0 << ": ||r||_B = "
-                << eta << (print_level == 3 ? " ...\n" : "\n");
+      MFEM_VERIFY(X.Height() == n && X.Width() == k, "invalid X size");
+   }
+   else
+   {
+      X.SetSize(n, k);
+      X = 0.0;
    }
 
-   for (it = 1; it <= max_iter; it++)
+   DenseMatrix R, W, T, S1, S2, XA;
+   Array<DenseMatrix *> V(m+1);
+   V = NULL;
+   Vector beta0(k), tol(k), final_res(k);
+   Array<int> active(k);
+   Array<bool> keep;
+   for (int c = 0; c < k; c++) { active[c] = c; }
+
+   int it = 0, pass = 0;
+   converged = 0;
+   while (true)
    {
-      v1 /= beta;
-      if (prec)
-      {
-         u1 /= beta;
-      }
-      oper->Mult(*z, q);
-      alpha = Dot(*z, q);
-      MFEM_ASSERT(IsFinite(alpha), "alpha = " << alpha);
-      if (it > 1) // (v0 == 0) for (it == 1)
+      // R = M (B - A X) for the active columns
+      XA.SetSize(n, active.Size());
+      R.SetSize(height, active.Size());
+      for (int c = 0; c < active.Size(); c++)
       {
-         q.Add(-beta, v0);
+         XA.SetCol(c, X.GetColumn(active[c]));
+         R.SetCol(c, B.GetColumn(active[c]));
       }
-      add(q, -alpha, v1, v0);
-
-      delta = gamma1*alpha - gamma0*sigma1*beta;
-      rho3 = sigma0*beta;
-      rho2 = sigma1*alpha + gamma0*gamma1*beta;
-      if (!prec)
+      if (iterative_mode || pass > 0)
       {
-         beta = Norm(v0);
+         MultiMult(*oper, XA, T);
+         R.Add(-1.0, T);
       }
-      else
+      if (prec)
       {
-         prec->Mult(v0, q);
-         beta = sqrt(Dot(v0, q));
+         MultiMult(*prec, R, T);
+         R = T;
       }
-      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
-      rho1 = hypot(delta, beta);
 
-      if (it == 1)
+      Vector res;
+      ColumnDot(R, R, res);
+      keep.SetSize(active.Size());
+      int num_active = 0;
+      for (int c = 0; c < active.Size(); c++)
       {
-         w0.Set(1./rho1, *z);   // (w0 == 0) and (w1 == 0)
+         const int a = active[c];
+         res(c) = sqrt(res(c));
+         MFEM_ASSERT(IsFinite(res(c)), "res(" << c << ") = " << res(c));
+         if (pass == 0)
+         {
+            beta0(a) = res(c);
+            tol(a) = std::max(rel_tol*res(c), abs_tol);
+         }
+         final_res(a) = res(c);
+         keep[c] = (res(c) > tol(a));
+         if (keep[c]) { active[num_active++] = a; }
       }
-      else if (it == 2)
+      if (pass == 0 && (print_level == 1 || print_level == 3))
       {
-         add(1./rho1, *z, -rho2/rho1, w1, w0);   // (w0 == 0)
+         mfem::out << "   Pass : " << setw(2) << 1
+                   << "   Iteration : " << setw(3) << 0
+                   << "  max ||B r|| = " << ((k > 0) ? final_res.Max() : 0.0)
+                   << (print_level == 3 ? " ...\n" : "\n");
       }
-      else
+      active.SetSize(num_active);
+      KeepColumns(R, keep);
+      pass++;
+
+      if (num_active == 0) { converged = 1; break; }
+      if (it >= max_iter) { break; }
+
+      // First block of the Arnoldi basis, R = V_0 S with CholQR2. The block
+      // size s of the cycle is the rank of R.
+      const int p = num_active;
+      if (!V[0]) { V[0] = new DenseMatrix; }
+      *V[0] = R;
+      Orthonormalize(*V[0], S1);
+      Orthonormalize(*V[0], S2);
+      const int s = V[0]->Width();
+      MFEM_VERIFY(s > 0, "invalid residual");
+
+      // Block Hessenberg matrix, reduced to triangular form with Householder
+      // reflections (stored in U), and the reduced right-hand side G
+      DenseMatrix H((m+1)*s, m*s), U(2*s, m*s), G((m+1)*s, p);
+      H = 0.0;
+      G = 0.0;
+      T.SetSize(S2.Height(), p);
+      mfem::Mult(S2, S1, T);
+      for (int c = 0; c < p; c++)
       {
-         add(-rho3/rho1, w0, -rho2/rho1, w1, w0);
-         w0.Add(1./rho1, *z);
+         for (int i = 0; i < T.Height(); i++) { G(i,c) = T(i,c); }
       }
 
-      gamma0 = gamma1;
-      gamma1 = delta/rho1;
-
-      x.Add(gamma1*eta, w0);
+      int j = 0;
+      for ( ; j < m && it < max_iter; )
+      {
+         // W = M A V_j
+         MultiMult(*oper, *V[j], T);
+         if (prec) { MultiMult(*prec, T, W); }
+         else { W = T; }
+
+         // Block modified Gram-Schmidt
+         DenseMatrix Hij;
+         for (int i = 0; i <= j; i++)
+         {
+            BlockDot(*V[i], W, Hij);
+            AddMult_a(-1.0, *V[i], Hij, W);
+            for (int a = 0; a < s; a++)
+            {
+               for (int b = 0; b < s; b++) { H(i*s+a, j*s+b) = Hij(a,b); }
+            }
+         }
 
-      sigma0 = sigma1;
-      sigma1 = beta/rho1;
+         // W = V_{j+1} H_{j+1,j} with CholQR2
+         Orthonormalize(W, S1);
+         Orthonormalize(W, S2);
+         Hij.SetSize(S2.Height(), s);
+         mfem::Mult(S2, S1, Hij);
+         const bool breakdown = (W.Width() < s);
+         for (int a = 0; a < Hij.Height(); a++)
+         {
+            for (int b = 0; b < s; b++) { H((j+1)*s+a, j*s+b) = Hij(a,b); }
+         }
+         if (!breakdown)
+         {
+            if (!V[j+1]) { V[j+1] = new DenseMatrix; }
+            *V[j+1] = W;
+         }
 
-      eta = -sigma1*eta;
-      MFEM_ASSERT(IsFinite(eta), "eta = " << eta);
+         // Apply the previous reflections to the new block column
+         for (int q = 0; q < j*s; q++)
+         {
+            const int len = 2*s - q % s;
+            for (int b = 0; b < s; b++)
+            {
+               double d = 0.0;
+               for (int l = 0; l < len; l++) { d += U(l,q) * H(q+l, j*s+b); }
+               for (int l = 0; l < len; l++) { H(q+l, j*s+b) -= 2.0*d*U(l,q); }
+            }
+         }
+         // Compute the new reflections and apply them to H and G
+         for (int a = 0; a < s; a++)
+         {
+            const int q = j*s + a, len = 2*s - a;
+            double nrm = 0.0;
+            for (int l = 0; l < len; l++) { nrm += H(q+l,q)*H(q+l,q); }
+            nrm = sqrt(nrm);
+            for (int l = 0; l < len; l++) { U(l,q) = 0.0; }
+            if (nrm == 0.0) { continue; }
+            const double alpha = (H(q,q) > 0.0) ? -nrm : nrm;
+            for (int l = 0; l < len; l++) { U(l,q) = H(q+l,q); }
+            U(0,q) -= alpha;
+            double unrm = 0.0;
+            for (int l = 0; l < len; l++) { unrm += U(l,q)*U(l,q); }
+            unrm = sqrt(unrm);
+            for (int l = 0; l < len; l++) { U(l,q) /= unrm; }
+            for (int b = a; b < s; b++)
+            {
+               double d = 0.0;
+               for (int l = 0; l < len; l++) { d += U(l,q) * H(q+l, j*s+b); }
+               for (int l = 0; l < len; l++) { H(q+l, j*s+b) -= 2.0*d*U(l,q); }
+            }
+            for (int c = 0; c < p; c++)
+            {
+               double d = 0.0;
+               for (int l = 0; l < len; l++) { d += U(l,q) * G(q+l,c); }
+               for (int l = 0; l < len; l++) { G(q+l,c) -= 2.0*d*U(l,q); }
+            }
+         }
 
-      if (fabs(eta) <= norm_goal)
-      {
-         goto loop_end;
+         // Residual norms of the least squares problem
+         bool all_converged = true;
+         double max_res = 0.0;
+         for (int c = 0; c < p; c++)
+         {
+            double r2 = 0.0;
+            for (int a = 0; a < s; a++) { r2 += G((j+1)*s+a,c)*G((j+1)*s+a,c); }
+            final_res(active[c]) = sqrt(r2);
+            max_res = std::max(max_res, sqrt(r2));
+            if (sqrt(r2) > tol(active[c])) { all_converged = false; }
+         }
+         j++;
+         it++;
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << pass
+                      << "   Iteration : " << setw(3) << it
+                      << "  max ||B r|| = " << max_res << '\n';
+         }
+         if (all_converged || breakdown) { break; }
       }
 
-      if (print_level == 1)
+      // Solve the triangular system H Y = G and update X = X + [V_0..V_j-1] Y
+      const int js = j*s;
+      double hmax = 0.0;
+      for (int q = 0; q < js; q++) { hmax = std::max(hmax, fabs(H(q,q))); }
+      DenseMatrix Y(js, p);
+      for (int c = 0; c < p; c++)
       {
-         mfem::out << "MINRES: iteration " << setw(3) << it << ": ||r||_B = "
-                   << fabs(eta) << '\n';
+         for (int q = js-1; q >= 0; q--)
+         {
+            double y = G(q,c);
+            for (int l = q+1; l < js; l++) { y -= H(q,l)*Y(l,c); }
+            Y(q,c) = (fabs(H(q,q)) > 1e-14*hmax) ? y/H(q,q) : 0.0;
+         }
       }
-
-      if (prec)
+      for (int c = 0; c < p; c++)
       {
-         Swap(u1, q);
+         double *xc = X.GetColumn(active[c]);
+         for (int i = 0; i < j; i++)
+         {
+            for (int a = 0; a < s; a++)
+            {
+               const double y = Y(i*s+a,c);
+               const double *v = V[i]->GetColumn(a);
+               for (int l = 0; l < n; l++) { xc[l] += y*v[l]; }
+            }
+         }
       }
-      Swap(v0, v1);
-      Swap(w0, w1);
    }
-   converged = 0;
-   it--;
 
-loop_end:
    final_iter = it;
-   final_norm = fabs(eta);
+   final_norm = (k > 0) ? final_res.Max() : 0.0;
+   if (print_level == 2)
+   {
+      mfem::out << "Block GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   else if (print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << pass
+                << "   Iteration : " << setw(3) << final_iter
+                << "  max ||B r|| = " << final_norm << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Block GMRES: No convergence!\n";
+   }
+
+   for (int i = 0; i <= m; i++) { delete V[i]; }
+}
+
+
+void NewtonSolver::SetOperator(const Operator &op)
+{
+   oper = &op;
+   height = op.Height();
+   width = op.Width();
+   MFEM_ASSERT(height == width, "square Operator is required.");
+
+   r.SetSize(width);
+   c.SetSize(width);
+
+   grad = NULL;
+   grad_age = 0;
+   jf_oper.SetSize(width);
+}
+
+void NewtonSolver::JacobianFreeOperator::Mult(const Vector &v, Vector &y) const
+{
+   const Vector *pv = &v;
+   if (newton.jf_prec)
+   {
+      z.SetSize(width);
+      newton.jf_prec->Mult(v, z);
+      pv = &z;
+   }
+   const double v_norm = newton.Norm(*pv);
+   if (v_norm == 0.0)
+   {
+      y = 0.0;
+      return;
+   }
+   const double h = newton.fd_eps*(1.0 + x_norm)/v_norm;
 
-   if (print_level == 1 || print_level == 3)
+   xp.SetSize(width);
+   add(*x, h, *pv, xp);
+   newton.oper->Mult(xp, y);
+   if (b)
    {
-      mfem::out << "MINRES: iteration " << setw(3) << final_iter << ": ||r||_B = "
-                << final_norm << '\n';
+      y -= *b;
    }
-   else if (print_level == 2)
+   y -= *r;    // y = F(x + h v) - F(x)
+   y /= h;
+}
+
+void NewtonSolver::SetAdaptiveLinRtol(int type, double rtol0, double rtol_max,
+                                      double alpha, double gamma)
+{
+   MFEM_VERIFY(type >= 0 && type <= 2, "invalid forcing term type: " << type);
+   lin_rtol_type = type;
+   lin_rtol0 = rtol0;
+   lin_rtol_max = rtol_max;
+   eta_alpha = alpha;
+   eta_gamma = gamma;
+}
+
+void NewtonSolver::AdaptiveLinRtolPreSolve(int it, double fnorm) const
+{
+   IterativeSolver *lin_solver = dynamic_cast<IterativeSolver*>(prec);
+   MFEM_VERIFY(lin_solver, "the adaptive linear tolerance requires an "
+               "IterativeSolver");
+
+   double eta;
+   if (it == 0)
    {
-      mfem::out << "MINRES: number of iterations: " << final_iter << '\n';
+      eta = lin_rtol0;
    }
-#if 0
-   if (print_level >= 1)
+   else
    {
-      oper->Mult(x, v1);
-      subtract(b, v1, v1);
-      if (prec)
+      if (lin_rtol_type == 1)
       {
-         prec->Mult(v1, u1);
+         eta = fabs(fnorm - lnorm_last)/fnorm_last;
       }
-      eta = sqrt(Dot(*z, v1));
-      mfem::out << "MINRES: iteration " << setw(3) << it << ": ||r||_B = "
-                << eta << " (re-computed)" << '\n';
+      else
+      {
+         eta = eta_gamma*pow(fnorm/fnorm_last, eta_alpha);
+      }
+      // Safeguard against oversolving
+      const double eta_sg = (lin_rtol_type == 1) ?
+                            pow(eta_last, 0.5*(1.0 + sqrt(5.0))) :
+                            eta_gamma*pow(eta_last, eta_alpha);
+      if (eta_sg > 0.1) { eta = std::max(eta, eta_sg); }
    }
-#endif
-   if (!converged && print_level >= 0)
+   eta = std::min(eta, lin_rtol_max);
+   lin_solver->SetRelTol(eta);
+   eta_last = eta;
+
+   if (print_level >= 1)
    {
-      mfem::out << "MINRES: No convergence!\n";
+      mfem::out << "   linear solver relative tolerance = " << eta << '\n';
    }
 }
 
-void MINRES(const Operator &A, const Vector &b, Vector &x, int print_it,
-            int max_it, double rtol, double atol)
-{
-   MINRESSolver minres;
-   minres.SetPrintLevel(print_it);
-   minres.SetMaxIter(max_it);
-   minres.SetRelTol(sqrt(rtol));
-   minres.SetAbsTol(sqrt(atol));
-   minres.SetOperator(A);
-   minres.Mult(b, x);
-}
-
-void MINRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
-            int print_it, int max_it, double rtol, double atol)
+void NewtonSolver::AdaptiveLinRtolPostSolve(const Operator &J,
+                                            const Vector &c, double c_scale,
+                                            double fnorm) const
 {
-   MINRESSolver minres;
-   minres.SetPrintLevel(print_it);
-   minres.SetMaxIter(max_it);
-   minres.SetRelTol(sqrt(rtol));
-   minres.SetAbsTol(sqrt(atol));
-   minres.SetOperator(A);
-   minres.SetPreconditioner(B);
-   minres.Mult(b, x);
+   fnorm_last = fnorm;
+   if (lin_rtol_type == 1)
+   {
+      // Norm of the linear model of the step s = -c_scale c: F(x) + DF s
+      if (c_scale == 1.0)
+      {
+         lnorm_last = static_cast<IterativeSolver*>(prec)->GetFinalNorm();
+      }
+      else
+      {
+         lin_res.SetSize(r.Size());
+         J.Mult(c, lin_res);
+         add(r, -c_scale, lin_res, lin_res);
+         lnorm_last = Norm(lin_res);
+      }
+   }
 }
 
-
-void NewtonSolver::SetOperator(const Operator &op)
+void NewtonSolver::UpdateGradient(const Vector &x, int it, double norm,
+                                  double norm_prev) const
 {
-   oper = &op;
-   height = op.Height();
-   width = op.Width();
-   MFEM_ASSERT(height == width, "square Operator is required.");
+   if (jacobian_free && !(jf_prec && jf_prec_setup)) { return; }
 
-   r.SetSize(width);
-   c.SetSize(width);
+   const bool stalled = (it > 0 && norm > grad_stall_factor*norm_prev);
+   if (grad == NULL || grad_age >= max_grad_reuse || stalled)
+   {
+      grad = &oper->GetGradient(x);
+      if (jacobian_free)
+      {
+         jf_prec->SetOperator(*grad);
+      }
+      else
+      {
+         prec->SetOperator(*grad);
+      }
+      grad_age = 0;
+      num_grad_setups++;
+   }
+   else
+   {
+      grad_age++;
+      num_grad_reuses++;
+   }
 }
 
 void NewtonSolver::Mult(const Vector &b, Vector &x) const
@@ -1342,8 +3328,9 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
    MFEM_ASSERT(prec != NULL, "the Solver is not set (use SetSolver).");
 
    int it;
-   double norm0, norm, norm_goal;
+   double norm0, norm, norm_prev, norm_goal;
    const bool have_b = (b.Size() == Height());
+   const int grad_setups0 = num_grad_setups, grad_reuses0 = num_grad_reuses;
 
    if (!iterative_mode)
    {
@@ -1356,11 +3343,34 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
       r -= b;
    }
 
-   norm0 = norm = Norm(r);
+   norm0 = norm = norm_prev = Norm(r);
    norm_goal = std::max(rel_tol*norm, abs_tol);
 
    prec->iterative_mode = false;
 
+   // The adaptive tolerance overwrites the one of the linear solver
+   IterativeSolver *lin_solver = dynamic_cast<IterativeSolver*>(prec);
+   const double lin_rtol = (lin_rtol_type && lin_solver) ?
+                           lin_solver->GetRelTol() : 0.0;
+
+   // In the Jacobian-free mode, the linear solver is applied to the finite
+   // difference operator J P^{-1}, with solution w, and c = P^{-1} w
+   Vector w;
+   if (jacobian_free)
+   {
+      MFEM_VERIFY(lin_solver, "the Jacobian-free mode requires an "
+                  "IterativeSolver");
+      jf_oper.x = &x;
+      jf_oper.r = &r;
+      jf_oper.b = have_b ? &b : NULL;
+      prec->SetOperator(jf_oper);
+      if (jf_prec)
+      {
+         jf_prec->iterative_mode = false;
+         w.SetSize(width);
+      }
+   }
+
    // x_{i+1} = x_i - [DF(x_i)]^{-1} [F(x_i)-b]
    for (it = 0; true; it++)
    {
@@ -1388,9 +3398,26 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
          break;
       }
 
-      prec->SetOperator(oper->GetGradient(x));
+      UpdateGradient(x, it, norm, norm_prev);
+
+      if (lin_rtol_type)
+      {
+         AdaptiveLinRtolPreSolve(it, norm);
+      }
 
-      prec->Mult(r, c);  // c = [DF(x_i)]^{-1} [F(x_i)-b]
+      if (jacobian_free)
+      {
+         jf_oper.x_norm = Norm(x);
+      }
+      if (jacobian_free && jf_prec)
+      {
+         prec->Mult(r, w);
+         jf_prec->Mult(w, c);
+      }
+      else
+      {
+         prec->Mult(r, c);  // c = [DF(x_i)]^{-1} [F(x_i)-b]
+      }
 
       const double c_scale = ComputeScalingFactor(x, b);
       if (c_scale == 0.0)
@@ -1398,6 +3425,18 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
          converged = 0;
          break;
       }
+
+      if (lin_rtol_type)
+      {
+         if (jacobian_free)
+         {
+            AdaptiveLinRtolPostSolve(jf_oper, jf_prec ? w : c, c_scale, norm);
+         }
+         else
+         {
+            AdaptiveLinRtolPostSolve(*grad, c, c_scale, norm);
+         }
+      }
       add(x, -c_scale, c, x);
 
       ProcessNewState(x);
@@ -1407,11 +3446,23 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
       {
          r -= b;
       }
+      norm_prev = norm;
       norm = Norm(r);
    }
 
    final_iter = it;
    final_norm = norm;
+
+   if (lin_rtol_type && lin_solver)
+   {
+      lin_solver->SetRelTol(lin_rtol);
+   }
+
+   if (print_level >= 0 && max_grad_reuse > 0)
+   {
+      mfem::out << "Newton: gradient setups: " << num_grad_setups - grad_setups0
+                << ", reused: " << num_grad_reuses - grad_reuses0 << '\n';
+   }
 }
 
 
@@ -1966,6 +4017,43 @@ void MinimumDiscardedFillOrdering(SparseMatrix &C, Array<int> &p)
    }
 }
 
+// Group the rows of a triangular factor in levels of rows which only depend on
+// rows of previous levels. Row i depends on the rows J[k], I[i] <= k < I[i+1],
+// with J[k] < i for a lower triangular factor and J[k] > i for an upper one;
+// the other entries are ignored.
+static void TriangularLevels(int n, const int *I, const int *J, bool lower,
+                             Array<int> &ptr, Array<int> &rows)
+{
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int t=0; t<n; ++t)
+   {
+      int i = lower ? t : n-1-t;
+      int lev = 0;
+      for (int k=I[i]; k<I[i+1]; ++k)
+      {
+         int j = J[k];
+         if (lower ? j < i : j > i) { lev = std::max(lev, level[j] + 1); }
+      }
+      level[i] = lev;
+      num_levels = std::max(num_levels, lev + 1);
+   }
+
+   ptr.SetSize(num_levels + 1);
+   ptr = 0;
+   for (int i=0; i<n; ++i)
+   {
+      ptr[level[i] + 1]++;
+   }
+   ptr.PartialSum();
+   Array<int> pos(ptr);
+   rows.SetSize(n);
+   for (int i=0; i<n; ++i)
+   {
+      rows[pos[level[i]]++] = i;
+   }
+}
+
 BlockILU::BlockILU(int block_size_,
                    Reordering reordering_,
                    int k_fill_)
@@ -2009,6 +4097,7 @@ void BlockILU::SetOperator(const Operator &op)
    MFEM_ASSERT(A->Finalized(), "Matrix must be finalized.");
    CreateBlockPattern(*A);
    Factorize();
+   ComputeLevels();
 }
 
 void BlockILU::CreateBlockPattern(const SparseMatrix &A)
@@ -2074,6 +4163,15 @@ void BlockILU::CreateBlockPattern(const SparseMatrix &A)
          case Reordering::MINIMUM_DISCARDED_FILL:
             MinimumDiscardedFillOrdering(C, P);
             break;
+         case Reordering::REVERSE_CUTHILL_MCKEE:
+            ReverseCuthillMcKeeOrdering(C, P);
+            break;
+         case Reordering::APPROXIMATE_MINIMUM_DEGREE:
+            ApproximateMinimumDegreeOrdering(C, P);
+            break;
+         case Reordering::NESTED_DISSECTION:
+            NestedDissectionOrdering(C, P);
+            break;
          default:
             MFEM_ABORT("BlockILU: unknown reordering")
       }
@@ -2215,53 +4313,404 @@ void BlockILU::Factorize()
    }
 }
 
+void BlockILU::ComputeLevels()
+{
+   int nblockrows = Height()/block_size;
+   TriangularLevels(nblockrows, IB.GetData(), JB.GetData(), true,
+                    lower_ptr, lower_rows);
+   TriangularLevels(nblockrows, IB.GetData(), JB.GetData(), false,
+                    upper_ptr, upper_rows);
+}
+
 void BlockILU::Mult(const Vector &b, Vector &x) const
 {
    MFEM_ASSERT(height > 0, "BlockILU(0) preconditioner is not constructed");
-   int nblockrows = Height()/block_size;
+   const int bs = block_size, bs2 = bs*bs;
    y.SetSize(Height());
-
-   DenseMatrix B;
-   Vector yi, yj, xi, xj;
-   Vector tmp(block_size);
-   // Forward substitute to solve Ly = b
+   y.UseDevice(true);
+
+   // The blocks are accessed through raw pointers, with the column-major
+   // layout of the DenseTensor AB, and the diagonal blocks are solved with
+   // the pivoted LU factors in DB, as in LUFactors::Solve().
+   const int ipiv_base = LUFactors::ipiv_base;
+   auto d_b = b.Read();
+   auto d_P = P.Read();
+   auto d_IB = IB.Read();
+   auto d_ID = ID.Read();
+   auto d_JB = JB.Read();
+   auto d_AB = Read(AB.GetMemory(), AB.TotalSize());
+
+   // Forward substitute to solve Ly = b, the block rows of a level in parallel
    // Implicitly, L has identity on the diagonal
-   y = 0.0;
-   for (int i=0; i<nblockrows; ++i)
+   auto d_lower = lower_rows.Read();
+   auto d_y = y.Write();
+   for (int l=0; l<lower_ptr.Size()-1; ++l)
+   {
+      const int begin = lower_ptr[l];
+      MFEM_FORALL(t, lower_ptr[l+1] - begin,
+      {
+         const int i = d_lower[begin + t];
+         double *yi = d_y + i*bs;
+         for (int ib=0; ib<bs; ++ib)
+         {
+            yi[ib] = d_b[ib + d_P[i]*bs];
+         }
+         for (int k=d_IB[i]; k<d_ID[i]; ++k)
+         {
+            // y_i = y_i - L_ij*y_j
+            const double *L_ij = d_AB + k*bs2;
+            const double *yj = d_y + d_JB[k]*bs;
+            for (int jb=0; jb<bs; ++jb)
+            {
+               for (int ib=0; ib<bs; ++ib)
+               {
+                  yi[ib] -= L_ij[ib + jb*bs]*yj[jb];
+               }
+            }
+         }
+      });
+   }
+
+   // Backward substitution to solve Ux = y, the block rows of a level in
+   // parallel
+   auto d_DB = Read(DB.GetMemory(), DB.TotalSize());
+   auto d_ipiv = ipiv.Read();
+   auto d_upper = upper_rows.Read();
+   auto d_x = x.Write();
+   for (int l=0; l<upper_ptr.Size()-1; ++l)
+   {
+      const int begin = upper_ptr[l];
+      MFEM_FORALL(t, upper_ptr[l+1] - begin,
+      {
+         const int i = d_upper[begin + t];
+         double *xi = d_x + d_P[i]*bs;
+         for (int ib=0; ib<bs; ++ib)
+         {
+            xi[ib] = d_y[ib + i*bs];
+         }
+         for (int k=d_ID[i]+1; k<d_IB[i+1]; ++k)
+         {
+            // x_i = x_i - U_ij*x_j
+            const double *U_ij = d_AB + k*bs2;
+            const double *xj = d_x + d_P[d_JB[k]]*bs;
+            for (int jb=0; jb<bs; ++jb)
+            {
+               for (int ib=0; ib<bs; ++ib)
+               {
+                  xi[ib] -= U_ij[ib + jb*bs]*xj[jb];
+               }
+            }
+         }
+         // x_i = D_ii^{-1} x_i
+         const double *D_ii = d_DB + i*bs2;
+         const int *piv = d_ipiv + i*bs;
+         for (int ib=0; ib<bs; ++ib)
+         {
+            const int p = piv[ib] - ipiv_base;
+            const double tmp = xi[ib];
+            xi[ib] = xi[p];
+            xi[p] = tmp;
+         }
+         for (int jb=0; jb<bs; ++jb)
+         {
+            for (int ib=jb+1; ib<bs; ++ib)
+            {
+               xi[ib] -= D_ii[ib + jb*bs]*xi[jb];
+            }
+         }
+         for (int jb=bs-1; jb>=0; --jb)
+         {
+            xi[jb] /= D_ii[jb + jb*bs];
+            for (int ib=0; ib<jb; ++ib)
+            {
+               xi[ib] -= D_ii[ib + jb*bs]*xi[jb];
+            }
+         }
+      });
+   }
+}
+
+LevelScheduledILU::LevelScheduledILU(int k_fill_, Type type_, bool reorder_)
+   : Solver(0),
+     k_fill(k_fill_),
+     type(type_),
+     reorder(reorder_)
+{ }
+
+LevelScheduledILU::LevelScheduledILU(const Operator &op, int k_fill_,
+                                     Type type_, bool reorder_)
+   : LevelScheduledILU(k_fill_, type_, reorder_)
+{
+   SetOperator(op);
+}
+
+void LevelScheduledILU::SetOperator(const Operator &op)
+{
+   const SparseMatrix *A = dynamic_cast<const SparseMatrix *>(&op);
+   if (A == NULL)
+   {
+      MFEM_ABORT("LevelScheduledILU must be created with a SparseMatrix");
+   }
+   MFEM_VERIFY(A->Finalized(), "Matrix must be finalized.");
+   MFEM_VERIFY(A->Height() == A->Width(), "Matrix must be square.");
+   MFEM_VERIFY(k_fill >= 0, "Invalid level of fill: " << k_fill);
+   height = op.Height();
+   width = op.Width();
+
+   if (reorder)
+   {
+      ReverseCuthillMcKeeOrdering(*A, perm);
+      perm_inv.SetSize(height);
+      for (int i=0; i<height; ++i)
+      {
+         perm_inv[perm[i]] = i;
+      }
+   }
+   else
+   {
+      perm.DeleteAll();
+      perm_inv.DeleteAll();
+   }
+
+   SymbolicFactorization(*A);
+   NumericFactorization(*A);
+   ComputeLevels();
+}
+
+void LevelScheduledILU::SymbolicFactorization(const SparseMatrix &A)
+{
+   int n = height;
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+   bool permuted = perm.Size() > 0;
+
+   // Level of fill of the entries of the current row (-1: not in the pattern)
+   // and of the entries of U, used for the following rows
+   std::vector<int> lev(n, -1);
+   Array<int> U_lev;
+   std::set<int> cols;
+
+   LI.SetSize(n + 1);
+   UI.SetSize(n + 1);
+   LJ.SetSize(0);
+   UJ.SetSize(0);
+   LI[0] = UI[0] = 0;
+   for (int i=0; i<n; ++i)
+   {
+      // The pattern of the row of A, and the diagonal
+      int row = permuted ? perm[i] : i;
+      cols.clear();
+      for (int k=I[row]; k<I[row+1]; ++k)
+      {
+         int j = permuted ? perm_inv[J[k]] : J[k];
+         cols.insert(j);
+         lev[j] = 0;
+      }
+      cols.insert(i);
+      lev[i] = 0;
+
+      // Fill from the rows k < i of U, in increasing order of k. The new
+      // entries are to the right of k, so they are visited later.
+      for (auto it = cols.begin(); it != cols.end() && *it < i; ++it)
+      {
+         int k = *it;
+         for (int kk=UI[k]+1; kk<UI[k+1]; ++kk)
+         {
+            int j = UJ[kk];
+            int lev_ij = lev[k] + U_lev[kk] + 1;
+            if (lev_ij > k_fill) { continue; }
+            if (lev[j] < 0)
+            {
+               cols.insert(j);
+               lev[j] = lev_ij;
+            }
+            else
+            {
+               lev[j] = std::min(lev[j], lev_ij);
+            }
+         }
+      }
+
+      // L ends with the diagonal and U starts with it
+      for (int j : cols)
+      {
+         if (j < i)
+         {
+            LJ.Append(j);
+         }
+         else
+         {
+            UJ.Append(j);
+            U_lev.Append(lev[j]);
+         }
+         lev[j] = -1;
+      }
+      LJ.Append(i);
+      LI[i+1] = LJ.Size();
+      UI[i+1] = UJ.Size();
+   }
+}
+
+void LevelScheduledILU::NumericFactorization(const SparseMatrix &A)
+{
+   int n = height;
+   const int *I = A.HostReadI();
+   const int *J = A.HostReadJ();
+   const double *V = A.HostReadData();
+   bool permuted = perm.Size() > 0;
+
+   LV.SetSize(LJ.Size());
+   UV.SetSize(UJ.Size());
+   double *lv = LV.HostWrite();
+   double *uv = UV.HostWrite();
+
+   // Row i is eliminated in the dense work vector w, restricted to its pattern
+   std::vector<double> w(n, 0.0);
+   std::vector<int> in_row(n, -1);
+   for (int i=0; i<n; ++i)
    {
-      yi.SetDataAndSize(&y[i*block_size], block_size);
-      for (int ib=0; ib<block_size; ++ib)
+      for (int k=LI[i]; k<LI[i+1]; ++k) { in_row[LJ[k]] = i; }
+      for (int k=UI[i]; k<UI[i+1]; ++k) { in_row[UJ[k]] = i; }
+      int row = permuted ? perm[i] : i;
+      for (int k=I[row]; k<I[row+1]; ++k)
+      {
+         w[permuted ? perm_inv[J[k]] : J[k]] += V[k];
+      }
+
+      for (int kk=LI[i]; kk<LI[i+1]-1; ++kk)
       {
-         yi[ib] = b[ib + P[i]*block_size];
+         int k = LJ[kk];
+         double l_ik = w[k] / uv[UI[k]];
+         for (int jj=UI[k]+1; jj<UI[k+1]; ++jj)
+         {
+            int j = UJ[jj];
+            if (in_row[j] == i) { w[j] -= l_ik*uv[jj]; }
+         }
+         lv[kk] = l_ik;
+         w[k] = 0.0;
       }
-      for (int k=IB[i]; k<ID[i]; ++k)
+      lv[LI[i+1]-1] = 1.0;
+      for (int jj=UI[i]; jj<UI[i+1]; ++jj)
       {
-         int j = JB[k];
-         const DenseMatrix &L_ij = AB(k);
-         yj.SetDataAndSize(&y[j*block_size], block_size);
-         // y_i = y_i - L_ij*y_j
-         L_ij.AddMult_a(-1.0, yj, yi);
+         uv[jj] = w[UJ[jj]];
+         w[UJ[jj]] = 0.0;
       }
+      MFEM_VERIFY(uv[UI[i]] != 0.0, "Zero pivot in row " << i);
    }
-   // Backward substitution to solve Ux = y
-   for (int i=nblockrows-1; i >= 0; --i)
+
+   if (type == Type::IC)
    {
-      xi.SetDataAndSize(&x[P[i]*block_size], block_size);
-      for (int ib=0; ib<block_size; ++ib)
+      // For a symmetric matrix, L = U^t D^{-1} with D = diag(U), so the
+      // factorization is U^t U after scaling the rows of U by D^{-1/2}
+      for (int i=0; i<n; ++i)
       {
-         xi[ib] = y[ib + i*block_size];
+         double d = uv[UI[i]];
+         MFEM_VERIFY(d > 0.0, "Matrix is not positive definite, pivot " << d
+                     << " in row " << i);
+         double s = 1.0/sqrt(d);
+         for (int jj=UI[i]; jj<UI[i+1]; ++jj) { uv[jj] *= s; }
       }
-      for (int k=ID[i]+1; k<IB[i+1]; ++k)
+
+      // L = U^t, where each row ends with the diagonal
+      int nnz = UJ.Size();
+      LI.SetSize(n + 1);
+      LI = 0;
+      for (int k=0; k<nnz; ++k) { LI[UJ[k] + 1]++; }
+      LI.PartialSum();
+      LJ.SetSize(nnz);
+      LV.SetSize(nnz);
+      lv = LV.HostWrite();
+      Array<int> pos(LI);
+      for (int i=0; i<n; ++i)
       {
-         int j = JB[k];
-         const DenseMatrix &U_ij = AB(k);
-         xj.SetDataAndSize(&x[P[j]*block_size], block_size);
-         // x_i = x_i - U_ij*x_j
-         U_ij.AddMult_a(-1.0, xj, xi);
+         for (int jj=UI[i]; jj<UI[i+1]; ++jj)
+         {
+            int k = pos[UJ[jj]]++;
+            LJ[k] = i;
+            lv[k] = uv[jj];
+         }
       }
-      LUFactors A_ii_inv(&DB(0,0,i), &ipiv[i*block_size]);
-      // x_i = D_ii^{-1} x_i
-      A_ii_inv.Solve(block_size, 1, xi);
+   }
+}
+
+void LevelScheduledILU::ComputeLevels()
+{
+   TriangularLevels(height, LI.GetData(), LJ.GetData(), true,
+                    lower_ptr, lower_rows);
+   TriangularLevels(height, UI.GetData(), UJ.GetData(), false,
+                    upper_ptr, upper_rows);
+}
+
+void LevelScheduledILU::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_ASSERT(LI.Size() == height + 1,
+               "LevelScheduledILU preconditioner is not constructed");
+   const int n = height;
+   const bool permuted = perm.Size() > 0;
+   y.SetSize(n);
+   y.UseDevice(true);
+
+   const double *d_b = b.Read();
+   if (permuted)
+   {
+      z.SetSize(n);
+      z.UseDevice(true);
+      auto d_perm = perm.Read();
+      auto d_z = z.Write();
+      MFEM_FORALL(i, n, d_z[i] = d_b[d_perm[i]];);
+      d_b = z.Read();
+   }
+
+   // Forward substitution to solve Ly = b, the rows of a level in parallel
+   auto d_LI = LI.Read();
+   auto d_LJ = LJ.Read();
+   auto d_LV = LV.Read();
+   auto d_lower = lower_rows.Read();
+   auto d_y = y.Write();
+   for (int l=0; l<GetNumLowerLevels(); ++l)
+   {
+      const int begin = lower_ptr[l];
+      MFEM_FORALL(t, lower_ptr[l+1] - begin,
+      {
+         const int i = d_lower[begin + t];
+         const int end = d_LI[i+1] - 1;
+         double s = d_b[i];
+         for (int k = d_LI[i]; k < end; k++)
+         {
+            s -= d_LV[k] * d_y[d_LJ[k]];
+         }
+         d_y[i] = s / d_LV[end];
+      });
+   }
+
+   // Backward substitution to solve Ux = y, the rows of a level in parallel
+   auto d_UI = UI.Read();
+   auto d_UJ = UJ.Read();
+   auto d_UV = UV.Read();
+   auto d_upper = upper_rows.Read();
+   auto d_x = permuted ? z.Write() : x.Write();
+   for (int l=0; l<GetNumUpperLevels(); ++l)
+   {
+      const int begin = upper_ptr[l];
+      MFEM_FORALL(t, upper_ptr[l+1] - begin,
+      {
+         const int i = d_upper[begin + t];
+         const int diag = d_UI[i];
+         double s = d_y[i];
+         for (int k = diag + 1; k < d_UI[i+1]; k++)
+         {
+            s -= d_UV[k] * d_x[d_UJ[k]];
+         }
+         d_x[i] = s / d_UV[diag];
+      });
+   }
+
+   if (permuted)
+   {
+      auto d_perm = perm.Read();
+      auto d_z = z.Read();
+      auto d_xo = x.Write();
+      MFEM_FORALL(i, n, d_xo[d_perm[i]] = d_z[i];);
    }
 }
 
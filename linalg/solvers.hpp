@@ -37,6 +37,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request sum_request; // see GlobalSumStart()
 #endif
 
 protected:
@@ -53,6 +54,24 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Compute the matrix of inner products XtY = X^t Y of the columns of
+       the multi-vectors @a X and @a Y, with a single global reduction. */
+   void BlockDot(const DenseMatrix &X, const DenseMatrix &Y,
+                 DenseMatrix &XtY) const;
+   /// Compute the inner products of the matching columns of @a X and @a Y.
+   void ColumnDot(const DenseMatrix &X, const DenseMatrix &Y, Vector &xy) const;
+
+   /** @brief Start the global (non-blocking) sum of the @a n local values in
+       @a buf, which are replaced by the global sums. */
+   /** The sums are available after GlobalSumWait(); meanwhile, @a buf should
+       not be accessed. With MPI versions before 3.0, the sum is blocking. */
+   void GlobalSumStart(double *buf, int n) const;
+   /// Wait for the completion of the sum started with GlobalSumStart().
+   void GlobalSumWait() const;
+   /// Return the sum of @a local over the ranks, e.g. from a fused kernel.
+   double GlobalSum(double local) const
+   { GlobalSumStart(&local, 1); GlobalSumWait(); return local; }
+
 public:
    IterativeSolver();
 
@@ -67,6 +86,7 @@ public:
 
    int GetNumIterations() const { return final_iter; }
    int GetConverged() const { return converged; }
+   double GetRelTol() const { return rel_tol; }
    double GetFinalNorm() const { return final_norm; }
 
    /// This should be called before SetOperator
@@ -148,6 +168,57 @@ void SLI(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/// Anderson accelerated fixed-point iteration for x = G(x) + b
+/** The operator G is the one given to SetOperator(); if the right-hand side of
+    Mult() is empty, b is assumed to be zero. With the residuals f_k = G(x_k)
+    + b - x_k and the differences of the last m residuals, dF, and of the last
+    m values g_k = G(x_k) + b, dG, the iteration is (Walker and Ni, SIAM J.
+    Numer. Anal., 49 (2011))
+
+        gamma_k = argmin |f_k - dF gamma|,
+        x_{k+1} = g_k - dG gamma_k - (1 - beta) (f_k - dF gamma_k),
+
+    where beta is the damping parameter. The least-squares problems use a QR
+    factorization of dF, which is updated when a column is added and downdated
+    when the oldest one is dropped, either because the history is full or to
+    keep the factorization well conditioned. With m = 0, this is the damped
+    fixed-point iteration x_{k+1} = x_k + beta f_k.
+
+    The convergence criterion is |f_k| <= max(rel_tol |f_0|, abs_tol). For
+    example, the stationary iteration of SLISolver, x = x + B (b - A x), is
+    accelerated with G = I - B A and the right-hand side B b. */
+class AndersonSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetHistoryDepth()
+   double beta; // see SetDamping()
+
+public:
+   AndersonSolver() : m(5), beta(1.0) { }
+
+#ifdef MFEM_USE_MPI
+   AndersonSolver(MPI_Comm _comm) : IterativeSolver(_comm), m(5), beta(1.0) { }
+#endif
+
+   /// Set the number of previous iterates used, default is 5.
+   void SetHistoryDepth(int depth) { m = depth; }
+
+   /// Set the damping parameter beta in (0,1], default is 1 (no damping).
+   void SetDamping(double damping) { beta = damping; }
+
+   /// Set the fixed-point operator G.
+   virtual void SetOperator(const Operator &op)
+   {
+      oper = &op;
+      height = op.Height();
+      width = op.Width();
+      MFEM_VERIFY(height == width, "square Operator is required.");
+   }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
 /// Conjugate gradient method
 class CGSolver : public IterativeSolver
 {
@@ -180,6 +251,36 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/// Pipelined conjugate gradient method
+/** This is the preconditioned pipelined CG method of P. Ghysels and W.
+    Vanroose (Parallel Computing, 2014). The two inner products of each
+    iteration are combined in a single non-blocking global reduction, which is
+    overlapped with the application of the preconditioner and the operator. The
+    method needs more vectors and vector updates than CGSolver and may converge
+    to a less accurate solution, so it is beneficial when the global reductions
+    dominate, e.g. in strong scaling runs. The convergence criterion is the same
+    as in CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
@@ -217,6 +318,138 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Communication-avoiding (s-step) GMRES method with left
+    preconditioning. */
+/** Within each restart cycle, the Krylov basis is built in blocks of s
+    vectors. The vectors of a block are generated with s consecutive
+    applications of the preconditioned operator, in a scaled monomial basis or
+    in a Newton basis with the shifts given to SetShifts(). The block is then
+    orthogonalized against the previous basis vectors and within itself with
+    two passes of block classical Gram-Schmidt with Cholesky QR, each pass
+    needing a single global reduction, instead of the one reduction per basis
+    vector of the modified Gram-Schmidt in GMRESSolver. The Hessenberg matrix
+    of the Arnoldi process is recovered from the triangular factors, so the
+    least squares problem, the restarts and the convergence criterion are the
+    same as in GMRESSolver.
+
+    When the vectors of a block are numerically linearly dependent, only the
+    independent ones are used and the cycle is restarted. */
+class CAGMRESSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+   int s; // see SetStepSize()
+   Vector shifts; // see SetShifts()
+
+   /** @brief Orthogonalize the @a sb columns of @a V starting at column @a k
+       against the first @a k columns, which must be orthonormal, and among
+       themselves, with one pass of block classical Gram-Schmidt. */
+   /** The Gram matrix of the block and its projection on the previous columns,
+       @a C (k x sb), are computed with a single global reduction. The Cholesky
+       factor @a R (sb x sb) of the projected block is obtained from them and
+       the leading columns of the block are replaced with the orthonormal
+       factor. Returns the number of leading columns that are numerically
+       linearly independent; only these columns of @a R are set. */
+   int OrthogonalizeBlock(DenseMatrix &V, int k, int sb, DenseMatrix &C,
+                          DenseMatrix &R) const;
+
+public:
+   CAGMRESSolver() { m = 50; s = 5; }
+
+#ifdef MFEM_USE_MPI
+   CAGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; s = 5; }
+#endif
+
+   /** @brief Set the number of iteration to perform between restarts, default
+       is 50. It is rounded up to a multiple of the step size. */
+   void SetKDim(int dim) { m = dim; }
+
+   /// Set the number of Krylov vectors generated per block, default is 5.
+   void SetStepSize(int step) { s = step; }
+
+   /** @brief Use the Newton basis with the given real shifts, cycled through
+       in each block. */
+   /** Good shifts are, e.g., Leja ordered estimates of the eigenvalues of the
+       preconditioned operator. An empty vector selects the (default) monomial
+       basis. */
+   void SetShifts(const Vector &theta) { shifts = theta; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/** @brief GCRO-DR, GMRES with deflated restarting and Krylov subspace
+    recycling between solves, with left preconditioning. */
+/** The solver keeps a recycled subspace of dimension k, given by the columns
+    of U and C = M A U, with C orthonormal. The subspace is carried over
+    between restart cycles and between calls to Mult(), so that a sequence of
+    slowly varying systems, e.g. in implicit time stepping or in a Newton
+    iteration, does not rebuild the slowly converging components from scratch.
+
+    Each solve first projects the initial residual on the complement of C, and
+    each cycle then builds m-k Arnoldi vectors of (I - C C^t) M A and minimizes
+    the residual over span(U) + the Krylov space. After each cycle, the
+    recycled subspace is replaced with the k vectors of the current search
+    space with the smallest values of |M A y|/|y|, obtained from a small
+    symmetric eigenproblem, i.e. approximate right singular vectors of M A. The
+    first cycle of the first solve is a cycle of GMRES(m).
+
+    When the operator or the preconditioner changes, call SetOperator() or
+    SetPreconditioner() again: the recycled U is kept and C is recomputed,
+    with k additional operator applications, at the beginning of the next
+    solve. ClearRecycleSpace() discards the subspace. */
+class GCRODRSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+   int k; // see SetRecycleDim()
+
+   /// The recycled subspace; U and C have the same number of vectors.
+   mutable Array<Vector*> U, C;
+   /// Set when C must be recomputed from U for a new operator.
+   mutable bool update_C;
+
+   void DeleteRecycleSpace() const;
+
+   /// Recompute C = M A U, orthonormalize it and update U accordingly.
+   void UpdateRecycleSpace() const;
+
+   /** @brief Replace the recycled subspace with the k vectors of the search
+       space @a Vh with the smallest |G y|/|Vh y|, where M A Vh = Wh G. */
+   void SelectRecycleSpace(const Array<Vector*> &Vh, const Array<Vector*> &Wh,
+                           const DenseMatrix &G) const;
+
+public:
+   GCRODRSolver() : m(50), k(10), update_C(false) { }
+
+#ifdef MFEM_USE_MPI
+   GCRODRSolver(MPI_Comm _comm)
+      : IterativeSolver(_comm), m(50), k(10), update_C(false) { }
+#endif
+
+   /// Set the dimension of the search space of each cycle, default is 50.
+   void SetKDim(int dim) { m = dim; }
+
+   /** @brief Set the dimension of the recycled subspace, default is 10. It
+       must be smaller than the dimension of the search space. */
+   void SetRecycleDim(int dim) { k = dim; }
+
+   /// Return the dimension of the current recycled subspace.
+   int GetRecycleDim() const { return U.Size(); }
+
+   /// Discard the recycled subspace.
+   void ClearRecycleSpace() { DeleteRecycleSpace(); }
+
+   /// Set the preconditioner, keeping the recycled subspace.
+   virtual void SetPreconditioner(Solver &pr);
+
+   /// Set the operator, keeping the recycled subspace.
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~GCRODRSolver() { DeleteRecycleSpace(); }
+};
+
 /// GMRES method. (tolerances are squared)
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit);
@@ -293,20 +526,202 @@ void MINRES(const Operator &A, Solver &B, const Vector &b, Vector &x,
             double rtol = 1e-12, double atol = 1e-24);
 
 
+/// Abstract base class for block Krylov solvers with multiple right-hand sides
+/** The right-hand sides and the solutions are multi-vectors: the columns of a
+    DenseMatrix. All systems are advanced together, in a shared search space.
+    The operator is applied to all vectors together when it provides a
+    multi-vector product (SparseMatrix and HypreParMatrix), otherwise column by
+    column. The tolerances apply to each column separately. */
+class BlockIterativeSolver : public IterativeSolver
+{
+protected:
+   /// Y = op X, using the multi-vector product of @a op if available.
+   void MultiMult(const Operator &op, const DenseMatrix &X,
+                  DenseMatrix &Y) const;
+
+   /** @brief Orthonormalize the columns of @a W, dropping the (numerically)
+       linearly dependent columns. */
+   /** On return, @a W has r orthonormal columns, where r is the numerical
+       rank, and the input W0 is approximated by W R, with R of size r x k.
+       The method uses the pivoted Cholesky factorization of W0^t W0. */
+   void Orthonormalize(DenseMatrix &W, DenseMatrix &R) const;
+
+   /** @brief Orthonormalize the columns of @a W in the inner product with
+       Gram matrix @a G = W^t M W, for a symmetric positive definite M. */
+   /** The global reduction of @a G is done by the caller, see Orthonormalize()
+       above. If @a MW is not NULL, it is transformed as @a W, so that it holds
+       M W on return. If @a C is not NULL, it is the k x m matrix W^t M Y on
+       input and it is replaced by the r x m matrix W^t M Y on return. */
+   void Orthonormalize(const DenseMatrix &G, DenseMatrix &W, DenseMatrix &R,
+                       DenseMatrix *MW, DenseMatrix *C) const;
+
+public:
+   BlockIterativeSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockIterativeSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   /// Solve A X = B for the columns of @a B.
+   virtual void Mult(const DenseMatrix &B, DenseMatrix &X) const = 0;
+
+   /// Solve A x = b, i.e. the case of a single right-hand side.
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
+/// Block conjugate gradient method for multiple right-hand sides
+/** This is the breakdown-free block CG method of H. Ji and Y. Li (BIT Numer.
+    Math., 2017): the search directions are orthonormalized, so that the
+    directions which become linearly dependent are removed from the block.
+    The converged columns are deflated, i.e. removed from the active block.
+    The convergence criterion for each column is the same as in CGSolver.
+
+    The search directions are A-orthonormalized, using the recurrence for A Z
+    + A P beta instead of a second product with A. All the inner products of
+    an iteration are then gathered in one block product and one global
+    reduction. As a consequence, the product with A of the last residual is
+    computed before the convergence check. */
+class BlockCGSolver : public BlockIterativeSolver
+{
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : BlockIterativeSolver(_comm) { }
+#endif
+
+   using BlockIterativeSolver::Mult;
+
+   virtual void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+};
+
+
+/// Block GMRES method for multiple right-hand sides
+/** Restarted block GMRES with left preconditioning, as GMRESSolver. The block
+    Arnoldi basis is orthonormalized with block Gram-Schmidt and CholQR2, and
+    the least squares problem is updated with Householder reflections. The
+    converged columns are deflated at each restart. If the block Krylov space
+    becomes rank deficient, the cycle is ended early and the method restarts.
+    The convergence criterion for each column is the same as in GMRESSolver. */
+class BlockGMRESSolver : public BlockIterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+
+public:
+   BlockGMRESSolver() { m = 20; }
+
+#ifdef MFEM_USE_MPI
+   BlockGMRESSolver(MPI_Comm _comm) : BlockIterativeSolver(_comm) { m = 20; }
+#endif
+
+   /// Set the number of block iterations between restarts, default is 20.
+   void SetKDim(int dim) { m = dim; }
+
+   using BlockIterativeSolver::Mult;
+
+   virtual void Mult(const DenseMatrix &B, DenseMatrix &X) const;
+};
+
+
 /// Newton's method for solving F(x)=b for a given operator F.
 /** The method GetGradient() must be implemented for the operator F.
     The preconditioner is used (in non-iterative mode) to evaluate
-    the action of the inverse gradient of the operator. */
+    the action of the inverse gradient of the operator.
+
+    Optionally, the relative tolerance of the linear solver is chosen in each
+    iteration with the Eisenstat-Walker forcing terms, see
+    SetAdaptiveLinRtol(), and the gradient, together with the setup of the
+    linear solver, is reused over several iterations, see SetGradientReuse().
+
+    In the Jacobian-free Newton-Krylov mode, see SetJacobianFree(), the
+    gradient is not formed: its action is approximated with finite differences
+    of F, and the method GetGradient() is only needed to set up the optional
+    preconditioner. */
 class NewtonSolver : public IterativeSolver
 {
 protected:
+   /** @brief Finite difference approximation of the action of the gradient of
+       F at the current iterate, right preconditioned with jf_prec, if set. */
+   /** The action on v is (F(x + h v) - F(x))/h with h = eps (1 + |x|)/|v|,
+       where F(x) - b is the current residual. */
+   class JacobianFreeOperator : public Operator
+   {
+   protected:
+      const NewtonSolver &newton;
+      mutable Vector xp, z;
+
+   public:
+      /// The current iterate, its norm, the residual and the right-hand side.
+      const Vector *x, *r, *b;
+      double x_norm;
+
+      JacobianFreeOperator(const NewtonSolver &newton_)
+         : newton(newton_), x(NULL), r(NULL), b(NULL), x_norm(0.0) { }
+
+      void SetSize(int s) { height = width = s; }
+
+      virtual void Mult(const Vector &v, Vector &y) const;
+   };
+
    mutable Vector r, c;
 
+   // Adaptive relative tolerance of the linear solver, see SetAdaptiveLinRtol()
+   int lin_rtol_type; // 0: fixed tolerance
+   double lin_rtol0, lin_rtol_max, eta_alpha, eta_gamma;
+   mutable double eta_last, fnorm_last, lnorm_last;
+   mutable Vector lin_res; // linear residual of a damped step, type 1 only
+
+   // Reuse of the gradient, see SetGradientReuse()
+   int max_grad_reuse;
+   double grad_stall_factor;
+   mutable Operator *grad;
+   mutable int grad_age, num_grad_setups, num_grad_reuses;
+
+   // Jacobian-free mode, see SetJacobianFree()
+   bool jacobian_free;
+   double fd_eps;
+   Solver *jf_prec;
+   bool jf_prec_setup;
+   mutable JacobianFreeOperator jf_oper;
+
+   /** @brief Set the relative tolerance of the linear solver for the iteration
+       @a it, where @a fnorm is the norm of the current residual. */
+   void AdaptiveLinRtolPreSolve(int it, double fnorm) const;
+
+   /** @brief Record the data needed by the forcing term of the next iteration,
+       after the linear solve of J c = r and the step x -= c_scale c. */
+   /** For a full step, c_scale = 1, the norm of the linear residual r - J c is
+       the final norm of the linear solver; otherwise, r - c_scale J c is
+       computed in lin_res. */
+   void AdaptiveLinRtolPostSolve(const Operator &J, const Vector &c,
+                                 double c_scale, double fnorm) const;
+
+   /** @brief Compute the gradient at @a x and set it as the operator of the
+       linear solver, or of the preconditioner in the Jacobian-free mode,
+       unless the current one can be reused. */
+   void UpdateGradient(const Vector &x, int it, double norm,
+                       double norm_prev) const;
+
 public:
-   NewtonSolver() { }
+   NewtonSolver()
+      : lin_rtol_type(0), lin_rtol0(0.5), lin_rtol_max(0.9), eta_alpha(1.0),
+        eta_gamma(1.0), eta_last(0.0), fnorm_last(0.0), lnorm_last(0.0),
+        max_grad_reuse(0), grad_stall_factor(0.5), grad(NULL), grad_age(0),
+        num_grad_setups(0), num_grad_reuses(0),
+        jacobian_free(false), fd_eps(1.49e-8), jf_prec(NULL),
+        jf_prec_setup(false), jf_oper(*this) { }
 
 #ifdef MFEM_USE_MPI
-   NewtonSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+   NewtonSolver(MPI_Comm _comm)
+      : IterativeSolver(_comm),
+        lin_rtol_type(0), lin_rtol0(0.5), lin_rtol_max(0.9), eta_alpha(1.0),
+        eta_gamma(1.0), eta_last(0.0), fnorm_last(0.0), lnorm_last(0.0),
+        max_grad_reuse(0), grad_stall_factor(0.5), grad(NULL), grad_age(0),
+        num_grad_setups(0), num_grad_reuses(0),
+        jacobian_free(false), fd_eps(1.49e-8), jf_prec(NULL),
+        jf_prec_setup(false), jf_oper(*this) { }
 #endif
    virtual void SetOperator(const Operator &op);
 
@@ -314,6 +729,68 @@ public:
    /** This method is equivalent to calling SetPreconditioner(). */
    virtual void SetSolver(Solver &solver) { prec = &solver; }
 
+   /** @brief Choose the relative tolerance of the linear solver, which must be
+       an IterativeSolver, in each iteration with the forcing terms of
+       Eisenstat and Walker, "Choosing the forcing terms in an inexact Newton
+       method", SIAM J. Sci. Comput., 17 (1996). */
+   /** With @a type = 1, eta_k = | |F(x_k)| - |F(x_{k-1}) + DF s_{k-1}| | /
+       |F(x_{k-1})|, where DF s_{k-1} is the linear model of the last step;
+       with @a type = 2, eta_k = gamma (|F(x_k)|/|F(x_{k-1})|)^alpha. In both
+       cases, eta_k is bounded below to avoid oversolving while the
+       convergence is not yet fast: with @a type = 1, eta_k >=
+       eta_{k-1}^((1+sqrt(5))/2) when the latter is above 0.1, and with @a type
+       = 2, eta_k >= gamma eta_{k-1}^alpha when the latter is above 0.1.
+       Finally, eta_k <= @a rtol_max. The first iteration uses @a rtol0. A
+       @a type of 0 keeps the tolerance of the linear solver.
+
+       For @a type = 1, the norm of the linear residual of a full step is the
+       one reported by the linear solver, see IterativeSolver::GetFinalNorm(),
+       which for some preconditioned solvers, e.g. GMRESSolver, is the norm of
+       the preconditioned residual. The relative tolerance of the linear
+       solver is restored at the end of Mult(). */
+   void SetAdaptiveLinRtol(int type = 2, double rtol0 = 0.5,
+                           double rtol_max = 0.9,
+                           double alpha = 0.5*(1.0 + sqrt(5.0)),
+                           double gamma = 1.0);
+
+   /** @brief Reuse the gradient, and thus the setup of the linear solver, for
+       at most @a max_reuse further iterations. */
+   /** The gradient is recomputed earlier when the convergence stalls, i.e.
+       when the residual is reduced by less than @a stall_factor in the last
+       iteration. The gradient is also reused between calls to Mult(), e.g.
+       in consecutive time steps, until SetOperator() is called. The default,
+       @a max_reuse = 0, computes the gradient in every iteration. */
+   void SetGradientReuse(int max_reuse, double stall_factor = 0.5)
+   { max_grad_reuse = max_reuse; grad_stall_factor = stall_factor; }
+
+   /// Return the number of gradient computations and linear solver setups.
+   int GetNumGradientSetups() const { return num_grad_setups; }
+
+   /// Return the number of iterations which reused the previous gradient.
+   int GetNumGradientReuses() const { return num_grad_reuses; }
+
+   /** @brief Use the Jacobian-free Newton-Krylov method, where the action of
+       the gradient is approximated with finite differences of F. */
+   /** The linear solver given to SetSolver() must be an IterativeSolver
+       without a preconditioner of its own; a preconditioner can be given with
+       SetJacobianFreePreconditioner() instead. */
+   void SetJacobianFree(bool jf = true) { jacobian_free = jf; grad = NULL; }
+
+   /** @brief Set the relative perturbation of the finite differences in the
+       Jacobian-free mode, default is 1.49e-8, about the square root of the
+       machine precision. */
+   void SetFDPerturbation(double eps) { fd_eps = eps; }
+
+   /** @brief Set the (right) preconditioner of the linear solver in the
+       Jacobian-free mode. */
+   /** If @a setup_from_gradient is true, the operator of @a pc is set to the
+       gradient of F, e.g. an approximate or cheaper one, following the reuse
+       policy of SetGradientReuse(). Otherwise, @a pc is used as it is, e.g.
+       with an operator set up by the user once for several solves. */
+   void SetJacobianFreePreconditioner(Solver &pc,
+                                      bool setup_from_gradient = false)
+   { jf_prec = &pc; jf_prec_setup = setup_from_gradient; }
+
    /// Solve the nonlinear system with right-hand side @a b.
    /** If `b.Size() != Height()`, then @a b is assumed to be zero. */
    virtual void Mult(const Vector &b, Vector &x) const;
@@ -485,9 +962,15 @@ public:
  *  the matrix.
  *
  *  Renumbering the blocks is also supported by specifying a reordering method.
- *  Currently greedy minimum discarded fill ordering and no reordering are
- *  supported. Renumbering the blocks can lead to a much better approximate
- *  factorization.
+ *  Currently greedy minimum discarded fill ordering, reverse Cuthill-McKee,
+ *  approximate minimum degree and nested dissection orderings (see
+ *  linalg/reordering.hpp), and no reordering are supported. Renumbering the
+ *  blocks can lead to a much better approximate factorization.
+ *
+ *  The block rows of the triangular solves in Mult() are grouped in levels of
+ *  rows that only depend on rows of previous levels. The block rows of a
+ *  level are solved in parallel with the Device backends, like in
+ *  LevelScheduledILU.
  */
 class BlockILU : public Solver
 {
@@ -497,7 +980,10 @@ public:
    enum class Reordering
    {
       MINIMUM_DISCARDED_FILL,
-      NONE
+      NONE,
+      REVERSE_CUTHILL_MCKEE,
+      APPROXIMATE_MINIMUM_DEGREE,
+      NESTED_DISSECTION
    };
 
    /** Create an "empty" BlockILU solver. SetOperator must be called later to
@@ -547,6 +1033,9 @@ private:
    /// Perform the block ILU factorization
    void Factorize();
 
+   /// Group the block rows of the L and U factors in levels for Mult()
+   void ComputeLevels();
+
    int block_size;
 
    /// Fill level for block ILU(k) factorizations. Only k=0 is supported.
@@ -572,6 +1061,97 @@ private:
    mutable DenseTensor DB;
    /// Pivot arrays for the LU factorizations given by #DB
    mutable Array<int> ipiv;
+
+   /** Level sets of the L and U factors: the block rows of level l of L are
+    *  lower_rows[lower_ptr[l]], ..., lower_rows[lower_ptr[l+1]-1], and the
+    *  same for U.
+    */
+   Array<int> lower_ptr, lower_rows, upper_ptr, upper_rows;
+};
+
+/** Level scheduled ILU(k) and IC(k) solver:
+ *  Performs a scalar incomplete LU, or incomplete Cholesky, factorization of a
+ *  SparseMatrix with the fill pattern given by the level of fill k, where k=0
+ *  keeps the sparsity pattern of the matrix. The incomplete Cholesky variant,
+ *  A ~ U^t U, requires a symmetric positive definite matrix and leads to a
+ *  symmetric preconditioner, e.g. for CGSolver.
+ *
+ *  The rows of the triangular factors are grouped in levels (wavefronts) of
+ *  rows that only depend on rows of previous levels, and the rows of each level
+ *  are solved in parallel in Mult(), on the host or on the device. The number
+ *  of levels, and thus the available parallelism, depends on the ordering of
+ *  the unknowns. An optional reverse Cuthill-McKee reordering, applied
+ *  symmetrically to the matrix before the factorization, reduces the fill of
+ *  ILU(k) for k > 0.
+ */
+class LevelScheduledILU : public Solver
+{
+public:
+   /// The type of the incomplete factorization.
+   enum class Type
+   {
+      ILU,
+      IC
+   };
+
+   /** Create an "empty" LevelScheduledILU solver. SetOperator must be called
+    *  later to actually form the factorization.
+    */
+   LevelScheduledILU(int k_fill_ = 0, Type type_ = Type::ILU,
+                     bool reorder_ = false);
+
+   /// Create the incomplete factorization of the SparseMatrix @a op.
+   LevelScheduledILU(const Operator &op, int k_fill_ = 0,
+                     Type type_ = Type::ILU, bool reorder_ = false);
+
+   /// Perform the incomplete factorization of the SparseMatrix @a op.
+   void SetOperator(const Operator &op);
+
+   /// Solve the system `LUx = b`, where `L` and `U` are the incomplete factors.
+   void Mult(const Vector &b, Vector &x) const;
+
+   /// Return the number of levels of the L factor.
+   int GetNumLowerLevels() const { return lower_ptr.Size() - 1; }
+
+   /// Return the number of levels of the U factor.
+   int GetNumUpperLevels() const { return upper_ptr.Size() - 1; }
+
+   /// Return the number of nonzeros of the L and U factors.
+   int NumNonZeroElems() const { return LJ.Size() + UJ.Size(); }
+
+   /** Return the reordering: row i of the factorization is row perm[i] of the
+    *  matrix. Empty if no reordering is used.
+    */
+   const Array<int> &GetPermutation() const { return perm; }
+
+private:
+   /// Compute the fill pattern of the ILU(k) factors
+   void SymbolicFactorization(const SparseMatrix &A);
+
+   /// Compute the values of the factors
+   void NumericFactorization(const SparseMatrix &A);
+
+   /// Group the rows of the factors in levels for Mult()
+   void ComputeLevels();
+
+   int k_fill;
+   Type type;
+   bool reorder;
+
+   /// The reordering and its inverse, empty if no reordering is used.
+   Array<int> perm, perm_inv;
+
+   /** CSR storage of the factors. Each row of L ends with its diagonal entry,
+    *  which is 1 for ILU, and each row of U starts with its diagonal entry.
+    */
+   Array<int> LI, LJ, UI, UJ;
+   Vector LV, UV;
+
+   /// Level sets of the factors, see BlockILU.
+   Array<int> lower_ptr, lower_rows, upper_ptr, upper_rows;
+
+   /// Temporary vectors used in the Mult() function.
+   mutable Vector y, z;
 };
 
 #ifdef MFEM_USE_SUITESPARSE
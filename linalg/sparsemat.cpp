@@ -23,11 +23,24 @@
 #include <limits>
 #include <cstring>
 
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace mfem
 {
 
 using namespace std;
 
+// Returns true if the element-wise (row-parallel) methods, e.g. GetDiag() and
+// the Jacobi iterations, should run with the device kernels: when one of the
+// vectors is on the device, or when the device memory is the host memory, e.g.
+// with the "omp" backend, in which case the kernels are multithreaded.
+static inline bool UseDeviceKernels(bool vec_use_dev)
+{
+   return vec_use_dev || Device::GetMemoryClass() == MemoryClass::HOST;
+}
+
 SparseMatrix::SparseMatrix(int nrows, int ncols)
    : AbstractSparseMatrix(nrows, (ncols >= 0) ? ncols : nrows),
      Rows(new RowNode *[nrows]),
@@ -483,6 +496,13 @@ const double &SparseMatrix::operator()(int i, int j) const
    return zero;
 }
 
+int *SparseMatrix::ResetKernelError(bool use_dev) const
+{
+   kernel_err.SetSize(1);
+   kernel_err.HostWrite()[0] = -1;
+   return kernel_err.ReadWrite(use_dev);
+}
+
 void SparseMatrix::GetDiag(Vector & d) const
 {
    MFEM_VERIFY(height == width, "Matrix must be square, not height = "
@@ -491,24 +511,27 @@ void SparseMatrix::GetDiag(Vector & d) const
 
    d.SetSize(height);
 
-   int j, end;
-   for (int i = 0; i < height; i++)
-   {
-
-      end = I[i+1];
-      for (j = I[i]; j < end; j++)
+   const int height = this->height;
+   const int nnz = J.Capacity();
+   const bool use_dev = UseDeviceKernels(d.UseDevice());
+   auto d_I = Read(I, height+1, use_dev);
+   auto d_J = Read(J, nnz, use_dev);
+   auto d_A = Read(A, nnz, use_dev);
+   auto d_d = d.Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, height,
+   {
+      double di = 0.0;
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
       {
-         if (J[j] == i)
+         if (d_J[j] == i)
          {
-            d[i] = A[j];
+            di = d_A[j];
             break;
          }
       }
-      if (j == end)
-      {
-         d[i] = 0.;
-      }
-   }
+      d_d[i] = di;
+   });
 }
 
 /// Produces a DenseMatrix from a SparseMatrix
@@ -647,19 +670,162 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    if (At)
    {
       At->AddMult(x, y, a);
+      return;
    }
-   else
+
+   MFEM_VERIFY(Device::GetMemoryClass() == MemoryClass::HOST,
+               "transpose action on device is not enabled; see "
+               "BuildTranspose() for details.");
+   const int nnz = J.Capacity();
+   const int *Ip = HostRead(I, height+1);
+   const int *Jp = HostRead(J, nnz);
+   const double *Ap = HostRead(A, nnz);
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+#ifdef MFEM_USE_OPENMP
+   if (Device::Allows(Backend::OMP_MASK))
+   {
+      // Each thread accumulates the contributions of its rows in a private
+      // copy of y, then the copies are summed in parallel over the columns.
+      const int width = this->width;
+      thread_y.SetSize(omp_get_max_threads()*width);
+      double *ytp = thread_y.GetData();
+      #pragma omp parallel
+      {
+         const int nt = omp_get_num_threads();
+         double *yl = ytp + omp_get_thread_num()*width;
+         for (int j = 0; j < width; j++) { yl[j] = 0.0; }
+         #pragma omp for
+         for (int i = 0; i < height; i++)
+         {
+            const double xi = a * xp[i];
+            const int end = Ip[i+1];
+            for (int j = Ip[i]; j < end; j++)
+            {
+               yl[Jp[j]] += Ap[j] * xi;
+            }
+         }
+         #pragma omp for
+         for (int j = 0; j < width; j++)
+         {
+            double yj = 0.0;
+            for (int t = 0; t < nt; t++) { yj += ytp[t*width + j]; }
+            yp[j] += yj;
+         }
+      }
+      return;
+   }
+#endif
+   for (int i = 0; i < height; i++)
    {
-      MFEM_VERIFY(Device::IsDisabled(), "transpose action on device is not "
-                  "enabled; see BuildTranspose() for details.");
-      for (int i = 0; i < height; i++)
+      const double xi = a * xp[i];
+      const int end = Ip[i+1];
+      for (int j = Ip[i]; j < end; j++)
       {
-         const double xi = a * x[i];
-         const int end = I[i+1];
-         for (int j = I[i]; j < end; j++)
+         yp[Jp[j]] += Ap[j] * xi;
+      }
+   }
+}
+
+// Maximum number of vectors processed together in the multi-vector kernels
+static const int SPMM_MAX_K = 16;
+
+void SparseMatrix::Mult(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   Y.SetSize(height, X.Width());
+   Y = 0.0;
+   AddMult(X, Y);
+}
+
+void SparseMatrix::AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                           const double a) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   MFEM_ASSERT(width == X.Height(), "Input height (" << X.Height()
+               << ") must match matrix width (" << width << ")");
+   MFEM_ASSERT(height == Y.Height() && X.Width() == Y.Width(),
+               "invalid output size: " << Y.Height() << " x " << Y.Width());
+
+   // The multi-vectors are on the host, so the kernel is run on the device only
+   // when the device memory is the host memory, e.g. with the "omp" backend.
+   const bool use_dev = (Device::GetMemoryClass() == MemoryClass::HOST);
+   const int height = this->height;
+   const int width = this->width;
+   const int k = X.Width();
+   const int nnz = J.Capacity();
+   const int *Ip = HostRead(I, height+1);
+   const int *Jp = HostRead(J, nnz);
+   const double *Ap = HostRead(A, nnz);
+   const double *Xp = X.Data();
+   double *Yp = Y.Data();
+   MFEM_FORALL_SWITCH(use_dev, i, height,
+   {
+      // Process the vectors in groups of at most SPMM_MAX_K, re-reading the
+      // entries of the row from the cache for each group
+      for (int c0 = 0; c0 < k; c0 += SPMM_MAX_K)
+      {
+         const int kb = (k - c0 < SPMM_MAX_K) ? k - c0 : SPMM_MAX_K;
+         double d[SPMM_MAX_K];
+         for (int c = 0; c < kb; c++) { d[c] = 0.0; }
+         const int end = Ip[i+1];
+         for (int j = Ip[i]; j < end; j++)
+         {
+            const double Aij = Ap[j];
+            const double *Xj = Xp + Jp[j] + c0*width;
+            for (int c = 0; c < kb; c++)
+            {
+               d[c] += Aij * Xj[c*width];
+            }
+         }
+         double *Yi = Yp + i + c0*height;
+         for (int c = 0; c < kb; c++)
+         {
+            Yi[c*height] += a * d[c];
+         }
+      }
+   });
+}
+
+void SparseMatrix::MultTranspose(const DenseMatrix &X, DenseMatrix &Y) const
+{
+   Y.SetSize(width, X.Width());
+   Y = 0.0;
+   AddMultTranspose(X, Y);
+}
+
+void SparseMatrix::AddMultTranspose(const DenseMatrix &X, DenseMatrix &Y,
+                                    const double a) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   MFEM_ASSERT(height == X.Height(), "Input height (" << X.Height()
+               << ") must match matrix height (" << height << ")");
+   MFEM_ASSERT(width == Y.Height() && X.Width() == Y.Width(),
+               "invalid output size: " << Y.Height() << " x " << Y.Width());
+
+   if (At)
+   {
+      At->AddMult(X, Y, a);
+      return;
+   }
+
+   const int k = X.Width();
+   const int nnz = J.Capacity();
+   const int *Ip = HostRead(I, height+1);
+   const int *Jp = HostRead(J, nnz);
+   const double *Ap = HostRead(A, nnz);
+   const double *Xp = X.Data();
+   double *Yp = Y.Data();
+   for (int i = 0; i < height; i++)
+   {
+      const int end = Ip[i+1];
+      for (int j = Ip[i]; j < end; j++)
+      {
+         const double aAij = a * Ap[j];
+         const double *Xi = Xp + i;
+         double *Yj = Yp + Jp[j];
+         for (int c = 0; c < k; c++)
          {
-            const int Jj = J[j];
-            y[Jj] += A[j] * xi;
+            Yj[c*width] += aAij * Xi[c*height];
          }
       }
    }
@@ -1907,6 +2073,65 @@ void SparseMatrix::EliminateZeroRows(const double threshold)
    }
 }
 
+#ifdef MFEM_USE_OPENMP
+// Hybrid Gauss-Seidel sweep, used with the "omp" backend: the rows are split in
+// contiguous blocks, one per thread, and the sweep is sequential within each
+// block. The coupling with the other blocks uses the values of y from the
+// beginning of the sweep, i.e. it is a block Jacobi iteration with Gauss-Seidel
+// in the blocks, as in the hybrid smoothers of hypre. The work array y0p, of
+// size s, receives these values. Returns the index of a row with a zero
+// diagonal that could not be processed, or -1.
+static int HybridGaussSeidel(const int s, const int *Ip, const int *Jp,
+                             const double *Ap, const double *xp, double *yp,
+                             double *y0p, const bool forward)
+{
+   int err = -1;
+   #pragma omp parallel
+   {
+      const int nt = omp_get_num_threads();
+      const int t = omp_get_thread_num();
+      const int b0 = (int)(((long long)s * t) / nt);
+      const int b1 = (int)(((long long)s * (t+1)) / nt);
+      for (int i = b0; i < b1; i++) { y0p[i] = yp[i]; }
+      #pragma omp barrier
+      for (int k = 0; k < b1 - b0; k++)
+      {
+         const int i = forward ? b0 + k : b1 - 1 - k;
+         const int end = Ip[i+1];
+         double sum = 0.0;
+         int d = -1;
+         for (int j = Ip[i]; j < end; j++)
+         {
+            const int c = Jp[j];
+            if (c == i)
+            {
+               d = j;
+            }
+            else
+            {
+               sum += Ap[j] * ((c >= b0 && c < b1) ? yp[c] : y0p[c]);
+            }
+         }
+
+         if (d >= 0 && Ap[d] != 0.0)
+         {
+            yp[i] = (xp[i] - sum) / Ap[d];
+         }
+         else if (xp[i] == sum)
+         {
+            yp[i] = sum;
+         }
+         else
+         {
+            #pragma omp atomic write
+            err = i;
+         }
+      }
+   }
+   return err;
+}
+#endif
+
 void SparseMatrix::Gauss_Seidel_forw(const Vector &x, Vector &y) const
 {
    if (!Finalized())
@@ -1957,6 +2182,18 @@ void SparseMatrix::Gauss_Seidel_forw(const Vector &x, Vector &y) const
       double *yp = y.HostReadWrite();
       const double *xp = x.HostRead();
 
+#ifdef MFEM_USE_OPENMP
+      if (Device::Allows(Backend::OMP_MASK) && omp_get_max_threads() > 1)
+      {
+         thread_y.SetSize(s);
+         if (HybridGaussSeidel(s, Ip, Jp, Ap, xp, yp, thread_y.GetData(),
+                               true) >= 0)
+         {
+            mfem_error("SparseMatrix::Gauss_Seidel_forw(...) #2");
+         }
+         return;
+      }
+#endif
       for (int i = 0, j = Ip[0]; i < s; i++)
       {
          const int end = Ip[i+1];
@@ -2040,6 +2277,18 @@ void SparseMatrix::Gauss_Seidel_back(const Vector &x, Vector &y) const
       double *yp = y.HostReadWrite();
       const double *xp = x.HostRead();
 
+#ifdef MFEM_USE_OPENMP
+      if (Device::Allows(Backend::OMP_MASK) && omp_get_max_threads() > 1)
+      {
+         thread_y.SetSize(s);
+         if (HybridGaussSeidel(s, Ip, Jp, Ap, xp, yp, thread_y.GetData(),
+                               false) >= 0)
+         {
+            mfem_error("SparseMatrix::Gauss_Seidel_back(...) #2");
+         }
+         return;
+      }
+#endif
       for (int i = s-1, j = Ip[s]-1; i >= 0; i--)
       {
          const int beg = Ip[i];
@@ -2112,29 +2361,45 @@ void SparseMatrix::Jacobi(const Vector &b, const Vector &x0, Vector &x1,
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
-   for (int i = 0; i < height; i++)
+   const int height = this->height;
+   const int nnz = J.Capacity();
+   const bool use_dev = UseDeviceKernels(b.UseDevice() || x0.UseDevice() ||
+                                         x1.UseDevice());
+   auto d_err = ResetKernelError(use_dev);
+   auto d_I = Read(I, height+1, use_dev);
+   auto d_J = Read(J, nnz, use_dev);
+   auto d_A = Read(A, nnz, use_dev);
+   auto d_b = b.Read(use_dev);
+   auto d_x0 = x0.Read(use_dev);
+   auto d_x1 = x1.Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, height,
    {
       int d = -1;
-      double sum = b(i);
-      for (int j = I[i]; j < I[i+1]; j++)
+      double sum = d_b[i];
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
       {
-         if (J[j] == i)
+         if (d_J[j] == i)
          {
             d = j;
          }
          else
          {
-            sum -= A[j] * x0(J[j]);
+            sum -= d_A[j] * d_x0[d_J[j]];
          }
       }
-      if (d >= 0 && A[d] != 0.0)
+      if (d >= 0 && d_A[d] != 0.0)
       {
-         x1(i) = sc * (sum / A[d]) + (1.0 - sc) * x0(i);
+         d_x1[i] = sc * (sum / d_A[d]) + (1.0 - sc) * d_x0[i];
       }
       else
       {
-         mfem_error("SparseMatrix::Jacobi(...) #2");
+         d_err[0] = i;
       }
+   });
+   if (kernel_err.HostRead()[0] >= 0)
+   {
+      mfem_error("SparseMatrix::Jacobi(...) #2");
    }
 }
 
@@ -2142,32 +2407,39 @@ void SparseMatrix::DiagScale(const Vector &b, Vector &x, double sc) const
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
-   bool scale = (sc != 1.0);
-   for (int i = 0, j = 0; i < height; i++)
+   const int height = this->height;
+   const int nnz = J.Capacity();
+   const bool use_dev = UseDeviceKernels(b.UseDevice() || x.UseDevice());
+   auto d_err = ResetKernelError(use_dev);
+   auto d_I = Read(I, height+1, use_dev);
+   auto d_J = Read(J, nnz, use_dev);
+   auto d_A = Read(A, nnz, use_dev);
+   auto d_b = b.Read(use_dev);
+   auto d_x = x.Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, height,
    {
-      int end = I[i+1];
-      for ( ; true; j++)
+      int d = -1;
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
       {
-         MFEM_VERIFY(j != end, "Couldn't find diagonal in row. i = " << i
-                     << ", j = " << j
-                     << ", I[i+1] = " << end );
-         if (J[j] == i)
+         if (d_J[j] == i)
          {
-            MFEM_VERIFY(std::abs(A[j]) > 0.0, "Diagonal " << j << " must be nonzero");
-            if (scale)
-            {
-               x(i) = sc * b(i) / A[j];
-            }
-            else
-            {
-               x(i) = b(i) / A[j];
-            }
+            d = j;
             break;
          }
       }
-      j = end;
-   }
-   return;
+      if (d >= 0 && d_A[d] != 0.0)
+      {
+         d_x[i] = sc * d_b[i] / d_A[d];
+      }
+      else
+      {
+         d_err[0] = i;
+      }
+   });
+   const int err_row = kernel_err.HostRead()[0];
+   MFEM_VERIFY(err_row < 0, "Couldn't find a nonzero diagonal in row "
+               << err_row);
 }
 
 void SparseMatrix::Jacobi2(const Vector &b, const Vector &x0, Vector &x1,
@@ -2175,23 +2447,37 @@ void SparseMatrix::Jacobi2(const Vector &b, const Vector &x0, Vector &x1,
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
-   for (int i = 0; i < height; i++)
-   {
-      double resi = b(i), norm = 0.0;
-      for (int j = I[i]; j < I[i+1]; j++)
+   const int height = this->height;
+   const int nnz = J.Capacity();
+   const bool use_dev = UseDeviceKernels(b.UseDevice() || x0.UseDevice() ||
+                                         x1.UseDevice());
+   auto d_err = ResetKernelError(use_dev);
+   auto d_I = Read(I, height+1, use_dev);
+   auto d_J = Read(J, nnz, use_dev);
+   auto d_A = Read(A, nnz, use_dev);
+   auto d_b = b.Read(use_dev);
+   auto d_x0 = x0.Read(use_dev);
+   auto d_x1 = x1.Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, height,
+   {
+      double resi = d_b[i], norm = 0.0;
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
       {
-         resi -= A[j] * x0(J[j]);
-         norm += fabs(A[j]);
+         resi -= d_A[j] * d_x0[d_J[j]];
+         norm += fabs(d_A[j]);
       }
       if (norm > 0.0)
       {
-         x1(i) = x0(i) + sc * resi / norm;
+         d_x1[i] = d_x0[i] + sc * resi / norm;
       }
       else
       {
-         MFEM_ABORT("L1 norm of row " << i << " is zero.");
+         d_err[0] = i;
       }
-   }
+   });
+   const int err_row = kernel_err.HostRead()[0];
+   MFEM_VERIFY(err_row < 0, "L1 norm of row " << err_row << " is zero.");
 }
 
 void SparseMatrix::Jacobi3(const Vector &b, const Vector &x0, Vector &x1,
@@ -2199,23 +2485,37 @@ void SparseMatrix::Jacobi3(const Vector &b, const Vector &x0, Vector &x1,
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
-   for (int i = 0; i < height; i++)
-   {
-      double resi = b(i), sum = 0.0;
-      for (int j = I[i]; j < I[i+1]; j++)
+   const int height = this->height;
+   const int nnz = J.Capacity();
+   const bool use_dev = UseDeviceKernels(b.UseDevice() || x0.UseDevice() ||
+                                         x1.UseDevice());
+   auto d_err = ResetKernelError(use_dev);
+   auto d_I = Read(I, height+1, use_dev);
+   auto d_J = Read(J, nnz, use_dev);
+   auto d_A = Read(A, nnz, use_dev);
+   auto d_b = b.Read(use_dev);
+   auto d_x0 = x0.Read(use_dev);
+   auto d_x1 = x1.Write(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, height,
+   {
+      double resi = d_b[i], sum = 0.0;
+      const int end = d_I[i+1];
+      for (int j = d_I[i]; j < end; j++)
       {
-         resi -= A[j] * x0(J[j]);
-         sum  += A[j];
+         resi -= d_A[j] * d_x0[d_J[j]];
+         sum  += d_A[j];
       }
       if (sum > 0.0)
       {
-         x1(i) = x0(i) + sc * resi / sum;
+         d_x1[i] = d_x0[i] + sc * resi / sum;
       }
       else
       {
-         MFEM_ABORT("sum of row " << i << " is zero.");
+         d_err[0] = i;
       }
-   }
+   });
+   const int err_row = kernel_err.HostRead()[0];
+   MFEM_VERIFY(err_row < 0, "sum of row " << err_row << " is zero.");
 }
 
 void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
@@ -3417,6 +3717,223 @@ SparseMatrix *Mult_AtDA (const SparseMatrix &A, const Vector &D,
    return AtDA;
 }
 
+void SparseProductPlan::Setup(const SparseMatrix &A, const SparseMatrix &B)
+{
+   MFEM_VERIFY(A.Finalized() && B.Finalized(),
+               "the matrices must be finalized");
+   MFEM_VERIFY(A.Width() == B.Height(),
+               "number of columns of A (" << A.Width()
+               << ") must equal number of rows of B (" << B.Height() << ")");
+
+   height = A.Height();
+   width = B.Width();
+   nnz_A = A.NumNonZeroElems();
+   nnz_B = B.NumNonZeroElems();
+
+   const int *A_i = A.HostReadI(), *A_j = A.HostReadJ();
+   const int *B_i = B.HostReadI(), *B_j = B.HostReadJ();
+
+   Array<int> marker(width);
+   marker = -1;
+
+   // Count the entries and the products in each row
+   I.SetSize(height+1);
+   term_offset.SetSize(height+1);
+   int nnz = 0, num_terms = 0;
+   for (int i = 0; i < height; i++)
+   {
+      I[i] = nnz;
+      term_offset[i] = num_terms;
+      for (int ia = A_i[i]; ia < A_i[i+1]; ia++)
+      {
+         const int ja = A_j[ia];
+         num_terms += B_i[ja+1] - B_i[ja];
+         for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+         {
+            if (marker[B_j[ib]] != i)
+            {
+               marker[B_j[ib]] = i;
+               nnz++;
+            }
+         }
+      }
+   }
+   I[height] = nnz;
+   term_offset[height] = num_terms;
+
+   // Fill the column indices and the position of each product
+   J.SetSize(nnz);
+   term_pos.SetSize(num_terms);
+   marker = -1;
+   for (int i = 0, t = 0; i < height; i++)
+   {
+      int counter = I[i];
+      for (int ia = A_i[i]; ia < A_i[i+1]; ia++)
+      {
+         const int ja = A_j[ia];
+         for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+         {
+            const int jb = B_j[ib];
+            if (marker[jb] < I[i])
+            {
+               marker[jb] = counter;
+               J[counter++] = jb;
+            }
+            term_pos[t++] = marker[jb];
+         }
+      }
+   }
+}
+
+SparseMatrix *SparseProductPlan::CreateMatrix() const
+{
+   const int nnz = J.Size();
+   int *C_i = new int[height+1];
+   int *C_j = new int[nnz];
+   double *C_data = new double[nnz];
+   for (int i = 0; i <= height; i++) { C_i[i] = I[i]; }
+   for (int k = 0; k < nnz; k++)
+   {
+      C_j[k] = J[k];
+      C_data[k] = 0.0;
+   }
+   return new SparseMatrix(C_i, C_j, C_data, height, width);
+}
+
+void SparseProductPlan::Mult(const SparseMatrix &A, const SparseMatrix &B,
+                             SparseMatrix &C) const
+{
+   MFEM_VERIFY(A.Height() == height && A.NumNonZeroElems() == nnz_A &&
+               B.Width() == width && B.NumNonZeroElems() == nnz_B,
+               "the matrices do not match the sparsity of the product");
+   MFEM_VERIFY(C.Finalized() && C.Height() == height &&
+               C.NumNonZeroElems() == J.Size(),
+               "the output matrix does not match the sparsity of the product");
+
+   auto d_Ai = A.ReadI();
+   auto d_Aj = A.ReadJ();
+   auto d_Ad = A.ReadData();
+   auto d_Bi = B.ReadI();
+   auto d_Bd = B.ReadData();
+   auto d_Ci = C.ReadI();
+   auto d_Cd = C.WriteData();
+   auto d_offset = term_offset.Read();
+   auto d_pos = term_pos.Read();
+   // The products of row i are added to the entries of row i of C
+   MFEM_FORALL(i, height,
+   {
+      for (int k = d_Ci[i]; k < d_Ci[i+1]; k++) { d_Cd[k] = 0.0; }
+      int t = d_offset[i];
+      for (int ia = d_Ai[i]; ia < d_Ai[i+1]; ia++)
+      {
+         const int ja = d_Aj[ia];
+         const double a = d_Ad[ia];
+         for (int ib = d_Bi[ja]; ib < d_Bi[ja+1]; ib++)
+         {
+            d_Cd[d_pos[t++]] += a * d_Bd[ib];
+         }
+      }
+   });
+}
+
+SparseMatrix *SparseProductPlan::Mult(const SparseMatrix &A,
+                                      const SparseMatrix &B) const
+{
+   SparseMatrix *C = CreateMatrix();
+   Mult(A, B, *C);
+   return C;
+}
+
+// Return the transpose of A and, in map, the entry of A for each entry of the
+// transpose.
+static SparseMatrix *TransposeWithMap(const SparseMatrix &A, Array<int> &map)
+{
+   const int m = A.Height(), n = A.Width(), nnz = A.NumNonZeroElems();
+   const int *A_i = A.HostReadI(), *A_j = A.HostReadJ();
+   const double *A_data = A.HostReadData();
+
+   int *At_i = new int[n+1];
+   int *At_j = new int[nnz];
+   double *At_data = new double[nnz];
+   map.SetSize(nnz);
+
+   for (int j = 0; j <= n; j++) { At_i[j] = 0; }
+   for (int k = 0; k < nnz; k++) { At_i[A_j[k]+1]++; }
+   for (int j = 1; j <= n; j++) { At_i[j] += At_i[j-1]; }
+   for (int i = 0; i < m; i++)
+   {
+      for (int k = A_i[i]; k < A_i[i+1]; k++)
+      {
+         const int pos = At_i[A_j[k]]++;
+         At_j[pos] = i;
+         At_data[pos] = A_data[k];
+         map[pos] = k;
+      }
+   }
+   for (int j = n; j > 0; j--) { At_i[j] = At_i[j-1]; }
+   At_i[0] = 0;
+
+   return new SparseMatrix(At_i, At_j, At_data, n, m);
+}
+
+// Update the values of the transpose At of A, built with TransposeWithMap().
+static void UpdateTranspose(const SparseMatrix &A, const Array<int> &map,
+                            SparseMatrix &At)
+{
+   MFEM_VERIFY(A.NumNonZeroElems() == map.Size() &&
+               A.Height() == At.Width() && A.Width() == At.Height(),
+               "the matrix does not match the sparsity of the product");
+   auto d_map = map.Read();
+   auto d_A = A.ReadData();
+   auto d_At = At.WriteData();
+   MFEM_FORALL(k, map.Size(), d_At[k] = d_A[d_map[k]];);
+}
+
+SparseRAPPlan::SparseRAPPlan(const SparseMatrix &A, const SparseMatrix &R)
+   : general(false)
+{
+   MFEM_VERIFY(R.Finalized(), "the matrices must be finalized");
+   T = TransposeWithMap(R, T_map);
+   AP_plan.Setup(A, *T);
+   AP = AP_plan.Mult(A, *T);
+   RAP_plan.Setup(R, *AP);
+}
+
+SparseRAPPlan::SparseRAPPlan(const SparseMatrix &Rt, const SparseMatrix &A,
+                             const SparseMatrix &P)
+   : general(true)
+{
+   MFEM_VERIFY(Rt.Finalized(), "the matrices must be finalized");
+   T = TransposeWithMap(Rt, T_map);
+   AP_plan.Setup(A, P);
+   AP = AP_plan.Mult(A, P);
+   RAP_plan.Setup(*T, *AP);
+}
+
+void SparseRAPPlan::Mult(const SparseMatrix &A, const SparseMatrix &R,
+                         SparseMatrix &C) const
+{
+   MFEM_VERIFY(!general, "this is a plan for Rt^t A P");
+   UpdateTranspose(R, T_map, *T);
+   AP_plan.Mult(A, *T, *AP);
+   RAP_plan.Mult(R, *AP, C);
+}
+
+void SparseRAPPlan::Mult(const SparseMatrix &Rt, const SparseMatrix &A,
+                         const SparseMatrix &P, SparseMatrix &C) const
+{
+   MFEM_VERIFY(general, "this is a plan for R A R^t");
+   UpdateTranspose(Rt, T_map, *T);
+   AP_plan.Mult(A, P, *AP);
+   RAP_plan.Mult(*T, *AP, C);
+}
+
+SparseRAPPlan::~SparseRAPPlan()
+{
+   delete AP;
+   delete T;
+}
+
 SparseMatrix * Add(double a, const SparseMatrix & A, double b,
                    const SparseMatrix & B)
 {
@@ -69,6 +69,13 @@ protected:
    /// Transpose of A. Owned. Used to perform MultTranspose() on devices.
    mutable SparseMatrix *At;
 
+   /// Row with an error in the Jacobi() and DiagScale() kernels, or -1.
+   mutable Array<int> kernel_err;
+   /** Work vector of the OpenMP kernels: the per-thread copies of y in
+       AddMultTranspose() and the values of y at the start of a hybrid
+       Gauss-Seidel sweep. */
+   mutable Vector thread_y;
+
 #ifdef MFEM_USE_MEMALLOC
    typedef MemAlloc <RowNode, 1024> RowNodeAlloc;
    RowNodeAlloc * NodesMem;
@@ -80,6 +87,10 @@ protected:
    void Destroy();   // Delete all owned data
    void SetEmpty();  // Init all entries with empty values
 
+   /** @brief Set #kernel_err to -1 and return it for writing in a kernel, on
+       the device if @a use_dev is true. */
+   int *ResetKernelError(bool use_dev) const;
+
 public:
    /// Create an empty SparseMatrix.
    SparseMatrix() { SetEmpty(); }
@@ -274,6 +285,26 @@ public:
    void AddMultTranspose(const Vector &x, Vector &y,
                          const double a = 1.0) const;
 
+   /** @brief Multiply the columns of the multi-vector @a X, i.e. Y = A X, where
+       the k vectors are the columns of the (column-major) DenseMatrix @a X. */
+   /** The vectors are processed in groups of up to 16 in one pass over the
+       matrix, so the entries of the matrix are read once per group, i.e. once
+       for k <= 16. @a Y is resized to Height() x k. */
+   void Mult(const DenseMatrix &X, DenseMatrix &Y) const;
+
+   /// Y += A X (default)  or  Y += a * A X, see Mult(const DenseMatrix &, ...).
+   void AddMult(const DenseMatrix &X, DenseMatrix &Y,
+                const double a = 1.0) const;
+
+   /// Multiply a multi-vector with the transposed matrix: Y = At X.
+   void MultTranspose(const DenseMatrix &X, DenseMatrix &Y) const;
+
+   /// Y += At X (default)  or  Y += a * At X
+   /** If the internal transpose is built, see BuildTranspose(), it is used to
+       compute the product; otherwise the product is computed on the host. */
+   void AddMultTranspose(const DenseMatrix &X, DenseMatrix &Y,
+                         const double a = 1.0) const;
+
    /** @brief Build and store internally the transpose of this matrix which will
        be used in the methods AddMultTranspose() and MultTranspose(). */
    /** If this method has been called, the internal transpose matrix will be
@@ -285,12 +316,13 @@ public:
        call to this method. If the internal transpose is already built, this
        method has no effect.
 
-       When any non-default backend is enabled, i.e. Device::IsEnabled() is
-       true, the methods AddMultTranspose(), and MultTranspose(), require the
+       When a device backend is enabled, i.e. the device memory is not the host
+       memory, the methods AddMultTranspose(), and MultTranspose(), require the
        internal transpose to be built. If that is not the case (i.e. the
        internal transpose is not built), these methods will raise an error with
-       an appropriate message pointing to this method. When using the default
-       backend, calling this method is optional.
+       an appropriate message pointing to this method. With host backends,
+       calling this method is optional; with the "omp" backend, the transpose
+       action is then computed with thread-private copies of the output vector.
 
        This method can only be used when the sparse matrix is finalized. */
    void BuildTranspose() const;
@@ -392,6 +424,9 @@ public:
    virtual void EliminateZeroRows(const double threshold = 1e-12);
 
    /// Gauss-Seidel forward and backward iterations over a vector x.
+   /** With the "omp" backend, a hybrid Gauss-Seidel iteration is used: the
+       rows are split in one block per thread, with Gauss-Seidel within the
+       blocks and Jacobi coupling between them. */
    void Gauss_Seidel_forw(const Vector &x, Vector &y) const;
    void Gauss_Seidel_back(const Vector &x, Vector &y) const;
 
@@ -624,6 +659,91 @@ SparseMatrix *Mult_AtDA(const SparseMatrix &A, const Vector &D,
                         SparseMatrix *OAtDA = NULL);
 
 
+/** @brief Sparsity structure of the product C = A B of two finalized sparse
+    matrices, for repeated products of matrices with fixed sparsity. */
+/** The construction (symbolic phase) computes the sparsity of C, with the
+    entries of each row in the same order as in Mult(const SparseMatrix&,
+    const SparseMatrix&, SparseMatrix*), and the position in C of each of the
+    products A(i,k) B(k,j). The numeric phase, Mult(), then recomputes the
+    values of C in parallel over the rows, with the device backends when they
+    are enabled. The matrices given to Mult() must have the same sparsity as
+    the ones used in the construction, while their values may differ. */
+class SparseProductPlan
+{
+protected:
+   int height, width, nnz_A, nnz_B;
+   Array<int> I, J;         ///< Sparsity of the product.
+   Array<int> term_offset;  ///< Offsets of the products of each row.
+   Array<int> term_pos;     ///< Position of each product A(i,k) B(k,j) in C.
+
+public:
+   SparseProductPlan() : height(0), width(0), nnz_A(0), nnz_B(0) { }
+
+   /// Compute the structure of the product A B.
+   SparseProductPlan(const SparseMatrix &A, const SparseMatrix &B)
+   { Setup(A, B); }
+
+   /// Compute the structure of the product A B.
+   void Setup(const SparseMatrix &A, const SparseMatrix &B);
+
+   int Height() const { return height; }
+   int Width() const { return width; }
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /// Return a new matrix with the sparsity of the product and zero values.
+   SparseMatrix *CreateMatrix() const;
+
+   /** @brief Compute C = A B, where C has the sparsity of the product, e.g. C
+       is returned by CreateMatrix(). */
+   void Mult(const SparseMatrix &A, const SparseMatrix &B,
+             SparseMatrix &C) const;
+
+   /// Return a new matrix A B.
+   SparseMatrix *Mult(const SparseMatrix &A, const SparseMatrix &B) const;
+};
+
+/** @brief Sparsity structure of the triple products computed by RAP(), for
+    repeated products of matrices with fixed sparsity. */
+/** The triple product is computed with two SparseProductPlan%s. The transpose
+    of R (resp. Rt) is formed once, and its values are updated from the matrix
+    given to Mult(), so all the matrices may change their values, but not their
+    sparsity. */
+class SparseRAPPlan
+{
+protected:
+   bool general;          ///< Is this a plan for Rt^t A P?
+   SparseMatrix *T;       ///< The transpose of R, or of Rt.
+   Array<int> T_map;      ///< Entry of R (or Rt) for each entry of T.
+   SparseMatrix *AP;      ///< The intermediate product A R^t, or A P.
+   SparseProductPlan AP_plan, RAP_plan;
+
+public:
+   /// Compute the structure of R A R^t, see RAP(const SparseMatrix &A, ...).
+   SparseRAPPlan(const SparseMatrix &A, const SparseMatrix &R);
+
+   /// Compute the structure of Rt^t A P.
+   SparseRAPPlan(const SparseMatrix &Rt, const SparseMatrix &A,
+                 const SparseMatrix &P);
+
+   /// The plan owns its intermediate matrices and cannot be copied.
+   SparseRAPPlan(const SparseRAPPlan &) = delete;
+   SparseRAPPlan &operator=(const SparseRAPPlan &) = delete;
+
+   /// Return a new matrix with the sparsity of the product and zero values.
+   SparseMatrix *CreateMatrix() const { return RAP_plan.CreateMatrix(); }
+
+   /// Compute C = R A R^t with a plan for R A R^t.
+   void Mult(const SparseMatrix &A, const SparseMatrix &R,
+             SparseMatrix &C) const;
+
+   /// Compute C = Rt^t A P with a plan for Rt^t A P.
+   void Mult(const SparseMatrix &Rt, const SparseMatrix &A,
+             const SparseMatrix &P, SparseMatrix &C) const;
+
+   ~SparseRAPPlan();
+};
+
+
 /// Matrix addition result = A + B.
 SparseMatrix * Add(const SparseMatrix & A, const SparseMatrix & B);
 /// Matrix addition result = a*A + b*B
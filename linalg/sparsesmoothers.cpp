@@ -15,7 +15,9 @@
 #include "matrix.hpp"
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
+#include "../general/forall.hpp"
 #include <iostream>
+#include <cmath>
 
 namespace mfem
 {
@@ -108,4 +110,106 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+double MaxEigenvalueDinvA(const SparseMatrix &A, int iter)
+{
+   const int n = A.Height();
+   Vector dinv(n), v(n), w(n);
+   A.GetDiag(dinv);
+   double *h_dinv = dinv.HostReadWrite();
+   double *h_v = v.HostWrite();
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(h_dinv[i] != 0.0, "zero diagonal entry in row " << i);
+      h_dinv[i] = 1.0/h_dinv[i];
+      // deterministic, non-smooth starting vector
+      h_v[i] = 1.0 + ((37*i) % 101)/101.0;
+   }
+   v /= v.Norml2();
+
+   double lambda = 0.0;
+   for (int k = 0; k < iter; k++)
+   {
+      A.Mult(v, w);
+      double *h_w = w.HostReadWrite();
+      for (int i = 0; i < n; i++) { h_w[i] *= h_dinv[i]; }
+      lambda = w.Norml2();
+      if (lambda == 0.0) { break; }
+      v.Set(1.0/lambda, w);
+   }
+   return 1.1*lambda;
+}
+
+ChebyshevSmoother::ChebyshevSmoother(const SparseMatrix &a, int deg,
+                                     double ratio_)
+   : SparseSmoother(a)
+{
+   degree = deg;
+   ratio = ratio_;
+   Setup();
+}
+
+void ChebyshevSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   Setup();
+}
+
+void ChebyshevSmoother::Setup()
+{
+   MFEM_VERIFY(degree > 0, "invalid polynomial degree: " << degree);
+   MFEM_VERIFY(ratio > 1.0, "invalid eigenvalue ratio: " << ratio);
+   lmax = MaxEigenvalueDinvA(*oper);
+   oper->GetDiag(dinv);
+   double *h_dinv = dinv.HostReadWrite();
+   for (int i = 0; i < dinv.Size(); i++) { h_dinv[i] = 1.0/h_dinv[i]; }
+}
+
+void ChebyshevSmoother::Mult(const Vector &x, Vector &y) const
+{
+   // Chebyshev iteration, see Y. Saad, "Iterative Methods for Sparse Linear
+   // Systems", Algorithm 12.1
+   const double upper = lmax, lower = lmax/ratio;
+   const double theta = 0.5*(upper + lower), delta = 0.5*(upper - lower);
+   const double sigma = theta/delta;
+   double rho = 1.0/sigma;
+
+   r.SetSize(height);
+   d.SetSize(height);
+   z.SetSize(height);
+
+   if (!iterative_mode)
+   {
+      y = 0.0;
+      r = x;
+   }
+   else
+   {
+      oper->Mult(y, r);
+      subtract(x, r, r);
+   }
+
+   const int n = height;
+   auto d_dinv = dinv.Read();
+   {
+      auto d_r = r.Read();
+      auto d_d = d.Write();
+      MFEM_FORALL(i, n, d_d[i] = d_dinv[i]*d_r[i]/theta;);
+   }
+   for (int k = 0; k < degree; k++)
+   {
+      y += d;
+      if (k == degree - 1) { break; }
+
+      oper->Mult(d, z);
+      r -= z;
+
+      const double rho_new = 1.0/(2.0*sigma - rho);
+      const double c1 = rho_new*rho, c2 = 2.0*rho_new/delta;
+      auto d_r = r.Read();
+      auto d_d = d.ReadWrite();
+      MFEM_FORALL(i, n, d_d[i] = c1*d_d[i] + c2*d_dinv[i]*d_r[i];);
+      rho = rho_new;
+   }
+}
+
 }
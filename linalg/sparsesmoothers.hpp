@@ -73,6 +73,47 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/// Chebyshev polynomial smoother of sparse matrix, with Jacobi scaling
+/** The smoother performs @a degree steps of the Chebyshev iteration for
+    D^{-1} A, where D is the diagonal of A, damping the eigenvalues in the
+    interval [lmax/ratio, lmax]. The largest eigenvalue lmax of D^{-1} A is
+    estimated in SetOperator() with MaxEigenvalueDinvA(). The smoother is
+    symmetric when A is symmetric and needs no damping parameter. */
+class ChebyshevSmoother : public SparseSmoother
+{
+protected:
+   int degree;
+   double ratio;
+   double lmax;
+
+   Vector dinv;
+   mutable Vector r, d, z;
+
+   void Setup();
+
+public:
+   /// Create Chebyshev smoother.
+   ChebyshevSmoother(int deg = 2, double ratio_ = 30.0)
+   { degree = deg; ratio = ratio_; lmax = 0.0; }
+
+   /// Create Chebyshev smoother.
+   ChebyshevSmoother(const SparseMatrix &a, int deg = 2, double ratio_ = 30.0);
+
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalue() const { return lmax; }
+
+   /// Matrix vector multiplication with Chebyshev smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** @brief Return an estimate of the largest eigenvalue of D^{-1} A, where D is
+    the diagonal of A, computed with @a iter power iterations. */
+/** The estimate is increased by 10%, so that it is an upper bound in practice
+    when the eigenvalues are real, e.g. for symmetric positive definite A. */
+double MaxEigenvalueDinvA(const SparseMatrix &A, int iter = 10);
+
 }
 
 #endif
@@ -445,6 +445,198 @@ void subtract(const double a, const Vector &x, const Vector &y, Vector &z)
    }
 }
 
+// The fused kernels are threaded with the OpenMP backend, or legacy OpenMP.
+static inline bool FusedUseOmp(const bool use_dev)
+{
+#ifdef MFEM_USE_LEGACY_OPENMP
+   return true;
+#else
+   return use_dev && Device::Allows(Backend::OMP_MASK);
+#endif
+}
+
+// Return true if the fused kernels run on a GPU device.
+static inline bool FusedUseGpu(const bool use_dev)
+{
+   return use_dev && Device::Allows(Backend::DEVICE_MASK);
+}
+
+// Sum of dot(i) over 0 <= i < N in a single host loop, which also performs the
+// element-wise updates of the fused kernels.
+template <typename DOT>
+static double FusedSum(const int N, const bool use_dev, DOT &&dot)
+{
+   double sum = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:sum) if (FusedUseOmp(use_dev))
+#endif
+   for (int i = 0; i < N; i++) { sum += dot(i); }
+   return sum;
+}
+
+// On GPU devices, the fused kernels are MFEM_FORALL reductions: thread t of nt
+// updates and sums the entries t, t + nt, t + 2 nt, ..., so that the memory
+// accesses are coalesced, and the nt partial sums are added on the host.
+static const int FUSED_GPU_THREADS = 16384;
+static Vector fused_partial_sums;
+
+static inline int FusedGpuThreads(const int N)
+{
+   return std::min(N, FUSED_GPU_THREADS);
+}
+
+// Device buffer for num_sums sets of nt partial sums.
+static double *FusedPartialSums(const int nt, const int num_sums)
+{
+   fused_partial_sums.SetSize(num_sums*nt, Device::GetMemoryType());
+   fused_partial_sums.UseDevice(true);
+   return fused_partial_sums.Write();
+}
+
+// Add the k-th set of nt partial sums on the host.
+static double FusedTotal(const int nt, const int k)
+{
+   const double *h_sums = fused_partial_sums.HostRead() + k*nt;
+   double sum = 0.0;
+   for (int t = 0; t < nt; t++) { sum += h_sums[t]; }
+   return sum;
+}
+
+double AddAndDot(const Vector &v1, double alpha, const Vector &v2, Vector &v,
+                 const Vector &w)
+{
+   MFEM_ASSERT(v.Size() == v1.Size() && v.Size() == v2.Size() &&
+               v.Size() == w.Size(), "incompatible Vectors!");
+
+   const bool use_dev = v1.UseDevice() || v2.UseDevice() || v.UseDevice() ||
+                        w.UseDevice();
+   const int N = v.Size();
+   // Note: get read access first, in case v is the same as v1/v2/w.
+   auto d_x = v1.Read(use_dev);
+   auto d_y = v2.Read(use_dev);
+   auto d_w = w.Read(use_dev);
+   auto d_v = v.ReadWrite(use_dev);
+   if (FusedUseGpu(use_dev))
+   {
+      const int nt = FusedGpuThreads(N);
+      auto d_sums = FusedPartialSums(nt, 1);
+      MFEM_FORALL(t, nt,
+      {
+         double sum = 0.0;
+         for (int i = t; i < N; i += nt)
+         {
+            const double v_i = d_x[i] + alpha * d_y[i];
+            d_v[i] = v_i;
+            sum += v_i * d_w[i];
+         }
+         d_sums[t] = sum;
+      });
+      return FusedTotal(nt, 0);
+   }
+   return FusedSum(N, use_dev, [=](int i) -> double
+   {
+      d_v[i] = d_x[i] + alpha * d_y[i];
+      return d_v[i] * d_w[i];
+   });
+}
+
+double AddAndNorm2(const Vector &v1, double alpha, const Vector &v2, Vector &v)
+{
+   MFEM_ASSERT(v.Size() == v1.Size() && v.Size() == v2.Size(),
+               "incompatible Vectors!");
+
+   const bool use_dev = v1.UseDevice() || v2.UseDevice() || v.UseDevice();
+   const int N = v.Size();
+   auto d_x = v1.Read(use_dev);
+   auto d_y = v2.Read(use_dev);
+   auto d_v = v.ReadWrite(use_dev);
+   if (FusedUseGpu(use_dev))
+   {
+      const int nt = FusedGpuThreads(N);
+      auto d_sums = FusedPartialSums(nt, 1);
+      MFEM_FORALL(t, nt,
+      {
+         double sum = 0.0;
+         for (int i = t; i < N; i += nt)
+         {
+            const double v_i = d_x[i] + alpha * d_y[i];
+            d_v[i] = v_i;
+            sum += v_i * v_i;
+         }
+         d_sums[t] = sum;
+      });
+      return FusedTotal(nt, 0);
+   }
+   return FusedSum(N, use_dev, [=](int i) -> double
+   {
+      const double v_i = d_x[i] + alpha * d_y[i];
+      d_v[i] = v_i;
+      return v_i * v_i;
+   });
+}
+
+void AddAndXpay(double alpha, const Vector &z, double beta, Vector &x,
+                Vector &d)
+{
+   MFEM_ASSERT(x.Size() == z.Size() && x.Size() == d.Size(),
+               "incompatible Vectors!");
+
+   const bool use_dev = z.UseDevice() || x.UseDevice() || d.UseDevice();
+   const int N = x.Size();
+   auto d_z = z.Read(use_dev);
+   auto d_x = x.ReadWrite(use_dev);
+   auto d_d = d.ReadWrite(use_dev);
+   MFEM_FORALL_SWITCH(use_dev, i, N,
+   {
+      const double d_i = d_d[i];
+      d_x[i] += alpha * d_i;
+      d_d[i] = d_z[i] + beta * d_i;
+   });
+}
+
+void Dot2(const Vector &x, const Vector &y1, const Vector &y2,
+          double &d1, double &d2)
+{
+   MFEM_ASSERT(x.Size() == y1.Size() && x.Size() == y2.Size(),
+               "incompatible Vectors!");
+
+   const bool use_dev = x.UseDevice() || y1.UseDevice() || y2.UseDevice();
+   const int N = x.Size();
+   auto d_x = x.Read(use_dev);
+   auto d_y1 = y1.Read(use_dev);
+   auto d_y2 = y2.Read(use_dev);
+   if (FusedUseGpu(use_dev))
+   {
+      const int nt = FusedGpuThreads(N);
+      auto d_sums = FusedPartialSums(nt, 2);
+      MFEM_FORALL(t, nt,
+      {
+         double s1 = 0.0, s2 = 0.0;
+         for (int i = t; i < N; i += nt)
+         {
+            s1 += d_x[i] * d_y1[i];
+            s2 += d_x[i] * d_y2[i];
+         }
+         d_sums[t] = s1;
+         d_sums[nt + t] = s2;
+      });
+      d1 = FusedTotal(nt, 0);
+      d2 = FusedTotal(nt, 1);
+      return;
+   }
+   double s1 = 0.0, s2 = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:s1,s2) if (FusedUseOmp(use_dev))
+#endif
+   for (int i = 0; i < N; i++)
+   {
+      s1 += d_x[i] * d_y1[i];
+      s2 += d_x[i] * d_y2[i];
+   }
+   d1 = s1;
+   d2 = s2;
+}
+
 void Vector::median(const Vector &lo, const Vector &hi)
 {
    MFEM_ASSERT(size == lo.size && size == hi.size,
@@ -367,6 +367,32 @@ public:
 #endif
 };
 
+/** @name Fused vector kernels
+
+    Vector updates combined with each other or with the dot product of their
+    results, computed in a single pass over memory on the host or the device.
+    They are used in the inner loops of the Krylov solvers. The dot products
+    are local, i.e. they are not summed over the MPI ranks. */
+///@{
+
+/// Set v = v1 + alpha * v2 and return (v, w), with the updated v.
+double AddAndDot(const Vector &v1, double alpha, const Vector &v2, Vector &v,
+                 const Vector &w);
+
+/// Set v = v1 + alpha * v2 and return (v, v).
+double AddAndNorm2(const Vector &v1, double alpha, const Vector &v2,
+                   Vector &v);
+
+/// Set x = x + alpha * d and d = z + beta * d, using the input d in both.
+void AddAndXpay(double alpha, const Vector &z, double beta, Vector &x,
+                Vector &d);
+
+/// Compute d1 = (x, y1) and d2 = (x, y2).
+void Dot2(const Vector &x, const Vector &y1, const Vector &y2,
+          double &d1, double &d2);
+
+///@}
+
 // Inline methods
 
 inline bool IsFinite(const double &val)
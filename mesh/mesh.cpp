@@ -10033,20 +10033,45 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    this->mesh = mesh;
    IntRule = &ir;
    computed_factors = flags;
+   Compute(NULL);
+}
+
+GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
+                                   int flags, const Array<int> &elements)
+{
+   this->mesh = mesh;
+   IntRule = &ir;
+   computed_factors = flags;
+   Compute(&elements);
+}
 
+void GeometricFactors::Compute(const Array<int> *elements)
+{
    const GridFunction *nodes = mesh->GetNodes();
+   MFEM_VERIFY(nodes, "the mesh has no nodes");
    const FiniteElementSpace *fespace = nodes->FESpace();
-   const FiniteElement *fe = fespace->GetFE(0);
    const int vdim = fespace->GetVDim();
-   const int NE   = fespace->GetNE();
+   const int NE   = elements ? elements->Size() : fespace->GetNE();
+   if (NE == 0) { return; }
+   const FiniteElement *fe = fespace->GetFE(elements ? (*elements)[0] : 0);
    const int ND   = fe->GetDof();
-   const int NQ   = ir.GetNPoints();
+   const int NQ   = IntRule->GetNPoints();
+   const int flags = computed_factors;
 
    Vector Enodes(vdim*ND*NE);
    // For now, we are not using tensor product evaluation
-   const Operator *elem_restr = fespace->GetElementRestriction(
-                                   ElementDofOrdering::NATIVE);
-   elem_restr->Mult(*nodes, Enodes);
+   if (elements)
+   {
+      SubsetElementRestriction elem_restr(*fespace, ElementDofOrdering::NATIVE,
+                                          *elements);
+      elem_restr.Mult(*nodes, Enodes);
+   }
+   else
+   {
+      const Operator *elem_restr = fespace->GetElementRestriction(
+                                      ElementDofOrdering::NATIVE);
+      elem_restr->Mult(*nodes, Enodes);
+   }
 
    unsigned eval_flags = 0;
    if (flags & GeometricFactors::COORDINATES)
@@ -10065,10 +10090,18 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
       eval_flags |= QuadratureInterpolator::DETERMINANTS;
    }
 
-   const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
+   const QuadratureInterpolator *qi =
+      fespace->GetQuadratureInterpolator(*IntRule);
    // For now, we are not using tensor product evaluation (not implemented)
    qi->DisableTensorProducts();
-   qi->Mult(Enodes, eval_flags, X, J, detJ);
+   if (elements)
+   {
+      qi->Mult(Enodes, *elements, eval_flags, X, J, detJ);
+   }
+   else
+   {
+      qi->Mult(Enodes, eval_flags, X, J, detJ);
+   }
 }
 
 
@@ -1312,6 +1312,15 @@ public:
 
    GeometricFactors(const Mesh *mesh, const IntegrationRule &ir, int flags);
 
+   /** @brief Compute the geometric factors of the given @a elements, which
+       must all be of the same type. The mesh must have nodes. */
+   /** The factors are computed on the device, as for all mesh elements, and
+       are stored in the order of @a elements, i.e. NE = elements.Size() in the
+       layouts below. Used for partial assembly on a subset of the elements,
+       see BilinearFormIntegrator::AssemblePAElements(). */
+   GeometricFactors(const Mesh *mesh, const IntegrationRule &ir, int flags,
+                    const Array<int> &elements);
+
    /// Mapped (physical) coordinates of all quadrature points.
    /** This array uses a column-major layout with dimensions (NQ x SDIM x NE)
        where
@@ -1334,6 +1343,9 @@ public:
        - NQ = number of quadrature points per element, and
        - NE = number of elements in the mesh. */
    Vector detJ;
+
+private:
+   void Compute(const Array<int> *elements);
 };
 
 
@@ -0,0 +1,93 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace dgmassinv
+{
+
+double coeff_function(const Vector &x)
+{
+   return 1.0 + x(0)*x(0);
+}
+
+// Returns the norm of M M^{-1} x - x, where M is the fully assembled mass
+// matrix with a coefficient.
+double test_dg_mass_inverse(int dim, int order, int vdim,
+                            DGMassInverse::Mode mode)
+{
+   Mesh *mesh;
+   if (dim == 1)
+   {
+      mesh = new Mesh(5, 2.0);
+   }
+   else if (dim == 2)
+   {
+      mesh = new Mesh(3, 2, Element::QUADRILATERAL, 0, 2.0, 1.0);
+   }
+   else
+   {
+      mesh = new Mesh(2, 2, 2, Element::HEXAHEDRON, 0, 2.0, 1.0, 1.0);
+   }
+
+   L2_FECollection fec(order, dim, BasisType::GaussLobatto);
+   FiniteElementSpace fes(mesh, &fec, vdim);
+
+   // The TENSOR mode is exact for affine elements and constant coefficients
+   ConstantCoefficient two(2.0);
+   FunctionCoefficient fcoeff(coeff_function);
+   Coefficient *coeff = (mode == DGMassInverse::DENSE) ?
+                        (Coefficient*)&fcoeff : (Coefficient*)&two;
+
+   BilinearForm m(&fes);
+   if (vdim == 1) { m.AddDomainIntegrator(new MassIntegrator(*coeff)); }
+   else { m.AddDomainIntegrator(new VectorMassIntegrator(*coeff)); }
+   m.Assemble();
+   m.Finalize();
+
+   DGMassInverse minv(fes, coeff, mode);
+
+   Vector x(fes.GetVSize()), y(fes.GetVSize()), z(fes.GetVSize());
+   x.Randomize(1);
+   minv.Mult(x, y);
+   m.Mult(y, z);
+   z -= x;
+   const double error = z.Normlinf() / x.Normlinf();
+
+   delete mesh;
+   return error;
+}
+
+TEST_CASE("DG Mass Inverse", "[DGMassInverse]")
+{
+   for (int dim = 1; dim <= 3; ++dim)
+   {
+      for (int order = 1; order <= 3; ++order)
+      {
+         // Scalar space and vector space with vdim equal to the space
+         // dimension, as assumed by VectorMassIntegrator
+         const int num_vdims = (dim == 1) ? 1 : 2;
+         for (int i = 0; i < num_vdims; ++i)
+         {
+            const int vdim = (i == 0) ? 1 : dim;
+            REQUIRE(test_dg_mass_inverse(dim, order, vdim,
+                                         DGMassInverse::DENSE) < 1e-10);
+            REQUIRE(test_dg_mass_inverse(dim, order, vdim,
+                                         DGMassInverse::TENSOR) < 1e-10);
+         }
+      }
+   }
+}
+
+} // namespace dgmassinv
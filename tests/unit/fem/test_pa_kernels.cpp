@@ -353,6 +353,99 @@ TEST_CASE("PA Vector Diffusion", "[PartialAssembly], [VectorPA]")
    }
 }
 
+// Difference between the full and the partial assembly of a form with a mass
+// domain integrator and the given boundary integrator: the largest of the
+// differences of the actions and, if check_diag is true, of the diagonals
+double test_bdr_pa_integrator(int dim, BilinearFormIntegrator *bfi_fa,
+                              BilinearFormIntegrator *bfi_pa,
+                              Array<int> *bdr_marker, bool check_diag = true)
+{
+   Mesh *mesh = (dim == 2) ?
+                new Mesh(2, 3, Element::QUADRILATERAL, 0, 1.0, 1.5) :
+                new Mesh(2, 2, 3, Element::HEXAHEDRON, 0, 1.0, 1.0, 1.5);
+   // Perturb the vertices to get boundary elements with general Jacobians
+   mesh->EnsureNodes();
+   GridFunction &nodes = *mesh->GetNodes();
+   Vector perturbation(nodes.Size());
+   perturbation.Randomize(5);
+   nodes.Add(0.05, perturbation);
+
+   int order = 3;
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   GridFunction x(&fes), y_fa(&fes), y_pa(&fes);
+   x.Randomize(1);
+
+   BilinearForm blf_fa(&fes);
+   blf_fa.AddDomainIntegrator(new MassIntegrator);
+   blf_fa.AddBoundaryIntegrator(bfi_fa, *bdr_marker);
+   blf_fa.Assemble();
+   blf_fa.Finalize();
+   blf_fa.Mult(x, y_fa);
+
+   BilinearForm blf_pa(&fes);
+   blf_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   blf_pa.AddDomainIntegrator(new MassIntegrator);
+   blf_pa.AddBoundaryIntegrator(bfi_pa, *bdr_marker);
+   blf_pa.Assemble();
+   blf_pa.Mult(x, y_pa);
+
+   y_fa -= y_pa;
+   double difference = y_fa.Norml2();
+
+   if (check_diag)
+   {
+      Vector d_fa, d_pa(fes.GetTrueVSize());
+      blf_fa.SpMat().GetDiag(d_fa);
+      blf_pa.AssembleDiagonal(d_pa);
+      d_fa -= d_pa;
+      difference = std::max(difference, d_fa.Norml2());
+   }
+
+   delete mesh;
+   return difference;
+}
+
+TEST_CASE("PA Boundary Integrators", "[PartialAssembly]")
+{
+   ConstantCoefficient two(2.0);
+   for (int dim = 2; dim <= 3; ++dim)
+   {
+      Array<int> bdr_marker(2*dim);
+      bdr_marker = 1;
+      bdr_marker[0] = 0;
+
+      SECTION("Mass " + std::to_string(dim) + "D")
+      {
+         REQUIRE(test_bdr_pa_integrator(dim, new MassIntegrator(two),
+                                        new MassIntegrator(two), &bdr_marker)
+                 < 1e-12);
+      }
+
+      SECTION("Diffusion " + std::to_string(dim) + "D")
+      {
+         REQUIRE(test_bdr_pa_integrator(dim, new DiffusionIntegrator(two),
+                                        new DiffusionIntegrator(two),
+                                        &bdr_marker)
+                 < 1e-12);
+      }
+
+      SECTION("Convection " + std::to_string(dim) + "D")
+      {
+         // Only the tangential part of the velocity acts on the boundary. The
+         // convection integrator has no PA diagonal.
+         Vector q(dim);
+         for (int d = 0; d < dim; d++) { q(d) = 1.0 + 0.5*d; }
+         VectorConstantCoefficient velocity(q);
+         REQUIRE(test_bdr_pa_integrator(dim, new ConvectionIntegrator(velocity),
+                                        new ConvectionIntegrator(velocity),
+                                        &bdr_marker, false)
+                 < 1e-12);
+      }
+   }
+}
+
 //test convection
 int dimension;
 
@@ -446,4 +539,386 @@ TEST_CASE("PA Convection")
 
 }//test case
 
+double mixed_coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0);
+}
+
+TEST_CASE("PA Mixed Meshes", "[PartialAssembly]")
+{
+   const char *mesh_files[] = { "../../data/star-mixed.mesh",
+                                "../../data/fichera-mixed.mesh"
+                              };
+   for (int imesh = 0; imesh < 2; ++imesh)
+   {
+      Mesh mesh(mesh_files[imesh], 1, 1);
+      const int dim = mesh.Dimension();
+      REQUIRE(mesh.GetNumGeometries(dim) > 1);
+      for (int order = 1; order <= 3; ++order)
+      {
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(&mesh, &fec);
+
+         FunctionCoefficient coeff(mixed_coeff);
+         BilinearForm a_fa(&fes), a_pa(&fes);
+         a_fa.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a_fa.AddDomainIntegrator(new MassIntegrator);
+         a_pa.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a_pa.AddDomainIntegrator(new MassIntegrator);
+         a_fa.Assemble();
+         a_fa.Finalize();
+         a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         a_pa.Assemble();
+
+         Vector x(fes.GetVSize()), y_fa(fes.GetVSize()), y_pa(fes.GetVSize());
+         x.Randomize(1);
+         a_fa.Mult(x, y_fa);
+         a_pa.Mult(x, y_pa);
+         y_pa -= y_fa;
+         REQUIRE(y_pa.Normlinf() / y_fa.Normlinf() < 1.e-12);
+
+         Vector d_fa(fes.GetVSize()), d_pa(fes.GetVSize());
+         a_fa.SpMat().GetDiag(d_fa);
+         a_pa.AssembleDiagonal(d_pa);
+         d_pa -= d_fa;
+         REQUIRE(d_pa.Normlinf() / d_fa.Normlinf() < 1.e-12);
+
+         Vector v(dim);
+         v = 1.0;
+         v(0) = 0.5;
+         VectorConstantCoefficient velocity(v);
+         BilinearForm c_fa(&fes), c_pa(&fes);
+         c_fa.AddDomainIntegrator(new ConvectionIntegrator(velocity, -1.0));
+         c_pa.AddDomainIntegrator(new ConvectionIntegrator(velocity, -1.0));
+         c_fa.Assemble();
+         c_fa.Finalize();
+         c_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         c_pa.Assemble();
+         c_fa.Mult(x, y_fa);
+         c_pa.Mult(x, y_pa);
+         y_pa -= y_fa;
+         REQUIRE(y_pa.Normlinf() / y_fa.Normlinf() < 1.e-12);
+      }
+   }
+}
+
+TEST_CASE("PA Element Partition", "[PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; ++dim)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(4, 4, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                   new Mesh(3, 3, 3, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+      for (int order = 1; order <= 3; ++order)
+      {
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         const int n = fes.GetVSize();
+
+         FunctionCoefficient coeff(mixed_coeff);
+         BilinearForm a_pa(&fes), a_part(&fes);
+         a_pa.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a_pa.AddDomainIntegrator(new MassIntegrator);
+         a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         a_pa.Assemble();
+
+         // Split the elements into two interleaved sets
+         Array<int> interior, shared;
+         for (int e = 0; e < mesh->GetNE(); ++e)
+         {
+            if (e % 3 == 0) { interior.Append(e); }
+            else { shared.Append(e); }
+         }
+         a_part.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a_part.AddDomainIntegrator(new MassIntegrator);
+         PABilinearFormExtension ext(&a_part);
+         ext.SetElementPartition(interior, shared);
+         REQUIRE(ext.Partitioned());
+         ext.Assemble();
+
+         Vector x(n), y_pa(n), y_part(n);
+         x.Randomize(1);
+         a_pa.Mult(x, y_pa);
+         ext.MultInterior(x, y_part);
+         ext.AddMultShared(x, y_part);
+         y_part -= y_pa;
+         REQUIRE(y_part.Normlinf() / y_pa.Normlinf() < 1.e-12);
+
+         ext.Mult(x, y_part);
+         y_part -= y_pa;
+         REQUIRE(y_part.Normlinf() / y_pa.Normlinf() < 1.e-12);
+
+         Vector d_pa(n), d_part(n);
+         a_pa.AssembleDiagonal(d_pa);
+         ext.AssembleDiagonal(d_part);
+         d_part -= d_pa;
+         REQUIRE(d_part.Normlinf() / d_pa.Normlinf() < 1.e-12);
+      }
+      delete mesh;
+   }
+}
+
+TEST_CASE("Device NC Prolongation", "[PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; ++dim)
+   {
+      for (int order = 1; order <= 3; ++order)
+      {
+         for (int vdim = 1; vdim <= 2; ++vdim)
+         {
+            Mesh *mesh = (dim == 2) ?
+                         new Mesh(2, 2, Element::QUADRILATERAL) :
+                         new Mesh(2, 2, 2, Element::HEXAHEDRON);
+            mesh->EnsureNCMesh();
+            // Refine twice around the first element to get hanging nodes that
+            // depend on other hanging nodes
+            for (int r = 0; r < 2; r++)
+            {
+               Array<int> refs(1);
+               refs[0] = 0;
+               mesh->GeneralRefinement(refs);
+            }
+
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec, vdim, Ordering::byVDIM);
+            const SparseMatrix *P = fes.GetConformingProlongation();
+            const SparseMatrix *R = fes.GetConformingRestriction();
+            REQUIRE(P != NULL);
+
+            const Array<int> tdof_ldof(const_cast<int*>(R->GetJ()),
+                                       R->Height());
+            DeviceNCProlongationOperator dP(*P, tdof_ldof);
+
+            Vector x(P->Width()), y(P->Height()), y_dev(P->Height());
+            x.Randomize(1);
+            P->Mult(x, y);
+            dP.Mult(x, y_dev);
+            y_dev -= y;
+            REQUIRE(y_dev.Normlinf() < 1.e-12);
+
+            Vector xt(P->Height()), yt(P->Width()), yt_dev(P->Width());
+            xt.Randomize(2);
+            P->MultTranspose(xt, yt);
+            dP.MultTranspose(xt, yt_dev);
+            yt_dev -= yt;
+            REQUIRE(yt_dev.Normlinf() < 1.e-12);
+
+            delete mesh;
+         }
+      }
+   }
+}
+
+#ifdef MFEM_USE_MPI
+
+// Largest absolute value of the entries of x over all processors
+double global_max_norm(const Vector &x)
+{
+   double loc_max = x.Normlinf(), glob_max;
+   MPI_Allreduce(&loc_max, &glob_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+   return glob_max;
+}
+
+TEST_CASE("Parallel PA Element Partition", "[Parallel], [PartialAssembly]")
+{
+   int num_procs;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   for (int dim = 2; dim <= 3; ++dim)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(8, 8, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                   new Mesh(4, 4, 4, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+      for (int order = 1; order <= 3; ++order)
+      {
+         H1_FECollection fec(order, dim);
+         ParFiniteElementSpace pfes(&pmesh, &fec);
+
+         SECTION("GetInteriorElements " + std::to_string(dim) + "D, order " +
+                 std::to_string(order))
+         {
+            Array<int> interior, shared;
+            pfes.GetInteriorElements(interior, shared);
+            REQUIRE(interior.Size() + shared.Size() == pmesh.GetNE());
+            REQUIRE(interior.IsSorted());
+            REQUIRE(shared.IsSorted());
+
+            // The DOFs of the interior elements are owned and not shared
+            int err = 0;
+            Array<int> vdofs;
+            for (int i = 0; i < interior.Size(); i++)
+            {
+               pfes.GetElementVDofs(interior[i], vdofs);
+               for (int j = 0; j < vdofs.Size(); j++)
+               {
+                  const int ldof = (vdofs[j] >= 0) ? vdofs[j] : -1 - vdofs[j];
+                  err += (pfes.GetLocalTDofNumber(ldof) < 0);
+               }
+            }
+            int glob_err, num_shared = shared.Size(), glob_shared;
+            MPI_Allreduce(&err, &glob_err, 1, MPI_INT, MPI_SUM,
+                          MPI_COMM_WORLD);
+            MPI_Allreduce(&num_shared, &glob_shared, 1, MPI_INT, MPI_SUM,
+                          MPI_COMM_WORLD);
+            REQUIRE(glob_err == 0);
+            REQUIRE((num_procs == 1) == (glob_shared == 0));
+         }
+
+         FunctionCoefficient coeff(mixed_coeff);
+         ParBilinearForm a_ref(&pfes);
+         a_ref.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a_ref.AddDomainIntegrator(new MassIntegrator);
+         a_ref.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         a_ref.Assemble();
+
+         const int n = pfes.GetTrueVSize();
+         Vector x(n), y_ref(n), y(n);
+         x.Randomize(1 + pmesh.GetMyRank());
+
+         SECTION("ParPAOverlapOperator " + std::to_string(dim) + "D, order " +
+                 std::to_string(order))
+         {
+            Array<int> no_ess;
+            OperatorHandle A_ref;
+            a_ref.FormSystemMatrix(no_ess, A_ref);
+            A_ref->Mult(x, y_ref);
+
+            ParBilinearForm a(&pfes);
+            a.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+            a.AddDomainIntegrator(new MassIntegrator);
+            PABilinearFormExtension ext(&a);
+            Array<int> interior, shared;
+            pfes.GetInteriorElements(interior, shared);
+            ext.SetElementPartition(interior, shared);
+            ext.Assemble();
+
+            const ConformingProlongationOperator *P =
+               dynamic_cast<const ConformingProlongationOperator*>(
+                  pfes.GetProlongationMatrix());
+            REQUIRE(P != NULL);
+
+            // BcastBegin() and BcastEnd() give the same result as Mult()
+            Vector Px(P->Height()), Px_ref(P->Height());
+            P->Mult(x, Px_ref);
+            P->BcastBegin(x, Px);
+            P->BcastEnd(Px);
+            Px -= Px_ref;
+            REQUIRE(global_max_norm(Px) == 0.0);
+
+            ParPAOverlapOperator A(*P, ext);
+            A.Mult(x, y);
+            y -= y_ref;
+            REQUIRE(global_max_norm(y) / global_max_norm(y_ref) < 1.e-12);
+
+            // The operator is symmetric
+            A.MultTranspose(x, y);
+            y -= y_ref;
+            REQUIRE(global_max_norm(y) / global_max_norm(y_ref) < 1.e-12);
+         }
+
+         SECTION("OverlapCommunication " + std::to_string(dim) + "D, order " +
+                 std::to_string(order))
+         {
+            Array<int> ess_bdr(pmesh.bdr_attributes.Max()), ess_tdof_list;
+            ess_bdr = 1;
+            pfes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+            OperatorHandle A_ref, A;
+            a_ref.FormSystemMatrix(ess_tdof_list, A_ref);
+            A_ref->Mult(x, y_ref);
+
+            ParBilinearForm a(&pfes);
+            a.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+            a.AddDomainIntegrator(new MassIntegrator);
+            a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            a.OverlapCommunication();
+            a.Assemble();
+            a.FormSystemMatrix(ess_tdof_list, A);
+            A->Mult(x, y);
+            y -= y_ref;
+            REQUIRE(global_max_norm(y) / global_max_norm(y_ref) < 1.e-12);
+
+            // The right-hand side is eliminated in the same way
+            ParGridFunction u(&pfes), u_ref(&pfes);
+            ParLinearForm b(&pfes), b_ref(&pfes);
+            u.Randomize(2);
+            u_ref = u;
+            b.Randomize(3);
+            b_ref = b;
+            Vector X, B, X_ref, B_ref;
+            a_ref.FormLinearSystem(ess_tdof_list, u_ref, b_ref, A_ref, X_ref,
+                                   B_ref);
+            a.FormLinearSystem(ess_tdof_list, u, b, A, X, B);
+            B -= B_ref;
+            REQUIRE(global_max_norm(B) / global_max_norm(B_ref) < 1.e-12);
+         }
+      }
+   }
+}
+
+TEST_CASE("Parallel Device NC Prolongation", "[Parallel], [PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; ++dim)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(4, 4, Element::QUADRILATERAL) :
+                   new Mesh(2, 2, 2, Element::HEXAHEDRON);
+      mesh->EnsureNCMesh();
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+      // Refine around the first element of each processor to get hanging
+      // nodes, also on the processor boundaries
+      for (int r = 0; r < 2; r++)
+      {
+         Array<int> refs;
+         if (pmesh.GetNE() > 0) { refs.Append(0); }
+         pmesh.GeneralRefinement(refs);
+      }
+      for (int order = 1; order <= 3; ++order)
+      {
+         H1_FECollection fec(order, dim);
+         ParFiniteElementSpace pfes(&pmesh, &fec, 2, Ordering::byVDIM);
+         HypreParMatrix *P = pfes.Dof_TrueDof_Matrix();
+
+         // The device operator is only used when the device is enabled
+         const Operator *P_op = pfes.GetProlongationMatrix();
+         if (Device::Allows(Backend::DEVICE_MASK))
+         {
+            REQUIRE(dynamic_cast<const ParDeviceNCProlongationOperator*>(P_op)
+                    != NULL);
+         }
+         else
+         {
+            REQUIRE(P_op == P);
+         }
+
+         ParDeviceNCProlongationOperator dP(pfes);
+         for (int it = 0; it < 2; it++)
+         {
+            Vector x(P->Width()), y(P->Height()), y_dev(P->Height());
+            x.Randomize(1 + it);
+            P->Mult(x, y);
+            dP.Mult(x, y_dev);
+            y_dev -= y;
+            REQUIRE(global_max_norm(y_dev) < 1.e-12);
+            P_op->Mult(x, y_dev);
+            y_dev -= y;
+            REQUIRE(global_max_norm(y_dev) < 1.e-12);
+
+            Vector xt(P->Height()), yt(P->Width()), yt_dev(P->Width());
+            xt.Randomize(3 + it);
+            P->MultTranspose(xt, yt);
+            dP.MultTranspose(xt, yt_dev);
+            yt_dev -= yt;
+            REQUIRE(global_max_norm(yt_dev) < 1.e-12);
+            P_op->MultTranspose(xt, yt_dev);
+            yt_dev -= yt;
+            REQUIRE(global_max_norm(yt_dev) < 1.e-12);
+         }
+      }
+   }
+}
+
+#endif // MFEM_USE_MPI
+
 }// namespace pa_kernels
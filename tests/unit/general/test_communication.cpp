@@ -0,0 +1,139 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+#ifdef MFEM_USE_MPI
+
+namespace communication
+{
+
+// Groups of a ring of processors: the groups of two and three consecutive
+// ranks. The number of ldofs in each group depends only on its ranks.
+void ring_groups(GroupTopology &gt, Array<int> &ldof_group)
+{
+   int rank, P;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &P);
+
+   ListOfIntegerSets groups;
+   IntegerSet group;
+   group.Recreate(1, &rank);
+   groups.Insert(group);
+   if (P > 1)
+   {
+      int left[2] = { (rank+P-1) % P, rank };
+      int right[2] = { rank, (rank+1) % P };
+      group.Recreate(2, left);
+      groups.Insert(group);
+      group.Recreate(2, right);
+      groups.Insert(group);
+   }
+   for (int c = rank-1; c <= rank+1 && P > 2; c++)
+   {
+      int three[3] = { (c+P-1) % P, (c+P) % P, (c+1) % P };
+      group.Recreate(3, three);
+      groups.Insert(group);
+   }
+   gt.Create(groups, 822);
+
+   ldof_group.SetSize(0);
+   for (int g = 0; g < gt.NGroups(); g++)
+   {
+      int sum = 0;
+      for (int k = 0; k < gt.GetGroupSize(g); k++)
+      {
+         sum += 7*gt.GetNeighborRank(gt.GetGroup(g)[k]);
+      }
+      const int n = (g == 0) ? 3 : 1 + sum % 4;
+      for (int i = 0; i < n; i++) { ldof_group.Append(g); }
+   }
+}
+
+}
+
+using namespace communication;
+
+TEST_CASE("GroupCommunicator modes", "[Parallel], [GroupCommunicator]")
+{
+   int rank;
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   GroupTopology gt(MPI_COMM_WORLD);
+   Array<int> ldof_group;
+   ring_groups(gt, ldof_group);
+   const int n = ldof_group.Size();
+
+   GroupCommunicator ref(gt, GroupCommunicator::byGroup);
+   ref.Create(ldof_group);
+
+   const GroupCommunicator::Mode modes[] =
+   {
+      GroupCommunicator::byNeighbor,
+      GroupCommunicator::byNeighborPersistent,
+#if MPI_VERSION >= 3
+      GroupCommunicator::byNeighborCollective
+#endif
+   };
+   const int num_modes = sizeof(modes)/sizeof(modes[0]);
+
+   for (int m = 0; m < num_modes; m++)
+   {
+      for (int switch_mode = 0; switch_mode < 2; switch_mode++)
+      {
+         GroupCommunicator gc(gt, switch_mode ? ref.GetMode() : modes[m]);
+         gc.Create(ldof_group);
+         Array<double> x(n), y(n);
+         Array<int> xi(n), yi(n);
+         for (int it = 0; it < 3; it++)
+         {
+            // Switch the mode after the first use
+            if (switch_mode && it == 1) { gc.SetMode(modes[m]); }
+            REQUIRE(gc.GetMode() == (switch_mode && it == 0 ?
+                                     ref.GetMode() : modes[m]));
+
+            for (int i = 0; i < n; i++)
+            {
+               x[i] = y[i] = 100*rank + i + it;
+               xi[i] = yi[i] = 100*rank + i + it;
+            }
+            ref.Bcast(x);
+            gc.Bcast(y);
+            ref.Bcast(xi);
+            gc.Bcast(yi);
+            int err = 0;
+            for (int i = 0; i < n; i++)
+            {
+               err += (x[i] != y[i] || xi[i] != yi[i]);
+            }
+
+            ref.Reduce<double>(x, GroupCommunicator::Sum);
+            gc.Reduce<double>(y, GroupCommunicator::Sum);
+            ref.Reduce<int>(xi, GroupCommunicator::Max);
+            gc.Reduce<int>(yi, GroupCommunicator::Max);
+            for (int i = 0; i < n; i++)
+            {
+               err += (x[i] != y[i] || xi[i] != yi[i]);
+            }
+
+            int glob_err;
+            MPI_Allreduce(&err, &glob_err, 1, MPI_INT, MPI_SUM,
+                          MPI_COMM_WORLD);
+            REQUIRE(glob_err == 0);
+         }
+      }
+   }
+}
+
+#endif // MFEM_USE_MPI
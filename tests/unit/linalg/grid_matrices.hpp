@@ -0,0 +1,66 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_UNIT_TESTS_GRID_MATRICES
+#define MFEM_UNIT_TESTS_GRID_MATRICES
+
+#include "mfem.hpp"
+
+// Finite difference test matrices on structured grids, shared by the linear
+// algebra unit tests. The grid points are numbered lexicographically, x first.
+namespace grid_matrices
+{
+
+// Upwind finite difference convection-diffusion operator on an n x n x nz
+// grid: the 5-point (nz = 1) or 7-point Laplacian plus a first-order upwind
+// convection term with velocity (cx, cy) in the x-y plane
+inline mfem::SparseMatrix *ConvectionDiffusion(int n, double cx, double cy,
+                                               int nz = 1)
+{
+   mfem::SparseMatrix *A = new mfem::SparseMatrix(n*n*nz);
+   const double diag = (nz > 1) ? 6.0 : 4.0;
+   for (int k = 0; k < nz; k++)
+   {
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = 0; i < n; i++)
+         {
+            const int r = i + n*(j + n*k);
+            A->Add(r, r, diag + (cx + cy));
+            if (i > 0) { A->Add(r, r-1, -1.0 - cx); }
+            if (i < n-1) { A->Add(r, r+1, -1.0); }
+            if (j > 0) { A->Add(r, r-n, -1.0 - cy); }
+            if (j < n-1) { A->Add(r, r+n, -1.0); }
+            if (k > 0) { A->Add(r, r-n*n, -1.0); }
+            if (k < nz-1) { A->Add(r, r+n*n, -1.0); }
+         }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Upwind convection-diffusion operator on an n x n grid with velocity (c, c)
+inline mfem::SparseMatrix *ConvectionDiffusion(int n, double c)
+{
+   return ConvectionDiffusion(n, c, c);
+}
+
+// 5-point (nz = 1) or 7-point finite difference Laplacian on an n x n x nz
+// grid
+inline mfem::SparseMatrix *Laplacian(int n, int nz = 1)
+{
+   return ConvectionDiffusion(n, 0.0, 0.0, nz);
+}
+
+}
+
+#endif
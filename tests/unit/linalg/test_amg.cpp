@@ -0,0 +1,101 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+TEST_CASE("Smoothed Aggregation AMG", "[AMG]")
+{
+   const int n = 64, N = n*n;
+   SparseMatrix *A_ptr = Laplacian(n);
+   SparseMatrix &A = *A_ptr;
+
+   Vector b(N), x(N), r(N);
+   b.Randomize(1);
+
+   CGSolver cg;
+   cg.SetOperator(A);
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(1000);
+   cg.SetPrintLevel(-1);
+   x = 0.0;
+   cg.Mult(b, x);
+   const int cg_iter = cg.GetNumIterations();
+
+   SECTION("Hierarchy")
+   {
+      SmoothedAggregationAMG amg(A);
+      REQUIRE(amg.GetNumLevels() > 2);
+      REQUIRE(amg.GetOperatorComplexity() < 2.0);
+      for (int l = 0; l + 1 < amg.GetNumLevels(); l++)
+      {
+         const SparseMatrix &Pl = amg.GetProlongation(l);
+         REQUIRE(Pl.Height() == amg.GetLevelMatrix(l).Height());
+         REQUIRE(Pl.Width() == amg.GetLevelMatrix(l+1).Height());
+         REQUIRE(Pl.Width() < Pl.Height());
+      }
+      REQUIRE(amg.GetLevelMatrix(amg.GetNumLevels()-1).Height() <= 100);
+   }
+
+   SECTION("Preconditioned CG")
+   {
+      for (int smoother = 0; smoother <= 1; smoother++)
+      {
+         for (int cycle = 1; cycle <= 2; cycle++)
+         {
+            SmoothedAggregationAMG amg;
+            amg.SetSmoother(smoother ? SmoothedAggregationAMG::CHEBYSHEV :
+                            SmoothedAggregationAMG::JACOBI, smoother ? 2 : 1);
+            amg.SetCycleType(SmoothedAggregationAMG::CycleType(cycle));
+            amg.SetOperator(A);
+
+            CGSolver pcg;
+            pcg.SetOperator(A);
+            pcg.SetPreconditioner(amg);
+            pcg.SetRelTol(1e-10);
+            pcg.SetMaxIter(1000);
+            pcg.SetPrintLevel(-1);
+            x = 0.0;
+            pcg.Mult(b, x);
+
+            REQUIRE(pcg.GetConverged());
+            REQUIRE(pcg.GetNumIterations() < 30);
+            REQUIRE(4*pcg.GetNumIterations() < cg_iter);
+
+            A.Mult(x, r);
+            r -= b;
+            REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+         }
+      }
+   }
+
+   SECTION("Coarse solve")
+   {
+      // A small matrix is solved exactly on a single level
+      SparseMatrix *As = Laplacian(8);
+      SmoothedAggregationAMG amg(*As);
+      REQUIRE(amg.GetNumLevels() == 1);
+      Vector bs(As->Height()), xs(As->Height()), rs(As->Height());
+      bs.Randomize(2);
+      xs = 0.0;
+      amg.Mult(bs, xs);
+      As->Mult(xs, rs);
+      rs -= bs;
+      REQUIRE(rs.Norml2() < 1e-10 * bs.Norml2());
+      delete As;
+   }
+
+   delete A_ptr;
+}
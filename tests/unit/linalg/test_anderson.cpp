@@ -0,0 +1,158 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+// Iteration operator of the stationary iteration, G = I - B A
+class StationaryIterationOperator : public Operator
+{
+private:
+   const Operator &A, &B;
+   mutable Vector z;
+
+public:
+   StationaryIterationOperator(const Operator &A_, const Operator &B_)
+      : Operator(A_.Height()), A(A_), B(B_), z(A_.Height()) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      A.Mult(x, z);
+      B.Mult(z, y);
+      subtract(x, y, y);
+   }
+};
+
+// Picard iteration for A x + x^3 = b: G(x) solves (A + diag(x^2)) y = b
+class PicardOperator : public Operator
+{
+private:
+   const SparseMatrix &A;
+   const Vector &b;
+
+public:
+   PicardOperator(const SparseMatrix &A_, const Vector &b_)
+      : Operator(A_.Height()), A(A_), b(b_) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      SparseMatrix J(A);
+      for (int i = 0; i < height; i++) { J.Elem(i,i) += x(i)*x(i); }
+      CGSolver cg;
+      cg.SetOperator(J);
+      cg.SetRelTol(1e-14);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(-1);
+      y = 0.0;
+      cg.Mult(b, y);
+   }
+};
+
+TEST_CASE("Anderson acceleration", "[Anderson]")
+{
+   SECTION("Stationary iteration")
+   {
+      const int n = 16, N = n*n;
+      SparseMatrix *A = Laplacian(n);
+      DSmoother jacobi(*A);
+      Vector b(N), Bb(N), x(N), r(N);
+      b.Randomize(1);
+
+      SLISolver sli;
+      sli.SetOperator(*A);
+      sli.SetPreconditioner(jacobi);
+      sli.SetRelTol(1e-8);
+      sli.SetMaxIter(10000);
+      sli.SetPrintLevel(-1);
+      x = 0.0;
+      sli.Mult(b, x);
+      REQUIRE(sli.GetConverged());
+
+      StationaryIterationOperator G(*A, jacobi);
+      jacobi.Mult(b, Bb);
+      AndersonSolver anderson;
+      anderson.SetOperator(G);
+      anderson.SetHistoryDepth(10);
+      anderson.SetRelTol(1e-8);
+      anderson.SetMaxIter(10000);
+      anderson.SetPrintLevel(-1);
+      x = 0.0;
+      anderson.Mult(Bb, x);
+      REQUIRE(anderson.GetConverged());
+      REQUIRE(10*anderson.GetNumIterations() < sli.GetNumIterations());
+
+      A->Mult(x, r);
+      r -= b;
+      REQUIRE(r.Norml2() < 1e-6 * b.Norml2());
+
+      // Without history, this is the stationary iteration
+      anderson.SetHistoryDepth(0);
+      x = 0.0;
+      anderson.Mult(Bb, x);
+      REQUIRE(anderson.GetConverged());
+      REQUIRE(abs(anderson.GetNumIterations() - sli.GetNumIterations()) <= 1);
+
+      delete A;
+   }
+
+   SECTION("Picard iteration")
+   {
+      const int n = 8, N = n*n;
+      SparseMatrix *A = Laplacian(n);
+      Vector b(N), x(N), r(N), empty;
+      b.Randomize(1);
+      b *= 0.5;
+      PicardOperator G(*A, b);
+
+      // The plain Picard iteration oscillates, the damped one converges
+      AndersonSolver picard;
+      picard.SetOperator(G);
+      picard.SetHistoryDepth(0);
+      picard.SetRelTol(1e-10);
+      picard.SetMaxIter(100);
+      picard.SetPrintLevel(-1);
+      x = 0.0;
+      picard.Mult(empty, x);
+      REQUIRE(!picard.GetConverged());
+
+      picard.SetDamping(0.5);
+      x = 0.0;
+      picard.Mult(empty, x);
+      REQUIRE(picard.GetConverged());
+      const int picard_iter = picard.GetNumIterations();
+
+      for (int depth = 3; depth <= 6; depth += 3)
+      {
+         AndersonSolver anderson;
+         anderson.SetOperator(G);
+         anderson.SetHistoryDepth(depth);
+         anderson.SetRelTol(1e-10);
+         anderson.SetMaxIter(100);
+         anderson.SetPrintLevel(-1);
+         x = 0.0;
+         anderson.Mult(empty, x);
+         REQUIRE(anderson.GetConverged());
+         REQUIRE(3*anderson.GetNumIterations() < 2*picard_iter);
+
+         // Residual of the nonlinear system A x + x^3 = b
+         A->Mult(x, r);
+         for (int i = 0; i < N; i++) { r(i) += x(i)*x(i)*x(i); }
+         r -= b;
+         REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+      }
+
+      delete A;
+   }
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+namespace block_solvers
+{
+
+// Right-hand sides with a repeated column and a zero column
+void make_rhs(int n, int k, DenseMatrix &B)
+{
+   B.SetSize(n, k);
+   for (int c = 0; c < k; c++)
+   {
+      Vector b(B.GetColumn(c), n);
+      b.Randomize(c + 1);
+   }
+   B.SetCol(1, B.GetColumn(0));
+   B.SetCol(2, 0.0);
+}
+
+// Returns the maximum relative residual of the columns of X
+double max_residual(const SparseMatrix &A, const DenseMatrix &B,
+                    const DenseMatrix &X)
+{
+   DenseMatrix R;
+   A.Mult(X, R);
+   R -= B;
+   double res = 0.0;
+   for (int c = 0; c < B.Width(); c++)
+   {
+      Vector r(R.GetColumn(c), R.Height());
+      Vector b(const_cast<double*>(B.GetColumn(c)), B.Height());
+      res = std::max(res, r.Norml2() / std::max(b.Norml2(), 1.0));
+   }
+   return res;
+}
+
+TEST_CASE("Block CG", "[BlockSolvers]")
+{
+   const int n = 20, k = 6;
+   SparseMatrix *A = Laplacian(n);
+   DenseMatrix B, X;
+   make_rhs(n*n, k, B);
+
+   for (int use_prec = 0; use_prec <= 1; use_prec++)
+   {
+      DSmoother jacobi(*A);
+      BlockCGSolver bcg;
+      bcg.SetOperator(*A);
+      if (use_prec) { bcg.SetPreconditioner(jacobi); }
+      bcg.SetRelTol(1e-10);
+      bcg.SetMaxIter(500);
+      bcg.SetPrintLevel(-1);
+      X.SetSize(n*n, k);
+      X = 0.0;
+      bcg.Mult(B, X);
+      REQUIRE(bcg.GetConverged());
+      REQUIRE(max_residual(*A, B, X) < 1e-8);
+
+      // The shared search space needs fewer iterations than a single CG solve
+      Vector b(B.GetColumn(0), n*n), x(n*n);
+      x = 0.0;
+      CGSolver cg;
+      cg.SetOperator(*A);
+      if (use_prec) { cg.SetPreconditioner(jacobi); }
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(500);
+      cg.SetPrintLevel(-1);
+      cg.Mult(b, x);
+      REQUIRE(bcg.GetNumIterations() < cg.GetNumIterations());
+   }
+
+   // Single right-hand side through the Vector interface
+   BlockCGSolver bcg;
+   bcg.SetOperator(*A);
+   bcg.SetRelTol(1e-10);
+   bcg.SetMaxIter(500);
+   Vector b(B.GetColumn(3), n*n), x(n*n), r(n*n);
+   x = 0.0;
+   bcg.Mult(b, x);
+   A->Mult(x, r);
+   r -= b;
+   REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+
+   delete A;
+}
+
+TEST_CASE("Block GMRES", "[BlockSolvers]")
+{
+   const int n = 20, k = 6;
+   SparseMatrix *A = ConvectionDiffusion(n, 0.5, 0.0);
+   DenseMatrix B, X;
+   make_rhs(n*n, k, B);
+
+   for (int use_prec = 0; use_prec <= 1; use_prec++)
+   {
+      GSSmoother gs(*A);
+      BlockGMRESSolver bgmres;
+      bgmres.SetOperator(*A);
+      if (use_prec) { bgmres.SetPreconditioner(gs); }
+      bgmres.SetKDim(10);
+      bgmres.SetRelTol(1e-10);
+      bgmres.SetMaxIter(500);
+      bgmres.SetPrintLevel(-1);
+      X.SetSize(n*n, k);
+      X = 0.0;
+      bgmres.Mult(B, X);
+      REQUIRE(bgmres.GetConverged());
+      REQUIRE(max_residual(*A, B, X) < 1e-6);
+   }
+
+   delete A;
+}
+
+} // namespace block_solvers
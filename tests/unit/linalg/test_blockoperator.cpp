@@ -0,0 +1,292 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace block_operator
+{
+
+// Random sparse matrix with a few nonzeros per row
+SparseMatrix *random_matrix(int m, int n, int seed)
+{
+   SparseMatrix *A = new SparseMatrix(m, n);
+   Vector v(3*m);
+   v.Randomize(seed);
+   for (int i = 0; i < m; i++)
+   {
+      A->Add(i, i % n, 2.0 + v(3*i));
+      A->Add(i, int(v(3*i+1)*n) % n, v(3*i+2) - 0.5);
+   }
+   A->Finalize();
+   return A;
+}
+
+// Operator wrapper, which is not an AbstractSparseMatrix
+class WrappedOperator : public Operator
+{
+private:
+   const Operator &A;
+
+public:
+   WrappedOperator(const Operator &A_)
+      : Operator(A_.Height(), A_.Width()), A(A_) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const { A.Mult(x, y); }
+
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { A.MultTranspose(x, y); }
+};
+
+}
+
+using namespace block_operator;
+
+TEST_CASE("BlockVector views", "[BlockOperator]")
+{
+   Array<int> offsets(4);
+   offsets[0] = 0;
+   offsets[1] = 3;
+   offsets[2] = 3;
+   offsets[3] = 8;
+
+   Vector v(8);
+   v.Randomize(1);
+   BlockVector bv(v, offsets);
+   REQUIRE(bv.GetData() == v.GetData());
+   for (int i = 0; i < 3; i++)
+   {
+      REQUIRE(bv.GetBlock(i).Size() == offsets[i+1] - offsets[i]);
+      REQUIRE(bv.GetBlock(i).GetData() == v.GetData() + offsets[i]);
+   }
+   bv.GetBlock(2) = 1.0;
+   REQUIRE(v(7) == 1.0);
+
+   Vector w(5);
+   Array<int> offsets2(3);
+   offsets2[0] = 0;
+   offsets2[1] = 2;
+   offsets2[2] = 5;
+   bv.Update(w, offsets2);
+   REQUIRE(bv.BlockSize(1) == 3);
+   REQUIRE(bv.GetBlock(1).GetData() == w.GetData() + 2);
+}
+
+TEST_CASE("BlockOperator application", "[BlockOperator]")
+{
+   Array<int> row_offsets(4), col_offsets(3);
+   row_offsets[0] = 0;
+   row_offsets[1] = 20;
+   row_offsets[2] = 35;
+   row_offsets[3] = 40;
+   col_offsets[0] = 0;
+   col_offsets[1] = 12;
+   col_offsets[2] = 30;
+
+   // Block row 2 is zero, block (1,0) is not a sparse matrix
+   SparseMatrix *A00 = random_matrix(20, 12, 1);
+   SparseMatrix *A01 = random_matrix(20, 18, 2);
+   SparseMatrix *A10 = random_matrix(15, 12, 3);
+   SparseMatrix *A11 = random_matrix(15, 18, 4);
+   WrappedOperator W10(*A10);
+
+   BlockOperator B(row_offsets, col_offsets);
+   B.SetBlock(0, 0, A00);
+   B.SetBlock(0, 1, A01, -2.0);
+   B.SetBlock(1, 0, &W10, 0.5);
+   B.SetBlock(1, 1, A11);
+
+   Vector x(30), xt(40), y_ref(40), yt_ref(30), y(40), yt(30);
+   x.Randomize(5);
+   xt.Randomize(6);
+   BlockVector xb(x, col_offsets), xtb(xt, row_offsets);
+   BlockVector yb(y_ref, row_offsets), ytb(yt_ref, col_offsets);
+
+   y_ref = 0.0;
+   A00->AddMult(xb.GetBlock(0), yb.GetBlock(0));
+   A01->AddMult(xb.GetBlock(1), yb.GetBlock(0), -2.0);
+   A10->AddMult(xb.GetBlock(0), yb.GetBlock(1), 0.5);
+   A11->AddMult(xb.GetBlock(1), yb.GetBlock(1));
+
+   yt_ref = 0.0;
+   A00->AddMultTranspose(xtb.GetBlock(0), ytb.GetBlock(0));
+   A01->AddMultTranspose(xtb.GetBlock(0), ytb.GetBlock(1), -2.0);
+   A10->AddMultTranspose(xtb.GetBlock(1), ytb.GetBlock(0), 0.5);
+   A11->AddMultTranspose(xtb.GetBlock(1), ytb.GetBlock(1));
+
+   for (int concurrent = 0; concurrent < 2; concurrent++)
+   {
+      B.SetConcurrentBlocks(concurrent);
+      y = 1.0;
+      B.Mult(x, y);
+      y -= y_ref;
+      REQUIRE(y.Normlinf() < 1e-12);
+
+      yt = 1.0;
+      B.MultTranspose(xt, yt);
+      yt -= yt_ref;
+      REQUIRE(yt.Normlinf() < 1e-12);
+   }
+
+   // The result is valid on the host after writing the blocks of vectors that
+   // use the device
+   Vector x_dev(30), y_dev(40);
+   x_dev.UseDevice(true);
+   y_dev.UseDevice(true);
+   x_dev = x;
+   y_dev = 1.0;
+   B.Mult(x_dev, y_dev);
+   const double *h_y = y_dev.HostRead();
+   double err = 0.0;
+   for (int i = 0; i < 40; i++)
+   {
+      err = std::max(err, std::abs(h_y[i] - y_ref(i)));
+   }
+   REQUIRE(err < 1e-12);
+
+   delete A11;
+   delete A10;
+   delete A01;
+   delete A00;
+}
+
+TEST_CASE("Block preconditioners", "[BlockOperator]")
+{
+   const int nb = 5;
+   Array<int> offsets(nb+1);
+   offsets[0] = 0;
+   for (int i = 0; i < nb; i++) { offsets[i+1] = offsets[i] + 6 + 2*i; }
+   const int n = offsets[nb];
+
+   Array2D<SparseMatrix *> A(nb, nb);
+   for (int i = 0; i < nb; i++)
+   {
+      for (int j = 0; j < nb; j++)
+      {
+         A(i,j) = random_matrix(offsets[i+1] - offsets[i],
+                                offsets[j+1] - offsets[j], 1 + i + nb*j);
+      }
+   }
+   WrappedOperator W31(*A(3,1));
+
+   Vector x(n), y(n), y_seq(n), r(n);
+   x.Randomize(7);
+
+   SECTION("BlockDiagonalPreconditioner")
+   {
+      BlockDiagonalPreconditioner P(offsets);
+      for (int i = 0; i < nb; i += 2) { P.SetDiagonalBlock(i, A(i,i)); }
+
+      P.Mult(x, y_seq);
+      P.SetConcurrentBlocks();
+      P.Mult(x, y);
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+
+      P.SetConcurrentBlocks(false);
+      P.MultTranspose(x, y_seq);
+      P.SetConcurrentBlocks();
+      P.MultTranspose(x, y);
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+
+      // The result is valid on the host with vectors that use the device
+      Vector x_dev(n), y_dev(n);
+      x_dev.UseDevice(true);
+      y_dev.UseDevice(true);
+      x_dev = x;
+      P.Mult(x_dev, y_dev);
+      P.Mult(x, y_seq);
+      const double *h_y = y_dev.HostRead();
+      for (int i = 0; i < n; i++) { y(i) = h_y[i]; }
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+   }
+
+   SECTION("BlockLowerTriangularPreconditioner")
+   {
+      // The block rows {0, 2}, {1, 4} and {3} are independent in Mult; the
+      // block rows {3, 4}, {1, 2} and {0} are independent in MultTranspose
+      BlockLowerTriangularPreconditioner P(offsets);
+      P.SetBlock(1, 0, A(1,0));
+      P.SetBlock(3, 1, &W31);
+      P.SetBlock(3, 2, A(3,2));
+      P.SetBlock(4, 0, A(4,0));
+      for (int i = 0; i < nb; i += 2) { P.SetDiagonalBlock(i, A(i,i)); }
+
+      P.Mult(x, y_seq);
+      P.SetConcurrentBlocks();
+      P.Mult(x, y);
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+
+      P.SetConcurrentBlocks(false);
+      P.MultTranspose(x, y_seq);
+      P.SetConcurrentBlocks();
+      P.MultTranspose(x, y);
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+
+      // The result is valid on the host with vectors that use the device
+      Vector x_dev(n), y_dev(n);
+      x_dev.UseDevice(true);
+      y_dev.UseDevice(true);
+      x_dev = x;
+      P.Mult(x_dev, y_dev);
+      P.Mult(x, y_seq);
+      const double *h_y = y_dev.HostRead();
+      for (int i = 0; i < n; i++) { y(i) = h_y[i]; }
+      y -= y_seq;
+      REQUIRE(y.Normlinf() == 0.0);
+
+      // With identity diagonal blocks, the solutions satisfy L y = x and
+      // L^t y = x
+      BlockLowerTriangularPreconditioner Q(offsets);
+      Q.SetBlock(1, 0, A(1,0));
+      Q.SetBlock(3, 1, &W31);
+      Q.SetBlock(3, 2, A(3,2));
+      Q.SetBlock(4, 0, A(4,0));
+      BlockOperator L(offsets);
+      IdentityOperator *I[nb];
+      for (int i = 0; i < nb; i++)
+      {
+         I[i] = new IdentityOperator(offsets[i+1] - offsets[i]);
+         L.SetDiagonalBlock(i, I[i]);
+      }
+      L.SetBlock(1, 0, A(1,0));
+      L.SetBlock(3, 1, A(3,1));
+      L.SetBlock(3, 2, A(3,2));
+      L.SetBlock(4, 0, A(4,0));
+      for (int concurrent = 0; concurrent < 2; concurrent++)
+      {
+         Q.SetConcurrentBlocks(concurrent);
+         L.SetConcurrentBlocks(concurrent);
+
+         Q.Mult(x, y);
+         L.Mult(y, r);
+         r -= x;
+         REQUIRE(r.Normlinf() < 1e-12);
+
+         Q.MultTranspose(x, y);
+         L.MultTranspose(y, r);
+         r -= x;
+         REQUIRE(r.Normlinf() < 1e-12);
+      }
+      for (int i = 0; i < nb; i++) { delete I[i]; }
+   }
+
+   for (int i = 0; i < nb; i++)
+   {
+      for (int j = 0; j < nb; j++) { delete A(i,j); }
+   }
+}
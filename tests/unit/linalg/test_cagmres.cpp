@@ -0,0 +1,94 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+TEST_CASE("CA-GMRES", "[CAGMRES]")
+{
+   const int n = 30, N = n*n;
+   SparseMatrix *A_ptr = ConvectionDiffusion(n, 1.0, 0.0);
+   SparseMatrix &A = *A_ptr;
+   // Vary the diagonal in the x direction
+   for (int r = 0; r < N; r++) { A.Add(r, r, 0.1*((r % n) % 7)); }
+
+   Vector b(N), x0(N), x1(N), r(N);
+   b.Randomize(1);
+
+   DSmoother jacobi(A);
+
+   Vector shifts(4);
+   shifts(0) = 1.5; shifts(1) = 0.5; shifts(2) = 1.0; shifts(3) = 0.25;
+
+   for (int use_prec = 0; use_prec <= 1; use_prec++)
+   {
+      GMRESSolver gmres;
+      gmres.SetOperator(A);
+      if (use_prec) { gmres.SetPreconditioner(jacobi); }
+      gmres.SetKDim(10);
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(1000);
+      gmres.SetPrintLevel(-1);
+      x0 = 0.0;
+      gmres.Mult(b, x0);
+      REQUIRE(gmres.GetConverged());
+
+      // Step sizes dividing the restart length
+      const int steps[4] = { 1, 2, 5, 10 };
+      for (int s : steps)
+      {
+         for (int newton = 0; newton <= 1; newton++)
+         {
+            CAGMRESSolver cagmres;
+            cagmres.SetOperator(A);
+            if (use_prec) { cagmres.SetPreconditioner(jacobi); }
+            if (newton) { cagmres.SetShifts(shifts); }
+            cagmres.SetKDim(10);
+            cagmres.SetStepSize(s);
+            cagmres.SetRelTol(1e-10);
+            cagmres.SetMaxIter(1000);
+            cagmres.SetPrintLevel(-1);
+            x1 = 0.0;
+            cagmres.Mult(b, x1);
+
+            REQUIRE(cagmres.GetConverged());
+            REQUIRE(cagmres.GetNumIterations() <=
+                    gmres.GetNumIterations() + 2);
+
+            A.Mult(x1, r);
+            r -= b;
+            REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+         }
+      }
+   }
+
+   SECTION("Invariant subspace")
+   {
+      // The first block breaks down with the identity operator
+      IdentityOperator I(N);
+      CAGMRESSolver cagmres;
+      cagmres.SetOperator(I);
+      cagmres.SetRelTol(1e-12);
+      cagmres.SetPrintLevel(-1);
+      x1 = 0.0;
+      cagmres.Mult(b, x1);
+      REQUIRE(cagmres.GetConverged());
+      REQUIRE(cagmres.GetNumIterations() == 1);
+      x1 -= b;
+      REQUIRE(x1.Norml2() < 1e-12 * b.Norml2());
+   }
+
+   delete A_ptr;
+}
@@ -245,3 +245,88 @@ TEST_CASE("LUFactors RightSolve", "[DenseMatrix]")
 
    REQUIRE(C.MaxMaxNorm() < tol);
 }
+
+TEST_CASE("Batched dense linear algebra", "[DenseMatrix]")
+{
+   const double tol = 1e-10;
+   const int nk = 7;
+
+   for (int m = 1; m <= 6; m++)
+   {
+      // Diagonally dominant matrices, except for the zero diagonal entry of
+      // the first one which forces pivoting
+      DenseTensor A(m, m, nk);
+      for (int k = 0; k < nk; k++)
+      {
+         Vector a(A.GetData(k), m*m);
+         a.Randomize(k + 1);
+         for (int i = 0; i < m; i++) { A(i,i,k) += m; }
+         if (m > 1 && k == 0) { A(0,0,k) = 0.0; }
+      }
+
+      SECTION("Determinant and inverse, m = " + std::to_string(m))
+      {
+         Vector det;
+         BatchDet(A, det);
+         DenseTensor Ainv;
+         BatchInverse(A, Ainv);
+         DenseTensor AAinv;
+         BatchMult(A, Ainv, AAinv);
+         for (int k = 0; k < nk; k++)
+         {
+            REQUIRE(fabs(det(k) - A(k).Det()) < tol*fabs(det(k)));
+            DenseMatrix I(AAinv(k));
+            for (int i = 0; i < m; i++) { I(i,i) -= 1.0; }
+            REQUIRE(I.MaxMaxNorm() < tol);
+         }
+
+         // In place inverse
+         DenseTensor B(A);
+         BatchInverse(B, B);
+         for (int k = 0; k < nk; k++)
+         {
+            DenseMatrix D(B(k));
+            D -= Ainv(k);
+            REQUIRE(D.MaxMaxNorm() < tol);
+         }
+      }
+
+      SECTION("LU solve and products, m = " + std::to_string(m))
+      {
+         const int n = 2;
+         Vector x(m*n*nk), b, y(m*n*nk);
+         x.Randomize(1);
+         BatchMult(A, x, b);
+
+         DenseTensor LU(A);
+         Array<int> P;
+         REQUIRE(BatchLUFactor(LU, P));
+         y = b;
+         BatchLUSolve(LU, P, y);
+         y -= x;
+         REQUIRE(y.Normlinf() < tol);
+
+         DenseTensor C(A), C2;
+         BatchAddMult_a(2.0, A, A, C);
+         BatchMult(A, A, C2);
+         for (int k = 0; k < nk; k++)
+         {
+            DenseMatrix D(m), AA(m);
+            Mult(A(k), A(k), AA);
+            Add(A(k), AA, 2.0, D);
+            D -= C(k);
+            REQUIRE(D.MaxMaxNorm() < tol);
+            AA -= C2(k);
+            REQUIRE(AA.MaxMaxNorm() < tol);
+         }
+      }
+   }
+
+   SECTION("Singular matrix")
+   {
+      DenseTensor A(3, 3, 2);
+      A = 1.0;
+      Array<int> P;
+      REQUIRE(!BatchLUFactor(A, P));
+   }
+}
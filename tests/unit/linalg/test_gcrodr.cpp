@@ -0,0 +1,153 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+static double RelativeResidual(const SparseMatrix &A, const Vector &b,
+                               const Vector &x)
+{
+   Vector r(b.Size());
+   A.Mult(x, r);
+   r -= b;
+   return r.Norml2()/b.Norml2();
+}
+
+TEST_CASE("GCRO-DR", "[GCRODR]")
+{
+   const int n = 32, N = n*n;
+   Vector b(N), x(N);
+
+   SECTION("Multiple right-hand sides")
+   {
+      SparseMatrix *A = ConvectionDiffusion(n, 0.5);
+      GCRODRSolver gcrodr;
+      gcrodr.SetOperator(*A);
+      gcrodr.SetKDim(30);
+      gcrodr.SetRecycleDim(10);
+      gcrodr.SetRelTol(1e-10);
+      gcrodr.SetMaxIter(2000);
+      gcrodr.SetPrintLevel(-1);
+      gcrodr.iterative_mode = false;
+
+      GMRESSolver gmres;
+      gmres.SetOperator(*A);
+      gmres.SetKDim(30);
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(2000);
+      gmres.SetPrintLevel(-1);
+      gmres.iterative_mode = false;
+
+      for (int s = 1; s <= 4; s++)
+      {
+         b.Randomize(s);
+         gmres.Mult(b, x);
+         REQUIRE(gmres.GetConverged());
+         const int gmres_iter = gmres.GetNumIterations();
+
+         gcrodr.Mult(b, x);
+         REQUIRE(gcrodr.GetConverged());
+         REQUIRE(gcrodr.GetRecycleDim() == 10);
+         REQUIRE(RelativeResidual(*A, b, x) < 1e-9);
+         // Deflation within the first solve and recycling in the next ones
+         if (s == 1) { REQUIRE(gcrodr.GetNumIterations() < gmres_iter); }
+         else { REQUIRE(3*gcrodr.GetNumIterations() < 2*gmres_iter); }
+      }
+
+      gcrodr.ClearRecycleSpace();
+      REQUIRE(gcrodr.GetRecycleDim() == 0);
+      delete A;
+   }
+
+   SECTION("Sequence of operators")
+   {
+      // Slowly varying convection and right-hand side, with a preconditioner
+      // which is updated with the operator
+      GCRODRSolver gcrodr;
+      gcrodr.SetKDim(20);
+      gcrodr.SetRecycleDim(8);
+      gcrodr.SetRelTol(1e-10);
+      gcrodr.SetMaxIter(2000);
+      gcrodr.SetPrintLevel(-1);
+      DSmoother M_gcrodr;
+      gcrodr.SetPreconditioner(M_gcrodr);
+
+      GMRESSolver gmres;
+      gmres.SetKDim(20);
+      gmres.SetRelTol(1e-10);
+      gmres.SetMaxIter(2000);
+      gmres.SetPrintLevel(-1);
+      DSmoother M_gmres;
+      gmres.SetPreconditioner(M_gmres);
+
+      int gcrodr_iter = 0, gmres_iter = 0;
+      Vector y(N);
+      for (int s = 0; s < 5; s++)
+      {
+         SparseMatrix *A = ConvectionDiffusion(n, 1.0 + 0.02*s);
+         b.Randomize(1);
+         b *= 1.0 + 0.1*s;
+
+         gmres.SetOperator(*A);
+         y = 0.0;
+         gmres.Mult(b, y);
+         REQUIRE(gmres.GetConverged());
+
+         gcrodr.SetOperator(*A);
+         x = 0.0;
+         gcrodr.Mult(b, x);
+         REQUIRE(gcrodr.GetConverged());
+         REQUIRE(RelativeResidual(*A, b, x) < 1e-9);
+
+         if (s > 0)
+         {
+            gmres_iter += gmres.GetNumIterations();
+            gcrodr_iter += gcrodr.GetNumIterations();
+         }
+         delete A;
+      }
+      REQUIRE(2*gcrodr_iter < gmres_iter);
+   }
+
+   SECTION("Operator of a different size")
+   {
+      SparseMatrix *A = ConvectionDiffusion(n, 0.5);
+      SparseMatrix *A2 = ConvectionDiffusion(n/2, 0.5);
+      GCRODRSolver gcrodr;
+      gcrodr.SetKDim(20);
+      gcrodr.SetRecycleDim(5);
+      gcrodr.SetRelTol(1e-10);
+      gcrodr.SetMaxIter(2000);
+      gcrodr.SetPrintLevel(-1);
+
+      gcrodr.SetOperator(*A);
+      b.Randomize(1);
+      x = 0.0;
+      gcrodr.Mult(b, x);
+      REQUIRE(gcrodr.GetRecycleDim() == 5);
+
+      gcrodr.SetOperator(*A2);
+      REQUIRE(gcrodr.GetRecycleDim() == 0);
+      Vector b2(N/4), x2(N/4);
+      b2.Randomize(2);
+      x2 = 0.0;
+      gcrodr.Mult(b2, x2);
+      REQUIRE(gcrodr.GetConverged());
+      REQUIRE(RelativeResidual(*A2, b2, x2) < 1e-9);
+
+      delete A2;
+      delete A;
+   }
+}
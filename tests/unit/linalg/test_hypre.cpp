@@ -0,0 +1,177 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+#ifdef MFEM_USE_MPI
+
+namespace hypre_matrix
+{
+
+// Maximum difference of the actions of A and B on a random vector
+double action_difference(const HypreParMatrix &A, const HypreParMatrix &B)
+{
+   Vector x(A.Width()), y(A.Height()), z(B.Height());
+   x.Randomize(1);
+   A.Mult(x, y);
+   B.Mult(x, z);
+   y -= z;
+   double loc_err = y.Normlinf(), err;
+   MPI_Allreduce(&loc_err, &err, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+   return err;
+}
+
+// Serial mesh of the unit square, nonconforming if requested
+Mesh *square_mesh(bool nc)
+{
+   Mesh *mesh = new Mesh(4, 4, Element::QUADRILATERAL, true, 1.0, 1.0);
+   if (nc)
+   {
+      mesh->EnsureNCMesh();
+      Array<int> refs(1);
+      refs[0] = 0;
+      mesh->GeneralRefinement(refs);
+   }
+   return mesh;
+}
+
+}
+
+using namespace hypre_matrix;
+
+TEST_CASE("HypreRAPPlan", "[Parallel], [HypreRAPPlan]")
+{
+   for (int nc = 0; nc < 2; nc++)
+   {
+      Mesh *mesh = square_mesh(nc);
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+      H1_FECollection fec(2, 2);
+      ParFiniteElementSpace fes(&pmesh, &fec);
+      HypreParMatrix *P = fes.Dof_TrueDof_Matrix();
+
+      SECTION("Product")
+      {
+         ParBilinearForm a(&fes);
+         a.AddDomainIntegrator(new DiffusionIntegrator);
+         a.AddDomainIntegrator(new MassIntegrator);
+         a.Assemble();
+         a.Finalize();
+         SparseMatrix &A_local = a.SpMat();
+
+         HypreRAPPlan plan(A_local, *P);
+         HypreParMatrix *C = plan.CreateMatrix();
+         for (int it = 0; it < 2; it++)
+         {
+            A_local *= 1.0 + it;
+            plan.Mult(A_local, *C);
+
+            // The block-diagonal matrix reorders the columns of its diagonal
+            SparseMatrix A_copy(A_local);
+            HypreParMatrix dA(MPI_COMM_WORLD, fes.GlobalVSize(),
+                              fes.GetDofOffsets(), &A_copy);
+            HypreParMatrix *ref = RAP(&dA, P);
+            REQUIRE(action_difference(*C, *ref) < 1e-12);
+            delete ref;
+         }
+         delete C;
+      }
+
+      SECTION("KeepRAPPlan")
+      {
+         ConstantCoefficient coeff(1.0);
+         ParBilinearForm a(&fes);
+         a.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a.AddDomainIntegrator(new MassIntegrator);
+         a.KeepRAPPlan();
+
+         Array<int> ess_bdr(pmesh.bdr_attributes.Max()), ess_tdof_list;
+         ess_bdr = 1;
+         fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+         OperatorHandle A(Operator::Hypre_ParCSR), B(Operator::Hypre_ParCSR);
+         const Operator *A_first = NULL;
+         for (int it = 0; it < 3; it++)
+         {
+            coeff.constant = 1.0 + it;
+            a.Assemble();
+            a.FormSystemMatrix(ess_tdof_list, A);
+            // The values of the matrix are recomputed in place
+            if (it == 0) { A_first = A.Ptr(); }
+            REQUIRE(A.Ptr() == A_first);
+
+            ParBilinearForm b(&fes);
+            b.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+            b.AddDomainIntegrator(new MassIntegrator);
+            b.Assemble();
+            b.FormSystemMatrix(ess_tdof_list, B);
+            REQUIRE(action_difference(*A.As<HypreParMatrix>(),
+                                      *B.As<HypreParMatrix>()) < 1e-12);
+         }
+      }
+   }
+}
+
+TEST_CASE("HypreParMatrix multi-vector products",
+          "[Parallel], [HypreParMatrix]")
+{
+   for (int nc = 0; nc < 2; nc++)
+   {
+      Mesh *mesh = square_mesh(nc);
+      ParMesh pmesh(MPI_COMM_WORLD, *mesh);
+      delete mesh;
+      H1_FECollection fec(2, 2);
+      ParFiniteElementSpace fes(&pmesh, &fec);
+      // A rectangular matrix with off-processor entries
+      HypreParMatrix &P = *fes.Dof_TrueDof_Matrix();
+
+      // More vectors than processed together by the local kernels
+      const int k = 19;
+      DenseMatrix X(P.Width(), k), Xt(P.Height(), k), Y, Yt;
+      Vector(X.GetData(), X.Height()*k).Randomize(1);
+      Vector(Xt.GetData(), Xt.Height()*k).Randomize(2);
+
+      P.Mult(X, Y);
+      P.MultTranspose(Xt, Yt);
+      REQUIRE(Y.Height() == P.Height());
+      REQUIRE(Yt.Height() == P.Width());
+
+      DenseMatrix Y2(Y), Yt2(Yt);
+      P.Mult(2.0, X, -1.0, Y2);
+      P.MultTranspose(2.0, Xt, -1.0, Yt2);
+
+      double loc_err = 0.0;
+      Vector y(P.Height()), yt(P.Width());
+      for (int j = 0; j < k; j++)
+      {
+         Vector x(X.GetColumn(j), P.Width()), xt(Xt.GetColumn(j), P.Height());
+         P.Mult(x, y);
+         P.MultTranspose(xt, yt);
+         for (int i = 0; i < P.Height(); i++)
+         {
+            loc_err = std::max(loc_err, std::abs(Y(i,j) - y(i)));
+            loc_err = std::max(loc_err, std::abs(Y2(i,j) - y(i)));
+         }
+         for (int i = 0; i < P.Width(); i++)
+         {
+            loc_err = std::max(loc_err, std::abs(Yt(i,j) - yt(i)));
+            loc_err = std::max(loc_err, std::abs(Yt2(i,j) - yt(i)));
+         }
+      }
+      double err;
+      MPI_Allreduce(&loc_err, &err, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      REQUIRE(err < 1e-12);
+   }
+}
+
+#endif // MFEM_USE_MPI
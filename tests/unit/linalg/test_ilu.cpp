@@ -11,8 +11,10 @@
 
 #include "catch.hpp"
 #include "mfem.hpp"
+#include "grid_matrices.hpp"
 
 using namespace mfem;
+using namespace grid_matrices;
 
 TEST_CASE("ILU Structure", "[ILU]")
 {
@@ -169,3 +171,137 @@ TEST_CASE("ILU Factorization", "[ILU]")
    REQUIRE(AB(0,1,6) == Approx(-13.0/9.0));
    REQUIRE(AB(1,1,6) == Approx(-2.0));
 }
+
+static int GMRESIterations(const SparseMatrix &A, Solver *prec,
+                           const Vector &b)
+{
+   GMRESSolver gmres;
+   gmres.SetOperator(A);
+   if (prec) { gmres.SetPreconditioner(*prec); }
+   gmres.SetRelTol(1e-10);
+   gmres.SetMaxIter(1000);
+   gmres.SetKDim(50);
+   gmres.SetPrintLevel(-1);
+   Vector x(b.Size());
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   return gmres.GetNumIterations();
+}
+
+TEST_CASE("Level Scheduled ILU", "[ILU]")
+{
+   const int n = 20, N = n*n;
+   SparseMatrix *A = ConvectionDiffusion(n, 5.0);
+   Vector b(N), x(N), y(N);
+   b.Randomize(1);
+
+   SECTION("Levels")
+   {
+      // The wavefronts of the lexicographic ordering are the antidiagonals
+      LevelScheduledILU ilu(*A);
+      REQUIRE(ilu.GetNumLowerLevels() == 2*n - 1);
+      REQUIRE(ilu.GetNumUpperLevels() == 2*n - 1);
+      REQUIRE(ilu.NumNonZeroElems() == A->NumNonZeroElems() + N);
+
+      // Same factorization as the block ILU(0) with blocks of size 1
+      BlockILU block_ilu(*A, 1, BlockILU::Reordering::NONE);
+      ilu.Mult(b, x);
+      block_ilu.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-12 * x.Normlinf());
+   }
+
+   SECTION("ILU(k)")
+   {
+      const int it_none = GMRESIterations(*A, NULL, b);
+      LevelScheduledILU ilu0(*A, 0);
+      LevelScheduledILU ilu1(*A, 1);
+      LevelScheduledILU ilu1_rcm(*A, 1, LevelScheduledILU::Type::ILU, true);
+      const int it0 = GMRESIterations(*A, &ilu0, b);
+      const int it1 = GMRESIterations(*A, &ilu1, b);
+      const int it1_rcm = GMRESIterations(*A, &ilu1_rcm, b);
+      REQUIRE(it0 < it_none);
+      REQUIRE(it1 <= it0);
+      REQUIRE(it1_rcm <= it0);
+      REQUIRE(ilu1.NumNonZeroElems() > ilu0.NumNonZeroElems());
+
+      const Array<int> &p = ilu1_rcm.GetPermutation();
+      REQUIRE(p.Size() == N);
+      Array<int> count(N);
+      count = 0;
+      for (int i = 0; i < N; i++) { count[p[i]]++; }
+      REQUIRE(count.Min() == 1);
+      REQUIRE(count.Max() == 1);
+   }
+
+   SECTION("Complete factorization")
+   {
+      // With enough fill, the factorization is exact
+      for (int reorder = 0; reorder <= 1; reorder++)
+      {
+         LevelScheduledILU lu(*A, N, LevelScheduledILU::Type::ILU, reorder);
+         lu.Mult(b, x);
+         A->Mult(x, y);
+         y -= b;
+         REQUIRE(y.Normlinf() < 1e-10 * b.Normlinf());
+      }
+   }
+
+   SECTION("IC(k)")
+   {
+      SparseMatrix *L = ConvectionDiffusion(n, 0.0);
+
+      CGSolver cg;
+      cg.SetOperator(*L);
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(-1);
+
+      DSmoother jacobi(*L);
+      cg.SetPreconditioner(jacobi);
+      x = 0.0;
+      cg.Mult(b, x);
+      const int it_jacobi = cg.GetNumIterations();
+
+      for (int reorder = 0; reorder <= 1; reorder++)
+      {
+         LevelScheduledILU ic(*L, 0, LevelScheduledILU::Type::IC, reorder);
+         cg.SetPreconditioner(ic);
+         x = 0.0;
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         REQUIRE(cg.GetNumIterations() < it_jacobi);
+      }
+
+      LevelScheduledILU chol(*L, N, LevelScheduledILU::Type::IC);
+      chol.Mult(b, x);
+      L->Mult(x, y);
+      y -= b;
+      REQUIRE(y.Normlinf() < 1e-10 * b.Normlinf());
+
+      delete L;
+   }
+
+   SECTION("Block ILU with RCM")
+   {
+      BlockILU block_ilu(*A, 2, BlockILU::Reordering::REVERSE_CUTHILL_MCKEE);
+      BlockILU block_ilu_none(*A, 2, BlockILU::Reordering::NONE);
+      const int it_rcm = GMRESIterations(*A, &block_ilu, b);
+      const int it_none = GMRESIterations(*A, &block_ilu_none, b);
+      REQUIRE(it_rcm < GMRESIterations(*A, NULL, b));
+      REQUIRE(it_rcm <= it_none + 5);
+   }
+
+   SECTION("Block ILU with fill-reducing orderings")
+   {
+      BlockILU block_ilu_amd(
+         *A, 2, BlockILU::Reordering::APPROXIMATE_MINIMUM_DEGREE);
+      BlockILU block_ilu_nd(*A, 2, BlockILU::Reordering::NESTED_DISSECTION);
+      const int it_gmres = GMRESIterations(*A, NULL, b);
+      REQUIRE(GMRESIterations(*A, &block_ilu_amd, b) < it_gmres);
+      REQUIRE(GMRESIterations(*A, &block_ilu_nd, b) < it_gmres);
+   }
+
+   delete A;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+TEST_CASE("Mixed precision", "[MixedPrecision]")
+{
+   const int n = 32, N = n*n;
+   SparseMatrix *A = ConvectionDiffusion(n, 2.0);
+   Vector b(N), x(N), y(N);
+   b.Randomize(1);
+
+   SECTION("FloatSparseMatrix")
+   {
+      FloatSparseMatrix Af(*A);
+      REQUIRE(Af.NumNonZeroElems() == A->NumNonZeroElems());
+
+      A->Mult(b, x);
+      Af.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-6 * x.Normlinf());
+
+      // The output is overwritten, whatever its initial values
+      A->MultTranspose(b, x);
+      for (int k = 0; k < 2; k++)
+      {
+         y = 1.0;
+         Af.MultTranspose(b, y);
+         y -= x;
+         REQUIRE(y.Normlinf() < 1e-6 * x.Normlinf());
+      }
+
+      x = 1.0;
+      y = 1.0;
+      A->AddMult(b, x, -0.5);
+      Af.AddMult(b, y, -0.5);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-6 * x.Normlinf());
+
+      Vector d, df;
+      A->GetDiag(d);
+      Af.GetDiag(df);
+      df -= d;
+      REQUIRE(df.Normlinf() < 1e-6 * d.Normlinf());
+   }
+
+   SECTION("Iterative refinement")
+   {
+      MixedPrecisionRefinementSolver mp;
+      mp.SetInnerRelTol(1e-3);
+      mp.SetRelTol(1e-12);
+      mp.SetMaxIter(20);
+      mp.SetPrintLevel(-1);
+      mp.SetOperator(*A);
+      x = 0.0;
+      mp.Mult(b, x);
+      REQUIRE(mp.GetConverged());
+
+      A->Mult(x, y);
+      y -= b;
+      REQUIRE(y.Norml2() <= 1e-12 * b.Norml2());
+   }
+
+   SECTION("Iterative refinement with CG")
+   {
+      // Without convection the matrix is symmetric positive definite
+      SparseMatrix *L = ConvectionDiffusion(n, 0.0);
+      MixedPrecisionRefinementSolver mp;
+      mp.SetInnerSolverType(MixedPrecisionRefinementSolver::CG);
+      mp.SetRelTol(1e-12);
+      mp.SetMaxIter(20);
+      mp.SetPrintLevel(-1);
+      mp.SetOperator(*L);
+      x = 0.0;
+      mp.Mult(b, x);
+      REQUIRE(mp.GetConverged());
+
+      L->Mult(x, y);
+      y -= b;
+      REQUIRE(y.Norml2() <= 1e-12 * b.Norml2());
+      delete L;
+   }
+
+   SECTION("User inner solver")
+   {
+      FloatSparseMatrix Af(*A);
+      FloatDSmoother Mf(Af);
+      GMRESSolver gmres;
+      gmres.SetOperator(Af);
+      gmres.SetPreconditioner(Mf);
+      gmres.SetRelTol(1e-4);
+      gmres.SetMaxIter(100);
+      gmres.SetPrintLevel(-1);
+      gmres.iterative_mode = false;
+
+      MixedPrecisionRefinementSolver mp;
+      mp.SetInnerSolver(gmres);
+      mp.SetOperator(*A);
+      mp.SetRelTol(1e-12);
+      mp.SetMaxIter(20);
+      mp.SetPrintLevel(-1);
+      x = 0.0;
+      mp.Mult(b, x);
+      REQUIRE(mp.GetConverged());
+      // Each refinement step reduces the residual by about the inner tolerance
+      REQUIRE(mp.GetNumIterations() <= 5);
+
+      A->Mult(x, y);
+      y -= b;
+      REQUIRE(y.Norml2() <= 1e-12 * b.Norml2());
+   }
+
+   delete A;
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+// F(x) = A x + x^3, with the cube taken entrywise
+class CubicOperator : public Operator
+{
+private:
+   const SparseMatrix &A;
+   mutable SparseMatrix *J;
+
+public:
+   mutable int num_grad;
+
+   CubicOperator(const SparseMatrix &A_)
+      : Operator(A_.Height()), A(A_), J(NULL), num_grad(0) { }
+
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      A.Mult(x, y);
+      for (int i = 0; i < height; i++) { y(i) += x(i)*x(i)*x(i); }
+   }
+
+   virtual Operator &GetGradient(const Vector &x) const
+   {
+      delete J;
+      J = new SparseMatrix(A);
+      for (int i = 0; i < height; i++) { J->Elem(i,i) += 3.0*x(i)*x(i); }
+      num_grad++;
+      return *J;
+   }
+
+   virtual ~CubicOperator() { delete J; }
+};
+
+// CG solver which counts the iterations of all its solves
+class CountingCGSolver : public CGSolver
+{
+public:
+   mutable int total_iter;
+
+   CountingCGSolver() : total_iter(0) { }
+
+   virtual void Mult(const Vector &b, Vector &x) const
+   {
+      CGSolver::Mult(b, x);
+      total_iter += GetNumIterations();
+   }
+};
+
+// Newton solver with a fixed damping of the steps
+class DampedNewtonSolver : public NewtonSolver
+{
+public:
+   virtual double ComputeScalingFactor(const Vector &x, const Vector &b) const
+   { return 0.8; }
+};
+
+TEST_CASE("Newton solver", "[Newton]")
+{
+   const int n = 16, N = n*n;
+   SparseMatrix *A = Laplacian(n);
+   CubicOperator F(*A);
+   Vector b(N), x(N), r(N);
+   b.Randomize(1);
+   b *= 20.0;
+
+   CountingCGSolver cg;
+   cg.SetRelTol(1e-12);
+   cg.SetMaxIter(500);
+   cg.SetPrintLevel(-1);
+
+   NewtonSolver newton;
+   newton.SetSolver(cg);
+   newton.SetOperator(F);
+   newton.SetRelTol(1e-10);
+   newton.SetMaxIter(50);
+   newton.SetPrintLevel(-1);
+
+   x = 0.0;
+   newton.Mult(b, x);
+   REQUIRE(newton.GetConverged());
+   const int newton_iter = newton.GetNumIterations();
+   const int cg_iter = cg.total_iter;
+   REQUIRE(newton.GetNumGradientSetups() == newton_iter);
+   REQUIRE(F.num_grad == newton_iter);
+
+   SECTION("Eisenstat-Walker forcing terms")
+   {
+      for (int type = 1; type <= 2; type++)
+      {
+         cg.total_iter = 0;
+         newton.SetAdaptiveLinRtol(type, 0.1, 0.9);
+         x = 0.0;
+         newton.Mult(b, x);
+         REQUIRE(newton.GetConverged());
+         F.Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() <= 1e-10 * b.Norml2());
+         // The early, inaccurate Newton steps need fewer linear iterations
+         REQUIRE(cg.total_iter < cg_iter);
+         REQUIRE(cg.GetRelTol() == 1e-12);
+      }
+
+      // Damped steps, where the linear model is not the one of the linear
+      // solver
+      DampedNewtonSolver damped;
+      damped.SetSolver(cg);
+      damped.SetOperator(F);
+      damped.SetRelTol(1e-10);
+      damped.SetMaxIter(200);
+      damped.SetPrintLevel(-1);
+      damped.SetAdaptiveLinRtol(1, 0.1, 0.9);
+      x = 0.0;
+      damped.Mult(b, x);
+      REQUIRE(damped.GetConverged());
+      F.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Norml2() <= 1e-10 * b.Norml2());
+      REQUIRE(cg.GetRelTol() == 1e-12);
+   }
+
+   SECTION("Gradient reuse")
+   {
+      newton.SetGradientReuse(3, 0.5);
+      newton.SetOperator(F);
+      const int setups0 = newton.GetNumGradientSetups();
+      const int grad0 = F.num_grad;
+      x = 0.0;
+      newton.Mult(b, x);
+      REQUIRE(newton.GetConverged());
+      F.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Norml2() <= 1e-10 * b.Norml2());
+
+      const int setups = newton.GetNumGradientSetups() - setups0;
+      REQUIRE(setups == F.num_grad - grad0);
+      REQUIRE(setups < newton.GetNumIterations());
+      REQUIRE(setups + newton.GetNumGradientReuses() ==
+              newton.GetNumIterations());
+
+      // The next solve, for a nearby right-hand side, mostly reuses gradients
+      const int grad1 = F.num_grad;
+      const int reuses1 = newton.GetNumGradientReuses();
+      b *= 1.01;
+      newton.Mult(b, x);
+      REQUIRE(newton.GetConverged());
+      REQUIRE(F.num_grad - grad1 <= 1);
+      REQUIRE(newton.GetNumGradientReuses() > reuses1);
+   }
+
+   SECTION("Jacobian-free Newton-Krylov")
+   {
+      GMRESSolver gmres;
+      gmres.SetRelTol(1e-8);
+      gmres.SetMaxIter(500);
+      gmres.SetKDim(100);
+      gmres.SetPrintLevel(-1);
+
+      NewtonSolver jfnk;
+      jfnk.SetSolver(gmres);
+      jfnk.SetOperator(F);
+      jfnk.SetJacobianFree();
+      jfnk.SetRelTol(1e-10);
+      jfnk.SetMaxIter(50);
+      jfnk.SetPrintLevel(-1);
+
+      // No gradient is formed without preconditioner
+      const int grad0 = F.num_grad;
+      x = 0.0;
+      jfnk.Mult(b, x);
+      REQUIRE(jfnk.GetConverged());
+      REQUIRE(F.num_grad == grad0);
+      F.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Norml2() <= 1e-10 * b.Norml2());
+      const int jfnk_iter = jfnk.GetNumIterations();
+
+      // Jacobi preconditioner from lagged gradients
+      DSmoother jacobi;
+      jfnk.SetJacobianFreePreconditioner(jacobi, true);
+      jfnk.SetGradientReuse(2);
+      x = 0.0;
+      jfnk.Mult(b, x);
+      REQUIRE(jfnk.GetConverged());
+      REQUIRE(F.num_grad - grad0 == jfnk.GetNumGradientSetups());
+      REQUIRE(jfnk.GetNumGradientSetups() < jfnk.GetNumIterations());
+      F.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Norml2() <= 1e-10 * b.Norml2());
+      REQUIRE(jfnk.GetNumIterations() <= jfnk_iter + 2);
+   }
+
+   delete A;
+}
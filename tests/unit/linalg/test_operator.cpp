@@ -12,10 +12,123 @@
 #include "mfem.hpp"
 #include "catch.hpp"
 
-#ifdef MFEM_USE_EXCEPTIONS
-
 using namespace mfem;
 
+TEST_CASE("ConstrainedOperator", "[Operator]")
+{
+   // 1D Laplacian with a few constrained dofs
+   const int n = 10;
+   SparseMatrix A(n);
+   for (int i = 0; i < n; i++)
+   {
+      A.Add(i, i, 2.0);
+      if (i > 0) { A.Add(i, i-1, -1.0); }
+      if (i < n-1) { A.Add(i, i+1, -1.0); }
+   }
+   A.Finalize();
+
+   Array<int> ess_list(3);
+   ess_list[0] = 0; ess_list[1] = 4; ess_list[2] = n-1;
+   ConstrainedOperator C(&A, ess_list);
+
+   Vector x(n), x_copy(n), z(n), y(n), y_ref(n);
+   x.Randomize(1);
+   x_copy = x;
+
+   SECTION("Mult")
+   {
+      z = x;
+      for (int i = 0; i < ess_list.Size(); i++) { z(ess_list[i]) = 0.0; }
+      A.Mult(z, y_ref);
+      for (int i = 0; i < ess_list.Size(); i++)
+      {
+         y_ref(ess_list[i]) = x(ess_list[i]);
+      }
+
+      C.Mult(x, y);
+      y -= y_ref;
+      REQUIRE(y.Normlinf() < 1e-12);
+      // The input must be unchanged
+      x_copy -= x;
+      REQUIRE(x_copy.Normlinf() == 0.0);
+
+      // The input and output may alias
+      C.Mult(x, x);
+      x -= y_ref;
+      REQUIRE(x.Normlinf() < 1e-12);
+   }
+
+   SECTION("EliminateRHS")
+   {
+      Vector b(n), b_ref(n);
+      b.Randomize(2);
+      for (int k = 0; k < 2; k++)
+      {
+         z = 0.0;
+         for (int i = 0; i < ess_list.Size(); i++)
+         {
+            z(ess_list[i]) = x(ess_list[i]);
+         }
+         A.Mult(z, y_ref);
+         b_ref = b;
+         b_ref -= y_ref;
+         for (int i = 0; i < ess_list.Size(); i++)
+         {
+            b_ref(ess_list[i]) = x(ess_list[i]);
+         }
+
+         Vector b_elim(b);
+         C.EliminateRHS(x, b_elim);
+         b_elim -= b_ref;
+         REQUIRE(b_elim.Normlinf() < 1e-12);
+         // Repeated calls with a different x must give consistent results
+         x.Randomize(3);
+      }
+   }
+
+   SECTION("SetConstraints")
+   {
+      Vector b(n), b_elim(n);
+      b.Randomize(2);
+      C.Mult(x, y);
+      C.EliminateRHS(x, b_elim);
+
+      Array<int> new_list(2);
+      new_list[0] = 2; new_list[1] = 7;
+      C.SetConstraints(new_list);
+
+      z = x;
+      for (int i = 0; i < new_list.Size(); i++) { z(new_list[i]) = 0.0; }
+      A.Mult(z, y_ref);
+      for (int i = 0; i < new_list.Size(); i++)
+      {
+         y_ref(new_list[i]) = x(new_list[i]);
+      }
+      C.Mult(x, y);
+      y -= y_ref;
+      REQUIRE(y.Normlinf() < 1e-12);
+
+      z = 0.0;
+      for (int i = 0; i < new_list.Size(); i++)
+      {
+         z(new_list[i]) = x(new_list[i]);
+      }
+      A.Mult(z, y_ref);
+      Vector b_ref(b);
+      b_ref -= y_ref;
+      for (int i = 0; i < new_list.Size(); i++)
+      {
+         b_ref(new_list[i]) = x(new_list[i]);
+      }
+      b_elim = b;
+      C.EliminateRHS(x, b_elim);
+      b_elim -= b_ref;
+      REQUIRE(b_elim.Normlinf() < 1e-12);
+   }
+}
+
+#ifdef MFEM_USE_EXCEPTIONS
+
 TEST_CASE("Operator", "[Operator]")
 {
    // Define diagonal sparse matrix
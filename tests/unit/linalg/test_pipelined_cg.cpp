@@ -0,0 +1,61 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+TEST_CASE("Pipelined CG", "[PipelinedCG]")
+{
+   const int n = 30, N = n*n;
+   SparseMatrix *A_ptr = Laplacian(n);
+   SparseMatrix &A = *A_ptr;
+   // Vary the diagonal in the x direction
+   for (int r = 0; r < N; r++) { A.Add(r, r, 0.01*((r % n) % 5)); }
+
+   Vector b(N), x0(N), x1(N), r(N);
+   b.Randomize(1);
+
+   for (int use_prec = 0; use_prec <= 1; use_prec++)
+   {
+      DSmoother jacobi(A);
+
+      CGSolver cg;
+      cg.SetOperator(A);
+      if (use_prec) { cg.SetPreconditioner(jacobi); }
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(1000);
+      cg.SetPrintLevel(-1);
+      x0 = 0.0;
+      cg.Mult(b, x0);
+
+      PipelinedCGSolver pcg;
+      pcg.SetOperator(A);
+      if (use_prec) { pcg.SetPreconditioner(jacobi); }
+      pcg.SetRelTol(1e-10);
+      pcg.SetMaxIter(1000);
+      pcg.SetPrintLevel(-1);
+      x1 = 0.0;
+      pcg.Mult(b, x1);
+
+      REQUIRE(pcg.GetConverged());
+      REQUIRE(std::abs(pcg.GetNumIterations() - cg.GetNumIterations()) <= 2);
+
+      A.Mult(x1, r);
+      r -= b;
+      REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+   }
+
+   delete A_ptr;
+}
@@ -0,0 +1,329 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+static bool IsPermutation(const Array<int> &p, int n)
+{
+   if (p.Size() != n) { return false; }
+   Array<int> count(n);
+   count = 0;
+   for (int i = 0; i < n; i++)
+   {
+      if (p[i] < 0 || p[i] >= n || count[p[i]]++ > 0) { return false; }
+   }
+   return true;
+}
+
+TEST_CASE("Sparse matrix reordering", "[Reordering]")
+{
+   // A randomly permuted 2D Laplacian, and a 3D one
+   SparseMatrix *L2 = Laplacian(24, 1);
+   const int N2 = L2->Height();
+   Array<int> q(N2);
+   Vector r(N2);
+   r.Randomize(1);
+   for (int i = 0; i < N2; i++) { q[i] = i; }
+   std::sort(q.begin(), q.end(), [&r](int i, int j) { return r(i) < r(j); });
+   SparseMatrix *A2 = PermuteSparseMatrix(*L2, q);
+   SparseMatrix *A3 = Laplacian(12, 12);
+
+   SECTION("Permutation utilities")
+   {
+      Array<int> q_inv;
+      InvertPermutation(q, q_inv);
+      for (int i = 0; i < N2; i++) { REQUIRE(q[q_inv[i]] == i); }
+
+      // (P A P^t) (P x) = P (A x)
+      Vector x(N2), Px(N2), y(N2), Py(N2), z(N2);
+      x.Randomize(2);
+      PermuteVector(x, q, Px);
+      A2->Mult(Px, z);
+      L2->Mult(x, y);
+      PermuteVector(y, q, Py);
+      z -= Py;
+      REQUIRE(z.Normlinf() < 1e-12);
+
+      PermuteVector(Px, q, z, true);
+      z -= x;
+      REQUIRE(z.Normlinf() == 0.0);
+
+      SparseMatrix *B = PermuteSparseMatrix(*A2, q_inv);
+      B->Add(-1.0, *L2);
+      REQUIRE(B->MaxNorm() == 0.0);
+      delete B;
+   }
+
+   SECTION("Reverse Cuthill-McKee")
+   {
+      Array<int> p;
+      ReverseCuthillMcKeeOrdering(*A2, p);
+      REQUIRE(IsPermutation(p, N2));
+      SparseMatrix *B = PermuteSparseMatrix(*A2, p);
+      REQUIRE(Bandwidth(*B) <= 2*24);
+      REQUIRE(Bandwidth(*A2) > 10*Bandwidth(*B));
+      delete B;
+   }
+
+   SECTION("Fill-reducing orderings")
+   {
+      const SparseMatrix *As[2] = { A2, A3 };
+      for (int t = 0; t < 2; t++)
+      {
+         const SparseMatrix &A = *As[t];
+         const int N = A.Height();
+         Array<int> rcm, amd, nd;
+         ReverseCuthillMcKeeOrdering(A, rcm);
+         ApproximateMinimumDegreeOrdering(A, amd);
+         NestedDissectionOrdering(A, nd, 16);
+         REQUIRE(IsPermutation(amd, N));
+         REQUIRE(IsPermutation(nd, N));
+
+         const long nnz_none = CholeskyFactorNonZeros(A);
+         const long nnz_rcm = CholeskyFactorNonZeros(A, rcm);
+         const long nnz_amd = CholeskyFactorNonZeros(A, amd);
+         const long nnz_nd = CholeskyFactorNonZeros(A, nd);
+         REQUIRE(nnz_amd < nnz_rcm);
+         REQUIRE(nnz_nd < nnz_rcm);
+         REQUIRE(2*nnz_amd < nnz_none);
+         REQUIRE(2*nnz_nd < nnz_none);
+      }
+
+      // The fill computed from the elimination tree matches a dense Cholesky
+      // factorization of the (positive definite) reordered matrix
+      Array<int> amd;
+      ApproximateMinimumDegreeOrdering(*L2, amd);
+      SparseMatrix *B = PermuteSparseMatrix(*L2, amd);
+      DenseMatrix D;
+      B->ToDenseMatrix(D);
+      const int n = D.Height();
+      for (int k = 0; k < n; k++)
+      {
+         D(k,k) = sqrt(D(k,k));
+         for (int i = k+1; i < n; i++) { D(i,k) /= D(k,k); }
+         for (int j = k+1; j < n; j++)
+         {
+            for (int i = j; i < n; i++) { D(i,j) -= D(i,k)*D(j,k); }
+         }
+      }
+      long nnz = 0;
+      for (int j = 0; j < n; j++)
+      {
+         for (int i = j; i < n; i++) { nnz += (D(i,j) != 0.0); }
+      }
+      REQUIRE(nnz <= CholeskyFactorNonZeros(*L2, amd));
+      REQUIRE(nnz >= CholeskyFactorNonZeros(*L2, amd) - n/10);
+      delete B;
+   }
+
+   SECTION("Disconnected graph")
+   {
+      SparseMatrix *B = PermuteSparseMatrix(*A2, q);
+      SparseMatrix *C = new SparseMatrix(2*N2);
+      for (int i = 0; i < N2; i++)
+      {
+         for (int k = B->GetI()[i]; k < B->GetI()[i+1]; k++)
+         {
+            C->Add(i, B->GetJ()[k], 1.0);
+            C->Add(N2 + i, N2 + B->GetJ()[k], 1.0);
+         }
+      }
+      C->Finalize();
+      Array<int> rcm, amd, nd;
+      ReverseCuthillMcKeeOrdering(*C, rcm);
+      ApproximateMinimumDegreeOrdering(*C, amd);
+      NestedDissectionOrdering(*C, nd);
+      REQUIRE(IsPermutation(rcm, 2*N2));
+      REQUIRE(IsPermutation(amd, 2*N2));
+      REQUIRE(IsPermutation(nd, 2*N2));
+      delete C;
+      delete B;
+   }
+
+   SECTION("Many connected components")
+   {
+      // A 1D Laplacian with isolated rows
+      const int n = 40000;
+      SparseMatrix *P = new SparseMatrix(n);
+      for (int i = 0; i < n; i++)
+      {
+         P->Add(i, i, 2.0);
+         if (i % 2) { continue; }
+         if (i > 1) { P->Add(i, i-2, -1.0); }
+         if (i < n-2) { P->Add(i, i+2, -1.0); }
+      }
+      P->Finalize();
+      Array<int> nd;
+      NestedDissectionOrdering(*P, nd);
+      REQUIRE(IsPermutation(nd, n));
+      delete P;
+
+      // A block diagonal matrix with dense 4 x 4 blocks, which are ordered
+      // without fill
+      const int nb = 30000;
+      SparseMatrix *D = new SparseMatrix(4*nb);
+      for (int b = 0; b < nb; b++)
+      {
+         for (int i = 0; i < 4; i++)
+         {
+            for (int j = 0; j < 4; j++)
+            {
+               D->Add(4*b + i, 4*b + j, (i == j) ? 4.0 : -1.0);
+            }
+         }
+      }
+      D->Finalize();
+      NestedDissectionOrdering(*D, nd);
+      REQUIRE(IsPermutation(nd, 4*nb));
+      REQUIRE(CholeskyFactorNonZeros(*D, nd) == 10*nb);
+      delete D;
+   }
+
+   SECTION("Finite element space DOFs")
+   {
+      Mesh mesh(6, 6, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      const int n = fes.GetVSize();
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs, ess_tdofs_p;
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+      ConstantCoefficient one(1.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+      a.Finalize();
+      Array<int> p;
+      NestedDissectionOrdering(a.SpMat(), p, 8);
+
+      fes.ReorderDofs(p);
+      BilinearForm a_p(&fes);
+      a_p.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_p.Assemble();
+      a_p.Finalize();
+
+      // The form assembled on the reordered space is the permuted matrix
+      SparseMatrix *B = PermuteSparseMatrix(a.SpMat(), p);
+      B->Add(-1.0, a_p.SpMat());
+      REQUIRE(B->MaxNorm() < 1e-12);
+      delete B;
+
+      // The boundary DOFs are reordered as well
+      Array<int> p_inv;
+      InvertPermutation(p, p_inv);
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs_p);
+      REQUIRE(ess_tdofs_p.Size() == ess_tdofs.Size());
+      Array<int> marker(n);
+      marker = 0;
+      for (int i = 0; i < ess_tdofs.Size(); i++)
+      {
+         marker[p_inv[ess_tdofs[i]]]++;
+      }
+      for (int i = 0; i < ess_tdofs_p.Size(); i++)
+      {
+         REQUIRE(marker[ess_tdofs_p[i]] == 1);
+      }
+
+      // The DOFs of the mesh entities are renumbered consistently with the
+      // element DOFs, also after rebuilding the element-to-DOF table
+      Table elem_dof(fes.GetElementToDofTable());
+      fes.RebuildElementToDofTable();
+      Array<int> dofs, vert, edges, ori, vdofs, edofs, bdofs;
+      for (int e = 0; e < mesh.GetNE(); e++)
+      {
+         fes.GetElementDofs(e, dofs);
+         REQUIRE(dofs.Size() == elem_dof.RowSize(e));
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            REQUIRE(dofs[j] == elem_dof.GetRow(e)[j]);
+         }
+         mesh.GetElementVertices(e, vert);
+         fes.GetVertexDofs(vert[0], vdofs);
+         REQUIRE(dofs.Find(vdofs[0]) >= 0);
+         mesh.GetElementEdges(e, edges, ori);
+         fes.GetEdgeDofs(edges[0], edofs);
+         for (int j = 0; j < edofs.Size(); j++)
+         {
+            REQUIRE(dofs.Find(edofs[j]) >= 0);
+         }
+      }
+      for (int be = 0; be < mesh.GetNBE(); be++)
+      {
+         fes.GetBdrElementDofs(be, bdofs);
+         fes.GetFaceDofs(mesh.GetBdrElementEdgeIndex(be), dofs);
+         REQUIRE(bdofs.Size() == dofs.Size());
+         for (int j = 0; j < dofs.Size(); j++)
+         {
+            REQUIRE(bdofs.Find(dofs[j]) >= 0);
+         }
+      }
+
+      // Partial assembly uses the reordered element restriction
+      BilinearForm a_pa(&fes);
+      a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a_pa.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_pa.Assemble();
+      Vector x(n), y(n), z(n);
+      x.Randomize(3);
+      a_pa.Mult(x, y);
+      a_p.SpMat().Mult(x, z);
+      z -= y;
+      REQUIRE(z.Normlinf() < 1e-12);
+   }
+
+   SECTION("Discontinuous finite element space DOFs")
+   {
+      Mesh mesh(4, 3, Element::QUADRILATERAL, true);
+      L2_FECollection fec(2, 2, BasisType::GaussLobatto);
+      FiniteElementSpace fes(&mesh, &fec);
+      const int n = fes.GetVSize();
+
+      // A permutation that spreads the DOFs of each element
+      Array<int> p(n);
+      for (int i = 0; i < n; i++) { p[i] = (7*i) % n; }
+      REQUIRE(IsPermutation(p, n));
+      fes.ReorderDofs(p);
+
+      ConstantCoefficient one(1.0);
+      BilinearForm m(&fes);
+      m.AddDomainIntegrator(new MassIntegrator(one));
+      m.Assemble();
+      m.Finalize();
+
+      // The DG element restriction follows the reordered element DOFs
+      BilinearForm m_pa(&fes);
+      m_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      m_pa.AddDomainIntegrator(new MassIntegrator(one));
+      m_pa.Assemble();
+      Vector x(n), y(n), z(n);
+      x.Randomize(4);
+      m_pa.Mult(x, y);
+      m.SpMat().Mult(x, z);
+      z -= y;
+      REQUIRE(z.Normlinf() < 1e-12);
+
+      DGMassInverse minv(fes, &one, DGMassInverse::TENSOR);
+      minv.Mult(x, y);
+      m.SpMat().Mult(y, z);
+      z -= x;
+      REQUIRE(z.Normlinf() < 1e-10 * x.Normlinf());
+   }
+
+   delete A3;
+   delete A2;
+   delete L2;
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace sellmat
+{
+
+// Rectangular matrix with rows of very different lengths, including empty rows
+SparseMatrix *irregular_matrix(int height, int width)
+{
+   SparseMatrix *A = new SparseMatrix(height, width);
+   for (int i = 0; i < height; i++)
+   {
+      const int len = (i % 7 == 3) ? 0 : (i*i) % 11;
+      for (int k = 0; k < len; k++)
+      {
+         const int j = (i + 5*k*k) % width;
+         A->Add(i, j, 1.0 + 0.1*i - 0.3*k);
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+TEST_CASE("SELL-C-sigma Matrix", "[SellMatrix]")
+{
+   const int height = 53, width = 37;
+   SparseMatrix *A = irregular_matrix(height, width);
+
+   Vector x(width), xt(height), y0(height), y1(height), z0(width), z1(width);
+   x.Randomize(1);
+   xt.Randomize(2);
+   A->Mult(x, y0);
+   A->MultTranspose(xt, z0);
+
+   const int chunk_sizes[] = { 1, 3, 4, 8, 16 };
+   const int sigmas[] = { 1, 8, 20, 256 };
+   for (int C : chunk_sizes)
+   {
+      for (int sigma : sigmas)
+      {
+         SellMatrix S(*A, C, sigma);
+         REQUIRE(S.NumNonZeroElems() == A->NumNonZeroElems());
+         REQUIRE(S.NumStoredElems() >= A->NumNonZeroElems());
+
+         S.Mult(x, y1);
+         y1 -= y0;
+         REQUIRE(y1.Normlinf() < 1e-12);
+
+         y1 = y0;
+         S.AddMult(x, y1, -1.0);
+         REQUIRE(y1.Normlinf() < 1e-12);
+
+         S.MultTranspose(xt, z1);
+         z1 -= z0;
+         REQUIRE(z1.Normlinf() < 1e-12);
+
+         S.BuildTranspose();
+         S.MultTranspose(xt, z1);
+         z1 -= z0;
+         REQUIRE(z1.Normlinf() < 1e-12);
+      }
+   }
+
+   delete A;
+}
+
+TEST_CASE("SELL-C-sigma CG", "[SellMatrix]")
+{
+   // 1D Laplacian with Dirichlet boundary conditions
+   const int n = 100;
+   SparseMatrix A(n);
+   for (int i = 0; i < n; i++)
+   {
+      A.Add(i, i, 2.0);
+      if (i > 0) { A.Add(i, i-1, -1.0); }
+      if (i < n-1) { A.Add(i, i+1, -1.0); }
+   }
+   A.Finalize();
+
+   SellMatrix S(A);
+   Vector d0, d1;
+   A.GetDiag(d0);
+   S.GetDiag(d1);
+   d1 -= d0;
+   REQUIRE(d1.Normlinf() < 1e-12);
+
+   DSmoother jacobi(A);
+   CGSolver cg;
+   cg.SetOperator(S);
+   cg.SetPreconditioner(jacobi);
+   cg.SetRelTol(1e-12);
+   cg.SetMaxIter(2*n);
+   cg.SetPrintLevel(-1);
+
+   Vector b(n), x(n), r(n);
+   b.Randomize(3);
+   x = 0.0;
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+
+   A.Mult(x, r);
+   r -= b;
+   REQUIRE(r.Normlinf() < 1e-8 * b.Normlinf());
+}
+
+} // namespace sellmat
@@ -0,0 +1,204 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace sparsemat
+{
+
+// Diagonally dominant matrix with a non-symmetric sparsity pattern
+SparseMatrix *test_matrix(int n)
+{
+   SparseMatrix *A = new SparseMatrix(n);
+   for (int i = 0; i < n; i++)
+   {
+      A->Add(i, i, 10.0 + i % 3);
+      A->Add(i, (i + 1) % n, -1.0);
+      A->Add(i, (3*i + 5) % n, -2.0);
+   }
+   A->Finalize();
+   return A;
+}
+
+TEST_CASE("SparseMatrix Kernels", "[SparseMatrix]")
+{
+   const int n = 41;
+   SparseMatrix *A = test_matrix(n);
+   DenseMatrix *D = A->ToDenseMatrix();
+
+   Vector x(n), b(n), y0(n), y1(n);
+   x.Randomize(1);
+   b.Randomize(2);
+
+   SECTION("MultTranspose")
+   {
+      D->MultTranspose(x, y0);
+      A->MultTranspose(x, y1);
+      y1 -= y0;
+      REQUIRE(y1.Normlinf() < 1e-12);
+
+      y1 = y0;
+      A->AddMultTranspose(x, y1, -1.0);
+      REQUIRE(y1.Normlinf() < 1e-12);
+   }
+
+   SECTION("Diagonal and Jacobi")
+   {
+      Vector d;
+      A->GetDiag(d);
+      for (int i = 0; i < n; i++) { y0(i) = (*D)(i,i); }
+      y1 = d;
+      y1 -= y0;
+      REQUIRE(y1.Normlinf() < 1e-12);
+
+      // x1 = x0 + sc D^{-1} (b - A x0)
+      const double sc = 0.7;
+      D->Mult(x, y0);
+      subtract(b, y0, y0);
+      for (int i = 0; i < n; i++) { y0(i) = x(i) + sc * y0(i) / d(i); }
+      A->Jacobi(b, x, y1, sc);
+      y1 -= y0;
+      REQUIRE(y1.Normlinf() < 1e-12);
+
+      for (int i = 0; i < n; i++) { y0(i) = sc * b(i) / d(i); }
+      A->DiagScale(b, y1, sc);
+      y1 -= y0;
+      REQUIRE(y1.Normlinf() < 1e-12);
+   }
+
+   SECTION("Gauss-Seidel")
+   {
+      GSSmoother gs(*A, 0, 50);
+      gs.Mult(b, y1);
+      A->Mult(y1, y0);
+      y0 -= b;
+      REQUIRE(y0.Normlinf() < 1e-10 * b.Normlinf());
+   }
+
+   delete D;
+   delete A;
+}
+
+TEST_CASE("SparseMatrix Multi-Vector", "[SparseMatrix]")
+{
+   const int n = 41;
+   SparseMatrix *A = test_matrix(n);
+
+   // More vectors than processed together by the kernels
+   for (int k = 1; k <= 20; k += 19)
+   {
+      DenseMatrix X(n, k), Y, Z;
+      for (int c = 0; c < k; c++)
+      {
+         Vector x(X.GetColumn(c), n);
+         x.Randomize(c + 1);
+      }
+
+      A->Mult(X, Y);
+      A->MultTranspose(X, Z);
+      REQUIRE(Y.Width() == k);
+      REQUIRE(Z.Width() == k);
+
+      Vector y(n), z(n);
+      for (int c = 0; c < k; c++)
+      {
+         Vector x(X.GetColumn(c), n), yc(Y.GetColumn(c), n);
+         Vector zc(Z.GetColumn(c), n);
+         A->Mult(x, y);
+         A->MultTranspose(x, z);
+         y -= yc;
+         z -= zc;
+         REQUIRE(y.Normlinf() < 1e-12);
+         REQUIRE(z.Normlinf() < 1e-12);
+      }
+
+      A->AddMult(X, Y, -1.0);
+      REQUIRE(Y.MaxMaxNorm() < 1e-12);
+
+      A->BuildTranspose();
+      A->AddMultTranspose(X, Z, -1.0);
+      REQUIRE(Z.MaxMaxNorm() < 1e-12);
+      A->ResetTranspose();
+   }
+
+   delete A;
+}
+
+// Distance between two matrices with the same size
+double matrix_distance(const SparseMatrix &A, const SparseMatrix &B)
+{
+   SparseMatrix *D = Add(1.0, A, -1.0, B);
+   const double dist = D->MaxNorm();
+   delete D;
+   return dist;
+}
+
+TEST_CASE("SparseMatrix Product Plans", "[SparseMatrix]")
+{
+   const int n = 41, nc = 14;
+   SparseMatrix *A = test_matrix(n);
+
+   // Interpolation-like rectangular matrix
+   SparseMatrix P(n, nc);
+   for (int i = 0; i < n; i++)
+   {
+      P.Add(i, i/3, 1.0);
+      if (i % 3 == 2 && i/3 + 1 < nc) { P.Add(i, i/3 + 1, 0.5); }
+   }
+   P.Finalize();
+   SparseMatrix *R = Transpose(P);
+
+   SparseProductPlan AP_plan(*A, P);
+   SparseRAPPlan RAP_plan(*A, *R), RtAP_plan(P, *A, P);
+   SparseMatrix *AP = AP_plan.CreateMatrix();
+   SparseMatrix *RAP1 = RAP_plan.CreateMatrix();
+   SparseMatrix *RAP2 = RtAP_plan.CreateMatrix();
+
+   // The values of the matrices change between the products
+   for (int pass = 0; pass < 2; pass++)
+   {
+      if (pass == 1)
+      {
+         double *a = A->GetData();
+         for (int k = 0; k < A->NumNonZeroElems(); k++) { a[k] *= 1.0 + 0.1*k; }
+         double *p = P.GetData();
+         for (int k = 0; k < P.NumNonZeroElems(); k++) { p[k] -= 0.25; }
+         delete R;
+         R = Transpose(P);
+      }
+
+      SparseMatrix *AP0 = Mult(*A, P);
+      SparseMatrix *RAP0 = RAP(*A, *R);
+
+      AP_plan.Mult(*A, P, *AP);
+      RAP_plan.Mult(*A, *R, *RAP1);
+      RtAP_plan.Mult(P, *A, P, *RAP2);
+
+      REQUIRE(AP->NumNonZeroElems() == AP0->NumNonZeroElems());
+      REQUIRE(matrix_distance(*AP, *AP0) < 1e-12);
+      REQUIRE(matrix_distance(*RAP1, *RAP0) < 1e-12);
+      REQUIRE(matrix_distance(*RAP2, *RAP0) < 1e-12);
+
+      delete RAP0;
+      delete AP0;
+   }
+
+   delete RAP2;
+   delete RAP1;
+   delete AP;
+   delete R;
+   delete A;
+}
+
+} // namespace sparsemat
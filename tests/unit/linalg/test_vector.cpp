@@ -0,0 +1,112 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "grid_matrices.hpp"
+
+using namespace mfem;
+using namespace grid_matrices;
+
+TEST_CASE("Fused vector kernels", "[Vector]")
+{
+   const int n = 1000;
+   const double tol = 1e-12;
+   Vector a(n), b(n), c(n), d(n), v(n), w(n);
+   a.Randomize(1);
+   b.Randomize(2);
+   c.Randomize(3);
+   d.Randomize(4);
+
+   SECTION("AddAndDot")
+   {
+      const double dot = AddAndDot(a, 0.5, b, v, c);
+      add(a, 0.5, b, w);
+      REQUIRE(fabs(dot - w*c) < tol*n);
+      w -= v;
+      REQUIRE(w.Normlinf() == 0.0);
+
+      // In place update, v = v + alpha v2, with w = v
+      v = a;
+      const double norm2 = AddAndDot(v, -2.0, b, v, v);
+      add(a, -2.0, b, w);
+      REQUIRE(fabs(norm2 - w*w) < tol*n);
+   }
+
+   SECTION("AddAndNorm2")
+   {
+      // xpay: v = v1 + alpha v with the norm of the result
+      v = b;
+      const double norm2 = AddAndNorm2(a, 0.25, v, v);
+      add(a, 0.25, b, w);
+      REQUIRE(fabs(norm2 - w*w) < tol*n);
+      w -= v;
+      REQUIRE(w.Normlinf() == 0.0);
+   }
+
+   SECTION("AddAndXpay")
+   {
+      Vector x(c), p(d), x1(c), p1(d);
+      AddAndXpay(0.75, a, -0.5, x, p);
+      x1.Add(0.75, d);
+      add(a, -0.5, d, p1);
+      x1 -= x;
+      p1 -= p;
+      REQUIRE(x1.Normlinf() == 0.0);
+      REQUIRE(p1.Normlinf() == 0.0);
+   }
+
+   SECTION("Dot2")
+   {
+      double d1, d2;
+      Dot2(a, b, c, d1, d2);
+      REQUIRE(fabs(d1 - a*b) < tol*n);
+      REQUIRE(fabs(d2 - a*c) < tol*n);
+   }
+}
+
+TEST_CASE("Krylov solvers with fused kernels", "[Vector]")
+{
+   const int n = 20, N = n*n;
+   SparseMatrix *A_ptr = Laplacian(n);
+   SparseMatrix &A = *A_ptr;
+
+   Vector b(N), x(N), r(N);
+   b.Randomize(1);
+
+   CGSolver cg;
+   BiCGSTABSolver bicgstab;
+   MINRESSolver minres;
+   GMRESSolver gmres;
+   FGMRESSolver fgmres;
+   IterativeSolver *solvers[5] = { &cg, &bicgstab, &minres, &gmres, &fgmres };
+   for (int use_prec = 0; use_prec <= 1; use_prec++)
+   {
+      for (IterativeSolver *solver : solvers)
+      {
+         DSmoother jacobi(A);
+         solver->SetOperator(A);
+         if (use_prec) { solver->SetPreconditioner(jacobi); }
+         solver->SetRelTol(1e-10);
+         solver->SetMaxIter(1000);
+         solver->SetPrintLevel(-1);
+         x = 0.0;
+         solver->Mult(b, x);
+         REQUIRE(solver->GetConverged());
+
+         A.Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() < 1e-8 * b.Norml2());
+      }
+   }
+
+   delete A_ptr;
+}
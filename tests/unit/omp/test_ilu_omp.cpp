@@ -0,0 +1,66 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "../linalg/grid_matrices.hpp"
+
+using namespace mfem;
+
+namespace ilu_omp
+{
+
+// Block diagonal matrix with nc copies of the 5-point Laplacian on an n x n
+// grid. With blocks of size n, i.e. the grid lines, it is block tridiagonal
+// and block ILU(0) is exact, and each level has nc independent block rows.
+SparseMatrix *test_matrix(int n, int nc)
+{
+   SparseMatrix *L = grid_matrices::Laplacian(n);
+   const int N = L->Height();
+   const int *I = L->GetI(), *J = L->GetJ();
+   const double *V = L->GetData();
+   SparseMatrix *A = new SparseMatrix(nc*N);
+   for (int c = 0; c < nc; c++)
+   {
+      for (int i = 0; i < N; i++)
+      {
+         for (int k = I[i]; k < I[i+1]; k++)
+         {
+            A->Add(c*N + i, c*N + J[k], V[k]);
+         }
+      }
+   }
+   A->Finalize();
+   delete L;
+   return A;
+}
+
+TEST_CASE("BlockILU OpenMP Backend", "[ILU], [OpenMP]")
+{
+   REQUIRE(Device::Allows(Backend::OMP));
+
+   const int n = 12, nc = 7;
+   SparseMatrix *A = test_matrix(n, nc);
+   const int N = A->Height();
+
+   BlockILU ilu(*A, n, BlockILU::Reordering::NONE);
+
+   Vector b(N), x(N), r(N);
+   b.Randomize(1);
+   ilu.Mult(b, x);
+   A->Mult(x, r);
+   r -= b;
+   REQUIRE(r.Normlinf() < 1e-10 * b.Normlinf());
+
+   delete A;
+}
+
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace sparsemat_omp
+{
+
+// Diagonally dominant matrix with a non-symmetric sparsity pattern
+SparseMatrix *test_matrix(int n)
+{
+   SparseMatrix *A = new SparseMatrix(n);
+   for (int i = 0; i < n; i++)
+   {
+      A->Add(i, i, 10.0 + i % 3);
+      A->Add(i, (i + 1) % n, -1.0);
+      A->Add(i, (3*i + 5) % n, -2.0);
+   }
+   A->Finalize();
+   return A;
+}
+
+TEST_CASE("SparseMatrix OpenMP Backend", "[SparseMatrix], [OpenMP]")
+{
+   REQUIRE(Device::Allows(Backend::OMP));
+
+   const int n = 2003, k = 5;
+   SparseMatrix *A = test_matrix(n);
+   DenseMatrix *D = A->ToDenseMatrix();
+
+   Vector x(n), b(n);
+   x.Randomize(1);
+   b.Randomize(2);
+   DenseMatrix X(n, k);
+   Vector(X.GetData(), n*k).Randomize(3);
+
+   // Reference results with the dense matrix
+   const double sc = 0.7;
+   Vector y_ref(n), yt_ref(n), jac_ref(n), ds_ref(n), d_ref(n);
+   DenseMatrix Y_ref(n, k);
+   D->Mult(x, y_ref);
+   D->MultTranspose(x, yt_ref);
+   for (int i = 0; i < n; i++)
+   {
+      yt_ref(i) = 1.0 - 2.0 * yt_ref(i);
+      d_ref(i) = (*D)(i,i);
+      jac_ref(i) = x(i) + sc * (b(i) - y_ref(i)) / d_ref(i);
+      ds_ref(i) = sc * b(i) / d_ref(i);
+   }
+   Mult(*D, X, Y_ref);
+
+   Vector y(n), d;
+   DenseMatrix Y;
+   A->Mult(x, y);
+   y -= y_ref;
+   REQUIRE(y.Normlinf() < 1e-12);
+
+   // Repeat to reuse the per-thread storage of the transpose action
+   for (int it = 0; it < 2; it++)
+   {
+      y = 1.0;
+      A->AddMultTranspose(x, y, -2.0);
+      y -= yt_ref;
+      REQUIRE(y.Normlinf() < 1e-12);
+   }
+
+   A->Jacobi(b, x, y, sc);
+   y -= jac_ref;
+   REQUIRE(y.Normlinf() < 1e-12);
+
+   A->DiagScale(b, y, sc);
+   y -= ds_ref;
+   REQUIRE(y.Normlinf() < 1e-12);
+
+   A->GetDiag(d);
+   d -= d_ref;
+   REQUIRE(d.Normlinf() == 0.0);
+
+   A->Mult(X, Y);
+   Y -= Y_ref;
+   REQUIRE(Y.MaxMaxNorm() < 1e-12);
+
+   // The hybrid Gauss-Seidel sweeps converge for this matrix
+   GSSmoother gs(*A, 0, 50);
+   gs.Mult(b, y);
+   A->Mult(y, x);
+   x -= b;
+   REQUIRE(x.Normlinf() < 1e-10 * b.Normlinf());
+
+   delete D;
+   delete A;
+}
+
+} // namespace sparsemat_omp
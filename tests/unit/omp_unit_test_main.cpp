@@ -0,0 +1,36 @@
+// Copyright (c) 2019, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#define CATCH_CONFIG_RUNNER
+#include "mfem.hpp"
+#include "catch.hpp"
+
+// Unit tests of the "omp" device backend. The Device can be configured only
+// once, so these tests are run by their own executable, 'omp_unit_tests', and
+// the rest of the unit tests keep the default CPU backend.
+int main(int argc, char *argv[])
+{
+   // There must be exactly one instance.
+   Catch::Session session;
+
+   // Apply provided command line arguments.
+   int r = session.applyCommandLine(argc, argv);
+   if (r != 0)
+   {
+      return r;
+   }
+
+   mfem::Device device("omp");
+
+   int result = session.run();
+
+   return result;
+}